@@ -110,20 +110,17 @@ void Intro_InitAmiga(Intro* intro, SceneSetup* sceneSetup, AssetsData* assetsDat
     MArrayInit(intro->imageStore.images);
 
     if (intro->drawFrontierLogo) {
-#if FINTRO_SCREEN_RES == 3
-        Image8Bit image;
-        Image8Bit* imagePtr = &image;
-#else
+        // Logo at original size, then (if needed) upscaled 2x & 4x for the higher resolutions
         Image8Bit* imagePtr = MArrayAddPtr(intro->imageStore.images);
-#endif
         Render_ImageFromPlanerBitmap(imagePtr,
                                      sceneSetup->assets.mainData + 0x0007f2aa,
                                      (u16*) sceneSetup->assets.mainData + 0x0007f29a,
                                      16);
-#if FINTRO_SCREEN_RES == 3
-        Image8Bit* upScaledImage = MArrayAddPtr(intro->imageStore.images);
-        Render_ImageUpscale2x(&image, upScaledImage);
-        MFree(image.data, image.w * image.h);
+#if !defined(FINTRO_SCREEN_RES_FIXED) || FINTRO_SCREEN_RES >= 3
+        for (u32 i = 0; i < 2; i++) {
+            Image8Bit* upScaledImage = MArrayAddPtr(intro->imageStore.images);
+            Render_ImageUpscale2x(MArrayGetPtr(intro->imageStore.images, i), upScaledImage);
+        }
 #endif
     }
     sceneSetup->planetDetail = 2;
@@ -329,7 +326,11 @@ void Intro_Post3dRender(Intro* intro, SceneSetup* sceneSetup, i32 frameOffset) {
     }
 
     if (intro->drawFrontierLogo && scenePos.scene >= 2) {
-        Image8Bit* image = MArrayGetPtr(intro->imageStore.images, 0);
+        u32 logoIndex = sceneSetup->raster->surface->res > 2 ? sceneSetup->raster->surface->res - 2 : 0;
+        if (logoIndex >= MArraySize(intro->imageStore.images)) {
+            logoIndex = MArraySize(intro->imageStore.images) - 1;
+        }
+        Image8Bit* image = MArrayGetPtr(intro->imageStore.images, logoIndex);
         Vec2i16 pos;
         pos.x = (sceneSetup->raster->surface->width - image->w) / 2;
         pos.y = (sceneSetup->raster->surface->height - image->h);
@@ -904,8 +904,18 @@ i32 MMemReadU32BE(MMemIO*restrict memIO, u32*restrict val) {
     return 0;
 }
 
-i32 MMemReadU8CopyN(MMemIO* memIO, u8* dest, u32 size) {
-    return -1;
+i32 MMemReadU8CopyN(MMemIO*restrict memIO, u8*restrict dest, u32 size) {
+    if (size == 0) {
+        return 0;
+    }
+
+    if (memIO->pos + size > memIO->mem + memIO->size) {
+        return -1;
+    }
+
+    memmove(dest, memIO->pos, size);
+    memIO->pos += size;
+    return 0;
 }
 
 char* MMemReadStr(MMemIO* memIO) {
@@ -4605,6 +4605,183 @@ i32 CompileAndWriteModels(const char* modelsFile, const char* outputFile, MMemIO
     return 0;
 }
 
+// Renderer byte code handler for each func (see RunModelCodeFunc() in render.c)
+static const char* sTranslateFuncNames[32] = {
+        NULL, "RenderCircle", "RenderLine", "RenderTri",
+        "RenderQuad", "RenderComplex", "RenderBatch", "Render2TriMirrored",
+        "Render2QuadMirrored", "RenderTeardrop", "RenderVectorText", "RenderIf",
+        "RenderIfNot", "RenderCalc", "RenderModel", "RenderAudioCue",
+        "RenderCone", "RenderConeCapped", "RenderBitmapText", "RenderIfVar",
+        "RenderIfNotVar", "RenderDepthTreePushPop", "RenderLineBezier", "RenderScreenSpaceDist",
+        "RenderCircles", "RenderMatrixSetup", "RenderColour", "RenderModelScale",
+        "RenderMatrixTransform", "RenderCalc", "RenderMatrixCopy", "RenderPlanet",
+};
+
+MINTERNAL i32 TranslateModel(ModelData* model, u32 modelIndex, MMemIO* strOutput) {
+    const u8* code = ((u8*)model) + model->codeOffset;
+
+    // Find instructions reachable by falling through or by IF jumps
+    u8* found = (u8*)MMalloc(MODEL_CODE_MAX_SIZE);
+    memset(found, 0, MODEL_CODE_MAX_SIZE);
+    u32Array pending;
+    MArrayInit(pending);
+    MArrayAdd(pending, 0);
+    found[0] = 1;
+    u32 codeSize = 0;
+    u32 numOps = 0;
+    while (MArraySize(pending)) {
+        u32 offset = MArrayPop(pending);
+        numOps++;
+        u32 size = ModelCode_InstructionSize(code, offset);
+        if (offset + (size ? size : 2) > codeSize) {
+            codeSize = offset + (size ? size : 2);
+        }
+        if (!size || (ModelCode_Read16(code, offset) & 0x1f) == Render_DONE) {
+            continue;
+        }
+        u32 next[2] = { offset + size, ModelCode_BranchTarget(code, offset, size) };
+        for (int i = 0; i < 2; i++) {
+            if (next[i] && next[i] + 2 <= MODEL_CODE_MAX_SIZE && !found[next[i]]) {
+                found[next[i]] = 1;
+                MArrayAdd(pending, next[i]);
+            }
+        }
+    }
+    MArrayFree(pending);
+
+    if (numOps < 2) {
+        MFree(found, MODEL_CODE_MAX_SIZE);
+        return -1;
+    }
+
+    MStringAppendf(strOutput, "static const u8 sCompiledModelCode%d[] = {", (int)modelIndex);
+    for (u32 i = 0; i < codeSize; i++) {
+        MStringAppendf(strOutput, "%s0x%02x,", (i % 16) ? " " : "\n    ", (int)code[i]);
+    }
+    MStringAppend(strOutput, "\n};\n\n");
+
+    MStringAppendf(strOutput, "MINTERNAL void CompiledModel%d(RenderContext* renderContext, RenderFrame* rf, u8* code) {\n",
+                   (int)modelIndex);
+    for (u32 offset = 0; offset < codeSize; offset += 2) {
+        if (!found[offset]) {
+            continue;
+        }
+        u16 funcParam = ModelCode_Read16(code, offset);
+        u8 func = funcParam & 0x1f;
+        u32 size = ModelCode_InstructionSize(code, offset);
+        if (func == Render_DONE) {
+            MStringAppendf(strOutput, "    MODEL_DONE(0x%04x)\n", offset);
+        } else if (!size) {
+            MStringAppendf(strOutput, "    MODEL_OP_END(0x%04x, %s, 0x%04x)\n", offset, sTranslateFuncNames[func],
+                           funcParam);
+        } else {
+            MStringAppendf(strOutput, "    MODEL_OP(0x%04x, 0x%04x, %s, 0x%04x)\n", offset, offset + size,
+                           sTranslateFuncNames[func], funcParam);
+            // Next instruction is not the next one written out, so jump to it
+            u32 nextFound = offset + 2;
+            while (nextFound < codeSize && !found[nextFound]) {
+                nextFound += 2;
+            }
+            if (nextFound != offset + size) {
+                MStringAppendf(strOutput, "    goto L0x%04x;\n", offset + size);
+            }
+        }
+    }
+    MStringAppend(strOutput, "    MODEL_RESUME_BEGIN\n");
+    for (u32 offset = 0; offset < codeSize; offset += 2) {
+        if (found[offset]) {
+            MStringAppendf(strOutput, "    MODEL_RESUME(0x%04x)\n", offset);
+        }
+    }
+    MStringAppend(strOutput, "    MODEL_RESUME_END\n}\n\n");
+
+    MFree(found, MODEL_CODE_MAX_SIZE);
+    return 0;
+}
+
+i32 TranslateModels(ModelsArray* models, const u32* modelIndexes, u32 numIndexes, MMemIO* strOutput) {
+    MStringAppend(strOutput,
+                  "// Model byte code translated to C by 'fintro -translate', do not edit.\n"
+                  "// Included by render.c when FINTRO_MODELS_AOT is defined.\n\n");
+
+    u32Array translated;
+    MArrayInit(translated);
+    u32 count = numIndexes ? numIndexes : MArraySize(*models);
+    for (u32 i = 0; i < count; i++) {
+        u32 modelIndex = numIndexes ? modelIndexes[i] : i;
+        if (modelIndex >= MArraySize(*models) || !models->arr[modelIndex]) {
+            continue;
+        }
+        if (MArraySize(translated) >= MODELS_AOT_MAX) {
+            MLogf("Too many models to translate, skipping model %d", (int)modelIndex);
+            continue;
+        }
+        if (!TranslateModel(models->arr[modelIndex], modelIndex, strOutput)) {
+            MArrayAdd(translated, modelIndex);
+        }
+    }
+
+    MStringAppend(strOutput, "static const CompiledModel sCompiledModels[] = {\n");
+    for (u32 i = 0; i < MArraySize(translated); i++) {
+        int modelIndex = (int)translated.arr[i];
+        MStringAppendf(strOutput, "    { %d, sizeof(sCompiledModelCode%d), sCompiledModelCode%d, CompiledModel%d },\n",
+                       modelIndex, modelIndex, modelIndex, modelIndex);
+    }
+    MStringAppend(strOutput, "};\n");
+
+    i32 numTranslated = MArraySize(translated);
+    MArrayFree(translated);
+    return numTranslated;
+}
+
+i32 CompileAndTranslateModels(const char* modelsFile, const char* outputFile) {
+    MReadFileRet file = MFileReadFully(modelsFile);
+    if (file.size == 0) {
+        return -1;
+    }
+
+    MMemIO modelsMem;
+    MMemInitAlloc(&modelsMem, 1024);
+    ModelsArray models;
+    MArrayInit(models);
+
+    ModelCompileResult result = CompileMultipleModels((const char*)file.data, file.size, &modelsMem, &models,
+                                                      ModelEndian_LITTLE, FALSE);
+    MFree(file.data, file.size);
+
+    if (result.error) {
+        MLogf("Got error: %s", result.error);
+        MLogf("    at line: %d, column: %d", result.errorLine, result.errorColumn);
+        if (!result.staticError) {
+            MFree(result.error, result.errorLen); result.error = NULL;
+        }
+        MArrayFree(models);
+        MMemFree(&modelsMem);
+        return -2;
+    }
+
+    i32 ret = TranslateModelsToFile(&models, NULL, 0, outputFile);
+
+    MArrayFree(models);
+    MMemFree(&modelsMem);
+
+    return ret;
+}
+
+i32 TranslateModelsToFile(ModelsArray* models, const u32* modelIndexes, u32 numIndexes, const char* outputFile) {
+    MMemIO writer;
+    MMemInitAlloc(&writer, 10000);
+    i32 numTranslated = TranslateModels(models, modelIndexes, numIndexes, &writer);
+
+    MLogf("Saving %d translated models to %s...", numTranslated, outputFile);
+    MFile fileOut = MFileWriteOpen(outputFile);
+    MFileWriteMem(&fileOut, &writer);
+    MFileClose(&fileOut);
+
+    MMemFree(&writer);
+    return 0;
+}
+
 void TestModelCompile(MMemIO* memOutput, const char* testData, u32 testDataLen,
                       const char* error, u32 line, u32 column) {
 
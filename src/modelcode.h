@@ -79,6 +79,21 @@ ModelCompileResult CompileMultipleModels(const char* dataIn, u32 sizeIn, MMemIO*
 i32 CompileAndWriteModels(const char* modelsFile, const char* outputFile, MMemIO* outModelMem, ModelsArray* outModels,
                           ModelEndianEnum endian, b32 dumpModelsToConsole);
 
+// Max number of models that can be translated to C
+#define MODELS_AOT_MAX 64
+
+// Translate model byte code into C functions that call the renderer's byte code handlers directly, with
+// no dispatch. Translates the models listed in modelIndexes, or all models if numIndexes is 0.
+// The output is included by render.c when built with FINTRO_MODELS_AOT.
+// Returns the number of models translated.
+i32 TranslateModels(ModelsArray* models, const u32* modelIndexes, u32 numIndexes, MMemIO* strOutput);
+
+// Translate models and write the C code to given file
+i32 TranslateModelsToFile(ModelsArray* models, const u32* modelIndexes, u32 numIndexes, const char* outputFile);
+
+// Compile all models from file and write their C translation to given file
+i32 CompileAndTranslateModels(const char* modelsFile, const char* outputFile);
+
 void ModelCompile_Test();
 
 #ifdef __cplusplus
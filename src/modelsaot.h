@@ -0,0 +1,1532 @@
+// Model byte code translated to C by 'fintro -translate', do not edit.
+// Included by render.c when FINTRO_MODELS_AOT is defined.
+
+static const u8 sCompiledModelCode20[] = {
+    0x5d, 0xc2, 0x80, 0x05, 0x1d, 0xc3, 0x60, 0x01, 0xfd, 0xc2, 0xc2, 0xc3, 0x2d, 0xc6, 0xc2, 0x02,
+    0x19, 0x80, 0x1e, 0xc0, 0x4d, 0xc5, 0xc6, 0x01, 0x1d, 0xc5, 0x6c, 0xc5, 0x3c, 0x00, 0xc5, 0x00,
+    0xed, 0xc3, 0x50, 0xc5, 0x5d, 0xc3, 0xc3, 0x01, 0x0d, 0xc3, 0x01, 0xc3, 0x1d, 0xc3, 0x60, 0xc3,
+    0xdd, 0xc4, 0x50, 0xc5, 0x5d, 0xc4, 0xc4, 0x01, 0x0d, 0xc4, 0x60, 0xc4, 0x0d, 0xc1, 0x3f, 0x78,
+    0x7d, 0xc6, 0xc6, 0x70, 0x3d, 0xc6, 0xc6, 0x0c, 0x5d, 0xc6, 0xc6, 0x03, 0x1d, 0xc6, 0x60, 0xc6,
+    0x4d, 0xc6, 0xc6, 0x01, 0x0d, 0xc6, 0xc6, 0x60, 0xed, 0xc6, 0x50, 0xc6, 0x0d, 0xc6, 0x50, 0xc6,
+    0x5d, 0xc6, 0xc6, 0x01, 0x0e, 0x05, 0x12, 0x06, 0x00, 0x00,
+};
+
+MINTERNAL void CompiledModel20(RenderContext* renderContext, RenderFrame* rf, u8* code) {
+    MODEL_OP(0x0000, 0x0004, RenderCalc, 0xc25d)
+    MODEL_OP(0x0004, 0x0008, RenderCalc, 0xc31d)
+    MODEL_OP(0x0008, 0x000c, RenderCalc, 0xc2fd)
+    MODEL_OP(0x000c, 0x0010, RenderCalc, 0xc62d)
+    MODEL_OP(0x0010, 0x0012, RenderMatrixSetup, 0x8019)
+    MODEL_OP(0x0012, 0x0014, RenderMatrixCopy, 0xc01e)
+    MODEL_OP(0x0014, 0x0018, RenderCalc, 0xc54d)
+    MODEL_OP(0x0018, 0x001c, RenderCalc, 0xc51d)
+    MODEL_OP(0x001c, 0x0020, RenderMatrixTransform, 0x003c)
+    MODEL_OP(0x0020, 0x0024, RenderCalc, 0xc3ed)
+    MODEL_OP(0x0024, 0x0028, RenderCalc, 0xc35d)
+    MODEL_OP(0x0028, 0x002c, RenderCalc, 0xc30d)
+    MODEL_OP(0x002c, 0x0030, RenderCalc, 0xc31d)
+    MODEL_OP(0x0030, 0x0034, RenderCalc, 0xc4dd)
+    MODEL_OP(0x0034, 0x0038, RenderCalc, 0xc45d)
+    MODEL_OP(0x0038, 0x003c, RenderCalc, 0xc40d)
+    MODEL_OP(0x003c, 0x0040, RenderCalc, 0xc10d)
+    MODEL_OP(0x0040, 0x0044, RenderCalc, 0xc67d)
+    MODEL_OP(0x0044, 0x0048, RenderCalc, 0xc63d)
+    MODEL_OP(0x0048, 0x004c, RenderCalc, 0xc65d)
+    MODEL_OP(0x004c, 0x0050, RenderCalc, 0xc61d)
+    MODEL_OP(0x0050, 0x0054, RenderCalc, 0xc64d)
+    MODEL_OP(0x0054, 0x0058, RenderCalc, 0xc60d)
+    MODEL_OP(0x0058, 0x005c, RenderCalc, 0xc6ed)
+    MODEL_OP(0x005c, 0x0060, RenderCalc, 0xc60d)
+    MODEL_OP(0x0060, 0x0064, RenderCalc, 0xc65d)
+    MODEL_OP(0x0064, 0x0068, RenderModel, 0x050e)
+    MODEL_DONE(0x0068)
+    MODEL_RESUME_BEGIN
+    MODEL_RESUME(0x0000)
+    MODEL_RESUME(0x0004)
+    MODEL_RESUME(0x0008)
+    MODEL_RESUME(0x000c)
+    MODEL_RESUME(0x0010)
+    MODEL_RESUME(0x0012)
+    MODEL_RESUME(0x0014)
+    MODEL_RESUME(0x0018)
+    MODEL_RESUME(0x001c)
+    MODEL_RESUME(0x0020)
+    MODEL_RESUME(0x0024)
+    MODEL_RESUME(0x0028)
+    MODEL_RESUME(0x002c)
+    MODEL_RESUME(0x0030)
+    MODEL_RESUME(0x0034)
+    MODEL_RESUME(0x0038)
+    MODEL_RESUME(0x003c)
+    MODEL_RESUME(0x0040)
+    MODEL_RESUME(0x0044)
+    MODEL_RESUME(0x0048)
+    MODEL_RESUME(0x004c)
+    MODEL_RESUME(0x0050)
+    MODEL_RESUME(0x0054)
+    MODEL_RESUME(0x0058)
+    MODEL_RESUME(0x005c)
+    MODEL_RESUME(0x0060)
+    MODEL_RESUME(0x0064)
+    MODEL_RESUME(0x0068)
+    MODEL_RESUME_END
+}
+
+static const u8 sCompiledModelCode34[] = {
+    0x5d, 0xc2, 0x80, 0x07, 0x0d, 0xc6, 0xc2, 0x00, 0x19, 0x80, 0x1e, 0xc0, 0x0e, 0x0d, 0x00, 0x00,
+    0x0d, 0xc2, 0xc6, 0x00, 0xce, 0x06, 0x00, 0x00, 0x5d, 0xc5, 0xc6, 0x02, 0xdd, 0xc5, 0x42, 0xc5,
+    0x0d, 0xc5, 0xc5, 0x42, 0x1d, 0xc5, 0x5c, 0xc5, 0xbc, 0x05, 0x60, 0x00, 0x1c, 0x83, 0x50, 0x00,
+    0x5c, 0x83, 0xc5, 0x00, 0x0d, 0xc2, 0x7f, 0x03, 0x0d, 0xc1, 0x7f, 0x00, 0xbd, 0xc3, 0xc6, 0x62,
+    0x93, 0x01, 0xc3, 0x00, 0x5d, 0xc3, 0xc6, 0x01, 0x4d, 0xc3, 0xc3, 0x02, 0x1d, 0xc3, 0x50, 0xc3,
+    0xdd, 0xc3, 0x50, 0xc3, 0x1d, 0xc3, 0x50, 0xc3, 0x5d, 0xc3, 0xc3, 0x02, 0x2d, 0xc5, 0xc6, 0x05,
+    0xed, 0xc5, 0x41, 0xc5, 0x0d, 0xc5, 0xc5, 0x41, 0x6e, 0x05, 0x2c, 0x06, 0x2d, 0xc5, 0xc6, 0x03,
+    0xdd, 0xc5, 0x44, 0xc5, 0x0d, 0xc5, 0xc5, 0x44, 0x0d, 0xc5, 0x5c, 0xc5, 0xbc, 0x05, 0x60, 0x00,
+    0x1c, 0x83, 0x50, 0x00, 0x5c, 0x83, 0xc5, 0x00, 0x0d, 0xc2, 0x7f, 0x03, 0x0d, 0xc1, 0x7f, 0x00,
+    0xbd, 0xc4, 0xc6, 0x60, 0xd3, 0x01, 0xc4, 0x00, 0x1d, 0xc4, 0xc6, 0x60, 0x4d, 0xc4, 0xc4, 0x03,
+    0x2d, 0xc4, 0xc4, 0x08, 0x0d, 0xc2, 0xc4, 0x44, 0x1d, 0xc1, 0x00, 0x01, 0xee, 0x06, 0x26, 0x00,
+    0x0d, 0xc4, 0x01, 0x00, 0x14, 0x01, 0xc4, 0x00, 0x2d, 0xc3, 0xc6, 0x05, 0xed, 0xc3, 0x41, 0xc3,
+    0x0d, 0xc3, 0xc3, 0x41, 0x6e, 0x05, 0x26, 0x06, 0xbd, 0xc4, 0xc6, 0x60, 0x93, 0x04, 0xc4, 0x00,
+    0x1d, 0xc4, 0xc6, 0x60, 0x4d, 0xc7, 0x41, 0x02, 0x0d, 0xc4, 0xc4, 0xc7, 0x4d, 0xc4, 0xc4, 0x01,
+    0xed, 0xc4, 0x50, 0xc4, 0x1d, 0xc4, 0x50, 0xc4, 0x5d, 0xc4, 0xc4, 0x02, 0x4d, 0xc5, 0xc4, 0x03,
+    0x1d, 0xc5, 0x00, 0xc5, 0x4d, 0xc5, 0xc5, 0x01, 0x1d, 0xc5, 0xc5, 0x60, 0xbc, 0x05, 0x60, 0x00,
+    0x1c, 0x83, 0x50, 0x00, 0x1c, 0x83, 0xc5, 0x00, 0x0d, 0xc2, 0x5f, 0x01, 0x0d, 0xc1, 0x7f, 0x00,
+    0xce, 0x04, 0x0a, 0x06, 0x0d, 0xc4, 0x01, 0x00, 0xd4, 0x02, 0xc4, 0x00, 0x4d, 0xc4, 0xc6, 0x01,
+    0xdd, 0xc4, 0x50, 0xc4, 0x5d, 0xc4, 0xc4, 0x02, 0x4d, 0xc5, 0xc4, 0x01, 0x1d, 0xc5, 0xc5, 0x60,
+    0xbc, 0x05, 0x60, 0x00, 0x1c, 0x83, 0x50, 0x00, 0x1c, 0x83, 0xc5, 0x00, 0x0d, 0xc2, 0x5f, 0x01,
+    0x0d, 0xc1, 0x7f, 0x00, 0xce, 0x04, 0x06, 0x06, 0xcd, 0xc1, 0xc6, 0x60, 0xbd, 0xc1, 0xc1, 0x58,
+    0xd3, 0x01, 0xc1, 0x00, 0xc6, 0x44, 0x4d, 0xc1, 0xc6, 0x07, 0xfd, 0xc1, 0xc1, 0x01, 0xd3, 0x00,
+    0xc1, 0x00, 0x21, 0xf2, 0x00, 0x0f, 0x80, 0x26, 0x23, 0xf2, 0x3c, 0x3a, 0x00, 0x26, 0x06, 0x00,
+    0x00, 0x00,
+};
+
+MINTERNAL void CompiledModel34(RenderContext* renderContext, RenderFrame* rf, u8* code) {
+    MODEL_OP(0x0000, 0x0004, RenderCalc, 0xc25d)
+    MODEL_OP(0x0004, 0x0008, RenderCalc, 0xc60d)
+    MODEL_OP(0x0008, 0x000a, RenderMatrixSetup, 0x8019)
+    MODEL_OP(0x000a, 0x000c, RenderMatrixCopy, 0xc01e)
+    MODEL_OP(0x000c, 0x0010, RenderModel, 0x0d0e)
+    MODEL_OP(0x0010, 0x0014, RenderCalc, 0xc20d)
+    MODEL_OP(0x0014, 0x0018, RenderModel, 0x06ce)
+    MODEL_OP(0x0018, 0x001c, RenderCalc, 0xc55d)
+    MODEL_OP(0x001c, 0x0020, RenderCalc, 0xc5dd)
+    MODEL_OP(0x0020, 0x0024, RenderCalc, 0xc50d)
+    MODEL_OP(0x0024, 0x0028, RenderCalc, 0xc51d)
+    MODEL_OP(0x0028, 0x002c, RenderMatrixTransform, 0x05bc)
+    MODEL_OP(0x002c, 0x0030, RenderMatrixTransform, 0x831c)
+    MODEL_OP(0x0030, 0x0034, RenderMatrixTransform, 0x835c)
+    MODEL_OP(0x0034, 0x0038, RenderCalc, 0xc20d)
+    MODEL_OP(0x0038, 0x003c, RenderCalc, 0xc10d)
+    MODEL_OP(0x003c, 0x0040, RenderCalc, 0xc3bd)
+    MODEL_OP(0x0040, 0x0044, RenderIfVar, 0x0193)
+    MODEL_OP(0x0044, 0x0048, RenderCalc, 0xc35d)
+    MODEL_OP(0x0048, 0x004c, RenderCalc, 0xc34d)
+    MODEL_OP(0x004c, 0x0050, RenderCalc, 0xc31d)
+    MODEL_OP(0x0050, 0x0054, RenderCalc, 0xc3dd)
+    MODEL_OP(0x0054, 0x0058, RenderCalc, 0xc31d)
+    MODEL_OP(0x0058, 0x005c, RenderCalc, 0xc35d)
+    MODEL_OP(0x005c, 0x0060, RenderCalc, 0xc52d)
+    MODEL_OP(0x0060, 0x0064, RenderCalc, 0xc5ed)
+    MODEL_OP(0x0064, 0x0068, RenderCalc, 0xc50d)
+    MODEL_OP(0x0068, 0x006c, RenderModel, 0x056e)
+    MODEL_OP(0x006c, 0x0070, RenderCalc, 0xc52d)
+    MODEL_OP(0x0070, 0x0074, RenderCalc, 0xc5dd)
+    MODEL_OP(0x0074, 0x0078, RenderCalc, 0xc50d)
+    MODEL_OP(0x0078, 0x007c, RenderCalc, 0xc50d)
+    MODEL_OP(0x007c, 0x0080, RenderMatrixTransform, 0x05bc)
+    MODEL_OP(0x0080, 0x0084, RenderMatrixTransform, 0x831c)
+    MODEL_OP(0x0084, 0x0088, RenderMatrixTransform, 0x835c)
+    MODEL_OP(0x0088, 0x008c, RenderCalc, 0xc20d)
+    MODEL_OP(0x008c, 0x0090, RenderCalc, 0xc10d)
+    MODEL_OP(0x0090, 0x0094, RenderCalc, 0xc4bd)
+    MODEL_OP(0x0094, 0x0098, RenderIfVar, 0x01d3)
+    MODEL_OP(0x0098, 0x009c, RenderCalc, 0xc41d)
+    MODEL_OP(0x009c, 0x00a0, RenderCalc, 0xc44d)
+    MODEL_OP(0x00a0, 0x00a4, RenderCalc, 0xc42d)
+    MODEL_OP(0x00a4, 0x00a8, RenderCalc, 0xc20d)
+    MODEL_OP(0x00a8, 0x00ac, RenderCalc, 0xc11d)
+    MODEL_OP(0x00ac, 0x00b0, RenderModel, 0x06ee)
+    MODEL_OP(0x00b0, 0x00b4, RenderCalc, 0xc40d)
+    MODEL_OP(0x00b4, 0x00b8, RenderIfNotVar, 0x0114)
+    MODEL_OP(0x00b8, 0x00bc, RenderCalc, 0xc32d)
+    MODEL_OP(0x00bc, 0x00c0, RenderCalc, 0xc3ed)
+    MODEL_OP(0x00c0, 0x00c4, RenderCalc, 0xc30d)
+    MODEL_OP(0x00c4, 0x00c8, RenderModel, 0x056e)
+    MODEL_OP(0x00c8, 0x00cc, RenderCalc, 0xc4bd)
+    MODEL_OP(0x00cc, 0x00d0, RenderIfVar, 0x0493)
+    MODEL_OP(0x00d0, 0x00d4, RenderCalc, 0xc41d)
+    MODEL_OP(0x00d4, 0x00d8, RenderCalc, 0xc74d)
+    MODEL_OP(0x00d8, 0x00dc, RenderCalc, 0xc40d)
+    MODEL_OP(0x00dc, 0x00e0, RenderCalc, 0xc44d)
+    MODEL_OP(0x00e0, 0x00e4, RenderCalc, 0xc4ed)
+    MODEL_OP(0x00e4, 0x00e8, RenderCalc, 0xc41d)
+    MODEL_OP(0x00e8, 0x00ec, RenderCalc, 0xc45d)
+    MODEL_OP(0x00ec, 0x00f0, RenderCalc, 0xc54d)
+    MODEL_OP(0x00f0, 0x00f4, RenderCalc, 0xc51d)
+    MODEL_OP(0x00f4, 0x00f8, RenderCalc, 0xc54d)
+    MODEL_OP(0x00f8, 0x00fc, RenderCalc, 0xc51d)
+    MODEL_OP(0x00fc, 0x0100, RenderMatrixTransform, 0x05bc)
+    MODEL_OP(0x0100, 0x0104, RenderMatrixTransform, 0x831c)
+    MODEL_OP(0x0104, 0x0108, RenderMatrixTransform, 0x831c)
+    MODEL_OP(0x0108, 0x010c, RenderCalc, 0xc20d)
+    MODEL_OP(0x010c, 0x0110, RenderCalc, 0xc10d)
+    MODEL_OP(0x0110, 0x0114, RenderModel, 0x04ce)
+    MODEL_OP(0x0114, 0x0118, RenderCalc, 0xc40d)
+    MODEL_OP(0x0118, 0x011c, RenderIfNotVar, 0x02d4)
+    MODEL_OP(0x011c, 0x0120, RenderCalc, 0xc44d)
+    MODEL_OP(0x0120, 0x0124, RenderCalc, 0xc4dd)
+    MODEL_OP(0x0124, 0x0128, RenderCalc, 0xc45d)
+    MODEL_OP(0x0128, 0x012c, RenderCalc, 0xc54d)
+    MODEL_OP(0x012c, 0x0130, RenderCalc, 0xc51d)
+    MODEL_OP(0x0130, 0x0134, RenderMatrixTransform, 0x05bc)
+    MODEL_OP(0x0134, 0x0138, RenderMatrixTransform, 0x831c)
+    MODEL_OP(0x0138, 0x013c, RenderMatrixTransform, 0x831c)
+    MODEL_OP(0x013c, 0x0140, RenderCalc, 0xc20d)
+    MODEL_OP(0x0140, 0x0144, RenderCalc, 0xc10d)
+    MODEL_OP(0x0144, 0x0148, RenderModel, 0x04ce)
+    MODEL_OP(0x0148, 0x014c, RenderCalc, 0xc1cd)
+    MODEL_OP(0x014c, 0x0150, RenderCalc, 0xc1bd)
+    MODEL_OP(0x0150, 0x0154, RenderIfVar, 0x01d3)
+    MODEL_OP(0x0154, 0x0156, RenderBatch, 0x44c6)
+    MODEL_OP(0x0156, 0x015a, RenderCalc, 0xc14d)
+    MODEL_OP(0x015a, 0x015e, RenderCalc, 0xc1fd)
+    MODEL_OP(0x015e, 0x0162, RenderIfVar, 0x00d3)
+    MODEL_OP(0x0162, 0x0168, RenderCircle, 0xf221)
+    MODEL_OP(0x0168, 0x016e, RenderTri, 0xf223)
+    MODEL_OP(0x016e, 0x0170, RenderBatch, 0x0006)
+    MODEL_DONE(0x0170)
+    MODEL_RESUME_BEGIN
+    MODEL_RESUME(0x0000)
+    MODEL_RESUME(0x0004)
+    MODEL_RESUME(0x0008)
+    MODEL_RESUME(0x000a)
+    MODEL_RESUME(0x000c)
+    MODEL_RESUME(0x0010)
+    MODEL_RESUME(0x0014)
+    MODEL_RESUME(0x0018)
+    MODEL_RESUME(0x001c)
+    MODEL_RESUME(0x0020)
+    MODEL_RESUME(0x0024)
+    MODEL_RESUME(0x0028)
+    MODEL_RESUME(0x002c)
+    MODEL_RESUME(0x0030)
+    MODEL_RESUME(0x0034)
+    MODEL_RESUME(0x0038)
+    MODEL_RESUME(0x003c)
+    MODEL_RESUME(0x0040)
+    MODEL_RESUME(0x0044)
+    MODEL_RESUME(0x0048)
+    MODEL_RESUME(0x004c)
+    MODEL_RESUME(0x0050)
+    MODEL_RESUME(0x0054)
+    MODEL_RESUME(0x0058)
+    MODEL_RESUME(0x005c)
+    MODEL_RESUME(0x0060)
+    MODEL_RESUME(0x0064)
+    MODEL_RESUME(0x0068)
+    MODEL_RESUME(0x006c)
+    MODEL_RESUME(0x0070)
+    MODEL_RESUME(0x0074)
+    MODEL_RESUME(0x0078)
+    MODEL_RESUME(0x007c)
+    MODEL_RESUME(0x0080)
+    MODEL_RESUME(0x0084)
+    MODEL_RESUME(0x0088)
+    MODEL_RESUME(0x008c)
+    MODEL_RESUME(0x0090)
+    MODEL_RESUME(0x0094)
+    MODEL_RESUME(0x0098)
+    MODEL_RESUME(0x009c)
+    MODEL_RESUME(0x00a0)
+    MODEL_RESUME(0x00a4)
+    MODEL_RESUME(0x00a8)
+    MODEL_RESUME(0x00ac)
+    MODEL_RESUME(0x00b0)
+    MODEL_RESUME(0x00b4)
+    MODEL_RESUME(0x00b8)
+    MODEL_RESUME(0x00bc)
+    MODEL_RESUME(0x00c0)
+    MODEL_RESUME(0x00c4)
+    MODEL_RESUME(0x00c8)
+    MODEL_RESUME(0x00cc)
+    MODEL_RESUME(0x00d0)
+    MODEL_RESUME(0x00d4)
+    MODEL_RESUME(0x00d8)
+    MODEL_RESUME(0x00dc)
+    MODEL_RESUME(0x00e0)
+    MODEL_RESUME(0x00e4)
+    MODEL_RESUME(0x00e8)
+    MODEL_RESUME(0x00ec)
+    MODEL_RESUME(0x00f0)
+    MODEL_RESUME(0x00f4)
+    MODEL_RESUME(0x00f8)
+    MODEL_RESUME(0x00fc)
+    MODEL_RESUME(0x0100)
+    MODEL_RESUME(0x0104)
+    MODEL_RESUME(0x0108)
+    MODEL_RESUME(0x010c)
+    MODEL_RESUME(0x0110)
+    MODEL_RESUME(0x0114)
+    MODEL_RESUME(0x0118)
+    MODEL_RESUME(0x011c)
+    MODEL_RESUME(0x0120)
+    MODEL_RESUME(0x0124)
+    MODEL_RESUME(0x0128)
+    MODEL_RESUME(0x012c)
+    MODEL_RESUME(0x0130)
+    MODEL_RESUME(0x0134)
+    MODEL_RESUME(0x0138)
+    MODEL_RESUME(0x013c)
+    MODEL_RESUME(0x0140)
+    MODEL_RESUME(0x0144)
+    MODEL_RESUME(0x0148)
+    MODEL_RESUME(0x014c)
+    MODEL_RESUME(0x0150)
+    MODEL_RESUME(0x0154)
+    MODEL_RESUME(0x0156)
+    MODEL_RESUME(0x015a)
+    MODEL_RESUME(0x015e)
+    MODEL_RESUME(0x0162)
+    MODEL_RESUME(0x0168)
+    MODEL_RESUME(0x016e)
+    MODEL_RESUME(0x0170)
+    MODEL_RESUME_END
+}
+
+static const u8 sCompiledModelCode36[] = {
+    0x5d, 0xc2, 0x80, 0x05, 0x0d, 0xc6, 0xc2, 0x00, 0x19, 0x80, 0x1e, 0xc0, 0x0d, 0xc5, 0xc6, 0x00,
+    0x94, 0x04, 0xc5, 0x10, 0x5d, 0xc6, 0xc6, 0x01, 0x1d, 0xc2, 0x40, 0xc6, 0x4d, 0xc2, 0xc2, 0x02,
+    0xed, 0xc2, 0x50, 0xc2, 0x1d, 0xc2, 0x50, 0xc2, 0x4d, 0xc2, 0xc2, 0x02, 0x5d, 0xc4, 0xc6, 0x02,
+    0x1d, 0xc4, 0xc4, 0x50, 0xdd, 0xc4, 0xc2, 0xc4, 0x1d, 0xc4, 0x40, 0xc4, 0x3c, 0x18, 0xc4, 0x00,
+    0x0e, 0x0d, 0x00, 0x06, 0x7d, 0xc3, 0xc6, 0x50, 0xdd, 0xc3, 0x50, 0xc3, 0x5d, 0xc3, 0xc3, 0x02,
+    0x0d, 0xc2, 0xc6, 0x00, 0x6d, 0xc2, 0xc6, 0x42, 0x4e, 0x08, 0x06, 0x06, 0x93, 0x03, 0xc5, 0x10,
+    0x1d, 0xc6, 0x40, 0x01, 0x5d, 0xc4, 0xc5, 0x01, 0x4d, 0xc4, 0xc4, 0x02, 0xed, 0xc4, 0x50, 0xc4,
+    0x1d, 0xc4, 0x50, 0xc4, 0x5d, 0xc4, 0xc4, 0x03, 0x3c, 0x18, 0xc4, 0x00, 0x0e, 0x0d, 0x00, 0x06,
+    0x5d, 0xc3, 0xc5, 0x01, 0x7d, 0xc3, 0xc3, 0x48, 0x5d, 0xc3, 0xc3, 0x03, 0x1d, 0xc3, 0x40, 0xc3,
+    0x0d, 0xc2, 0xc6, 0x00, 0x4e, 0x08, 0x04, 0x06, 0x00, 0x00,
+};
+
+MINTERNAL void CompiledModel36(RenderContext* renderContext, RenderFrame* rf, u8* code) {
+    MODEL_OP(0x0000, 0x0004, RenderCalc, 0xc25d)
+    MODEL_OP(0x0004, 0x0008, RenderCalc, 0xc60d)
+    MODEL_OP(0x0008, 0x000a, RenderMatrixSetup, 0x8019)
+    MODEL_OP(0x000a, 0x000c, RenderMatrixCopy, 0xc01e)
+    MODEL_OP(0x000c, 0x0010, RenderCalc, 0xc50d)
+    MODEL_OP(0x0010, 0x0014, RenderIfNotVar, 0x0494)
+    MODEL_OP(0x0014, 0x0018, RenderCalc, 0xc65d)
+    MODEL_OP(0x0018, 0x001c, RenderCalc, 0xc21d)
+    MODEL_OP(0x001c, 0x0020, RenderCalc, 0xc24d)
+    MODEL_OP(0x0020, 0x0024, RenderCalc, 0xc2ed)
+    MODEL_OP(0x0024, 0x0028, RenderCalc, 0xc21d)
+    MODEL_OP(0x0028, 0x002c, RenderCalc, 0xc24d)
+    MODEL_OP(0x002c, 0x0030, RenderCalc, 0xc45d)
+    MODEL_OP(0x0030, 0x0034, RenderCalc, 0xc41d)
+    MODEL_OP(0x0034, 0x0038, RenderCalc, 0xc4dd)
+    MODEL_OP(0x0038, 0x003c, RenderCalc, 0xc41d)
+    MODEL_OP(0x003c, 0x0040, RenderMatrixTransform, 0x183c)
+    MODEL_OP(0x0040, 0x0044, RenderModel, 0x0d0e)
+    MODEL_OP(0x0044, 0x0048, RenderCalc, 0xc37d)
+    MODEL_OP(0x0048, 0x004c, RenderCalc, 0xc3dd)
+    MODEL_OP(0x004c, 0x0050, RenderCalc, 0xc35d)
+    MODEL_OP(0x0050, 0x0054, RenderCalc, 0xc20d)
+    MODEL_OP(0x0054, 0x0058, RenderCalc, 0xc26d)
+    MODEL_OP(0x0058, 0x005c, RenderModel, 0x084e)
+    MODEL_OP(0x005c, 0x0060, RenderIfVar, 0x0393)
+    MODEL_OP(0x0060, 0x0064, RenderCalc, 0xc61d)
+    MODEL_OP(0x0064, 0x0068, RenderCalc, 0xc45d)
+    MODEL_OP(0x0068, 0x006c, RenderCalc, 0xc44d)
+    MODEL_OP(0x006c, 0x0070, RenderCalc, 0xc4ed)
+    MODEL_OP(0x0070, 0x0074, RenderCalc, 0xc41d)
+    MODEL_OP(0x0074, 0x0078, RenderCalc, 0xc45d)
+    MODEL_OP(0x0078, 0x007c, RenderMatrixTransform, 0x183c)
+    MODEL_OP(0x007c, 0x0080, RenderModel, 0x0d0e)
+    MODEL_OP(0x0080, 0x0084, RenderCalc, 0xc35d)
+    MODEL_OP(0x0084, 0x0088, RenderCalc, 0xc37d)
+    MODEL_OP(0x0088, 0x008c, RenderCalc, 0xc35d)
+    MODEL_OP(0x008c, 0x0090, RenderCalc, 0xc31d)
+    MODEL_OP(0x0090, 0x0094, RenderCalc, 0xc20d)
+    MODEL_OP(0x0094, 0x0098, RenderModel, 0x084e)
+    MODEL_DONE(0x0098)
+    MODEL_RESUME_BEGIN
+    MODEL_RESUME(0x0000)
+    MODEL_RESUME(0x0004)
+    MODEL_RESUME(0x0008)
+    MODEL_RESUME(0x000a)
+    MODEL_RESUME(0x000c)
+    MODEL_RESUME(0x0010)
+    MODEL_RESUME(0x0014)
+    MODEL_RESUME(0x0018)
+    MODEL_RESUME(0x001c)
+    MODEL_RESUME(0x0020)
+    MODEL_RESUME(0x0024)
+    MODEL_RESUME(0x0028)
+    MODEL_RESUME(0x002c)
+    MODEL_RESUME(0x0030)
+    MODEL_RESUME(0x0034)
+    MODEL_RESUME(0x0038)
+    MODEL_RESUME(0x003c)
+    MODEL_RESUME(0x0040)
+    MODEL_RESUME(0x0044)
+    MODEL_RESUME(0x0048)
+    MODEL_RESUME(0x004c)
+    MODEL_RESUME(0x0050)
+    MODEL_RESUME(0x0054)
+    MODEL_RESUME(0x0058)
+    MODEL_RESUME(0x005c)
+    MODEL_RESUME(0x0060)
+    MODEL_RESUME(0x0064)
+    MODEL_RESUME(0x0068)
+    MODEL_RESUME(0x006c)
+    MODEL_RESUME(0x0070)
+    MODEL_RESUME(0x0074)
+    MODEL_RESUME(0x0078)
+    MODEL_RESUME(0x007c)
+    MODEL_RESUME(0x0080)
+    MODEL_RESUME(0x0084)
+    MODEL_RESUME(0x0088)
+    MODEL_RESUME(0x008c)
+    MODEL_RESUME(0x0090)
+    MODEL_RESUME(0x0094)
+    MODEL_RESUME(0x0098)
+    MODEL_RESUME_END
+}
+
+static const u8 sCompiledModelCode39[] = {
+    0x06, 0xe0, 0x3a, 0x00, 0xdf, 0x02, 0x45, 0x74, 0x00, 0x00, 0x48, 0xe4, 0x62, 0x02, 0x00, 0x00,
+    0x00, 0x00, 0x28, 0x02, 0x10, 0x40, 0x48, 0x05, 0x00, 0x00, 0x04, 0xfa, 0x19, 0xc6, 0xf7, 0x21,
+    0xca, 0x05, 0x3c, 0xed, 0xfb, 0x3d, 0x05, 0x10, 0x3b, 0x10, 0xf1, 0x39, 0xfb, 0xe6, 0x28, 0xf8,
+    0xd0, 0x30, 0xe0, 0xe5, 0x00, 0x00, 0x00, 0x00,
+};
+
+MINTERNAL void CompiledModel39(RenderContext* renderContext, RenderFrame* rf, u8* code) {
+    MODEL_OP(0x0000, 0x0004, RenderBatch, 0xe006)
+    MODEL_OP(0x0004, 0x0036, RenderPlanet, 0x02df)
+    MODEL_DONE(0x0036)
+    MODEL_RESUME_BEGIN
+    MODEL_RESUME(0x0000)
+    MODEL_RESUME(0x0004)
+    MODEL_RESUME(0x0036)
+    MODEL_RESUME_END
+}
+
+static const u8 sCompiledModelCode40[] = {
+    0x0d, 0xc6, 0xc2, 0x00, 0x0d, 0xc3, 0xc1, 0x00, 0x4e, 0x0e, 0x00, 0x40, 0x15, 0x00, 0xd3, 0x02,
+    0xc3, 0x04, 0x06, 0x41, 0x85, 0x00, 0x00, 0x20, 0x00, 0x02, 0x16, 0x0a, 0x3e, 0x16, 0x10, 0x08,
+    0x14, 0x10, 0x0c, 0x08, 0x3c, 0x0c, 0x18, 0x08, 0x0e, 0x18, 0x1a, 0x08, 0x1e, 0x1c, 0x12, 0x08,
+    0x20, 0x12, 0x22, 0x08, 0x0a, 0x24, 0x00, 0x00, 0x7b, 0x08, 0x08, 0x0b, 0x22, 0x42, 0xe6, 0xff,
+    0x73, 0x00, 0xc3, 0x02, 0x9b, 0x08, 0x37, 0x23, 0x30, 0x20, 0x53, 0x00, 0xc3, 0x01, 0xae, 0x08,
+    0x28, 0x0b, 0x73, 0x01, 0xc3, 0x06, 0x06, 0x00, 0x2e, 0x09, 0x32, 0x00, 0x2e, 0x09, 0x34, 0x00,
+    0x2e, 0x09, 0x36, 0x00, 0x2e, 0x09, 0x38, 0x00, 0x2e, 0x09, 0x3a, 0x00, 0x73, 0x02, 0xc3, 0x03,
+    0x4e, 0x09, 0x0b, 0x20, 0x9b, 0x08, 0x26, 0x23, 0x30, 0x10, 0x8e, 0x08, 0x1b, 0x20, 0x4e, 0x09,
+    0x1d, 0x28, 0x6e, 0x09, 0x1f, 0x00, 0x8e, 0x08, 0x13, 0x20, 0x4e, 0x09, 0x21, 0x23, 0x6e, 0x09,
+    0x23, 0x28, 0x8e, 0x08, 0x25, 0x00, 0x53, 0x01, 0xc3, 0x05, 0x8e, 0x09, 0x06, 0x00, 0x1d, 0xc1,
+    0x00, 0x01, 0xce, 0x09, 0x04, 0x00, 0x0d, 0xc1, 0x4a, 0x27, 0x4e, 0x0a, 0x02, 0x00, 0x53, 0x00,
+    0xc3, 0x0f, 0x0e, 0x0b, 0x00, 0x00, 0xbb, 0x0b, 0x5e, 0x03, 0x44, 0x24, 0xbb, 0x0b, 0x60, 0x2b,
+    0x44, 0x34, 0xbb, 0x0b, 0x62, 0x28, 0x44, 0x24, 0xbb, 0x0b, 0x64, 0x00, 0x44, 0x34, 0x53, 0x10,
+    0xc3, 0x10, 0x54, 0x04, 0xc6, 0x10, 0x7d, 0xc4, 0xc6, 0x58, 0x3d, 0xc4, 0xc4, 0x06, 0x5d, 0xc4,
+    0xc4, 0x03, 0x1d, 0xc4, 0x60, 0xc4, 0x4d, 0xc5, 0xc4, 0x01, 0x0d, 0xc5, 0xc5, 0x60, 0xed, 0xc5,
+    0x50, 0xc5, 0x0d, 0xc5, 0x50, 0xc5, 0x5d, 0xc5, 0xc5, 0x01, 0x0d, 0xc1, 0xc5, 0x00, 0x5d, 0xc3,
+    0xc5, 0x02, 0x3c, 0x08, 0xc3, 0x00, 0xfd, 0xc2, 0xc5, 0x7f, 0x0d, 0xc2, 0xc2, 0x01, 0x5d, 0xc4,
+    0x3b, 0x01, 0x6d, 0xc5, 0xc5, 0xc4, 0xce, 0x04, 0x5c, 0x06, 0x93, 0x0b, 0xc6, 0x10, 0x1d, 0xc4,
+    0xc6, 0x60, 0xbd, 0xc3, 0xc4, 0x50, 0x54, 0x05, 0xc3, 0x00, 0x5d, 0xc5, 0xc4, 0x02, 0x4d, 0xc3,
+    0xc6, 0x05, 0xfd, 0xc3, 0xc3, 0x02, 0xb3, 0x01, 0xc3, 0x00, 0x86, 0x49, 0x4d, 0xc1, 0x41, 0x03,
+    0x5d, 0xc2, 0xc4, 0x09, 0x4d, 0xc2, 0xc2, 0x08, 0xce, 0x0b, 0x4c, 0x4d, 0x23, 0xf2, 0x4c, 0x66,
+    0x00, 0x46, 0x06, 0x00, 0x4d, 0xc3, 0xc6, 0x05, 0x0d, 0xc3, 0xc3, 0x07, 0xfd, 0xc3, 0xc3, 0x01,
+    0xb3, 0x01, 0xc3, 0x00, 0x46, 0x4a, 0x4d, 0xc1, 0x41, 0x03, 0x5d, 0xc2, 0xc4, 0x09, 0x4d, 0xc2,
+    0xc2, 0x08, 0xce, 0x0b, 0x52, 0x4d, 0x23, 0xf2, 0x52, 0x66, 0x00, 0x46, 0x06, 0x00, 0x6d, 0xc4,
+    0xc4, 0x48, 0x1d, 0xc4, 0xc4, 0x48, 0x3d, 0xc4, 0xc4, 0x06, 0x5d, 0xc4, 0xc4, 0x03, 0x4d, 0xc5,
+    0xc4, 0x01, 0x0d, 0xc5, 0xc5, 0x60, 0xed, 0xc5, 0x50, 0xc5, 0x0d, 0xc5, 0x50, 0xc5, 0x5d, 0xc5,
+    0xc5, 0x01, 0x5d, 0xc3, 0xc4, 0x01, 0x3c, 0x08, 0xc3, 0x00, 0x7d, 0xc3, 0xc4, 0x50, 0x1c, 0x83,
+    0xc3, 0x00, 0x7d, 0xc2, 0xc4, 0x60, 0x5d, 0xc2, 0xc2, 0x01, 0xfd, 0xc2, 0xc2, 0x7f, 0x0d, 0xc2,
+    0xc2, 0x01, 0x7d, 0xc1, 0xc4, 0x48, 0x5d, 0xc1, 0xc1, 0x03, 0x5d, 0xc4, 0x3b, 0x01, 0x6d, 0xc5,
+    0xc5, 0xc4, 0xce, 0x04, 0x44, 0x06, 0x15, 0x80, 0x00, 0x00,
+};
+
+MINTERNAL void CompiledModel40(RenderContext* renderContext, RenderFrame* rf, u8* code) {
+    MODEL_OP(0x0000, 0x0004, RenderCalc, 0xc60d)
+    MODEL_OP(0x0004, 0x0008, RenderCalc, 0xc30d)
+    MODEL_OP(0x0008, 0x000c, RenderModel, 0x0e4e)
+    MODEL_OP(0x000c, 0x000e, RenderDepthTreePushPop, 0x0015)
+    MODEL_OP(0x000e, 0x0012, RenderIfVar, 0x02d3)
+    MODEL_OP(0x0012, 0x0014, RenderBatch, 0x4106)
+    MODEL_OP(0x0014, 0x0038, RenderComplex, 0x0085)
+    MODEL_OP(0x0038, 0x003e, RenderModelScale, 0x087b)
+    MODEL_OP(0x003e, 0x0040, RenderBatch, 0xffe6)
+    MODEL_OP(0x0040, 0x0044, RenderIfVar, 0x0073)
+    MODEL_OP(0x0044, 0x004a, RenderModelScale, 0x089b)
+    MODEL_OP(0x004a, 0x004e, RenderIfVar, 0x0053)
+    MODEL_OP(0x004e, 0x0052, RenderModel, 0x08ae)
+    MODEL_OP(0x0052, 0x0056, RenderIfVar, 0x0173)
+    MODEL_OP(0x0056, 0x0058, RenderBatch, 0x0006)
+    MODEL_OP(0x0058, 0x005c, RenderModel, 0x092e)
+    MODEL_OP(0x005c, 0x0060, RenderModel, 0x092e)
+    MODEL_OP(0x0060, 0x0064, RenderModel, 0x092e)
+    MODEL_OP(0x0064, 0x0068, RenderModel, 0x092e)
+    MODEL_OP(0x0068, 0x006c, RenderModel, 0x092e)
+    MODEL_OP(0x006c, 0x0070, RenderIfVar, 0x0273)
+    MODEL_OP(0x0070, 0x0074, RenderModel, 0x094e)
+    MODEL_OP(0x0074, 0x007a, RenderModelScale, 0x089b)
+    MODEL_OP(0x007a, 0x007e, RenderModel, 0x088e)
+    MODEL_OP(0x007e, 0x0082, RenderModel, 0x094e)
+    MODEL_OP(0x0082, 0x0086, RenderModel, 0x096e)
+    MODEL_OP(0x0086, 0x008a, RenderModel, 0x088e)
+    MODEL_OP(0x008a, 0x008e, RenderModel, 0x094e)
+    MODEL_OP(0x008e, 0x0092, RenderModel, 0x096e)
+    MODEL_OP(0x0092, 0x0096, RenderModel, 0x088e)
+    MODEL_OP(0x0096, 0x009a, RenderIfVar, 0x0153)
+    MODEL_OP(0x009a, 0x009e, RenderModel, 0x098e)
+    MODEL_OP(0x009e, 0x00a2, RenderCalc, 0xc11d)
+    MODEL_OP(0x00a2, 0x00a6, RenderModel, 0x09ce)
+    MODEL_OP(0x00a6, 0x00aa, RenderCalc, 0xc10d)
+    MODEL_OP(0x00aa, 0x00ae, RenderModel, 0x0a4e)
+    MODEL_OP(0x00ae, 0x00b2, RenderIfVar, 0x0053)
+    MODEL_OP(0x00b2, 0x00b6, RenderModel, 0x0b0e)
+    MODEL_OP(0x00b6, 0x00bc, RenderModelScale, 0x0bbb)
+    MODEL_OP(0x00bc, 0x00c2, RenderModelScale, 0x0bbb)
+    MODEL_OP(0x00c2, 0x00c8, RenderModelScale, 0x0bbb)
+    MODEL_OP(0x00c8, 0x00ce, RenderModelScale, 0x0bbb)
+    MODEL_OP(0x00ce, 0x00d2, RenderIfVar, 0x1053)
+    MODEL_OP(0x00d2, 0x00d6, RenderIfNotVar, 0x0454)
+    MODEL_OP(0x00d6, 0x00da, RenderCalc, 0xc47d)
+    MODEL_OP(0x00da, 0x00de, RenderCalc, 0xc43d)
+    MODEL_OP(0x00de, 0x00e2, RenderCalc, 0xc45d)
+    MODEL_OP(0x00e2, 0x00e6, RenderCalc, 0xc41d)
+    MODEL_OP(0x00e6, 0x00ea, RenderCalc, 0xc54d)
+    MODEL_OP(0x00ea, 0x00ee, RenderCalc, 0xc50d)
+    MODEL_OP(0x00ee, 0x00f2, RenderCalc, 0xc5ed)
+    MODEL_OP(0x00f2, 0x00f6, RenderCalc, 0xc50d)
+    MODEL_OP(0x00f6, 0x00fa, RenderCalc, 0xc55d)
+    MODEL_OP(0x00fa, 0x00fe, RenderCalc, 0xc10d)
+    MODEL_OP(0x00fe, 0x0102, RenderCalc, 0xc35d)
+    MODEL_OP(0x0102, 0x0106, RenderMatrixTransform, 0x083c)
+    MODEL_OP(0x0106, 0x010a, RenderCalc, 0xc2fd)
+    MODEL_OP(0x010a, 0x010e, RenderCalc, 0xc20d)
+    MODEL_OP(0x010e, 0x0112, RenderCalc, 0xc45d)
+    MODEL_OP(0x0112, 0x0116, RenderCalc, 0xc56d)
+    MODEL_OP(0x0116, 0x011a, RenderModel, 0x04ce)
+    MODEL_OP(0x011a, 0x011e, RenderIfVar, 0x0b93)
+    MODEL_OP(0x011e, 0x0122, RenderCalc, 0xc41d)
+    MODEL_OP(0x0122, 0x0126, RenderCalc, 0xc3bd)
+    MODEL_OP(0x0126, 0x012a, RenderIfNotVar, 0x0554)
+    MODEL_OP(0x012a, 0x012e, RenderCalc, 0xc55d)
+    MODEL_OP(0x012e, 0x0132, RenderCalc, 0xc34d)
+    MODEL_OP(0x0132, 0x0136, RenderCalc, 0xc3fd)
+    MODEL_OP(0x0136, 0x013a, RenderIfVar, 0x01b3)
+    MODEL_OP(0x013a, 0x013c, RenderBatch, 0x4986)
+    MODEL_OP(0x013c, 0x0140, RenderCalc, 0xc14d)
+    MODEL_OP(0x0140, 0x0144, RenderCalc, 0xc25d)
+    MODEL_OP(0x0144, 0x0148, RenderCalc, 0xc24d)
+    MODEL_OP(0x0148, 0x014c, RenderModel, 0x0bce)
+    MODEL_OP(0x014c, 0x0152, RenderTri, 0xf223)
+    MODEL_OP(0x0152, 0x0154, RenderBatch, 0x0006)
+    MODEL_OP(0x0154, 0x0158, RenderCalc, 0xc34d)
+    MODEL_OP(0x0158, 0x015c, RenderCalc, 0xc30d)
+    MODEL_OP(0x015c, 0x0160, RenderCalc, 0xc3fd)
+    MODEL_OP(0x0160, 0x0164, RenderIfVar, 0x01b3)
+    MODEL_OP(0x0164, 0x0166, RenderBatch, 0x4a46)
+    MODEL_OP(0x0166, 0x016a, RenderCalc, 0xc14d)
+    MODEL_OP(0x016a, 0x016e, RenderCalc, 0xc25d)
+    MODEL_OP(0x016e, 0x0172, RenderCalc, 0xc24d)
+    MODEL_OP(0x0172, 0x0176, RenderModel, 0x0bce)
+    MODEL_OP(0x0176, 0x017c, RenderTri, 0xf223)
+    MODEL_OP(0x017c, 0x017e, RenderBatch, 0x0006)
+    MODEL_OP(0x017e, 0x0182, RenderCalc, 0xc46d)
+    MODEL_OP(0x0182, 0x0186, RenderCalc, 0xc41d)
+    MODEL_OP(0x0186, 0x018a, RenderCalc, 0xc43d)
+    MODEL_OP(0x018a, 0x018e, RenderCalc, 0xc45d)
+    MODEL_OP(0x018e, 0x0192, RenderCalc, 0xc54d)
+    MODEL_OP(0x0192, 0x0196, RenderCalc, 0xc50d)
+    MODEL_OP(0x0196, 0x019a, RenderCalc, 0xc5ed)
+    MODEL_OP(0x019a, 0x019e, RenderCalc, 0xc50d)
+    MODEL_OP(0x019e, 0x01a2, RenderCalc, 0xc55d)
+    MODEL_OP(0x01a2, 0x01a6, RenderCalc, 0xc35d)
+    MODEL_OP(0x01a6, 0x01aa, RenderMatrixTransform, 0x083c)
+    MODEL_OP(0x01aa, 0x01ae, RenderCalc, 0xc37d)
+    MODEL_OP(0x01ae, 0x01b2, RenderMatrixTransform, 0x831c)
+    MODEL_OP(0x01b2, 0x01b6, RenderCalc, 0xc27d)
+    MODEL_OP(0x01b6, 0x01ba, RenderCalc, 0xc25d)
+    MODEL_OP(0x01ba, 0x01be, RenderCalc, 0xc2fd)
+    MODEL_OP(0x01be, 0x01c2, RenderCalc, 0xc20d)
+    MODEL_OP(0x01c2, 0x01c6, RenderCalc, 0xc17d)
+    MODEL_OP(0x01c6, 0x01ca, RenderCalc, 0xc15d)
+    MODEL_OP(0x01ca, 0x01ce, RenderCalc, 0xc45d)
+    MODEL_OP(0x01ce, 0x01d2, RenderCalc, 0xc56d)
+    MODEL_OP(0x01d2, 0x01d6, RenderModel, 0x04ce)
+    MODEL_OP(0x01d6, 0x01d8, RenderDepthTreePushPop, 0x8015)
+    MODEL_DONE(0x01d8)
+    MODEL_RESUME_BEGIN
+    MODEL_RESUME(0x0000)
+    MODEL_RESUME(0x0004)
+    MODEL_RESUME(0x0008)
+    MODEL_RESUME(0x000c)
+    MODEL_RESUME(0x000e)
+    MODEL_RESUME(0x0012)
+    MODEL_RESUME(0x0014)
+    MODEL_RESUME(0x0038)
+    MODEL_RESUME(0x003e)
+    MODEL_RESUME(0x0040)
+    MODEL_RESUME(0x0044)
+    MODEL_RESUME(0x004a)
+    MODEL_RESUME(0x004e)
+    MODEL_RESUME(0x0052)
+    MODEL_RESUME(0x0056)
+    MODEL_RESUME(0x0058)
+    MODEL_RESUME(0x005c)
+    MODEL_RESUME(0x0060)
+    MODEL_RESUME(0x0064)
+    MODEL_RESUME(0x0068)
+    MODEL_RESUME(0x006c)
+    MODEL_RESUME(0x0070)
+    MODEL_RESUME(0x0074)
+    MODEL_RESUME(0x007a)
+    MODEL_RESUME(0x007e)
+    MODEL_RESUME(0x0082)
+    MODEL_RESUME(0x0086)
+    MODEL_RESUME(0x008a)
+    MODEL_RESUME(0x008e)
+    MODEL_RESUME(0x0092)
+    MODEL_RESUME(0x0096)
+    MODEL_RESUME(0x009a)
+    MODEL_RESUME(0x009e)
+    MODEL_RESUME(0x00a2)
+    MODEL_RESUME(0x00a6)
+    MODEL_RESUME(0x00aa)
+    MODEL_RESUME(0x00ae)
+    MODEL_RESUME(0x00b2)
+    MODEL_RESUME(0x00b6)
+    MODEL_RESUME(0x00bc)
+    MODEL_RESUME(0x00c2)
+    MODEL_RESUME(0x00c8)
+    MODEL_RESUME(0x00ce)
+    MODEL_RESUME(0x00d2)
+    MODEL_RESUME(0x00d6)
+    MODEL_RESUME(0x00da)
+    MODEL_RESUME(0x00de)
+    MODEL_RESUME(0x00e2)
+    MODEL_RESUME(0x00e6)
+    MODEL_RESUME(0x00ea)
+    MODEL_RESUME(0x00ee)
+    MODEL_RESUME(0x00f2)
+    MODEL_RESUME(0x00f6)
+    MODEL_RESUME(0x00fa)
+    MODEL_RESUME(0x00fe)
+    MODEL_RESUME(0x0102)
+    MODEL_RESUME(0x0106)
+    MODEL_RESUME(0x010a)
+    MODEL_RESUME(0x010e)
+    MODEL_RESUME(0x0112)
+    MODEL_RESUME(0x0116)
+    MODEL_RESUME(0x011a)
+    MODEL_RESUME(0x011e)
+    MODEL_RESUME(0x0122)
+    MODEL_RESUME(0x0126)
+    MODEL_RESUME(0x012a)
+    MODEL_RESUME(0x012e)
+    MODEL_RESUME(0x0132)
+    MODEL_RESUME(0x0136)
+    MODEL_RESUME(0x013a)
+    MODEL_RESUME(0x013c)
+    MODEL_RESUME(0x0140)
+    MODEL_RESUME(0x0144)
+    MODEL_RESUME(0x0148)
+    MODEL_RESUME(0x014c)
+    MODEL_RESUME(0x0152)
+    MODEL_RESUME(0x0154)
+    MODEL_RESUME(0x0158)
+    MODEL_RESUME(0x015c)
+    MODEL_RESUME(0x0160)
+    MODEL_RESUME(0x0164)
+    MODEL_RESUME(0x0166)
+    MODEL_RESUME(0x016a)
+    MODEL_RESUME(0x016e)
+    MODEL_RESUME(0x0172)
+    MODEL_RESUME(0x0176)
+    MODEL_RESUME(0x017c)
+    MODEL_RESUME(0x017e)
+    MODEL_RESUME(0x0182)
+    MODEL_RESUME(0x0186)
+    MODEL_RESUME(0x018a)
+    MODEL_RESUME(0x018e)
+    MODEL_RESUME(0x0192)
+    MODEL_RESUME(0x0196)
+    MODEL_RESUME(0x019a)
+    MODEL_RESUME(0x019e)
+    MODEL_RESUME(0x01a2)
+    MODEL_RESUME(0x01a6)
+    MODEL_RESUME(0x01aa)
+    MODEL_RESUME(0x01ae)
+    MODEL_RESUME(0x01b2)
+    MODEL_RESUME(0x01b6)
+    MODEL_RESUME(0x01ba)
+    MODEL_RESUME(0x01be)
+    MODEL_RESUME(0x01c2)
+    MODEL_RESUME(0x01c6)
+    MODEL_RESUME(0x01ca)
+    MODEL_RESUME(0x01ce)
+    MODEL_RESUME(0x01d2)
+    MODEL_RESUME(0x01d6)
+    MODEL_RESUME(0x01d8)
+    MODEL_RESUME_END
+}
+
+static const u8 sCompiledModelCode43[] = {
+    0x06, 0x00, 0x0d, 0xc5, 0xc2, 0x00, 0xfd, 0xc3, 0xc5, 0x7f, 0x93, 0x01, 0xc3, 0x00, 0x0d, 0xc1,
+    0xc3, 0x00, 0xbd, 0xc1, 0xc1, 0x45, 0xd3, 0x00, 0xc1, 0x00, 0xe9, 0x1e, 0x2a, 0x30, 0x20, 0x03,
+    0xe9, 0x1e, 0x2b, 0x31, 0x20, 0x03, 0x4b, 0x02, 0xa9, 0x03, 0x95, 0x06, 0xcb, 0x00, 0x04, 0x80,
+    0x93, 0x00, 0xc5, 0x01, 0x0d, 0xc1, 0x02, 0x00, 0xee, 0x0b, 0x3e, 0x00, 0xcb, 0x00, 0x05, 0x80,
+    0x93, 0x00, 0xc5, 0x02, 0x0d, 0xc1, 0x02, 0x00, 0xee, 0x0b, 0x3f, 0x00, 0x15, 0x80, 0xe6, 0xff,
+    0x05, 0x06, 0x02, 0x0c, 0x00, 0x02, 0x0a, 0x00, 0x06, 0x08, 0x0e, 0x06, 0x02, 0x06, 0x00, 0x00,
+    0x05, 0x06, 0x03, 0x0c, 0x00, 0x02, 0x0b, 0x00, 0x07, 0x09, 0x0f, 0x06, 0x02, 0x06, 0x00, 0x00,
+    0x45, 0x04, 0x04, 0x0c, 0x00, 0x02, 0x0a, 0x00, 0x06, 0x08, 0x18, 0x06, 0x04, 0x06, 0x00, 0x00,
+    0x45, 0x04, 0x05, 0x0c, 0x00, 0x02, 0x0b, 0x00, 0x07, 0x09, 0x19, 0x06, 0x04, 0x06, 0x00, 0x00,
+    0x8b, 0x00, 0x0f, 0x02, 0x08, 0x00, 0x20, 0x1e, 0x22, 0x1c, 0x02, 0x00, 0x8b, 0x00, 0x02, 0x80,
+    0x4b, 0x00, 0x98, 0x00, 0x8e, 0x05, 0x1a, 0x03, 0x86, 0xe6, 0xfe, 0xff, 0x68, 0x66, 0x0e, 0x04,
+    0x18, 0x02, 0x06, 0x00, 0x0b, 0x00, 0xb7, 0x01, 0xe7, 0x1e, 0x28, 0x26, 0x06, 0x24, 0x87, 0x88,
+    0x18, 0x0e, 0x16, 0x06, 0x86, 0xe1, 0x0b, 0x00, 0x82, 0x88, 0x06, 0x0c, 0xa6, 0xe1, 0x0b, 0x00,
+    0x82, 0x88, 0x07, 0x0d, 0x06, 0x00, 0x00, 0x00,
+};
+
+MINTERNAL void CompiledModel43(RenderContext* renderContext, RenderFrame* rf, u8* code) {
+    MODEL_OP(0x0000, 0x0002, RenderBatch, 0x0006)
+    MODEL_OP(0x0002, 0x0006, RenderCalc, 0xc50d)
+    MODEL_OP(0x0006, 0x000a, RenderCalc, 0xc3fd)
+    MODEL_OP(0x000a, 0x000e, RenderIfVar, 0x0193)
+    MODEL_OP(0x000e, 0x0012, RenderCalc, 0xc10d)
+    MODEL_OP(0x0012, 0x0016, RenderCalc, 0xc1bd)
+    MODEL_OP(0x0016, 0x001a, RenderIfVar, 0x00d3)
+    MODEL_OP(0x001a, 0x0020, RenderTeardrop, 0x1ee9)
+    MODEL_OP(0x0020, 0x0026, RenderTeardrop, 0x1ee9)
+    MODEL_OP(0x0026, 0x002a, RenderIf, 0x024b)
+    MODEL_OP(0x002a, 0x002c, RenderDepthTreePushPop, 0x0695)
+    MODEL_OP(0x002c, 0x0030, RenderIf, 0x00cb)
+    MODEL_OP(0x0030, 0x0034, RenderIfVar, 0x0093)
+    MODEL_OP(0x0034, 0x0038, RenderCalc, 0xc10d)
+    MODEL_OP(0x0038, 0x003c, RenderModel, 0x0bee)
+    MODEL_OP(0x003c, 0x0040, RenderIf, 0x00cb)
+    MODEL_OP(0x0040, 0x0044, RenderIfVar, 0x0093)
+    MODEL_OP(0x0044, 0x0048, RenderCalc, 0xc10d)
+    MODEL_OP(0x0048, 0x004c, RenderModel, 0x0bee)
+    MODEL_OP(0x004c, 0x004e, RenderDepthTreePushPop, 0x8015)
+    MODEL_OP(0x004e, 0x0050, RenderBatch, 0xffe6)
+    MODEL_OP(0x0050, 0x0060, RenderComplex, 0x0605)
+    MODEL_OP(0x0060, 0x0070, RenderComplex, 0x0605)
+    MODEL_OP(0x0070, 0x0080, RenderComplex, 0x0445)
+    MODEL_OP(0x0080, 0x0090, RenderComplex, 0x0445)
+    MODEL_OP(0x0090, 0x0094, RenderIf, 0x008b)
+    MODEL_OP(0x0094, 0x009c, Render2QuadMirrored, 0x0008)
+    MODEL_OP(0x009c, 0x00a0, RenderIf, 0x008b)
+    MODEL_OP(0x00a0, 0x00a4, RenderIf, 0x004b)
+    MODEL_OP(0x00a4, 0x00a8, RenderModel, 0x058e)
+    MODEL_OP(0x00a8, 0x00ac, RenderBatch, 0xe686)
+    MODEL_OP(0x00ac, 0x00b4, Render2QuadMirrored, 0x6668)
+    MODEL_OP(0x00b4, 0x00b8, RenderIf, 0x000b)
+    MODEL_OP(0x00b8, 0x00be, Render2TriMirrored, 0x1ee7)
+    MODEL_OP(0x00be, 0x00c4, Render2TriMirrored, 0x8887)
+    MODEL_OP(0x00c4, 0x00c8, RenderBatch, 0xe186)
+    MODEL_OP(0x00c8, 0x00cc, RenderLine, 0x8882)
+    MODEL_OP(0x00cc, 0x00d0, RenderBatch, 0xe1a6)
+    MODEL_OP(0x00d0, 0x00d4, RenderLine, 0x8882)
+    MODEL_OP(0x00d4, 0x00d6, RenderBatch, 0x0006)
+    MODEL_DONE(0x00d6)
+    MODEL_RESUME_BEGIN
+    MODEL_RESUME(0x0000)
+    MODEL_RESUME(0x0002)
+    MODEL_RESUME(0x0006)
+    MODEL_RESUME(0x000a)
+    MODEL_RESUME(0x000e)
+    MODEL_RESUME(0x0012)
+    MODEL_RESUME(0x0016)
+    MODEL_RESUME(0x001a)
+    MODEL_RESUME(0x0020)
+    MODEL_RESUME(0x0026)
+    MODEL_RESUME(0x002a)
+    MODEL_RESUME(0x002c)
+    MODEL_RESUME(0x0030)
+    MODEL_RESUME(0x0034)
+    MODEL_RESUME(0x0038)
+    MODEL_RESUME(0x003c)
+    MODEL_RESUME(0x0040)
+    MODEL_RESUME(0x0044)
+    MODEL_RESUME(0x0048)
+    MODEL_RESUME(0x004c)
+    MODEL_RESUME(0x004e)
+    MODEL_RESUME(0x0050)
+    MODEL_RESUME(0x0060)
+    MODEL_RESUME(0x0070)
+    MODEL_RESUME(0x0080)
+    MODEL_RESUME(0x0090)
+    MODEL_RESUME(0x0094)
+    MODEL_RESUME(0x009c)
+    MODEL_RESUME(0x00a0)
+    MODEL_RESUME(0x00a4)
+    MODEL_RESUME(0x00a8)
+    MODEL_RESUME(0x00ac)
+    MODEL_RESUME(0x00b4)
+    MODEL_RESUME(0x00b8)
+    MODEL_RESUME(0x00be)
+    MODEL_RESUME(0x00c4)
+    MODEL_RESUME(0x00c8)
+    MODEL_RESUME(0x00cc)
+    MODEL_RESUME(0x00d0)
+    MODEL_RESUME(0x00d4)
+    MODEL_RESUME(0x00d6)
+    MODEL_RESUME_END
+}
+
+static const u8 sCompiledModelCode53[] = {
+    0x0d, 0xc6, 0xc2, 0x00, 0x5d, 0xc5, 0xc6, 0x01, 0xdd, 0xc5, 0x41, 0xc5, 0x0d, 0xc5, 0xc5, 0x42,
+    0x1d, 0xc5, 0x7c, 0xc5, 0x5c, 0x00, 0xc5, 0x00, 0x0d, 0xc2, 0x7f, 0x03, 0x0d, 0xc1, 0x7f, 0x00,
+    0xdd, 0xc3, 0x41, 0xc6, 0x0d, 0xc3, 0xc3, 0x50, 0x5d, 0xc3, 0xc3, 0x01, 0x2d, 0xc5, 0xc6, 0x03,
+    0xed, 0xc5, 0x41, 0xc5, 0x0d, 0xc5, 0xc5, 0x41, 0x6e, 0x05, 0x2c, 0x06, 0x2d, 0xc5, 0xc6, 0x01,
+    0xdd, 0xc5, 0x41, 0xc5, 0x0d, 0xc5, 0xc5, 0x44, 0x0d, 0xc5, 0x7c, 0xc5, 0x5c, 0x00, 0xc5, 0x00,
+    0x0d, 0xc2, 0x7f, 0x03, 0x0d, 0xc1, 0x7f, 0x00, 0x0d, 0xc4, 0xc6, 0x00, 0x2d, 0xc3, 0xc6, 0x03,
+    0xed, 0xc3, 0x41, 0xc3, 0x0d, 0xc3, 0xc3, 0x41, 0x6e, 0x05, 0x26, 0x06, 0x00, 0x00,
+};
+
+MINTERNAL void CompiledModel53(RenderContext* renderContext, RenderFrame* rf, u8* code) {
+    MODEL_OP(0x0000, 0x0004, RenderCalc, 0xc60d)
+    MODEL_OP(0x0004, 0x0008, RenderCalc, 0xc55d)
+    MODEL_OP(0x0008, 0x000c, RenderCalc, 0xc5dd)
+    MODEL_OP(0x000c, 0x0010, RenderCalc, 0xc50d)
+    MODEL_OP(0x0010, 0x0014, RenderCalc, 0xc51d)
+    MODEL_OP(0x0014, 0x0018, RenderMatrixTransform, 0x005c)
+    MODEL_OP(0x0018, 0x001c, RenderCalc, 0xc20d)
+    MODEL_OP(0x001c, 0x0020, RenderCalc, 0xc10d)
+    MODEL_OP(0x0020, 0x0024, RenderCalc, 0xc3dd)
+    MODEL_OP(0x0024, 0x0028, RenderCalc, 0xc30d)
+    MODEL_OP(0x0028, 0x002c, RenderCalc, 0xc35d)
+    MODEL_OP(0x002c, 0x0030, RenderCalc, 0xc52d)
+    MODEL_OP(0x0030, 0x0034, RenderCalc, 0xc5ed)
+    MODEL_OP(0x0034, 0x0038, RenderCalc, 0xc50d)
+    MODEL_OP(0x0038, 0x003c, RenderModel, 0x056e)
+    MODEL_OP(0x003c, 0x0040, RenderCalc, 0xc52d)
+    MODEL_OP(0x0040, 0x0044, RenderCalc, 0xc5dd)
+    MODEL_OP(0x0044, 0x0048, RenderCalc, 0xc50d)
+    MODEL_OP(0x0048, 0x004c, RenderCalc, 0xc50d)
+    MODEL_OP(0x004c, 0x0050, RenderMatrixTransform, 0x005c)
+    MODEL_OP(0x0050, 0x0054, RenderCalc, 0xc20d)
+    MODEL_OP(0x0054, 0x0058, RenderCalc, 0xc10d)
+    MODEL_OP(0x0058, 0x005c, RenderCalc, 0xc40d)
+    MODEL_OP(0x005c, 0x0060, RenderCalc, 0xc32d)
+    MODEL_OP(0x0060, 0x0064, RenderCalc, 0xc3ed)
+    MODEL_OP(0x0064, 0x0068, RenderCalc, 0xc30d)
+    MODEL_OP(0x0068, 0x006c, RenderModel, 0x056e)
+    MODEL_DONE(0x006c)
+    MODEL_RESUME_BEGIN
+    MODEL_RESUME(0x0000)
+    MODEL_RESUME(0x0004)
+    MODEL_RESUME(0x0008)
+    MODEL_RESUME(0x000c)
+    MODEL_RESUME(0x0010)
+    MODEL_RESUME(0x0014)
+    MODEL_RESUME(0x0018)
+    MODEL_RESUME(0x001c)
+    MODEL_RESUME(0x0020)
+    MODEL_RESUME(0x0024)
+    MODEL_RESUME(0x0028)
+    MODEL_RESUME(0x002c)
+    MODEL_RESUME(0x0030)
+    MODEL_RESUME(0x0034)
+    MODEL_RESUME(0x0038)
+    MODEL_RESUME(0x003c)
+    MODEL_RESUME(0x0040)
+    MODEL_RESUME(0x0044)
+    MODEL_RESUME(0x0048)
+    MODEL_RESUME(0x004c)
+    MODEL_RESUME(0x0050)
+    MODEL_RESUME(0x0054)
+    MODEL_RESUME(0x0058)
+    MODEL_RESUME(0x005c)
+    MODEL_RESUME(0x0060)
+    MODEL_RESUME(0x0064)
+    MODEL_RESUME(0x0068)
+    MODEL_RESUME(0x006c)
+    MODEL_RESUME_END
+}
+
+static const u8 sCompiledModelCode66[] = {
+    0x0d, 0xc6, 0xc2, 0x00, 0xbd, 0xc7, 0xc6, 0x6e, 0x94, 0x04, 0xc7, 0x00, 0x5d, 0xc5, 0xc6, 0x01,
+    0xdd, 0xc5, 0x48, 0xc5, 0x1d, 0xc5, 0x40, 0xc5, 0xbc, 0x05, 0x26, 0xde, 0x1c, 0x83, 0x39, 0x72,
+    0x5c, 0x83, 0xc5, 0x00, 0x5d, 0xc4, 0xc6, 0x03, 0xed, 0xc3, 0x42, 0xc4, 0xdd, 0xc4, 0x42, 0xc4,
+    0x3c, 0x83, 0xc3, 0x00, 0x1c, 0x83, 0xc4, 0x00, 0x0d, 0xc3, 0xc3, 0x44, 0x0d, 0xc4, 0xc4, 0x44,
+    0x0d, 0xc5, 0xc6, 0x00, 0x0d, 0xc2, 0x7f, 0x03, 0x0d, 0xc1, 0x7f, 0x00, 0x6e, 0x05, 0x12, 0x06,
+    0x93, 0x02, 0xc7, 0x00, 0x1d, 0xc4, 0xc6, 0x6e, 0x4d, 0xc4, 0xc4, 0x03, 0x2d, 0xc4, 0xc4, 0x18,
+    0x0d, 0xc2, 0xc4, 0x44, 0x1d, 0xc4, 0xc6, 0x6e, 0x5d, 0xc5, 0xc4, 0x01, 0x1d, 0xc1, 0x40, 0x01,
+    0x9c, 0x0c, 0x20, 0x00, 0xee, 0x06, 0x20, 0x06, 0x0d, 0xc4, 0x01, 0x00, 0x2d, 0xc5, 0xc6, 0x03,
+    0xdd, 0xc5, 0x44, 0xc5, 0x0d, 0xc5, 0xc5, 0x44, 0x0d, 0xc5, 0x8c, 0xc5, 0x5c, 0x00, 0xc5, 0x00,
+    0x0d, 0xc4, 0xc6, 0x00, 0x2d, 0xc3, 0xc6, 0x45, 0xed, 0xc3, 0x41, 0xc3, 0x0d, 0xc3, 0xc3, 0x41,
+    0x0d, 0xc2, 0x67, 0x01, 0x1d, 0xc1, 0x40, 0xc6, 0x4d, 0xc1, 0xc1, 0x02, 0x5d, 0xc5, 0xc6, 0x02,
+    0xdd, 0xc5, 0xc1, 0xc5, 0x0d, 0xc5, 0xc5, 0x50, 0x5d, 0xc5, 0xc5, 0x01, 0x0d, 0xc1, 0x7f, 0x00,
+    0xce, 0x04, 0x2c, 0x06, 0xcd, 0xc1, 0xc6, 0x6f, 0xbd, 0xc1, 0xc1, 0x4d, 0x13, 0x02, 0xc1, 0x00,
+    0x46, 0x40, 0x4d, 0xc1, 0xc6, 0x07, 0xfd, 0xc1, 0xc1, 0x02, 0x13, 0x01, 0xc1, 0x00, 0x94, 0x00,
+    0xc7, 0x00, 0x42, 0xf4, 0x30, 0x2c, 0x53, 0x00, 0xc7, 0x00, 0x42, 0xf4, 0x20, 0x2c, 0x06, 0x00,
+    0x00, 0x00,
+};
+
+MINTERNAL void CompiledModel66(RenderContext* renderContext, RenderFrame* rf, u8* code) {
+    MODEL_OP(0x0000, 0x0004, RenderCalc, 0xc60d)
+    MODEL_OP(0x0004, 0x0008, RenderCalc, 0xc7bd)
+    MODEL_OP(0x0008, 0x000c, RenderIfNotVar, 0x0494)
+    MODEL_OP(0x000c, 0x0010, RenderCalc, 0xc55d)
+    MODEL_OP(0x0010, 0x0014, RenderCalc, 0xc5dd)
+    MODEL_OP(0x0014, 0x0018, RenderCalc, 0xc51d)
+    MODEL_OP(0x0018, 0x001c, RenderMatrixTransform, 0x05bc)
+    MODEL_OP(0x001c, 0x0020, RenderMatrixTransform, 0x831c)
+    MODEL_OP(0x0020, 0x0024, RenderMatrixTransform, 0x835c)
+    MODEL_OP(0x0024, 0x0028, RenderCalc, 0xc45d)
+    MODEL_OP(0x0028, 0x002c, RenderCalc, 0xc3ed)
+    MODEL_OP(0x002c, 0x0030, RenderCalc, 0xc4dd)
+    MODEL_OP(0x0030, 0x0034, RenderMatrixTransform, 0x833c)
+    MODEL_OP(0x0034, 0x0038, RenderMatrixTransform, 0x831c)
+    MODEL_OP(0x0038, 0x003c, RenderCalc, 0xc30d)
+    MODEL_OP(0x003c, 0x0040, RenderCalc, 0xc40d)
+    MODEL_OP(0x0040, 0x0044, RenderCalc, 0xc50d)
+    MODEL_OP(0x0044, 0x0048, RenderCalc, 0xc20d)
+    MODEL_OP(0x0048, 0x004c, RenderCalc, 0xc10d)
+    MODEL_OP(0x004c, 0x0050, RenderModel, 0x056e)
+    MODEL_OP(0x0050, 0x0054, RenderIfVar, 0x0293)
+    MODEL_OP(0x0054, 0x0058, RenderCalc, 0xc41d)
+    MODEL_OP(0x0058, 0x005c, RenderCalc, 0xc44d)
+    MODEL_OP(0x005c, 0x0060, RenderCalc, 0xc42d)
+    MODEL_OP(0x0060, 0x0064, RenderCalc, 0xc20d)
+    MODEL_OP(0x0064, 0x0068, RenderCalc, 0xc41d)
+    MODEL_OP(0x0068, 0x006c, RenderCalc, 0xc55d)
+    MODEL_OP(0x006c, 0x0070, RenderCalc, 0xc11d)
+    MODEL_OP(0x0070, 0x0074, RenderMatrixTransform, 0x0c9c)
+    MODEL_OP(0x0074, 0x0078, RenderModel, 0x06ee)
+    MODEL_OP(0x0078, 0x007c, RenderCalc, 0xc40d)
+    MODEL_OP(0x007c, 0x0080, RenderCalc, 0xc52d)
+    MODEL_OP(0x0080, 0x0084, RenderCalc, 0xc5dd)
+    MODEL_OP(0x0084, 0x0088, RenderCalc, 0xc50d)
+    MODEL_OP(0x0088, 0x008c, RenderCalc, 0xc50d)
+    MODEL_OP(0x008c, 0x0090, RenderMatrixTransform, 0x005c)
+    MODEL_OP(0x0090, 0x0094, RenderCalc, 0xc40d)
+    MODEL_OP(0x0094, 0x0098, RenderCalc, 0xc32d)
+    MODEL_OP(0x0098, 0x009c, RenderCalc, 0xc3ed)
+    MODEL_OP(0x009c, 0x00a0, RenderCalc, 0xc30d)
+    MODEL_OP(0x00a0, 0x00a4, RenderCalc, 0xc20d)
+    MODEL_OP(0x00a4, 0x00a8, RenderCalc, 0xc11d)
+    MODEL_OP(0x00a8, 0x00ac, RenderCalc, 0xc14d)
+    MODEL_OP(0x00ac, 0x00b0, RenderCalc, 0xc55d)
+    MODEL_OP(0x00b0, 0x00b4, RenderCalc, 0xc5dd)
+    MODEL_OP(0x00b4, 0x00b8, RenderCalc, 0xc50d)
+    MODEL_OP(0x00b8, 0x00bc, RenderCalc, 0xc55d)
+    MODEL_OP(0x00bc, 0x00c0, RenderCalc, 0xc10d)
+    MODEL_OP(0x00c0, 0x00c4, RenderModel, 0x04ce)
+    MODEL_OP(0x00c4, 0x00c8, RenderCalc, 0xc1cd)
+    MODEL_OP(0x00c8, 0x00cc, RenderCalc, 0xc1bd)
+    MODEL_OP(0x00cc, 0x00d0, RenderIfVar, 0x0213)
+    MODEL_OP(0x00d0, 0x00d2, RenderBatch, 0x4046)
+    MODEL_OP(0x00d2, 0x00d6, RenderCalc, 0xc14d)
+    MODEL_OP(0x00d6, 0x00da, RenderCalc, 0xc1fd)
+    MODEL_OP(0x00da, 0x00de, RenderIfVar, 0x0113)
+    MODEL_OP(0x00de, 0x00e2, RenderIfNotVar, 0x0094)
+    MODEL_OP(0x00e2, 0x00e6, RenderLine, 0xf442)
+    MODEL_OP(0x00e6, 0x00ea, RenderIfVar, 0x0053)
+    MODEL_OP(0x00ea, 0x00ee, RenderLine, 0xf442)
+    MODEL_OP(0x00ee, 0x00f0, RenderBatch, 0x0006)
+    MODEL_DONE(0x00f0)
+    MODEL_RESUME_BEGIN
+    MODEL_RESUME(0x0000)
+    MODEL_RESUME(0x0004)
+    MODEL_RESUME(0x0008)
+    MODEL_RESUME(0x000c)
+    MODEL_RESUME(0x0010)
+    MODEL_RESUME(0x0014)
+    MODEL_RESUME(0x0018)
+    MODEL_RESUME(0x001c)
+    MODEL_RESUME(0x0020)
+    MODEL_RESUME(0x0024)
+    MODEL_RESUME(0x0028)
+    MODEL_RESUME(0x002c)
+    MODEL_RESUME(0x0030)
+    MODEL_RESUME(0x0034)
+    MODEL_RESUME(0x0038)
+    MODEL_RESUME(0x003c)
+    MODEL_RESUME(0x0040)
+    MODEL_RESUME(0x0044)
+    MODEL_RESUME(0x0048)
+    MODEL_RESUME(0x004c)
+    MODEL_RESUME(0x0050)
+    MODEL_RESUME(0x0054)
+    MODEL_RESUME(0x0058)
+    MODEL_RESUME(0x005c)
+    MODEL_RESUME(0x0060)
+    MODEL_RESUME(0x0064)
+    MODEL_RESUME(0x0068)
+    MODEL_RESUME(0x006c)
+    MODEL_RESUME(0x0070)
+    MODEL_RESUME(0x0074)
+    MODEL_RESUME(0x0078)
+    MODEL_RESUME(0x007c)
+    MODEL_RESUME(0x0080)
+    MODEL_RESUME(0x0084)
+    MODEL_RESUME(0x0088)
+    MODEL_RESUME(0x008c)
+    MODEL_RESUME(0x0090)
+    MODEL_RESUME(0x0094)
+    MODEL_RESUME(0x0098)
+    MODEL_RESUME(0x009c)
+    MODEL_RESUME(0x00a0)
+    MODEL_RESUME(0x00a4)
+    MODEL_RESUME(0x00a8)
+    MODEL_RESUME(0x00ac)
+    MODEL_RESUME(0x00b0)
+    MODEL_RESUME(0x00b4)
+    MODEL_RESUME(0x00b8)
+    MODEL_RESUME(0x00bc)
+    MODEL_RESUME(0x00c0)
+    MODEL_RESUME(0x00c4)
+    MODEL_RESUME(0x00c8)
+    MODEL_RESUME(0x00cc)
+    MODEL_RESUME(0x00d0)
+    MODEL_RESUME(0x00d2)
+    MODEL_RESUME(0x00d6)
+    MODEL_RESUME(0x00da)
+    MODEL_RESUME(0x00de)
+    MODEL_RESUME(0x00e2)
+    MODEL_RESUME(0x00e6)
+    MODEL_RESUME(0x00ea)
+    MODEL_RESUME(0x00ee)
+    MODEL_RESUME(0x00f0)
+    MODEL_RESUME_END
+}
+
+static const u8 sCompiledModelCode68[] = {
+    0xe6, 0xff, 0xac, 0x01, 0xfa, 0x02, 0x03, 0x04, 0x24, 0x03, 0x02, 0x02, 0x03, 0x04, 0x24, 0x04,
+    0x04, 0x02, 0x03, 0x04, 0x24, 0x05, 0x06, 0x04, 0x03, 0x04, 0x24, 0x05, 0x08, 0x03, 0x00, 0x00,
+    0x2c, 0x05, 0x31, 0x01, 0x05, 0x04, 0x02, 0x0a, 0x01, 0x04, 0x03, 0x00, 0x02, 0x06, 0x00, 0x06,
+    0x00, 0x00, 0x05, 0x04, 0x04, 0x0a, 0x00, 0x04, 0x02, 0x00, 0x04, 0x06, 0x22, 0x06, 0x00, 0x00,
+    0x05, 0x04, 0x06, 0x0a, 0x22, 0x04, 0x04, 0x00, 0x05, 0x06, 0x23, 0x06, 0x00, 0x00, 0x05, 0x04,
+    0x08, 0x0a, 0x23, 0x04, 0x05, 0x00, 0x03, 0x06, 0x01, 0x06, 0x00, 0x00, 0x83, 0x88, 0x24, 0x01,
+    0x02, 0x00, 0x83, 0x88, 0x24, 0x22, 0x04, 0x00, 0x83, 0x88, 0x24, 0x23, 0x06, 0x22, 0x83, 0x88,
+    0x24, 0x01, 0x08, 0x23, 0x00, 0x00, 0x05, 0x04, 0x02, 0x14, 0x00, 0x02, 0x12, 0x01, 0x03, 0x14,
+    0x10, 0x08, 0x02, 0x0e, 0x18, 0x08, 0x00, 0x16, 0x2c, 0x08, 0x01, 0x2d, 0x00, 0x00, 0x05, 0x04,
+    0x04, 0x14, 0x00, 0x02, 0x16, 0x00, 0x02, 0x18, 0x0c, 0x08, 0x04, 0x06, 0x1c, 0x08, 0x22, 0x1a,
+    0x2e, 0x08, 0x00, 0x2c, 0x00, 0x00, 0x05, 0x04, 0x06, 0x14, 0x00, 0x02, 0x1a, 0x22, 0x04, 0x1c,
+    0x08, 0x08, 0x05, 0x09, 0x20, 0x08, 0x23, 0x1e, 0x2f, 0x08, 0x22, 0x2e, 0x00, 0x00, 0x05, 0x04,
+    0x08, 0x14, 0x00, 0x02, 0x1e, 0x23, 0x05, 0x20, 0x0a, 0x08, 0x03, 0x07, 0x14, 0x08, 0x01, 0x12,
+    0x2d, 0x08, 0x23, 0x2f, 0x00, 0x00, 0x85, 0x88, 0x02, 0x10, 0x00, 0x02, 0x26, 0x01, 0x24, 0x29,
+    0x28, 0x08, 0x00, 0x26, 0x2c, 0x08, 0x01, 0x2d, 0x00, 0x00, 0x85, 0x88, 0x04, 0x10, 0x00, 0x02,
+    0x26, 0x00, 0x24, 0x28, 0x2a, 0x08, 0x22, 0x26, 0x2e, 0x08, 0x00, 0x2c, 0x00, 0x00, 0x85, 0x88,
+    0x06, 0x10, 0x00, 0x02, 0x26, 0x22, 0x24, 0x2a, 0x2b, 0x08, 0x23, 0x26, 0x2f, 0x08, 0x22, 0x2e,
+    0x00, 0x00, 0x85, 0x88, 0x08, 0x10, 0x00, 0x02, 0x26, 0x23, 0x24, 0x2b, 0x29, 0x08, 0x01, 0x26,
+    0x2d, 0x08, 0x23, 0x2f, 0x00, 0x00, 0x00, 0x00,
+};
+
+MINTERNAL void CompiledModel68(RenderContext* renderContext, RenderFrame* rf, u8* code) {
+    MODEL_OP(0x0000, 0x0002, RenderBatch, 0xffe6)
+    MODEL_OP(0x0002, 0x0006, RenderIfNot, 0x01ac)
+    MODEL_OP(0x0006, 0x000c, RenderTri, 0x0403)
+    MODEL_OP(0x000c, 0x0012, RenderTri, 0x0403)
+    MODEL_OP(0x0012, 0x0018, RenderTri, 0x0403)
+    MODEL_OP(0x0018, 0x001e, RenderTri, 0x0403)
+    MODEL_DONE(0x001e)
+    MODEL_OP(0x0020, 0x0024, RenderIfNot, 0x052c)
+    MODEL_OP(0x0024, 0x0032, RenderComplex, 0x0405)
+    MODEL_OP(0x0032, 0x0040, RenderComplex, 0x0405)
+    MODEL_OP(0x0040, 0x004e, RenderComplex, 0x0405)
+    MODEL_OP(0x004e, 0x005c, RenderComplex, 0x0405)
+    MODEL_OP(0x005c, 0x0062, RenderTri, 0x8883)
+    MODEL_OP(0x0062, 0x0068, RenderTri, 0x8883)
+    MODEL_OP(0x0068, 0x006e, RenderTri, 0x8883)
+    MODEL_OP(0x006e, 0x0074, RenderTri, 0x8883)
+    MODEL_DONE(0x0074)
+    MODEL_OP(0x0076, 0x008e, RenderComplex, 0x0405)
+    MODEL_OP(0x008e, 0x00a6, RenderComplex, 0x0405)
+    MODEL_OP(0x00a6, 0x00be, RenderComplex, 0x0405)
+    MODEL_OP(0x00be, 0x00d6, RenderComplex, 0x0405)
+    MODEL_OP(0x00d6, 0x00ea, RenderComplex, 0x8885)
+    MODEL_OP(0x00ea, 0x00fe, RenderComplex, 0x8885)
+    MODEL_OP(0x00fe, 0x0112, RenderComplex, 0x8885)
+    MODEL_OP(0x0112, 0x0126, RenderComplex, 0x8885)
+    MODEL_DONE(0x0126)
+    MODEL_RESUME_BEGIN
+    MODEL_RESUME(0x0000)
+    MODEL_RESUME(0x0002)
+    MODEL_RESUME(0x0006)
+    MODEL_RESUME(0x000c)
+    MODEL_RESUME(0x0012)
+    MODEL_RESUME(0x0018)
+    MODEL_RESUME(0x001e)
+    MODEL_RESUME(0x0020)
+    MODEL_RESUME(0x0024)
+    MODEL_RESUME(0x0032)
+    MODEL_RESUME(0x0040)
+    MODEL_RESUME(0x004e)
+    MODEL_RESUME(0x005c)
+    MODEL_RESUME(0x0062)
+    MODEL_RESUME(0x0068)
+    MODEL_RESUME(0x006e)
+    MODEL_RESUME(0x0074)
+    MODEL_RESUME(0x0076)
+    MODEL_RESUME(0x008e)
+    MODEL_RESUME(0x00a6)
+    MODEL_RESUME(0x00be)
+    MODEL_RESUME(0x00d6)
+    MODEL_RESUME(0x00ea)
+    MODEL_RESUME(0x00fe)
+    MODEL_RESUME(0x0112)
+    MODEL_RESUME(0x0126)
+    MODEL_RESUME_END
+}
+
+static const u8 sCompiledModelCode78[] = {
+    0x06, 0xe3, 0x5e, 0x5f, 0x05, 0x16, 0x00, 0x0e, 0x70, 0x04, 0x54, 0x00, 0x58, 0x06, 0x5c, 0x06,
+    0x60, 0x06, 0x6c, 0x06, 0x00, 0x00, 0x0b, 0x00, 0xdc, 0x02, 0x04, 0x16, 0x51, 0x59, 0x69, 0x55,
+    0x00, 0x00, 0x03, 0x16, 0x52, 0x6a, 0x00, 0x56, 0x0b, 0x00, 0x62, 0x02, 0x53, 0x00, 0xc1, 0x0d,
+    0x2e, 0x0a, 0x61, 0x40, 0xac, 0x00, 0xab, 0x01, 0x42, 0x54, 0x00, 0x03, 0x42, 0x54, 0x04, 0x05,
+    0x00, 0x00, 0x44, 0x54, 0x03, 0x01, 0x02, 0x00, 0x00, 0x00, 0x44, 0x54, 0x07, 0x05, 0x06, 0x04,
+    0x00, 0x00, 0x4c, 0x02, 0xb7, 0x00, 0x42, 0x54, 0x40, 0x6c, 0x42, 0x54, 0x6c, 0x70, 0x42, 0x54,
+    0x44, 0x6f, 0x42, 0x54, 0x73, 0x4a, 0x42, 0x54, 0x4a, 0x6e, 0x42, 0x54, 0x6e, 0x72, 0x42, 0x54,
+    0x6e, 0x41, 0x42, 0x54, 0x45, 0x51, 0x42, 0x54, 0x48, 0x65, 0x8b, 0x04, 0xb7, 0x00, 0x44, 0x54,
+    0x6c, 0x42, 0x64, 0x40, 0x00, 0x00, 0x44, 0x54, 0x50, 0x6c, 0x70, 0x64, 0x00, 0x00, 0x44, 0x54,
+    0x6f, 0x46, 0x67, 0x44, 0x00, 0x00, 0x44, 0x54, 0x4e, 0x73, 0x4a, 0x53, 0x00, 0x00, 0x44, 0x54,
+    0x66, 0x4e, 0x6e, 0x4a, 0x00, 0x00, 0x44, 0x54, 0x52, 0x6e, 0x72, 0x66, 0x00, 0x00, 0x44, 0x54,
+    0x43, 0x6e, 0x41, 0x66, 0x00, 0x00, 0x44, 0x54, 0x51, 0x47, 0x71, 0x45, 0x00, 0x00, 0x44, 0x54,
+    0x65, 0x4c, 0x6d, 0x48, 0x00, 0x00, 0xee, 0x09, 0x3a, 0x00, 0x0e, 0x0a, 0x3b, 0x00, 0xee, 0x09,
+    0x3e, 0x00, 0x0e, 0x0a, 0x3f, 0x00, 0x0b, 0x00, 0x8c, 0x00, 0xee, 0x09, 0x08, 0x00, 0xee, 0x09,
+    0x09, 0x00, 0xee, 0x09, 0x0a, 0x00, 0xee, 0x09, 0x0b, 0x00, 0xee, 0x09, 0x0c, 0x00, 0xee, 0x09,
+    0x0d, 0x00, 0x6e, 0x0c, 0x0e, 0x0b, 0xee, 0x09, 0x0f, 0x00, 0xee, 0x09, 0x10, 0x00, 0xee, 0x09,
+    0x11, 0x00, 0xee, 0x09, 0x12, 0x00, 0xee, 0x09, 0x13, 0x00, 0xee, 0x09, 0x14, 0x00, 0xee, 0x09,
+    0x15, 0x00, 0xee, 0x09, 0x16, 0x00, 0xee, 0x09, 0x17, 0x00, 0xee, 0x09, 0x18, 0x00, 0xee, 0x09,
+    0x19, 0x00, 0xee, 0x09, 0x1a, 0x00, 0xee, 0x09, 0x1b, 0x00, 0xee, 0x09, 0x1c, 0x00, 0xee, 0x09,
+    0x1d, 0x00, 0xee, 0x09, 0x1e, 0x00, 0xee, 0x09, 0x1f, 0x00, 0xee, 0x09, 0x20, 0x00, 0xee, 0x09,
+    0x21, 0x00, 0x6e, 0x0c, 0x22, 0x00, 0xee, 0x09, 0x23, 0x00, 0xee, 0x09, 0x24, 0x00, 0xee, 0x09,
+    0x26, 0x00, 0xee, 0x09, 0x28, 0x00, 0xee, 0x09, 0x29, 0x00, 0xee, 0x09, 0x2a, 0x00, 0xee, 0x09,
+    0x2c, 0x00, 0xee, 0x09, 0x2d, 0x00, 0xee, 0x09, 0x2e, 0x00, 0x8e, 0x0c, 0x68, 0x40, 0x00, 0x00,
+};
+
+MINTERNAL void CompiledModel78(RenderContext* renderContext, RenderFrame* rf, u8* code) {
+    MODEL_OP(0x0000, 0x0004, RenderBatch, 0xe306)
+    MODEL_OP(0x0004, 0x0016, RenderComplex, 0x1605)
+    MODEL_OP(0x0016, 0x001a, RenderIf, 0x000b)
+    MODEL_OP(0x001a, 0x0022, RenderQuad, 0x1604)
+    MODEL_OP(0x0022, 0x0028, RenderTri, 0x1603)
+    MODEL_OP(0x0028, 0x002c, RenderIf, 0x000b)
+    MODEL_OP(0x002c, 0x0030, RenderIfVar, 0x0053)
+    MODEL_OP(0x0030, 0x0034, RenderModel, 0x0a2e)
+    MODEL_OP(0x0034, 0x0038, RenderIfNot, 0x00ac)
+    MODEL_OP(0x0038, 0x003c, RenderLine, 0x5442)
+    MODEL_OP(0x003c, 0x0040, RenderLine, 0x5442)
+    MODEL_DONE(0x0040)
+    MODEL_OP(0x0042, 0x004a, RenderQuad, 0x5444)
+    MODEL_OP(0x004a, 0x0052, RenderQuad, 0x5444)
+    MODEL_OP(0x0052, 0x0056, RenderIfNot, 0x024c)
+    MODEL_OP(0x0056, 0x005a, RenderLine, 0x5442)
+    MODEL_OP(0x005a, 0x005e, RenderLine, 0x5442)
+    MODEL_OP(0x005e, 0x0062, RenderLine, 0x5442)
+    MODEL_OP(0x0062, 0x0066, RenderLine, 0x5442)
+    MODEL_OP(0x0066, 0x006a, RenderLine, 0x5442)
+    MODEL_OP(0x006a, 0x006e, RenderLine, 0x5442)
+    MODEL_OP(0x006e, 0x0072, RenderLine, 0x5442)
+    MODEL_OP(0x0072, 0x0076, RenderLine, 0x5442)
+    MODEL_OP(0x0076, 0x007a, RenderLine, 0x5442)
+    MODEL_OP(0x007a, 0x007e, RenderIf, 0x048b)
+    MODEL_OP(0x007e, 0x0086, RenderQuad, 0x5444)
+    MODEL_OP(0x0086, 0x008e, RenderQuad, 0x5444)
+    MODEL_OP(0x008e, 0x0096, RenderQuad, 0x5444)
+    MODEL_OP(0x0096, 0x009e, RenderQuad, 0x5444)
+    MODEL_OP(0x009e, 0x00a6, RenderQuad, 0x5444)
+    MODEL_OP(0x00a6, 0x00ae, RenderQuad, 0x5444)
+    MODEL_OP(0x00ae, 0x00b6, RenderQuad, 0x5444)
+    MODEL_OP(0x00b6, 0x00be, RenderQuad, 0x5444)
+    MODEL_OP(0x00be, 0x00c6, RenderQuad, 0x5444)
+    MODEL_OP(0x00c6, 0x00ca, RenderModel, 0x09ee)
+    MODEL_OP(0x00ca, 0x00ce, RenderModel, 0x0a0e)
+    MODEL_OP(0x00ce, 0x00d2, RenderModel, 0x09ee)
+    MODEL_OP(0x00d2, 0x00d6, RenderModel, 0x0a0e)
+    MODEL_OP(0x00d6, 0x00da, RenderIf, 0x000b)
+    MODEL_OP(0x00da, 0x00de, RenderModel, 0x09ee)
+    MODEL_OP(0x00de, 0x00e2, RenderModel, 0x09ee)
+    MODEL_OP(0x00e2, 0x00e6, RenderModel, 0x09ee)
+    MODEL_OP(0x00e6, 0x00ea, RenderModel, 0x09ee)
+    MODEL_OP(0x00ea, 0x00ee, RenderModel, 0x09ee)
+    MODEL_OP(0x00ee, 0x00f2, RenderModel, 0x09ee)
+    MODEL_OP(0x00f2, 0x00f6, RenderModel, 0x0c6e)
+    MODEL_OP(0x00f6, 0x00fa, RenderModel, 0x09ee)
+    MODEL_OP(0x00fa, 0x00fe, RenderModel, 0x09ee)
+    MODEL_OP(0x00fe, 0x0102, RenderModel, 0x09ee)
+    MODEL_OP(0x0102, 0x0106, RenderModel, 0x09ee)
+    MODEL_OP(0x0106, 0x010a, RenderModel, 0x09ee)
+    MODEL_OP(0x010a, 0x010e, RenderModel, 0x09ee)
+    MODEL_OP(0x010e, 0x0112, RenderModel, 0x09ee)
+    MODEL_OP(0x0112, 0x0116, RenderModel, 0x09ee)
+    MODEL_OP(0x0116, 0x011a, RenderModel, 0x09ee)
+    MODEL_OP(0x011a, 0x011e, RenderModel, 0x09ee)
+    MODEL_OP(0x011e, 0x0122, RenderModel, 0x09ee)
+    MODEL_OP(0x0122, 0x0126, RenderModel, 0x09ee)
+    MODEL_OP(0x0126, 0x012a, RenderModel, 0x09ee)
+    MODEL_OP(0x012a, 0x012e, RenderModel, 0x09ee)
+    MODEL_OP(0x012e, 0x0132, RenderModel, 0x09ee)
+    MODEL_OP(0x0132, 0x0136, RenderModel, 0x09ee)
+    MODEL_OP(0x0136, 0x013a, RenderModel, 0x09ee)
+    MODEL_OP(0x013a, 0x013e, RenderModel, 0x09ee)
+    MODEL_OP(0x013e, 0x0142, RenderModel, 0x09ee)
+    MODEL_OP(0x0142, 0x0146, RenderModel, 0x0c6e)
+    MODEL_OP(0x0146, 0x014a, RenderModel, 0x09ee)
+    MODEL_OP(0x014a, 0x014e, RenderModel, 0x09ee)
+    MODEL_OP(0x014e, 0x0152, RenderModel, 0x09ee)
+    MODEL_OP(0x0152, 0x0156, RenderModel, 0x09ee)
+    MODEL_OP(0x0156, 0x015a, RenderModel, 0x09ee)
+    MODEL_OP(0x015a, 0x015e, RenderModel, 0x09ee)
+    MODEL_OP(0x015e, 0x0162, RenderModel, 0x09ee)
+    MODEL_OP(0x0162, 0x0166, RenderModel, 0x09ee)
+    MODEL_OP(0x0166, 0x016a, RenderModel, 0x09ee)
+    MODEL_OP(0x016a, 0x016e, RenderModel, 0x0c8e)
+    MODEL_DONE(0x016e)
+    MODEL_RESUME_BEGIN
+    MODEL_RESUME(0x0000)
+    MODEL_RESUME(0x0004)
+    MODEL_RESUME(0x0016)
+    MODEL_RESUME(0x001a)
+    MODEL_RESUME(0x0022)
+    MODEL_RESUME(0x0028)
+    MODEL_RESUME(0x002c)
+    MODEL_RESUME(0x0030)
+    MODEL_RESUME(0x0034)
+    MODEL_RESUME(0x0038)
+    MODEL_RESUME(0x003c)
+    MODEL_RESUME(0x0040)
+    MODEL_RESUME(0x0042)
+    MODEL_RESUME(0x004a)
+    MODEL_RESUME(0x0052)
+    MODEL_RESUME(0x0056)
+    MODEL_RESUME(0x005a)
+    MODEL_RESUME(0x005e)
+    MODEL_RESUME(0x0062)
+    MODEL_RESUME(0x0066)
+    MODEL_RESUME(0x006a)
+    MODEL_RESUME(0x006e)
+    MODEL_RESUME(0x0072)
+    MODEL_RESUME(0x0076)
+    MODEL_RESUME(0x007a)
+    MODEL_RESUME(0x007e)
+    MODEL_RESUME(0x0086)
+    MODEL_RESUME(0x008e)
+    MODEL_RESUME(0x0096)
+    MODEL_RESUME(0x009e)
+    MODEL_RESUME(0x00a6)
+    MODEL_RESUME(0x00ae)
+    MODEL_RESUME(0x00b6)
+    MODEL_RESUME(0x00be)
+    MODEL_RESUME(0x00c6)
+    MODEL_RESUME(0x00ca)
+    MODEL_RESUME(0x00ce)
+    MODEL_RESUME(0x00d2)
+    MODEL_RESUME(0x00d6)
+    MODEL_RESUME(0x00da)
+    MODEL_RESUME(0x00de)
+    MODEL_RESUME(0x00e2)
+    MODEL_RESUME(0x00e6)
+    MODEL_RESUME(0x00ea)
+    MODEL_RESUME(0x00ee)
+    MODEL_RESUME(0x00f2)
+    MODEL_RESUME(0x00f6)
+    MODEL_RESUME(0x00fa)
+    MODEL_RESUME(0x00fe)
+    MODEL_RESUME(0x0102)
+    MODEL_RESUME(0x0106)
+    MODEL_RESUME(0x010a)
+    MODEL_RESUME(0x010e)
+    MODEL_RESUME(0x0112)
+    MODEL_RESUME(0x0116)
+    MODEL_RESUME(0x011a)
+    MODEL_RESUME(0x011e)
+    MODEL_RESUME(0x0122)
+    MODEL_RESUME(0x0126)
+    MODEL_RESUME(0x012a)
+    MODEL_RESUME(0x012e)
+    MODEL_RESUME(0x0132)
+    MODEL_RESUME(0x0136)
+    MODEL_RESUME(0x013a)
+    MODEL_RESUME(0x013e)
+    MODEL_RESUME(0x0142)
+    MODEL_RESUME(0x0146)
+    MODEL_RESUME(0x014a)
+    MODEL_RESUME(0x014e)
+    MODEL_RESUME(0x0152)
+    MODEL_RESUME(0x0156)
+    MODEL_RESUME(0x015a)
+    MODEL_RESUME(0x015e)
+    MODEL_RESUME(0x0162)
+    MODEL_RESUME(0x0166)
+    MODEL_RESUME(0x016a)
+    MODEL_RESUME(0x016e)
+    MODEL_RESUME_END
+}
+
+static const u8 sCompiledModelCode88[] = {
+    0x0d, 0xc1, 0x01, 0x00, 0xac, 0x00, 0x26, 0x07, 0x44, 0x54, 0x3c, 0x41, 0x40, 0x3d, 0x00, 0x00,
+    0x00, 0x00, 0x86, 0xea, 0x86, 0x47, 0x4e, 0x0b, 0x48, 0x00, 0x4e, 0x0b, 0x49, 0x00, 0x4e, 0x0b,
+    0x4a, 0x00, 0x4e, 0x0b, 0x4b, 0x00, 0xac, 0x01, 0x00, 0x05, 0x42, 0x54, 0x3e, 0x40, 0x42, 0x54,
+    0x3f, 0x41, 0x45, 0x54, 0x00, 0x0c, 0x10, 0x04, 0x1c, 0x00, 0x18, 0x06, 0x1d, 0x06, 0x11, 0x06,
+    0x00, 0x00, 0x00, 0x00, 0x45, 0x54, 0x00, 0x3c, 0x16, 0x04, 0x42, 0x00, 0x40, 0x06, 0x3e, 0x06,
+    0x3c, 0x06, 0x3a, 0x06, 0x38, 0x08, 0x34, 0x36, 0x2c, 0x06, 0x2e, 0x08, 0x32, 0x30, 0x20, 0x06,
+    0x1e, 0x08, 0x1a, 0x1c, 0x00, 0x0a, 0x00, 0x02, 0x1d, 0x1b, 0x21, 0x1f, 0x33, 0x06, 0x31, 0x08,
+    0x2d, 0x2f, 0x35, 0x06, 0x37, 0x08, 0x3b, 0x39, 0x3d, 0x06, 0x3f, 0x06, 0x41, 0x06, 0x43, 0x06,
+    0x17, 0x06, 0x00, 0x00, 0x4c, 0x04, 0x24, 0x02, 0x42, 0x54, 0x24, 0x18, 0x42, 0x54, 0x24, 0x2c,
+    0x42, 0x54, 0x25, 0x2d, 0x42, 0x54, 0x48, 0x4a, 0x42, 0x54, 0x49, 0x48, 0x42, 0x54, 0x49, 0x4b,
+    0x45, 0x54, 0x00, 0x12, 0x10, 0x04, 0x16, 0x00, 0x1a, 0x06, 0x18, 0x06, 0x19, 0x06, 0x1b, 0x06,
+    0x17, 0x06, 0x11, 0x06, 0x00, 0x00, 0x44, 0x44, 0x02, 0x01, 0x00, 0x03, 0x04, 0x00, 0x93, 0x00,
+    0xc1, 0x01, 0x44, 0x44, 0x0a, 0x09, 0x08, 0x0b, 0x02, 0x00, 0x00, 0x00, 0x45, 0x54, 0x00, 0x2e,
+    0x00, 0x02, 0x12, 0x10, 0x16, 0x14, 0x1a, 0x06, 0x18, 0x06, 0x22, 0x06, 0x24, 0x08, 0x28, 0x26,
+    0x2c, 0x06, 0x34, 0x06, 0x2a, 0x06, 0x2b, 0x06, 0x35, 0x06, 0x2d, 0x06, 0x29, 0x06, 0x27, 0x08,
+    0x23, 0x25, 0x19, 0x06, 0x1b, 0x06, 0x17, 0x06, 0x15, 0x08, 0x11, 0x13, 0x00, 0x00, 0x45, 0x54,
+    0x00, 0x12, 0x4e, 0x04, 0x4a, 0x00, 0x48, 0x06, 0x49, 0x06, 0x4b, 0x06, 0x4f, 0x06, 0x4d, 0x06,
+    0x4c, 0x06, 0x00, 0x00, 0x8a, 0x88, 0x00, 0x0e, 0x51, 0x41, 0x11, 0x40, 0x6e, 0x0b, 0x54, 0x00,
+    0xc6, 0x40, 0x44, 0x44, 0x04, 0x01, 0x00, 0x05, 0x06, 0x00, 0x48, 0x44, 0x02, 0x04, 0x00, 0x06,
+    0x08, 0x00, 0x44, 0x44, 0x06, 0x03, 0x02, 0x07, 0x0a, 0x00, 0x44, 0x44, 0x02, 0x01, 0x00, 0x03,
+    0x04, 0x00, 0x53, 0x02, 0xc1, 0x01, 0x46, 0x41, 0x24, 0x22, 0x0c, 0x09, 0x08, 0x0d, 0x0c, 0x00,
+    0x68, 0x66, 0x0a, 0x0c, 0x08, 0x0e, 0x0e, 0x00, 0x24, 0x22, 0x0e, 0x0b, 0x0a, 0x0f, 0x10, 0x00,
+    0x44, 0x44, 0x0a, 0x09, 0x08, 0x0b, 0x02, 0x00, 0x06, 0x00, 0x8e, 0x0b, 0x5c, 0x00, 0x2e, 0x0b,
+    0x44, 0x23, 0x2e, 0x0b, 0x46, 0x23, 0x2e, 0x0b, 0x45, 0x0b, 0x2e, 0x0b, 0x47, 0x0b, 0xd3, 0x00,
+    0xc1, 0x0e, 0xc6, 0x4a, 0x6e, 0x0c, 0x56, 0x28, 0xe6, 0x4a, 0x6e, 0x0c, 0x57, 0x00, 0xd3, 0x00,
+    0xc1, 0x0f, 0x06, 0x4b, 0x6e, 0x0c, 0x58, 0x23, 0x26, 0x4b, 0x6e, 0x0c, 0x59, 0x0b, 0xd3, 0x00,
+    0xc1, 0x10, 0x46, 0x4b, 0x6e, 0x0c, 0x5a, 0x23, 0x66, 0x4b, 0x6e, 0x0c, 0x5b, 0x0b, 0x00, 0x00,
+};
+
+MINTERNAL void CompiledModel88(RenderContext* renderContext, RenderFrame* rf, u8* code) {
+    MODEL_OP(0x0000, 0x0004, RenderCalc, 0xc10d)
+    MODEL_OP(0x0004, 0x0008, RenderIfNot, 0x00ac)
+    MODEL_OP(0x0008, 0x0010, RenderQuad, 0x5444)
+    MODEL_DONE(0x0010)
+    MODEL_OP(0x0012, 0x0016, RenderBatch, 0xea86)
+    MODEL_OP(0x0016, 0x001a, RenderModel, 0x0b4e)
+    MODEL_OP(0x001a, 0x001e, RenderModel, 0x0b4e)
+    MODEL_OP(0x001e, 0x0022, RenderModel, 0x0b4e)
+    MODEL_OP(0x0022, 0x0026, RenderModel, 0x0b4e)
+    MODEL_OP(0x0026, 0x002a, RenderIfNot, 0x01ac)
+    MODEL_OP(0x002a, 0x002e, RenderLine, 0x5442)
+    MODEL_OP(0x002e, 0x0032, RenderLine, 0x5442)
+    MODEL_OP(0x0032, 0x0042, RenderComplex, 0x5445)
+    MODEL_DONE(0x0042)
+    MODEL_OP(0x0044, 0x0084, RenderComplex, 0x5445)
+    MODEL_OP(0x0084, 0x0088, RenderIfNot, 0x044c)
+    MODEL_OP(0x0088, 0x008c, RenderLine, 0x5442)
+    MODEL_OP(0x008c, 0x0090, RenderLine, 0x5442)
+    MODEL_OP(0x0090, 0x0094, RenderLine, 0x5442)
+    MODEL_OP(0x0094, 0x0098, RenderLine, 0x5442)
+    MODEL_OP(0x0098, 0x009c, RenderLine, 0x5442)
+    MODEL_OP(0x009c, 0x00a0, RenderLine, 0x5442)
+    MODEL_OP(0x00a0, 0x00b6, RenderComplex, 0x5445)
+    MODEL_OP(0x00b6, 0x00be, RenderQuad, 0x4444)
+    MODEL_OP(0x00be, 0x00c2, RenderIfVar, 0x0093)
+    MODEL_OP(0x00c2, 0x00ca, RenderQuad, 0x4444)
+    MODEL_DONE(0x00ca)
+    MODEL_OP(0x00cc, 0x00fe, RenderComplex, 0x5445)
+    MODEL_OP(0x00fe, 0x0114, RenderComplex, 0x5445)
+    MODEL_OP(0x0114, 0x011c, RenderVectorText, 0x888a)
+    MODEL_OP(0x011c, 0x0120, RenderModel, 0x0b6e)
+    MODEL_OP(0x0120, 0x0122, RenderBatch, 0x40c6)
+    MODEL_OP(0x0122, 0x012a, RenderQuad, 0x4444)
+    MODEL_OP(0x012a, 0x0132, Render2QuadMirrored, 0x4448)
+    MODEL_OP(0x0132, 0x013a, RenderQuad, 0x4444)
+    MODEL_OP(0x013a, 0x0142, RenderQuad, 0x4444)
+    MODEL_OP(0x0142, 0x0146, RenderIfVar, 0x0253)
+    MODEL_OP(0x0146, 0x0148, RenderBatch, 0x4146)
+    MODEL_OP(0x0148, 0x0150, RenderQuad, 0x2224)
+    MODEL_OP(0x0150, 0x0158, Render2QuadMirrored, 0x6668)
+    MODEL_OP(0x0158, 0x0160, RenderQuad, 0x2224)
+    MODEL_OP(0x0160, 0x0168, RenderQuad, 0x4444)
+    MODEL_OP(0x0168, 0x016a, RenderBatch, 0x0006)
+    MODEL_OP(0x016a, 0x016e, RenderModel, 0x0b8e)
+    MODEL_OP(0x016e, 0x0172, RenderModel, 0x0b2e)
+    MODEL_OP(0x0172, 0x0176, RenderModel, 0x0b2e)
+    MODEL_OP(0x0176, 0x017a, RenderModel, 0x0b2e)
+    MODEL_OP(0x017a, 0x017e, RenderModel, 0x0b2e)
+    MODEL_OP(0x017e, 0x0182, RenderIfVar, 0x00d3)
+    MODEL_OP(0x0182, 0x0184, RenderBatch, 0x4ac6)
+    MODEL_OP(0x0184, 0x0188, RenderModel, 0x0c6e)
+    MODEL_OP(0x0188, 0x018a, RenderBatch, 0x4ae6)
+    MODEL_OP(0x018a, 0x018e, RenderModel, 0x0c6e)
+    MODEL_OP(0x018e, 0x0192, RenderIfVar, 0x00d3)
+    MODEL_OP(0x0192, 0x0194, RenderBatch, 0x4b06)
+    MODEL_OP(0x0194, 0x0198, RenderModel, 0x0c6e)
+    MODEL_OP(0x0198, 0x019a, RenderBatch, 0x4b26)
+    MODEL_OP(0x019a, 0x019e, RenderModel, 0x0c6e)
+    MODEL_OP(0x019e, 0x01a2, RenderIfVar, 0x00d3)
+    MODEL_OP(0x01a2, 0x01a4, RenderBatch, 0x4b46)
+    MODEL_OP(0x01a4, 0x01a8, RenderModel, 0x0c6e)
+    MODEL_OP(0x01a8, 0x01aa, RenderBatch, 0x4b66)
+    MODEL_OP(0x01aa, 0x01ae, RenderModel, 0x0c6e)
+    MODEL_DONE(0x01ae)
+    MODEL_RESUME_BEGIN
+    MODEL_RESUME(0x0000)
+    MODEL_RESUME(0x0004)
+    MODEL_RESUME(0x0008)
+    MODEL_RESUME(0x0010)
+    MODEL_RESUME(0x0012)
+    MODEL_RESUME(0x0016)
+    MODEL_RESUME(0x001a)
+    MODEL_RESUME(0x001e)
+    MODEL_RESUME(0x0022)
+    MODEL_RESUME(0x0026)
+    MODEL_RESUME(0x002a)
+    MODEL_RESUME(0x002e)
+    MODEL_RESUME(0x0032)
+    MODEL_RESUME(0x0042)
+    MODEL_RESUME(0x0044)
+    MODEL_RESUME(0x0084)
+    MODEL_RESUME(0x0088)
+    MODEL_RESUME(0x008c)
+    MODEL_RESUME(0x0090)
+    MODEL_RESUME(0x0094)
+    MODEL_RESUME(0x0098)
+    MODEL_RESUME(0x009c)
+    MODEL_RESUME(0x00a0)
+    MODEL_RESUME(0x00b6)
+    MODEL_RESUME(0x00be)
+    MODEL_RESUME(0x00c2)
+    MODEL_RESUME(0x00ca)
+    MODEL_RESUME(0x00cc)
+    MODEL_RESUME(0x00fe)
+    MODEL_RESUME(0x0114)
+    MODEL_RESUME(0x011c)
+    MODEL_RESUME(0x0120)
+    MODEL_RESUME(0x0122)
+    MODEL_RESUME(0x012a)
+    MODEL_RESUME(0x0132)
+    MODEL_RESUME(0x013a)
+    MODEL_RESUME(0x0142)
+    MODEL_RESUME(0x0146)
+    MODEL_RESUME(0x0148)
+    MODEL_RESUME(0x0150)
+    MODEL_RESUME(0x0158)
+    MODEL_RESUME(0x0160)
+    MODEL_RESUME(0x0168)
+    MODEL_RESUME(0x016a)
+    MODEL_RESUME(0x016e)
+    MODEL_RESUME(0x0172)
+    MODEL_RESUME(0x0176)
+    MODEL_RESUME(0x017a)
+    MODEL_RESUME(0x017e)
+    MODEL_RESUME(0x0182)
+    MODEL_RESUME(0x0184)
+    MODEL_RESUME(0x0188)
+    MODEL_RESUME(0x018a)
+    MODEL_RESUME(0x018e)
+    MODEL_RESUME(0x0192)
+    MODEL_RESUME(0x0194)
+    MODEL_RESUME(0x0198)
+    MODEL_RESUME(0x019a)
+    MODEL_RESUME(0x019e)
+    MODEL_RESUME(0x01a2)
+    MODEL_RESUME(0x01a4)
+    MODEL_RESUME(0x01a8)
+    MODEL_RESUME(0x01aa)
+    MODEL_RESUME(0x01ae)
+    MODEL_RESUME_END
+}
+
+static const u8 sCompiledModelCode94[] = {
+    0x5d, 0xc3, 0x80, 0x0a, 0x5c, 0x00, 0xc3, 0x00, 0x1e, 0xc0, 0x0d, 0xc3, 0x80, 0x00, 0x1a, 0xf0,
+    0x00, 0xc3, 0x40, 0x0f, 0x82, 0x0f, 0x82, 0x0f, 0x82, 0x0f, 0x82, 0x0f, 0x40, 0x0f, 0x00, 0x0f,
+    0x05, 0x11, 0x00, 0x1a, 0x1c, 0x04, 0x2a, 0x00, 0x1e, 0x06, 0x28, 0x06, 0x20, 0x06, 0x2b, 0x06,
+    0x22, 0x06, 0x2d, 0x06, 0x24, 0x06, 0x2e, 0x06, 0x26, 0x06, 0x2c, 0x06, 0x00, 0x00, 0x5a, 0xfc,
+    0x00, 0xc3, 0xe4, 0x0f, 0xe6, 0x0f, 0xea, 0x0f, 0xea, 0x0f, 0xe6, 0x0f, 0xe4, 0x0f, 0xc4, 0x0f,
+    0x05, 0x11, 0x00, 0x1a, 0x30, 0x04, 0x3e, 0x00, 0x32, 0x06, 0x3c, 0x06, 0x34, 0x06, 0x3f, 0x06,
+    0x36, 0x06, 0x41, 0x06, 0x38, 0x06, 0x42, 0x06, 0x3a, 0x06, 0x40, 0x06, 0x00, 0x00, 0x00, 0x00,
+};
+
+MINTERNAL void CompiledModel94(RenderContext* renderContext, RenderFrame* rf, u8* code) {
+    MODEL_OP(0x0000, 0x0004, RenderCalc, 0xc35d)
+    MODEL_OP(0x0004, 0x0008, RenderMatrixTransform, 0x005c)
+    MODEL_OP(0x0008, 0x000a, RenderMatrixCopy, 0xc01e)
+    MODEL_OP(0x000a, 0x000e, RenderCalc, 0xc30d)
+    MODEL_OP(0x000e, 0x0020, RenderColour, 0xf01a)
+    MODEL_OP(0x0020, 0x003e, RenderComplex, 0x1105)
+    MODEL_OP(0x003e, 0x0050, RenderColour, 0xfc5a)
+    MODEL_OP(0x0050, 0x006e, RenderComplex, 0x1105)
+    MODEL_DONE(0x006e)
+    MODEL_RESUME_BEGIN
+    MODEL_RESUME(0x0000)
+    MODEL_RESUME(0x0004)
+    MODEL_RESUME(0x0008)
+    MODEL_RESUME(0x000a)
+    MODEL_RESUME(0x000e)
+    MODEL_RESUME(0x0020)
+    MODEL_RESUME(0x003e)
+    MODEL_RESUME(0x0050)
+    MODEL_RESUME(0x006e)
+    MODEL_RESUME_END
+}
+
+static const u8 sCompiledModelCode106[] = {
+    0x06, 0x00, 0x15, 0x00, 0x71, 0x66, 0x00, 0x02, 0x02, 0x07, 0x84, 0x04, 0x00, 0x00, 0x77, 0x01,
+    0x64, 0x66, 0xfd, 0xfc, 0xfe, 0x1a, 0x00, 0x00, 0x48, 0x44, 0x04, 0x0e, 0x0c, 0x06, 0x06, 0x00,
+    0x48, 0x44, 0x06, 0x10, 0x0e, 0x08, 0x08, 0x00, 0x68, 0x66, 0x08, 0x12, 0x10, 0x0a, 0x0a, 0x00,
+    0x67, 0x66, 0x0e, 0x0c, 0x0c, 0x14, 0x47, 0x44, 0x10, 0x0e, 0x0e, 0x14, 0x47, 0x44, 0x12, 0x10,
+    0x10, 0x14, 0x48, 0x44, 0x08, 0x04, 0x0a, 0x06, 0x12, 0x00, 0x82, 0x88, 0x14, 0x16, 0x15, 0x80,
+    0xbd, 0xc3, 0xc2, 0x44, 0x13, 0x00, 0xc3, 0x00, 0x6e, 0x0d, 0x02, 0x48, 0x00, 0x00,
+};
+
+MINTERNAL void CompiledModel106(RenderContext* renderContext, RenderFrame* rf, u8* code) {
+    MODEL_OP(0x0000, 0x0002, RenderBatch, 0x0006)
+    MODEL_OP(0x0002, 0x0004, RenderDepthTreePushPop, 0x0015)
+    MODEL_OP(0x0004, 0x0010, RenderConeCapped, 0x6671)
+    MODEL_OP(0x0010, 0x0018, RenderQuad, 0x6664)
+    MODEL_OP(0x0018, 0x0020, Render2QuadMirrored, 0x4448)
+    MODEL_OP(0x0020, 0x0028, Render2QuadMirrored, 0x4448)
+    MODEL_OP(0x0028, 0x0030, Render2QuadMirrored, 0x6668)
+    MODEL_OP(0x0030, 0x0036, Render2TriMirrored, 0x6667)
+    MODEL_OP(0x0036, 0x003c, Render2TriMirrored, 0x4447)
+    MODEL_OP(0x003c, 0x0042, Render2TriMirrored, 0x4447)
+    MODEL_OP(0x0042, 0x004a, Render2QuadMirrored, 0x4448)
+    MODEL_OP(0x004a, 0x004e, RenderLine, 0x8882)
+    MODEL_OP(0x004e, 0x0050, RenderDepthTreePushPop, 0x8015)
+    MODEL_OP(0x0050, 0x0054, RenderCalc, 0xc3bd)
+    MODEL_OP(0x0054, 0x0058, RenderIfVar, 0x0013)
+    MODEL_OP(0x0058, 0x005c, RenderModel, 0x0d6e)
+    MODEL_DONE(0x005c)
+    MODEL_RESUME_BEGIN
+    MODEL_RESUME(0x0000)
+    MODEL_RESUME(0x0002)
+    MODEL_RESUME(0x0004)
+    MODEL_RESUME(0x0010)
+    MODEL_RESUME(0x0018)
+    MODEL_RESUME(0x0020)
+    MODEL_RESUME(0x0028)
+    MODEL_RESUME(0x0030)
+    MODEL_RESUME(0x0036)
+    MODEL_RESUME(0x003c)
+    MODEL_RESUME(0x0042)
+    MODEL_RESUME(0x004a)
+    MODEL_RESUME(0x004e)
+    MODEL_RESUME(0x0050)
+    MODEL_RESUME(0x0054)
+    MODEL_RESUME(0x0058)
+    MODEL_RESUME(0x005c)
+    MODEL_RESUME_END
+}
+
+static const u8 sCompiledModelCode114[] = {
+    0xdf, 0x01, 0x00, 0x7f, 0x00, 0x00, 0x74, 0x43, 0x04, 0x00, 0x44, 0x04, 0x44, 0x04, 0x08, 0x00,
+    0x1d, 0x40, 0x46, 0x06, 0x2c, 0x40, 0x36, 0x05, 0x88, 0x40, 0x26, 0x04, 0x68, 0x40, 0x16, 0x04,
+    0x00, 0x00, 0x00, 0x00,
+};
+
+MINTERNAL void CompiledModel114(RenderContext* renderContext, RenderFrame* rf, u8* code) {
+    MODEL_OP(0x0000, 0x0022, RenderPlanet, 0x01df)
+    MODEL_DONE(0x0022)
+    MODEL_RESUME_BEGIN
+    MODEL_RESUME(0x0000)
+    MODEL_RESUME(0x0022)
+    MODEL_RESUME_END
+}
+
+static const CompiledModel sCompiledModels[] = {
+    { 20, sizeof(sCompiledModelCode20), sCompiledModelCode20, CompiledModel20 },
+    { 34, sizeof(sCompiledModelCode34), sCompiledModelCode34, CompiledModel34 },
+    { 36, sizeof(sCompiledModelCode36), sCompiledModelCode36, CompiledModel36 },
+    { 39, sizeof(sCompiledModelCode39), sCompiledModelCode39, CompiledModel39 },
+    { 40, sizeof(sCompiledModelCode40), sCompiledModelCode40, CompiledModel40 },
+    { 43, sizeof(sCompiledModelCode43), sCompiledModelCode43, CompiledModel43 },
+    { 53, sizeof(sCompiledModelCode53), sCompiledModelCode53, CompiledModel53 },
+    { 66, sizeof(sCompiledModelCode66), sCompiledModelCode66, CompiledModel66 },
+    { 68, sizeof(sCompiledModelCode68), sCompiledModelCode68, CompiledModel68 },
+    { 78, sizeof(sCompiledModelCode78), sCompiledModelCode78, CompiledModel78 },
+    { 88, sizeof(sCompiledModelCode88), sCompiledModelCode88, CompiledModel88 },
+    { 94, sizeof(sCompiledModelCode94), sCompiledModelCode94, CompiledModel94 },
+    { 106, sizeof(sCompiledModelCode106), sCompiledModelCode106, CompiledModel106 },
+    { 114, sizeof(sCompiledModelCode114), sCompiledModelCode114, CompiledModel114 },
+};
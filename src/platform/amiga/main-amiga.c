@@ -664,7 +664,6 @@ __stdargs int main(int argc, char** argv) {
     AssetsReadEnum assetsRead = AssetsRead_Amiga_EliteClub2;
 
     Surface surface;
-    surface.pixels = 0;
     Surface_Init(&surface, SURFACE_WIDTH, SURFACE_HEIGHT);
 
     RasterContext raster;
@@ -699,6 +698,7 @@ __stdargs int main(int argc, char** argv) {
             MArraySet(introSceneSetup.assets.models, i, overrideModels.arr[i]);
         }
     }
+    Render_AnalyseModels(&introSceneSetup);
 
     u32 numFrames = Intro_GetNumFrames(&sIntro);
 
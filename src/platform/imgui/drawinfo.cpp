@@ -1,6 +1,42 @@
 #include "drawinfo.h"
 
-void DumpZtree(RasterContext* raster, DebugDrawInfo& drawInfo, RasterOpNode* drawNode, u8* zTreeMemM, MStrWriter* writer);
+void DumpZtree(RasterContext* raster, DebugDrawInfo& drawInfo, RasterOpNode* drawNode, MStrWriter* writer);
+
+const char* DrawFuncName(int func) {
+    switch (func) {
+        case DRAW_FUNC_NULL: return "NULL";
+        case DRAW_FUNC_SPANS_START: return "SPANS_START";
+        case DRAW_FUNC_SPANS_BEZIER: return "SPANS_BEZIER";
+        case DRAW_FUNC_SPANS_DRAW: return "SPANS_DRAW";
+        case DRAW_FUNC_SPANS_LINE: return "SPANS_LINE";
+        case DRAW_FUNC_SPANS_LINE_CONT: return "SPANS_LINE_CONT";
+        case DRAW_FUNC_SPANS_POINT: return "SPANS_POINT";
+        case DRAW_FUNC_SPANS_END: return "SPANS_END";
+        case DRAW_FUNC_BATCH_START: return "BATCH_START";
+        case DRAW_FUNC_BATCH_END1: return "BATCH_END1";
+        case DRAW_FUNC_BATCH_END: return "BATCH_END";
+        case DRAW_FUNC_LINE: return "LINE";
+        case DRAW_FUNC_TRI: return "TRI";
+        case DRAW_FUNC_QUAD: return "QUAD";
+        case DRAW_FUNC_BEZIER_LINE: return "BEZIER_LINE";
+        case DRAW_FUNC_FLARE: return "FLARE";
+        case DRAW_FUNC_CIRCLE: return "CIRCLE";
+        case DRAW_FUNC_RINGED_CIRCLE: return "RINGED_CIRCLE";
+        case DRAW_FUNC_CIRCLES: return "CIRCLES";
+        case DRAW_FUNC_TEXT: return "TEXT";
+        case DRAW_FUNC_SUBTREE: return "SUBTREE";
+        case DRAW_FUNC_BODY_START: return "BODY_START";
+        case DRAW_FUNC_BODY_LINE: return "BODY_LINE";
+        case DRAW_FUNC_BODY_BEZIER: return "BODY_BEZIER";
+        case DRAW_FUNC_BODY_TOGGLE_COLOUR: return "BODY_TOGGLE_COLOUR";
+        case DRAW_FUNC_BODY_DRAW_1: return "BODY_DRAW_1";
+        case DRAW_FUNC_BODY_DRAW_2: return "BODY_DRAW_2";
+        case DRAW_FUNC_BODY_DRAW_3: return "BODY_DRAW_3";
+        case DRAW_FUNC_NOP: return "NOP";
+        case DRAW_FUNC_NEXT_CHUNK: return "NEXT_CHUNK";
+        default: return "UNKNOWN";
+    }
+}
 
 int DumpDrawFunc(RasterContext* raster, DebugDrawInfo &drawInfo, DrawFunc *drawFunc, MStrWriter* writer) {
     switch (drawFunc->func) {
@@ -138,7 +174,7 @@ int DumpDrawFunc(RasterContext* raster, DebugDrawInfo &drawInfo, DrawFunc *drawF
              writer->appendf("SUBTREE_START\n");
             RasterOpNode* params = (RasterOpNode*)(&drawFunc->params);
 
-            DumpZtree(raster, drawInfo, params, raster->depthTree.data, writer);
+            DumpZtree(raster, drawInfo, params, writer);
 
 #ifdef FINTRO_INSPECTOR
             writer->appendf("       ");
@@ -250,10 +286,10 @@ int DumpDrawBatch(RasterContext* raster, DebugDrawInfo &drawInfo, RasterOpNode *
     do {
         currentFunc += sizeof(drawFunc->func);
         currentFunc += size;
+        currentFunc = DepthTree_FollowFunc(&raster->depthTree, currentFunc);
         drawFunc = (DrawFunc*)(currentFunc);
 #ifdef FINTRO_INSPECTOR
-        u16 offset1 = (u8*)drawFunc - (u8*)raster->depthTree.data;
-        u32 insOffsetTmp = raster->depthTree.insOffset[offset1];
+        u32 insOffsetTmp = DepthTree_InsOffsetForPtr(&raster->depthTree, drawFunc);
         writer->appendf("%05x | ", insOffsetTmp);
 #endif
         writer->append("          ");
@@ -270,8 +306,7 @@ int DumpBodySpanFunc(RasterContext* raster, DebugDrawInfo &drawInfo, RasterOpNod
 
     DrawFunc* drawFunc = (DrawFunc*)(currentFunc);
 #ifdef FINTRO_INSPECTOR
-    u16 offset1 = (u8*)drawFunc - (u8*)raster->depthTree.data;
-    u32 insOffsetTmp = raster->depthTree.insOffset[offset1];
+    u32 insOffsetTmp = DepthTree_InsOffsetForPtr(&raster->depthTree, drawFunc);
     writer->appendf("%05x | ", insOffsetTmp);
 #endif
 
@@ -289,10 +324,10 @@ int DumpBodySpanFunc(RasterContext* raster, DebugDrawInfo &drawInfo, RasterOpNod
         size = DumpDrawFunc(raster, drawInfo, drawFunc, writer);
         currentFunc += sizeof(drawFunc->func);
         currentFunc += size;
+        currentFunc = DepthTree_FollowFunc(&raster->depthTree, currentFunc);
         drawFunc = (DrawFunc*)(currentFunc);
 #ifdef FINTRO_INSPECTOR
-        u16 offset2 = (u8*)drawFunc - (u8*)raster->depthTree.data;
-        u32 insOffsetTmp2 = raster->depthTree.insOffset[offset2];
+        u32 insOffsetTmp2 = DepthTree_InsOffsetForPtr(&raster->depthTree, drawFunc);
         writer->appendf("%05x | ", insOffsetTmp2);
 #endif
     }
@@ -310,8 +345,7 @@ int DumpSpanFunc(RasterContext* raster, DebugDrawInfo &drawInfo, RasterOpNode *d
 
     DrawFunc* drawFunc = (DrawFunc*)(currentFunc);
 #ifdef FINTRO_INSPECTOR
-    u16 offset1 = (u8*)drawFunc - (u8*)raster->depthTree.data;
-    u32 insOffsetTmp = raster->depthTree.insOffset[offset1];
+    u32 insOffsetTmp = DepthTree_InsOffsetForPtr(&raster->depthTree, drawFunc);
     writer->appendf("%05x | ", insOffsetTmp);
 #endif
 
@@ -326,10 +360,10 @@ int DumpSpanFunc(RasterContext* raster, DebugDrawInfo &drawInfo, RasterOpNode *d
         size = DumpDrawFunc(raster, drawInfo, drawFunc, writer);
         currentFunc += sizeof(drawFunc->func);
         currentFunc += size;
+        currentFunc = DepthTree_FollowFunc(&raster->depthTree, currentFunc);
         drawFunc = (DrawFunc*)(currentFunc);
 #ifdef FINTRO_INSPECTOR
-        u16 offset2 = (u8*)drawFunc - (u8*)raster->depthTree.data;
-        u32 insOffsetTmp2 = raster->depthTree.insOffset[offset2];
+        u32 insOffsetTmp2 = DepthTree_InsOffsetForPtr(&raster->depthTree, drawFunc);
         writer->appendf("%05x | ", insOffsetTmp2);
 #endif
     }
@@ -392,49 +426,68 @@ int DumpDrawNodeInfo(RasterContext* raster, DebugDrawInfo &drawInfo, RasterOpNod
     return 0;
 }
 
-void DumpZtree(RasterContext* raster, DebugDrawInfo& drawInfo, RasterOpNode* drawNode, u8* zTreeMem, MStrWriter* writer) {
+void DumpDrawList(RasterContext* raster, DebugDrawInfo& drawInfo, u32 range, MStrWriter* writer) {
+    DepthTree* depthTree = &raster->depthTree;
+    if (range + 1 >= MArraySize(depthTree->rangeStart)) {
+        writer->append("Draw list not sorted\n");
+        return;
+    }
+
+    u32 end = depthTree->rangeStart.arr[range + 1];
+    for (u32 i = depthTree->rangeStart.arr[range]; i < end; i++) {
+        RasterOpNode* drawNode = (RasterOpNode*)DepthTree_Ptr(depthTree, depthTree->sortedKeys.arr[i].offset);
+
+#ifdef FINTRO_INSPECTOR
+        u32 insOffsetTmp = *DepthTree_InsOffsetPtr(depthTree, depthTree->sortedKeys.arr[i].offset);
+        writer->appendf("%05x | ", insOffsetTmp);
+#endif
+
+        writer->appendf("%8x: ", depthTree->sortedKeys.arr[i].z);
+
+        if (DumpDrawNodeInfo(raster, drawInfo, drawNode, writer) < 0) {
+            break;
+        }
+    }
+}
+
+void DumpZtree(RasterContext* raster, DebugDrawInfo& drawInfo, RasterOpNode* drawNode, MStrWriter* writer) {
+    if (raster->depthTree.sortMode == DEPTHSORT_LIST) {
+        // Root node holds the draw list range
+        DumpDrawList(raster, drawInfo, DepthTree_NodeZ(&raster->depthTree, drawNode), writer);
+        return;
+    }
+
     MPtrArray<RasterOpNode> stack(32);
 
     while (drawNode != NULL || stack.size()) {
         while (drawNode != NULL) {
             stack.add(drawNode);
-            if (drawNode->rightOffset) {
-                drawNode = (RasterOpNode*)(zTreeMem + drawNode->rightOffset);
-            } else {
-                drawNode = NULL;
-            }
+            drawNode = DepthTree_NodeRight(&raster->depthTree, drawNode);
         }
 
         drawNode = stack.pop();
 
 #ifdef FINTRO_INSPECTOR
-        u16 offset1 = (u8*)drawNode - (u8*)raster->depthTree.data;
-        u32 insOffsetTmp = raster->depthTree.insOffset[offset1];
+        u32 insOffsetTmp = DepthTree_InsOffsetForPtr(&raster->depthTree, drawNode);
         writer->appendf("%05x | ", insOffsetTmp);
 #endif
 
-        writer->appendf("%8x: ", drawNode->z);
+        writer->appendf("%8x: ", DepthTree_NodeZ(&raster->depthTree, drawNode));
 
         if (DumpDrawNodeInfo(raster, drawInfo, drawNode, writer) < 0) {
             break;
         }
 
-        if (drawNode->leftOffset) {
-            drawNode = (RasterOpNode*)(zTreeMem + drawNode->leftOffset);
-        } else {
-            drawNode = NULL;
-        }
+        drawNode = DepthTree_NodeLeft(&raster->depthTree, drawNode);
     }
 }
 
 void DumpDrawInfo(RasterContext* raster, DebugDrawInfo& drawInfo, MStrWriter* writer) {
     drawInfo.batchesDrawn = 0;
 
-    u8* zTreeMem = raster->depthTree.data;
-
-    RasterOpNode* drawNode = (RasterOpNode*)(zTreeMem + raster->depthTree.firstNodeOffset);
+    RasterOpNode* drawNode = DepthTree_Node(&raster->depthTree, DEPTHTREE_ROOT_NODE);
 
-    DumpZtree(raster, drawInfo, drawNode, (u8*) zTreeMem, writer);
+    DumpZtree(raster, drawInfo, drawNode, writer);
 }
 
 void DumpPaletteInfo(RasterContext* raster, RGB* screenPalette, DebugPaletteInfo& paletteInfo) {
@@ -14,6 +14,7 @@ typedef struct sDebugDrawInfo {
 } DebugDrawInfo;
 
 void DumpDrawInfo(RasterContext* raster, DebugDrawInfo& drawInfo, MStrWriter* writer);
+const char* DrawFuncName(int func);
 
 typedef struct sDebugPaletteInfo {
     MStrWriter writer;
@@ -24,45 +24,46 @@
 
 static RGB sDefaultPalette[256];
 static bool sModelRendered = false;
-static u8 sMinIndex = 0;
-static u8 sMaxIndex = 0;
 static u8* sSurfaceTexturePixels = NULL;
+#ifdef FINTRO_RASTER_STATS
+static bool sShowOverdraw = false;
+static bool sSaveOverdraw = false;
+static int sOverdrawFrame = 0;
+static u16 sMaxOverdraw = 0;
+#endif
 
 
 MINTERNAL void WritePng(const char* filepath, Surface* surface, RGB* palette) {
     std::ofstream out(filepath, std::ios::binary);
     TinyPngOut pngout(surface->width, surface->height, out);
 
-    u8 minIndex = 0xff;
-    u8 maxIndex = 0;
-
-    u8* surfaceTexturePixels = (u8*) MMalloc(surface->width * surface->height * 3);
-
-    for (int y = 0; y < surface->height; ++y) {
-        for (int x = 0; x < surface->width; ++x) {
-            u8 index = surface->pixels[x + (y * surface->width)];
-            RGB col = palette[index];
-
-            if (index != 0 && index < minIndex) {
-                minIndex = index;
-            }
+    RGBA32Lut lut;
+    RGBA32Lut_Build(&lut, palette, RGBA32_ORDER_RGBA);
 
-            if (index > maxIndex) {
-                maxIndex = index;
-            }
+    u32 numPixels = surface->width * surface->height;
+    u8* pixels = (u8*) MMalloc(numPixels * 4);
+    Surface_ConvertToRGBA32(surface, &lut, pixels, surface->width * 4);
 
-            int d = (x + (y *  surface->width)) * 3;
-            surfaceTexturePixels[d] = col.r;
-            surfaceTexturePixels[d+1] = col.g;
-            surfaceTexturePixels[d+2] = col.b;
-        }
+    // PNG is written as RGB, drop the alpha bytes in place
+    for (u32 i = 0; i < numPixels; i++) {
+        pixels[i * 3] = pixels[i * 4];
+        pixels[i * 3 + 1] = pixels[i * 4 + 1];
+        pixels[i * 3 + 2] = pixels[i * 4 + 2];
     }
 
-    pngout.write(surfaceTexturePixels, static_cast<size_t>(surface->width * surface->height));
+    pngout.write(pixels, static_cast<size_t>(numPixels));
 
-    MFree(surfaceTexturePixels, surface->width * surface->height * 3);
+    MFree(pixels, numPixels * 4);
 }
 
+#ifdef FINTRO_RASTER_STATS
+MINTERNAL void WriteOverdrawPng(const char* filepath, Surface* surface, RGB* heatmap) {
+    std::ofstream out(filepath, std::ios::binary);
+    TinyPngOut pngout(surface->width, surface->height, out);
+    pngout.write((u8*)heatmap, static_cast<size_t>(surface->width * surface->height));
+}
+#endif
+
 MINTERNAL MReadFileRet Assets_LoadAmigaExeFromDataDir(AssetsReadEnum assetsRead) {
     if (assetsRead == AssetsRead_Amiga_EliteClub) {
         return MFileReadFully("data/FrontierSE.amiga");
@@ -218,26 +219,35 @@ MINTERNAL GLuint CreateTextureForSurface(Surface *surface) {
 }
 
 MINTERNAL void UpdateSurfaceTexture(GLuint glTextureId, Surface* surface, RGB* palette) {
-    for (int y = 0; y < surface->height; ++y) {
-        for (int x = 0; x < surface->width; ++x) {
-            u8 index = surface->pixels[x + (y * surface->width)];
-            RGB col = palette[index];
-
-            if (index != 0 && index < sMinIndex) {
-                sMinIndex = index;
-            }
+#ifdef FINTRO_RASTER_STATS
+    RGB* heatmap = NULL;
+    if (sShowOverdraw || sSaveOverdraw) {
+        heatmap = (RGB*) MMalloc(sizeof(RGB) * surface->width * surface->height);
+        sMaxOverdraw = Surface_OverdrawToRGB(surface, heatmap);
+        if (sSaveOverdraw) {
+            char filepath[64];
+            snprintf(filepath, sizeof(filepath), "overdraw-%05d.png", sOverdrawFrame++);
+            WriteOverdrawPng(filepath, surface, heatmap);
+        }
+    }
+#endif
 
-            if (index > sMaxIndex) {
-                sMaxIndex = index;
-            }
+    RGBA32Lut lut;
+    RGBA32Lut_Build(&lut, palette, RGBA32_ORDER_RGBA);
+    Surface_ConvertToRGBA32(surface, &lut, sSurfaceTexturePixels, surface->width * 4);
 
-            int d = (x + (y *  surface->width)) * 4;
-            sSurfaceTexturePixels[d] = col.r;
-            sSurfaceTexturePixels[d + 1] = col.g;
-            sSurfaceTexturePixels[d + 2] = col.b;
-            sSurfaceTexturePixels[d + 3] = 0xff;
+#ifdef FINTRO_RASTER_STATS
+    if (sShowOverdraw) {
+        for (int i = 0; i < surface->width * surface->height; i++) {
+            sSurfaceTexturePixels[i * 4] = heatmap[i].r;
+            sSurfaceTexturePixels[i * 4 + 1] = heatmap[i].g;
+            sSurfaceTexturePixels[i * 4 + 2] = heatmap[i].b;
         }
     }
+    if (heatmap) {
+        MFree(heatmap, sizeof(RGB) * surface->width * surface->height);
+    }
+#endif
 
     glBindTexture(GL_TEXTURE_2D, glTextureId);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, surface->width, surface->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, sSurfaceTexturePixels);
@@ -410,8 +420,6 @@ int main(int, char**) {
     AssetsReadEnum assetsRead = AssetsRead_Amiga_EliteClub2;
 
     Surface surface;
-    surface.pixels = NULL;
-    surface.insOffset = NULL;
     Surface_Init(&surface, SURFACE_WIDTH, SURFACE_HEIGHT);
 
     FMath_BuildLookupTables();
@@ -937,6 +945,47 @@ int main(int, char**) {
                     ImGui::Text("Render Time: %lld Draw Time: %lld",
                                 curSceneSetup->debug.renderTime, curSceneSetup->debug.drawTime);
 
+                    DepthTree* depthTree = &curSceneSetup->raster->depthTree;
+                    ImGui::Text("Draw Buffer: %x High Water: %x Chunks: %d Nodes: %d",
+                                depthTree->offset, depthTree->highWater, MArraySize(depthTree->chunks),
+                                MArraySize(depthTree->nodes));
+
+                    bool depthSortList = depthTree->sortMode == DEPTHSORT_LIST;
+                    if (ImGui::Checkbox("Depth Sort Draw List", &depthSortList)) {
+                        Raster_SetDepthSort(curSceneSetup->raster, depthSortList ? DEPTHSORT_LIST : DEPTHSORT_TREE);
+                        renderScene = true;
+                    }
+
+                    bool spanBuffer = curSceneSetup->raster->engine == RASTER_ENGINE_SPAN_BUFFER;
+                    if (ImGui::Checkbox("Span Buffer Raster", &spanBuffer)) {
+                        Raster_SetEngine(curSceneSetup->raster, spanBuffer ? RASTER_ENGINE_SPAN_BUFFER : RASTER_ENGINE_PAINTER);
+                        renderScene = true;
+                    }
+
+#ifdef FINTRO_RASTER_STATS
+                    if (ImGui::Checkbox("Show Overdraw", &sShowOverdraw)) {
+                        renderScene = true;
+                    }
+                    ImGui::SameLine();
+                    ImGui::Checkbox("Save Overdraw PNGs", &sSaveOverdraw);
+
+                    Surface* rasterSurface = curSceneSetup->raster->surface;
+                    RasterStats* rasterStats = &rasterSurface->stats;
+                    u32 totalPixels = 0;
+                    for (int i = 0; i < RASTER_STATS_FUNCS; i++) {
+                        totalPixels += rasterStats->pixels[i];
+                    }
+                    u32 surfacePixels = rasterSurface->width * rasterSurface->height;
+                    ImGui::Text("Pixels Written: %d  Overdraw Avg: %.2f  Max: %d",
+                                totalPixels, (float)totalPixels / (float)surfacePixels, sMaxOverdraw);
+                    for (int i = 0; i < RASTER_STATS_FUNCS; i++) {
+                        if (rasterStats->calls[i] || rasterStats->pixels[i]) {
+                            ImGui::Text("    %-18s calls: %6d  pixels: %8d",
+                                        DrawFuncName(i), rasterStats->calls[i], rasterStats->pixels[i]);
+                        }
+                    }
+#endif
+
                     if (curSceneSetup->debug.planetRendered) {
                         ImGui::Text("Planet: ");
                         ImGui::SameLine();
@@ -967,16 +1016,9 @@ int main(int, char**) {
                 ImVec2 imagePos = ImGui::GetCursorScreenPos();
 
                 ImVec2 imageSize;
-#if FINTRO_SCREEN_RES == 1
-                imageSize.x = surface.width * 4;
-                imageSize.y = surface.height * 4;
-#elif FINTRO_SCREEN_RES == 2
-                imageSize.x = surface.width * 2;
-                imageSize.y = surface.height * 2;
-#else
-                imageSize.x = surface.width;
-                imageSize.y = surface.height;
-#endif
+                int imageZoom = surface.res == 1 ? 4 : (surface.res == 2 ? 2 : 1);
+                imageSize.x = surface.width * imageZoom;
+                imageSize.y = surface.height * imageZoom;
                 ImGui::Image((ImTextureID)surfaceTexture, imageSize,
                              ImVec2(0, 0), ImVec2(1, 1), ImColor(255, 255, 255, 255), ImColor(255, 255, 255, 0));
 
@@ -985,16 +1027,8 @@ int main(int, char**) {
                     io.ConfigFlags |= ImGuiConfigFlags_NoMouse;
                     ImGui::SetMouseCursor(ImGuiMouseCursor_None);
                 }
-#if FINTRO_SCREEN_RES == 1
-                mouseX = (mousePos.x - imagePos.x) / 4;
-                mouseY = (mousePos.y - imagePos.y) / 4;
-#elif FINTRO_SCREEN_RES == 2
-                mouseX = (mousePos.x - imagePos.x) / 2;
-                mouseY = (mousePos.y - imagePos.y) / 2;
-#else
-                mouseX = (mousePos.x - imagePos.x);
-                mouseY = (mousePos.y - imagePos.y);
-#endif
+                mouseX = (mousePos.x - imagePos.x) / imageZoom;
+                mouseY = (mousePos.y - imagePos.y) / imageZoom;
                 if (ImGui::RadioButton("Intro", &modelRadio, 0)) {
                     renderScene = true;
                 }
@@ -1297,12 +1331,12 @@ int main(int, char**) {
                     }
                 }
 
-                if (mouseX >= 0 && mouseY >= 0 && mouseX < SURFACE_WIDTH && mouseY < SURFACE_HEIGHT) {
-                    i32 o = mouseY * SURFACE_WIDTH + mouseX;
+                if (mouseX >= 0 && mouseY >= 0 && mouseX < surface.width && mouseY < surface.height) {
+                    i32 o = mouseY * surface.width + mouseX;
                     u32 tmp = surface.insOffset[o];
-                    ImGui::Text("%d,%d (%d, %d) : %05x", mouseX, mouseY, mouseX-SURFACE_WIDTH/2, mouseY-SURFACE_HEIGHT/2, tmp);
+                    ImGui::Text("%d,%d (%d, %d) : %05x", mouseX, mouseY, mouseX-surface.width/2, mouseY-surface.height/2, tmp);
                 } else {
-                    ImGui::Text("%d,%d (%d, %d) : n/a", mouseX, mouseY, mouseX-SURFACE_WIDTH/2, mouseY-SURFACE_HEIGHT/2);
+                    ImGui::Text("%d,%d (%d, %d) : n/a", mouseX, mouseY, mouseX-surface.width/2, mouseY-surface.height/2);
                 }
 
 
@@ -1587,7 +1621,7 @@ int main(int, char**) {
                                 ImGui::SetClipboardText(writer.data());
                             }
                         } else {
-                            hexEditor.DrawContents(raster.depthTree.data, raster.depthTree.size, 0x000);
+                            hexEditor.DrawContents(raster.depthTree.chunks.arr[0].data, DEPTHTREE_CHUNK_SIZE, 0x000);
                         }
                         ImGui::EndTabItem();
                     }
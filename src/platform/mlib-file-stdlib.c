@@ -33,6 +33,17 @@ MReadFileRet MFileReadWithOffset(const char* filePath, u32 offset, u32 readSize)
     return ret;
 }
 
+i32 MFileWriteDataFully(const char* filePath, u8* data, u32 size) {
+    FILE *file = fopen(filePath, "wb");
+    if (file == NULL) {
+        return 0;
+    }
+
+    size_t sizeWritten = fwrite(data, size, 1, file);
+    fclose(file);
+    return (i32)sizeWritten;
+}
+
 MFile MFileWriteOpen(const char* filePath) {
     MFile fileData;
 
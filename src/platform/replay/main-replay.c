@@ -0,0 +1,215 @@
+// Rasterize frames saved with 'fintro -capture <file>', without the models, the VM or any assets.  Used to time the
+// raster stage on its own and to compare raster engines / settings on the same frames.
+//
+//   draw-replay frames.fdc [-repeat 10] [-span-buffer] [-dirty-rects] [-bezier-detail 1] [-csv times.csv]
+//               [-ppm last.ppm]
+//
+// Must be built with the same FINTRO_TRUECOLOUR setting as the build that wrote the capture.
+
+#include <string.h>
+#include <time.h>
+
+#include "render.h"
+
+static const char* sCapturePath = NULL;
+static const char* sCSVPath = NULL;
+static const char* sPPMPath = NULL;
+static i32 sRepeat = 1;
+static RasterEngineEnum sRasterEngine = RASTER_ENGINE_PAINTER;
+static b32 sDirtyRects = FALSE;
+static b32 sBezierDetailSet = FALSE;
+static i32 sBezierDetail = 0;
+
+// Model code isn't run, so no sounds are triggered
+void Audio_PlaySample(AudioContext* audio, u16 sampleIndex, u16 volume) {
+}
+
+static u64 Replay_Micros() {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (u64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static i32 ParseCommandLine(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (arg[0] == '-') {
+            if (MStrCmp("repeat", arg + 1) == 0) {
+                i += 1;
+                if (i >= argc || MParseI32NoSign(argv[i], MStrEnd(argv[i]), &sRepeat) || sRepeat < 1) {
+                    MLog("'-repeat' option requires the number of times to draw each frame.");
+                    MLogf("   %s frames.fdc -repeat 10", argv[0]);
+                    return -1;
+                }
+            } else if (MStrCmp("span-buffer", arg + 1) == 0) {
+                sRasterEngine = RASTER_ENGINE_SPAN_BUFFER;
+            } else if (MStrCmp("dirty-rects", arg + 1) == 0) {
+                sDirtyRects = TRUE;
+            } else if (MStrCmp("bezier-detail", arg + 1) == 0) {
+                i += 1;
+                if (i >= argc || MParseI32(argv[i], MStrEnd(argv[i]), &sBezierDetail)) {
+                    MLog("'-bezier-detail' option requires the detail level.");
+                    MLogf("   %s frames.fdc -bezier-detail -1", argv[0]);
+                    return -1;
+                }
+                sBezierDetailSet = TRUE;
+            } else if (MStrCmp("csv", arg + 1) == 0) {
+                i += 1;
+                if (i >= argc) {
+                    MLog("'-csv' option requires output CSV path.");
+                    MLogf("   %s frames.fdc -csv times.csv", argv[0]);
+                    return -1;
+                }
+                sCSVPath = argv[i];
+            } else if (MStrCmp("ppm", arg + 1) == 0) {
+                i += 1;
+                if (i >= argc) {
+                    MLog("'-ppm' option requires output image path.");
+                    MLogf("   %s frames.fdc -ppm last.ppm", argv[0]);
+                    return -1;
+                }
+                sPPMPath = argv[i];
+            } else {
+                MLogf("Unknown option: %s", arg);
+                return -1;
+            }
+        } else {
+            sCapturePath = arg;
+        }
+    }
+
+    if (!sCapturePath) {
+        MLogf("Usage: %s frames.fdc [-repeat n] [-span-buffer] [-dirty-rects] [-bezier-detail n] [-csv path] "
+              "[-ppm path]", argv[0]);
+        return -1;
+    }
+    return 0;
+}
+
+static void WritePPM(Surface* surface, u16* colours, const char* path) {
+    MMemIO writer;
+    MMemInitAlloc(&writer, surface->width * surface->height * 3 + 32);
+    MStringAppendf(&writer, "P6\n%d %d\n255\n", surface->width, surface->height);
+    u8* rgb = MMemAddBytes(&writer, surface->width * surface->height * 3);
+    for (int i = 0; i < surface->width * surface->height; i++) {
+#ifdef FINTRO_TRUECOLOUR
+        u16 colour = surface->pixels[i];
+#else
+        u16 colour = colours[surface->pixels[i]];
+#endif
+        *rgb++ = ((colour >> 8) & 0xf) * 0x11;
+        *rgb++ = ((colour >> 4) & 0xf) * 0x11;
+        *rgb++ = (colour & 0xf) * 0x11;
+    }
+    MFileWriteDataFully(path, writer.mem, writer.size);
+    MLogf("Wrote last frame to %s", path);
+    MMemFree(&writer);
+}
+
+int main(int argc, char** argv) {
+    int result = ParseCommandLine(argc, argv);
+    if (result) {
+        return result;
+    }
+
+    MReadFileRet captureFile = MFileReadFully(sCapturePath);
+    if (!captureFile.data) {
+        MLogf("Unable to read %s", sCapturePath);
+        return -1;
+    }
+
+    RasterContext raster;
+    memset(&raster, 0, sizeof(raster));
+    Raster_Init(&raster);
+    Raster_SetEngine(&raster, sRasterEngine);
+
+    Surface surface;
+    memset(&surface, 0, sizeof(surface));
+    raster.surface = &surface;
+
+    // Hardware palette, dynamic colours stay set until replaced like on the display
+    u16 colours[256];
+    memset(colours, 0, sizeof(colours));
+
+    MMemIO csv;
+    MMemInitAlloc(&csv, 0x1000);
+    MStringAppend(&csv, "frame,micros\n");
+
+    MMemIO input;
+    MMemReadInit(&input, captureFile.data, captureFile.size);
+    u32 numFrames = 0;
+    u64 totalMicros = 0;
+    u32 minMicros = ~0u;
+    u32 maxMicros = 0;
+    u32 maxFrame = 0;
+    u16 width, height;
+    while (Raster_ReadCapture(&raster, &input, &width, &height)) {
+        if (surface.width != width || surface.height != height) {
+            if (surface.pixels) {
+                Surface_Free(&surface);
+            }
+            Surface_Init(&surface, width, height);
+            Surface_SetDirtyRects(&surface, sDirtyRects);
+        }
+        if (sBezierDetailSet) {
+            raster.bezierDetail = (i8)sBezierDetail;
+        }
+#ifdef FINTRO_TRUECOLOUR
+        SurfacePixel clearColour = raster.paletteContext.backgroundColour & 0xfff;
+#else
+        SurfacePixel clearColour = BACKGROUND_COLOUR_INDEX;
+        Palette_CopyFixedColours16(&raster.paletteContext, colours);
+        Palette_CopyDynamicColours16(&raster.paletteContext, colours);
+#endif
+
+        // Fastest of the repeats, dirty rects only redraws changed rows on the repeats
+        u32 frameMicros = ~0u;
+        for (i32 repeat = 0; repeat < sRepeat; repeat++) {
+            u64 start = Replay_Micros();
+            Raster_ClearAndDraw(&raster, clearColour);
+            u32 micros = (u32)(Replay_Micros() - start);
+            if (micros < frameMicros) {
+                frameMicros = micros;
+            }
+        }
+
+        MStringAppendf(&csv, "%u,%u\n", numFrames, frameMicros);
+
+        totalMicros += frameMicros;
+        if (frameMicros < minMicros) {
+            minMicros = frameMicros;
+        }
+        if (frameMicros > maxMicros) {
+            maxMicros = frameMicros;
+            maxFrame = numFrames;
+        }
+        numFrames++;
+    }
+
+    if (input.pos != input.mem + input.size) {
+        MLogf("Stopped at byte %u of %u, the rest of the capture couldn't be read", (u32)(input.pos - input.mem),
+              input.size);
+    }
+
+    if (numFrames) {
+        MLogf("Drew %u frames: avg %u us, min %u us, max %u us (frame %u)", numFrames, (u32)(totalMicros / numFrames),
+              minMicros, maxMicros, maxFrame);
+        if (sPPMPath) {
+            WritePPM(&surface, colours, sPPMPath);
+        }
+    }
+
+    if (sCSVPath) {
+        MFileWriteDataFully(sCSVPath, csv.mem, csv.size);
+        MLogf("Wrote frame times to %s", sCSVPath);
+    }
+
+    MMemFree(&csv);
+    if (surface.pixels) {
+        Surface_Free(&surface);
+    }
+    Raster_Free(&raster);
+    MFree(captureFile.data, captureFile.size);
+
+    return numFrames ? 0 : -1;
+}
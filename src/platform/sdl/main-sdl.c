@@ -8,6 +8,12 @@
 static b32 sRender = TRUE;
 static b32 sFullscreen = FALSE;
 static int sFrameOffset = 0;
+static u16 sSurfaceWidth = SURFACE_WIDTH;
+static u16 sSurfaceHeight = SURFACE_HEIGHT;
+static u16 sRasterThreads = 1;
+static DepthSortEnum sDepthSort = DEPTHSORT_TREE;
+static RasterEngineEnum sRasterEngine = RASTER_ENGINE_PAINTER;
+static b32 sDirtyRects = FALSE;
 static int sDebugMode = 0;
 static int sPause = 0;
 
@@ -26,33 +32,124 @@ static MMemIO sModelOverrides;
 static ModelsArray sOrigModels;
 static const char* sFileToCompile = NULL;
 static const char* sFileToHotCompile = NULL;
+static const char* sFileToTranslate = NULL;
+static const char* sTranslateOutputPath = NULL;
+static u32Array sTranslateIntroModels;
+#ifdef FINTRO_VM_PROFILE
+static const char* sVMProfilePath = NULL;
+#endif
+#ifdef FINTRO_DETAIL_GOVERNOR
+static u32 sFrameBudgetMicros = 0;
+#endif
+#ifdef FINTRO_PALETTE_STATS
+static const char* sPaletteStatsPath = NULL;
+#endif
+#ifdef FINTRO_DRAW_CAPTURE
+static const char* sDrawCapturePath = NULL;
+static MFile sDrawCaptureFile;
+static MMemIO sDrawCapture; // current frame, appended to the file as soon as it's drawn
+static u32 sDrawCaptureFrames = 0;
+static u64 sDrawCaptureBytes = 0;
+#endif
 
 #define INTRO_OVERRIDES_LE "data/model-overrides-le.dat"
 #define INTRO_OVERRIDES_BE "data/model-overrides-be.dat"
 
-static void UpdateSurfaceTexture(Surface* surface, RGB* palette, u8* pixels, int pitch) {
-    for (int y = 0; y < surface->height; ++y) {
-        for (int x = 0; x < surface->width; ++x) {
-            u8 index = surface->pixels[x + (y * surface->width)];
-            RGB col = palette[index];
-
-            int d = (x * 4) + (y *  pitch);
-            pixels[d] = 0xff;
-            pixels[d+1] = col.b;
-            pixels[d+2] = col.g;
-            pixels[d+3] = col.r;
+#define MAX_DAMAGE_RECTS 16
+
+#ifdef FINTRO_TRUECOLOUR
+// 12bit surface pixels are already SDL_PIXELFORMAT_RGB444, so rows are uploaded as they are
+static void UpdateSurfaceTexture(SDL_Texture* texture, RasterContext* raster, RGB* palette, u8* uploadPixels) {
+    Surface* surface = raster->surface;
+    int pitch = surface->width * (int)sizeof(SurfacePixel);
+    if (!surface->dirty) {
+        SDL_UpdateTexture(texture, NULL, surface->pixels, pitch);
+        return;
+    }
+
+    DamageRect rects[MAX_DAMAGE_RECTS];
+    u32 numRects = Surface_GetDamage(surface, rects, MAX_DAMAGE_RECTS);
+    for (u32 i = 0; i < numRects; i++) {
+        DamageRect* damage = rects + i;
+        SDL_Rect rect = { damage->x1, damage->y1, damage->x2 - damage->x1, damage->y2 - damage->y1 };
+        SDL_UpdateTexture(texture, &rect, surface->pixels + (damage->y1 * surface->width) + damage->x1, pitch);
+    }
+}
+#else
+static void UpdateSurfaceTexture(SDL_Texture* texture, RasterContext* raster, RGB* palette, u8* uploadPixels) {
+    static RGBA32Lut lut;
+    static RGB lutPalette[256];
+    static b32 lutValid = FALSE;
+
+    b32 paletteChanged = !lutValid;
+    for (int i = 0; i < 256 && !paletteChanged; i++) {
+        paletteChanged = palette[i].r != lutPalette[i].r || palette[i].g != lutPalette[i].g ||
+                         palette[i].b != lutPalette[i].b;
+    }
+    if (paletteChanged) {
+        RGBA32Lut_Build(&lut, palette, RGBA32_ORDER_ABGR);
+        for (int i = 0; i < 256; i++) {
+            lutPalette[i] = palette[i];
         }
+        lutValid = TRUE;
+    }
+
+    Surface* surface = raster->surface;
+    if (!surface->dirty || paletteChanged) {
+        int pitch;
+        void* pixels;
+        SDL_LockTexture(texture, NULL, &pixels, &pitch);
+        Raster_ConvertToRGBA32(raster, &lut, (u8*)pixels, (u32)pitch);
+        SDL_UnlockTexture(texture);
+        return;
+    }
+
+    // Palette is the same as last frame, so only the redrawn rows need uploading
+    DamageRect rects[MAX_DAMAGE_RECTS];
+    u32 pitch = surface->width * 4;
+    u32 numRects = Surface_GetDamage(surface, rects, MAX_DAMAGE_RECTS);
+    for (u32 i = 0; i < numRects; i++) {
+        DamageRect* damage = rects + i;
+        Surface_ConvertRowsToRGBA32(surface, &lut, uploadPixels, pitch, damage->y1, damage->y2);
+        SDL_Rect rect = { damage->x1, damage->y1, damage->x2 - damage->x1, damage->y2 - damage->y1 };
+        SDL_UpdateTexture(texture, &rect, uploadPixels + (damage->y1 * pitch) + (damage->x1 * 4), (int)pitch);
     }
 }
+#endif
+
+#ifdef FINTRO_DRAW_CAPTURE
+// Frames are written out as they're drawn, so the frames before a crash are kept.  Replay with draw-replay, see
+// src/platform/replay/main-replay.c
+static void AppendDrawCapture(RasterContext* raster) {
+    MMemReset(&sDrawCapture);
+    Raster_WriteCapture(raster, &sDrawCapture);
+    if (MFileWriteData(&sDrawCaptureFile, sDrawCapture.mem, sDrawCapture.size) <= 0) {
+        MLogf("Unable to write draw capture frame %u, capture stopped", sDrawCaptureFrames);
+        MFileClose(&sDrawCaptureFile);
+        return;
+    }
+    sDrawCaptureFrames++;
+    sDrawCaptureBytes += sDrawCapture.size;
+}
+#endif
 
 static void RenderIntroAtTime(Intro* intro, SceneSetup* sceneSetup, RenderEntity* entity, int frameOffset) {
     Intro_SetSceneForFrameOffset(intro, sceneSetup, entity, frameOffset);
 
     Render_RenderAndDrawScene(sceneSetup, entity, FALSE);
 
+#ifdef FINTRO_DRAW_CAPTURE
+    // Text and other overlays drawn after the 3d scene are not captured
+    if (sDrawCaptureFile.open) {
+        AppendDrawCapture(sceneSetup->raster);
+    }
+#endif
+
     Intro_Post3dRender(intro, sceneSetup, frameOffset);
 
+#ifndef FINTRO_TRUECOLOUR
     Palette_CopyDynamicColoursRGB(&sceneSetup->raster->paletteContext, (RGB*) sFIntroPalette);
+#endif
 }
 
 static MReadFileRet LoadAmigaExe() {
@@ -104,6 +201,59 @@ static i32 ParseCommandLine(int argc, char** argv) {
                         sFrameOffset = offset;
                     }
                 }
+            } else if (MStrCmp("size", arg + 1) == 0) {
+                i += 2;
+                if (i >= argc) {
+                    MLog("'-size' option requires width and height.");
+                    MLogf("   %s -size 2560 1344", argv[0]);
+                    return -1;
+                }
+                i32 width = 0;
+                i32 height = 0;
+                if (MParseI32NoSign(argv[i - 1], MStrEnd(argv[i - 1]), &width) ||
+                    MParseI32NoSign(argv[i], MStrEnd(argv[i]), &height) ||
+                    width < 64 || width > 8192 || height < 64 || height > 8192) {
+                    MLogf("'-size' width and height must be between 64 and 8192, got '%s' '%s'.", argv[i - 1],
+                          argv[i]);
+                    MLogf("   %s -size 2560 1344", argv[0]);
+                    return -1;
+                }
+                sSurfaceWidth = (u16)width;
+                sSurfaceHeight = (u16)height;
+            } else if (MStrCmp("threads", arg + 1) == 0) {
+                i++;
+                if (i >= argc) {
+                    MLog("'-threads' option requires number of raster threads.");
+                    MLogf("   %s -threads 4", argv[0]);
+                    return -1;
+                }
+                const char* arg2 = argv[i];
+                i32 threads = 0;
+                if (!MParseI32NoSign(arg2, MStrEnd(arg2), &threads)) {
+                    if (threads >= 1 && threads <= RASTER_MAX_THREADS) {
+                        sRasterThreads = (u16)threads;
+                    }
+                }
+#ifdef FINTRO_DETAIL_GOVERNOR
+            } else if (MStrCmp("frame-budget", arg + 1) == 0) {
+                i += 1;
+                if (i >= argc) {
+                    MLog("'-frame-budget' option requires render + raster time per frame in microseconds.");
+                    MLogf("   %s -frame-budget 8000", argv[0]);
+                    return -1;
+                }
+                const char* arg2 = argv[i];
+                i32 budget = 0;
+                if (!MParseI32NoSign(arg2, MStrEnd(arg2), &budget)) {
+                    sFrameBudgetMicros = (u32)budget;
+                }
+#endif
+            } else if (MStrCmp("depth-list", arg + 1) == 0) {
+                sDepthSort = DEPTHSORT_LIST;
+            } else if (MStrCmp("span-buffer", arg + 1) == 0) {
+                sRasterEngine = RASTER_ENGINE_SPAN_BUFFER;
+            } else if (MStrCmp("dirty-rects", arg + 1) == 0) {
+                sDirtyRects = TRUE;
             } else if (MStrCmp("dump-intro-models", arg + 1) == 0) {
                 sDumpIntroModels = TRUE;
             } else if (MStrCmp("dump-game-models", arg + 1) == 0) {
@@ -118,6 +268,36 @@ static i32 ParseCommandLine(int argc, char** argv) {
                     return -1;
                 }
                 sFileToCompile = argv[i];
+            } else if (MStrCmp("translate", arg + 1) == 0) {
+                i += 2;
+                if (i >= argc) {
+                    MLog("'-translate' option requires input file and output file.");
+                    MLogf("   %s -translate models.txt src/modelsaot.h", argv[0]);
+                    return -1;
+                }
+                sFileToTranslate = argv[i - 1];
+                sTranslateOutputPath = argv[i];
+            } else if (MStrCmp("translate-intro", arg + 1) == 0) {
+                i += 2;
+                if (i >= argc) {
+                    MLog("'-translate-intro' option requires comma separated model indexes and output file.");
+                    MLogf("   %s -translate-intro 20,34,53 src/modelsaot.h", argv[0]);
+                    return -1;
+                }
+                const char* start = argv[i - 1];
+                const char* end = MStrEnd(start);
+                while (start < end) {
+                    const char* comma = start;
+                    while (comma < end && *comma != ',') {
+                        comma++;
+                    }
+                    i32 modelIndex = 0;
+                    if (!MParseI32NoSign(start, comma, &modelIndex)) {
+                        MArrayAdd(sTranslateIntroModels, modelIndex);
+                    }
+                    start = comma + 1;
+                }
+                sTranslateOutputPath = argv[i];
             } else if (MStrCmp("hot-reload", arg + 1) == 0) {
                 i += 1;
                 if (i >= argc) {
@@ -126,6 +306,36 @@ static i32 ParseCommandLine(int argc, char** argv) {
                     return -1;
                 }
                 sFileToHotCompile = argv[i];
+#ifdef FINTRO_VM_PROFILE
+            } else if (MStrCmp("profile-vm", arg + 1) == 0) {
+                i += 1;
+                if (i >= argc) {
+                    MLog("'-profile-vm' option requires output path prefix.");
+                    MLogf("   %s -profile-vm vmprofile", argv[0]);
+                    return -1;
+                }
+                sVMProfilePath = argv[i];
+#endif
+#ifdef FINTRO_PALETTE_STATS
+            } else if (MStrCmp("palette-stats", arg + 1) == 0) {
+                i += 1;
+                if (i >= argc) {
+                    MLog("'-palette-stats' option requires output CSV path.");
+                    MLogf("   %s -palette-stats palette.csv", argv[0]);
+                    return -1;
+                }
+                sPaletteStatsPath = argv[i];
+#endif
+#ifdef FINTRO_DRAW_CAPTURE
+            } else if (MStrCmp("capture", arg + 1) == 0) {
+                i += 1;
+                if (i >= argc) {
+                    MLog("'-capture' option requires output path.");
+                    MLogf("   %s -capture frames.fdc", argv[0]);
+                    return -1;
+                }
+                sDrawCapturePath = argv[i];
+#endif
             }
         } else {
             sFrontierExePath = arg;
@@ -179,6 +389,50 @@ static void WriteAllModels(ModelsArray* modelsArray, const u8* dataStart) {
     MMemFree(&writer);
 }
 
+#ifdef FINTRO_VM_PROFILE
+// Writes '<pathPrefix>.folded' (collapsed stacks for flamegraph tools) and '<pathPrefix>.csv'
+static void WriteVMProfile(SceneSetup* sceneSetup, const char* pathPrefix) {
+    char path[1024];
+    MMemIO writer;
+    MMemInitAlloc(&writer, 0x1000);
+
+    Render_WriteVMProfileCollapsed(sceneSetup, &writer);
+    snprintf(path, sizeof(path), "%s.folded", pathPrefix);
+    MFileWriteDataFully(path, writer.mem, writer.size);
+    MLogf("Wrote VM profile stacks to %s", path);
+
+    MMemReset(&writer);
+    Render_WriteVMProfileCSV(sceneSetup, &writer);
+    snprintf(path, sizeof(path), "%s.csv", pathPrefix);
+    MFileWriteDataFully(path, writer.mem, writer.size);
+    MLogf("Wrote VM profile summary to %s", path);
+
+    MMemFree(&writer);
+}
+#endif
+
+#ifdef FINTRO_PALETTE_STATS
+static void WritePaletteStats(PaletteContext* palette, const char* path) {
+    MMemIO writer;
+    MMemInitAlloc(&writer, 0x1000);
+    Palette_WriteStatsCSV(palette, &writer);
+    MFileWriteDataFully(path, writer.mem, writer.size);
+    u32 numFrames;
+    Palette_GetFrameStats(palette, &numFrames);
+    MLogf("Wrote palette stats for %u frames to %s", numFrames, path);
+    MMemFree(&writer);
+}
+#endif
+
+#ifdef FINTRO_DRAW_CAPTURE
+static void CloseDrawCapture(const char* path) {
+    MFileClose(&sDrawCaptureFile);
+    MLogf("Wrote %u captured frames (%llu bytes) to %s", sDrawCaptureFrames, (unsigned long long)sDrawCaptureBytes,
+          path);
+    MMemFree(&sDrawCapture);
+}
+#endif
+
 int CompileFileAndWriteOut(const char* fileToCompile, const char* fileOutputPath, MMemIO* memOutput,
                            ModelsArray* modelsArray, ModelEndianEnum endian, b32 dumpModelsToConsole) {
 
@@ -242,6 +496,7 @@ typedef struct LoopContext {
     SDL_Window* window;
     SDL_Renderer* renderer;
     SDL_Texture* texture;
+    u8* uploadPixels; // RGBA32 rows for partial texture updates
 } LoopContext;
 
 static LoopContext sLoopContext;
@@ -362,6 +617,8 @@ void MainLoopIteration() {
                         if (sFileToHotCompile) {
                             HotReload(sLoopContext.assetsData);
                             sLoopContext.introScene.assets.models = sLoopContext.assetsData->introModels;
+                            Render_AnalyseModels(&sLoopContext.introScene);
+                            Render_ResetCompiledModels(&sLoopContext.introScene);
                             sRender = TRUE;
                         }
                     } else if (event.window.event == SDL_WINDOWEVENT_FOCUS_LOST) {
@@ -419,13 +676,8 @@ void MainLoopIteration() {
         Render_DrawBitmapText(&sLoopContext.introScene, frameRateString, pos, 0x7, TRUE);
     }
 
-    int pitch;
-    void* pixels;
-
-    SDL_LockTexture(sLoopContext.texture, NULL, &pixels, &pitch);
-
-    UpdateSurfaceTexture(&sLoopContext.surface, sFIntroPalette, (u8*)pixels, pitch);
-    SDL_UnlockTexture(sLoopContext.texture);
+    UpdateSurfaceTexture(sLoopContext.texture, sLoopContext.introScene.raster, sFIntroPalette,
+                         sLoopContext.uploadPixels);
 
     SDL_RenderClear(sLoopContext.renderer);
     SDL_RenderCopy(sLoopContext.renderer, sLoopContext.texture, NULL, NULL);
@@ -460,6 +712,15 @@ int main(int argc, char**argv) {
         return result;
     }
 
+    if (sFileToTranslate) {
+        MLogf("Translating: %s", sFileToTranslate);
+        result = CompileAndTranslateModels(sFileToTranslate, sTranslateOutputPath);
+        if (result == -1) {
+            MLogf("File not found: %s", sFileToTranslate);
+        }
+        return result;
+    }
+
     // Load intro file data
     MReadFileRet amigaExe = LoadAmigaExe();
     if (amigaExe.size == 0) {
@@ -467,8 +728,14 @@ int main(int argc, char**argv) {
         return -1;
     }
 
-    sLoopContext.surface.pixels = 0;
-    Surface_Init(&sLoopContext.surface, SURFACE_WIDTH, SURFACE_HEIGHT);
+    Surface_Init(&sLoopContext.surface, sSurfaceWidth, sSurfaceHeight);
+    sLoopContext.uploadPixels = NULL;
+    if (sDirtyRects) {
+        Surface_SetDirtyRects(&sLoopContext.surface, TRUE);
+#ifndef FINTRO_TRUECOLOUR
+        sLoopContext.uploadPixels = (u8*)MMalloc(sSurfaceWidth * sSurfaceHeight * 4);
+#endif
+    }
 
     FMath_BuildLookupTables();
 
@@ -476,6 +743,9 @@ int main(int argc, char**argv) {
     raster.surface = &sLoopContext.surface;
     raster.legacy = 0;
     Raster_Init(&raster);
+    Raster_SetNumThreads(&raster, sRasterThreads);
+    Raster_SetDepthSort(&raster, sDepthSort);
+    Raster_SetEngine(&raster, sRasterEngine);
 
     Render_Init(&sLoopContext.introScene, &raster);
     Palette_SetupForNewFrame(&raster.paletteContext, TRUE);
@@ -518,6 +788,39 @@ int main(int argc, char**argv) {
         }
     }
 
+    if (MArraySize(sTranslateIntroModels)) {
+        result = TranslateModelsToFile(&assetsData.introModels, sTranslateIntroModels.arr,
+                                       MArraySize(sTranslateIntroModels), sTranslateOutputPath);
+        MArrayFree(sTranslateIntroModels);
+        return result;
+    }
+
+    sLoopContext.introScene.assets.models = assetsData.introModels;
+    Render_AnalyseModels(&sLoopContext.introScene);
+#ifdef FINTRO_VM_PROFILE
+    if (sVMProfilePath) {
+        Render_SetVMProfile(&sLoopContext.introScene, TRUE);
+    }
+#endif
+#ifdef FINTRO_DETAIL_GOVERNOR
+    Render_SetDetailBudget(&sLoopContext.introScene, sFrameBudgetMicros);
+#endif
+#ifdef FINTRO_PALETTE_STATS
+    if (sPaletteStatsPath) {
+        Palette_SetStatsRecording(&sLoopContext.introScene.raster->paletteContext, TRUE);
+    }
+#endif
+#ifdef FINTRO_DRAW_CAPTURE
+    if (sDrawCapturePath) {
+        sDrawCaptureFile = MFileWriteOpen(sDrawCapturePath);
+        if (!sDrawCaptureFile.open) {
+            MLogf("Unable to open '%s' to write the draw capture", sDrawCapturePath);
+            return -1;
+        }
+        MMemInitAlloc(&sDrawCapture, 0x100000);
+    }
+#endif
+
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER | SDL_INIT_AUDIO) != 0) {
         MLogf("SDL Init Error: %s\n", SDL_GetError());
         return -1;
@@ -543,8 +846,13 @@ int main(int argc, char**argv) {
     sLoopContext.windowWidth = windowWidth;
     sLoopContext.windowHeight = windowHeight;
 
+#ifdef FINTRO_TRUECOLOUR
+    sLoopContext.texture = SDL_CreateTexture(sLoopContext.renderer, SDL_PIXELFORMAT_RGB444, SDL_TEXTUREACCESS_STREAMING,
+            sSurfaceWidth, sSurfaceHeight);
+#else
     sLoopContext.texture = SDL_CreateTexture(sLoopContext.renderer, SDL_PIXELFORMAT_RGBA8888,SDL_TEXTUREACCESS_STREAMING,
-            SURFACE_WIDTH, SURFACE_HEIGHT);
+            sSurfaceWidth, sSurfaceHeight);
+#endif
 
     sClockTickInterval = SDL_GetPerformanceFrequency();
 
@@ -566,6 +874,22 @@ int main(int argc, char**argv) {
         MainLoopIteration();
     }
 
+#ifdef FINTRO_VM_PROFILE
+    if (sVMProfilePath) {
+        WriteVMProfile(&sLoopContext.introScene, sVMProfilePath);
+    }
+#endif
+#ifdef FINTRO_PALETTE_STATS
+    if (sPaletteStatsPath) {
+        WritePaletteStats(&sLoopContext.introScene.raster->paletteContext, sPaletteStatsPath);
+    }
+#endif
+#ifdef FINTRO_DRAW_CAPTURE
+    if (sDrawCapturePath) {
+        CloseDrawCapture(sDrawCapturePath);
+    }
+#endif
+
     Audio_Exit(&sLoopContext.audio);
     Intro_Free(&sLoopContext.intro, &sLoopContext.introScene);
     MArrayFree(overrideModels);
@@ -578,6 +902,9 @@ int main(int argc, char**argv) {
     Render_Free(&sLoopContext.introScene);
     Raster_Free(&raster);
     Surface_Free(&sLoopContext.surface);
+    if (sLoopContext.uploadPixels) {
+        MFree(sLoopContext.uploadPixels, sSurfaceWidth * sSurfaceHeight * 4);
+    }
     Assets_Free(&assetsData);
 
     SDL_DestroyRenderer(sLoopContext.renderer);
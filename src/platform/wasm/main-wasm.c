@@ -9,6 +9,8 @@ typedef struct sWASM_Surface {
     u32 width;
     u32 height;
     u32* rgba;
+    u32 dirtyY1; // Rows of 'rgba' that changed since the last frame
+    u32 dirtyY2;
 } WASM_Surface;
 
 typedef struct sWASM_AudioBuffer {
@@ -64,6 +66,9 @@ typedef struct LoopContext {
     WASM_Surface wasmSurface;
     WASM_AudioBuffer audioBuffer;
     RGB palette[256];
+    RGBA32Lut rgbaLut;
+    RGB rgbaLutPalette[256];
+    b32 rgbaLutValid;
     MBasicAlloc* allocator;
 } LoopContext;
 
@@ -79,21 +84,6 @@ static void StartIntro(u32 currentTimestampMs) {
     Audio_ModStart(&sLoopContext.audio, sAudioAvailableMods[sLoopContext.audioModIndex]);
 }
 
-static void UpdateSurfaceTexture(Surface* surface, RGB* palette, u8* pixels, int pitch) {
-    for (int y = 0; y < surface->height; ++y) {
-        for (int x = 0; x < surface->width; ++x) {
-            u8 index = surface->pixels[x + (y * surface->width)];
-            RGB col = palette[index];
-
-            int d = (x * 4) + (y *  pitch);
-            pixels[d] = 0xff;
-            pixels[d+1] = col.b;
-            pixels[d+2] = col.g;
-            pixels[d+3] = col.r;
-        }
-    }
-}
-
 static void RenderIntroAtTime(Intro* intro, SceneSetup* sceneSetup, RenderEntity* entity, int frameOffset) {
     Intro_SetSceneForFrameOffset(intro, sceneSetup, entity, frameOffset);
 
@@ -101,7 +91,9 @@ static void RenderIntroAtTime(Intro* intro, SceneSetup* sceneSetup, RenderEntity
 
     Intro_Post3dRender(intro, sceneSetup, frameOffset);
 
+#ifndef FINTRO_TRUECOLOUR
     Palette_CopyDynamicColoursRGB(&sceneSetup->raster->paletteContext, (RGB*)sLoopContext.palette);
+#endif
 }
 
 __attribute__((export_name("set_paused")))
@@ -192,8 +184,8 @@ int setup(void) {
         return -1;
     }
 
-    sLoopContext.surface.pixels = 0;
     Surface_Init(&sLoopContext.surface, SURFACE_WIDTH, SURFACE_HEIGHT);
+    Surface_SetDirtyRects(&sLoopContext.surface, TRUE);
 
     FMath_BuildLookupTables();
 
@@ -218,6 +210,7 @@ int setup(void) {
             MArraySet(sLoopContext.introScene.assets.models, i, sLoopContext.overrideModels.arr[i]);
         }
     }
+    Render_AnalyseModels(&sLoopContext.introScene);
 
     sLoopContext.render = TRUE;
     sLoopContext.done = FALSE;
@@ -231,6 +224,9 @@ int setup(void) {
     sLoopContext.wasmSurface.height = sLoopContext.surface.height;
     sLoopContext.rgbaOutput = MMalloc(sLoopContext.wasmSurface.width * sLoopContext.wasmSurface.height * 4);
     sLoopContext.wasmSurface.rgba = sLoopContext.rgbaOutput;
+    sLoopContext.wasmSurface.dirtyY1 = 0;
+    sLoopContext.wasmSurface.dirtyY2 = 0;
+    sLoopContext.rgbaLutValid = FALSE;
 
     return 1;
 }
@@ -257,19 +253,42 @@ WASM_Surface* get_surface() {
     return &sLoopContext.wasmSurface;
 }
 
-static void RenderToRGASurface() {
-    u8* pixels = sLoopContext.surface.pixels;
-    u32* rgbaOutput = sLoopContext.rgbaOutput;
-    for (int y = 0; y < sLoopContext.wasmSurface.height; y++) {
-        for (int x = 0; x < sLoopContext.wasmSurface.width; x++) {
-            RGB* color = sLoopContext.palette + *pixels++;
-            // WASM is little endian and since we are writing 32bits at time, swizzle to abgr
-            u32 rgba = ((((((0xff << 8) + ((u32)color->b))
-                                  << 8) + ((u32)color->g))
-                                  << 8) + ((u32)color->r));
-            *rgbaOutput++ = rgba;
+static void RenderToRGASurface(b32 fullUpdate) {
+#ifdef FINTRO_TRUECOLOUR
+    // The lookup covers every 12bit colour, so never changes
+    b32 paletteChanged = FALSE;
+    if (!sLoopContext.rgbaLutValid) {
+        RGBA32Lut_Build(&sLoopContext.rgbaLut, RGBA32_ORDER_RGBA);
+        sLoopContext.rgbaLutValid = TRUE;
+        fullUpdate = TRUE;
+    }
+#else
+    b32 paletteChanged = !sLoopContext.rgbaLutValid;
+    for (int i = 0; i < 256; i++) {
+        RGB* rgb = sLoopContext.palette + i;
+        RGB* lutRgb = sLoopContext.rgbaLutPalette + i;
+        if (rgb->r != lutRgb->r || rgb->g != lutRgb->g || rgb->b != lutRgb->b) {
+            *lutRgb = *rgb;
+            paletteChanged = TRUE;
+        }
+    }
+    if (paletteChanged) {
+        RGBA32Lut_Build(&sLoopContext.rgbaLut, sLoopContext.palette, RGBA32_ORDER_RGBA);
+        sLoopContext.rgbaLutValid = TRUE;
+    }
+#endif
+
+    // Only the damaged rows need converting and copying to the canvas, unless the palette changed
+    DamageRect damage = { 0, 0, sLoopContext.surface.width, sLoopContext.surface.height };
+    if (!fullUpdate && !paletteChanged) {
+        if (!Surface_GetDamage(&sLoopContext.surface, &damage, 1)) {
+            damage.y1 = damage.y2 = 0;
         }
     }
+    Surface_ConvertRowsToRGBA32(&sLoopContext.surface, &sLoopContext.rgbaLut, (u8*)sLoopContext.rgbaOutput,
+                                sLoopContext.wasmSurface.width * 4, damage.y1, damage.y2);
+    sLoopContext.wasmSurface.dirtyY1 = damage.y1;
+    sLoopContext.wasmSurface.dirtyY2 = damage.y2;
 }
 
 __attribute__((export_name("start_intro_after_interaction")))
@@ -339,7 +358,8 @@ void render(u32 currentTimestampMs) {
             Render_DrawBitmapText(&sLoopContext.introScene, frameRateString, pos, 0x6, TRUE);
         }
     }
-    RenderToRGASurface();
+    // Waiting screen is drawn straight to the surface, without tracking what changed
+    RenderToRGASurface(sLoopContext.waitForInteraction);
 }
 
 __attribute__((export_name("audio_render")))
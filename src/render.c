@@ -9,54 +9,66 @@
 #include "fmath.h"
 #include "audio.h"
 
-#if FINTRO_SCREEN_RES == 1
-#define SCREEN_SCALE 1
-#define ZCLIPNEAR 0x40
-#define ZSCALE 8
-#define STAR_SCALE 0
-#define FONT_SCALE SCREEN_SCALE
-#define TEARDROP_SCALE SCREEN_SCALE
-#define HIGHLIGHTS_SMALL 7
-#define HIGHLIGHTS_BIG 9
-#define HIGHLIGHTS_SIZE 16
-#define PLANET_SCREENSPACE_ATMOS_DIST 0xb2
-#define PLANET_SCREENSPACE_MAJOR_AXIS_MAX 0x600
-#define PLANET_SCREENSPACE_HALF_RENDER 0x199
-#elif FINTRO_SCREEN_RES == 2
-#define SCREEN_SCALE 2
-#define ZCLIPNEAR 0x80
-#define ZSCALE 9
-#define STAR_SCALE (SCREEN_SCALE - 1)
-#define FONT_SCALE SCREEN_SCALE
-#define TEARDROP_SCALE SCREEN_SCALE
-#define HIGHLIGHTS_SMALL 9
-#define HIGHLIGHTS_BIG 22
-#define HIGHLIGHTS_SIZE 32
-#define PLANET_SCREENSPACE_ATMOS_DIST 0x168
-#define PLANET_SCREENSPACE_MAJOR_AXIS_MAX 0xb00
-#define PLANET_SCREENSPACE_HALF_RENDER 0x332
-#elif FINTRO_SCREEN_RES == 3
-#define SCREEN_SCALE 4
-#define ZCLIPNEAR 0x100
-#define ZSCALE 10
-#define STAR_SCALE (SCREEN_SCALE - 1)
-#define FONT_SCALE SCREEN_SCALE
-#define TEARDROP_SCALE 3
-#define HIGHLIGHTS_SMALL 9
-#define HIGHLIGHTS_BIG 22
-#define HIGHLIGHTS_SIZE 32
-#define PLANET_SCREENSPACE_ATMOS_DIST 0x2d0
-#define PLANET_SCREENSPACE_MAJOR_AXIS_MAX 0x1600
-#define PLANET_SCREENSPACE_HALF_RENDER 0x664
-#endif
-
-#define PLANET_CLIP_BORDER (SURFACE_HEIGHT/2)
+#ifdef M_USE_SDL
+// Raster threads
+#include <SDL2/SDL.h>
+#define RASTER_THREADS 1
+#ifdef FINTRO_ENTITY_THREADS
+#define ENTITY_THREADS 1
+#endif
+#endif
+
+static const ScreenParams sScreenParams[SCREEN_RES_MAX] = {
+    // w     h     res scale zscale font teardrop hlSmall hlBig hlSize zclip  atmos  majorMax halfRender
+    {  320,  168,  1,  1,    8,     1,   1,       7,      9,    16,    0x40,  0xb2,  0x600,   0x199 },
+    {  640,  400,  2,  2,    9,     2,   2,       9,      22,   32,    0x80,  0x168, 0xb00,   0x332 },
+    { 1280,  672,  3,  4,    10,    4,   3,       9,      22,   32,    0x100, 0x2d0, 0x1600,  0x664 },
+    { 2560, 1344,  4,  8,    11,    8,   6,       9,      22,   32,    0x200, 0x5a0, 0x2c00,  0xcc8 },
+};
+
+#ifdef FINTRO_SCREEN_RES_FIXED
+// Everything is known at compile time, sizes & scales get folded into constants
+#define SCREEN_PARAMS (sScreenParams[FINTRO_SCREEN_RES - 1])
+#define SCREEN_WIDTH SURFACE_WIDTH
+#define SCREEN_HEIGHT SURFACE_HEIGHT
+#define SURFACE_W(surface) SURFACE_WIDTH
+#define SURFACE_H(surface) SURFACE_HEIGHT
+#else
+// Parameters of the surface this thread is currently rendering or rasterizing to, see Screen_SetForSurface().  Each
+// thread has its own, so surfaces of different sizes can be drawn at the same time.
+#if defined(M_USE_SDL) && defined(_MSC_VER)
+#define SCREEN_THREAD_LOCAL __declspec(thread)
+#elif defined(M_USE_SDL)
+#define SCREEN_THREAD_LOCAL _Thread_local
+#else
+#define SCREEN_THREAD_LOCAL
+#endif
+static SCREEN_THREAD_LOCAL const ScreenParams* sScreen = &sScreenParams[FINTRO_SCREEN_RES - 1];
+#define SCREEN_PARAMS (*sScreen)
+#define SCREEN_WIDTH (sScreen->width)
+#define SCREEN_HEIGHT (sScreen->height)
+#define SURFACE_W(surface) ((surface)->width)
+#define SURFACE_H(surface) ((surface)->height)
+#endif
+
+#define SCREEN_RES (SCREEN_PARAMS.res)
+#define SCREEN_SCALE (SCREEN_PARAMS.screenScale)
+#define ZCLIPNEAR (SCREEN_PARAMS.zClipNear)
+#define ZSCALE (SCREEN_PARAMS.zScale)
+#define FONT_SCALE (SCREEN_PARAMS.fontScale)
+#define TEARDROP_SCALE (SCREEN_PARAMS.teardropScale)
+#define HIGHLIGHTS_SMALL (SCREEN_PARAMS.highlightsSmall)
+#define HIGHLIGHTS_BIG (SCREEN_PARAMS.highlightsBig)
+#define HIGHLIGHTS_SIZE (SCREEN_PARAMS.highlightsSize)
+#define PLANET_SCREENSPACE_ATMOS_DIST (SCREEN_PARAMS.planetScreenspaceAtmosDist)
+#define PLANET_SCREENSPACE_MAJOR_AXIS_MAX (SCREEN_PARAMS.planetScreenspaceMajorAxisMax)
+#define PLANET_SCREENSPACE_HALF_RENDER (SCREEN_PARAMS.planetScreenspaceHalfRender)
+
+#define PLANET_CLIP_BORDER (SCREEN_HEIGHT/2)
 #define BEZIER_STEP_3_LEN 8
 #define BEZIER_STEP_7_LEN 50
 #define BEZIER_STEP_15_LEN 300
 
-#define BACKGROUND_COLOUR_INDEX 0x7f
-
 #ifdef FINTRO_INSPECTOR
 #include "builddata.h"
 #endif
@@ -96,6 +108,7 @@ MINTERNAL void MMemStackFree(MMemStack* memStack) {
 
 MINTERNAL u8* MMemStackAlloc(MMemStack* memStack, size_t size) {
     u8* pos = memStack->pos;
+    MAssert((pos + size <= memStack->mem + memStack->size), "Frame memory stack overflow");
     memStack->pos = pos + size;
     return pos;
 }
@@ -270,24 +283,269 @@ MINTERNAL u8 UpdateClipBits(i16 x, u8 clipBits, u16 w) {
 static u16 sRingedCircleDiametersInner[] = {0, 0, 2, 2, 3, 4, 6, 7, 8, 9 };
 static u16 sRingedCircleDiametersOuter[] = {0, 2, 3, 5, 5, 6, 7, 9, 10, 11 };
 
+// Span fill kernels
+//
+// Long spans and full surface clears dominate raster time at the higher resolutions, so on targets with vector units
+// the fill is done 16/32 bytes at a time.  The kernel is picked once at startup (see SpanFill_InitKernels()), every
+// kernel writes exactly the same bytes as the scalar loop.
+#if !defined(AMIGA) && !defined(M_CLIB_DISABLE) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define SPAN_FILL_SIMD 1
+#define SPAN_FILL_AVX2 1
+#include <immintrin.h>
+#elif !defined(AMIGA) && !defined(M_CLIB_DISABLE) && defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SPAN_FILL_SIMD 1
+#include <emmintrin.h>
+#elif !defined(AMIGA) && !defined(M_CLIB_DISABLE) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define SPAN_FILL_SIMD 1
+#define SPAN_FILL_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Packed vertex batch transform (see VertexBatch_Transform()), SSE2 only for now
+#if defined(SPAN_FILL_SIMD) && !defined(SPAN_FILL_NEON)
+#define VERTEX_BATCH_SIMD 1
+#endif
+
+#ifdef SPAN_FILL_SIMD
+
+// Spans shorter than this are filled inline, the call through the kernel pointer isn't worth it
+#define SPAN_FILL_SIMD_MIN 16
+
+// Fill 'n' pixels from 'dst', n must be >= SPAN_FILL_SIMD_MIN
+typedef void (*SpanFillFunc)(SurfacePixel* restrict dst, SurfacePixel colour, u32 n);
+
+#ifdef FINTRO_TRUECOLOUR
+#define SPAN_FILL_SET1_NEON(colour) vreinterpretq_u8_u16(vdupq_n_u16(colour))
+#define SPAN_FILL_SET1_128(colour) _mm_set1_epi16((short)(colour))
+#define SPAN_FILL_SET1_256(colour) _mm256_set1_epi16((short)(colour))
+#else
+#define SPAN_FILL_SET1_NEON(colour) vdupq_n_u8(colour)
+#define SPAN_FILL_SET1_128(colour) _mm_set1_epi8((char)(colour))
+#define SPAN_FILL_SET1_256(colour) _mm256_set1_epi8((char)(colour))
+#endif
+
+#ifdef SPAN_FILL_NEON
+MINTERNAL void SpanFill_NEON(SurfacePixel* restrict dst, SurfacePixel colour, u32 n) {
+    u8* start = (u8*)dst;
+    u8* end = start + (n * sizeof(SurfacePixel));
+    uint8x16_t c = SPAN_FILL_SET1_NEON(colour);
+    // Unaligned head and tail stores overlap the aligned body, which is fine since every pixel gets the same value
+    vst1q_u8(start, c);
+    u8* p = (u8*)MPtrAlign(start + 1, 16);
+    for (; p + 16 <= end; p += 16) {
+        vst1q_u8(p, c);
+    }
+    vst1q_u8(end - 16, c);
+}
+
+static SpanFillFunc sSpanFill = SpanFill_NEON;
+
+MINTERNAL void SpanFill_InitKernels(void) {
+    // NEON is part of the base aarch64 / armv7-neon ABI, nothing to detect
+}
+#else
+MINTERNAL void SpanFill_SSE2(SurfacePixel* restrict dst, SurfacePixel colour, u32 n) {
+    u8* start = (u8*)dst;
+    u8* end = start + (n * sizeof(SurfacePixel));
+    __m128i c = SPAN_FILL_SET1_128(colour);
+    // Unaligned head and tail stores overlap the aligned body, which is fine since every pixel gets the same value
+    _mm_storeu_si128((__m128i*)start, c);
+    u8* p = (u8*)MPtrAlign(start + 1, 16);
+    for (; p + 16 <= end; p += 16) {
+        _mm_store_si128((__m128i*)p, c);
+    }
+    _mm_storeu_si128((__m128i*)(end - 16), c);
+}
+
+#ifdef SPAN_FILL_AVX2
+__attribute__((target("avx2")))
+MINTERNAL void SpanFill_AVX2(SurfacePixel* restrict dst, SurfacePixel colour, u32 n) {
+    u8* start = (u8*)dst;
+    u8* end = start + (n * sizeof(SurfacePixel));
+    if (end - start < 32) {
+        __m128i c = SPAN_FILL_SET1_128(colour);
+        _mm_storeu_si128((__m128i*)start, c);
+        _mm_storeu_si128((__m128i*)(end - 16), c);
+        return;
+    }
+    __m256i c = SPAN_FILL_SET1_256(colour);
+    _mm256_storeu_si256((__m256i*)start, c);
+    u8* p = (u8*)MPtrAlign(start + 1, 32);
+    for (; p + 32 <= end; p += 32) {
+        _mm256_store_si256((__m256i*)p, c);
+    }
+    _mm256_storeu_si256((__m256i*)(end - 32), c);
+}
+#endif
+
+static SpanFillFunc sSpanFill = SpanFill_SSE2;
+
+MINTERNAL void SpanFill_InitKernels(void) {
+#ifdef SPAN_FILL_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        sSpanFill = SpanFill_AVX2;
+    }
+#endif
+}
+#endif
+
+#endif
+
+// Palette to RGBA32 conversion kernels
+//
+// Front-ends convert the whole surface every frame, each pixel is a single load from a 256 entry (4096 with
+// FINTRO_TRUECOLOUR) u32 table that already holds the pixel in the output byte order (see RGBA32Lut_Build()).  With AVX2 the table lookups are done 8 at
+// a time with a gather, other targets have no gather instruction so unroll the scalar loop instead.
+typedef void (*ConvertRGBA32Func)(const SurfacePixel* restrict src, u32* restrict dest, const u32* restrict lut, u32 n);
+
+MINTERNAL void ConvertRGBA32_Scalar(const SurfacePixel* restrict src, u32* restrict dest, const u32* restrict lut, u32 n) {
+    u32 i = 0;
+    for (; i + 4 <= n; i += 4) {
+        dest[i] = lut[src[i]];
+        dest[i + 1] = lut[src[i + 1]];
+        dest[i + 2] = lut[src[i + 2]];
+        dest[i + 3] = lut[src[i + 3]];
+    }
+    for (; i < n; i++) {
+        dest[i] = lut[src[i]];
+    }
+}
+
+#ifdef SPAN_FILL_AVX2
+__attribute__((target("avx2")))
+MINTERNAL void ConvertRGBA32_AVX2(const SurfacePixel* restrict src, u32* restrict dest, const u32* restrict lut, u32 n) {
+    u32 i = 0;
+    for (; i + 8 <= n; i += 8) {
+#ifdef FINTRO_TRUECOLOUR
+        __m256i index = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src + i)));
+#else
+        __m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + i)));
+#endif
+        __m256i pixels = _mm256_i32gather_epi32((const int*)lut, index, 4);
+        _mm256_storeu_si256((__m256i*)(dest + i), pixels);
+    }
+    for (; i < n; i++) {
+        dest[i] = lut[src[i]];
+    }
+}
+#endif
+
+static ConvertRGBA32Func sConvertRGBA32 = ConvertRGBA32_Scalar;
+
+MINTERNAL void ConvertRGBA32_InitKernels(void) {
+#ifdef SPAN_FILL_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        sConvertRGBA32 = ConvertRGBA32_AVX2;
+    }
+#endif
+}
+
+// Dirty rects
+//
+// Damage is tracked in bands of rows.  Each frame every node is hashed into the bands its bounds overlap, bands whose
+// hash differs from the last frame are cleared & redrawn with the surface clipped to them, the same way the raster
+// threads split the surface.
+#define DIRTY_BAND_SHIFT 3
+#define DIRTY_BAND_ROWS (1 << DIRTY_BAND_SHIFT)
+#define DIRTY_HASH_SEED 0x811c9dc5
+#define DIRTY_HASH_PRIME 0x01000193
+// Node bounds are grown by this much, to cover rounding in the edge steppers
+#define DIRTY_BOUNDS_PAD 2
+
+typedef enum eDirtyBandEnum {
+    DIRTY_BAND_CHANGED = 0x1, // Redrawn by the last frame
+    DIRTY_BAND_OVERLAY = 0x2, // Drawn over outside the depth tree since the last frame
+} DirtyBandEnum;
+
+typedef enum eNodeBoundsEnum {
+    NODEBOUNDS_NONE = 0,
+    NODEBOUNDS_MEASURE = 1, // Nodes are measured & hashed into the dirty bands instead of drawn
+    NODEBOUNDS_CULL = 2,    // Nodes outside the clip band are skipped
+} NodeBoundsEnum;
+
+typedef struct sDirtyRects {
+    u16 width;
+    u16 height;
+    u16 numBands;
+    b32 redrawAll; // Surface contents no longer match the hashes, eg. after a clear
+    SurfacePixel clearColour;
+    u8 paletteIndexes[PALETTE_VIRTUAL_COLOURS]; // Virtual palette mapping the last frame was drawn with
+    u8* bands;     // DirtyBandEnum
+    u32* hashes;   // Hash of the nodes drawn in each band last frame
+    u32* newHashes;
+} DirtyRects;
+
+u8 Surface_ResForSize(u16 width, u16 height) {
+#ifdef FINTRO_SCREEN_RES_FIXED
+    return FINTRO_SCREEN_RES;
+#else
+    u8 res = SCREEN_RES_MAX;
+    while (res > SCREEN_RES_MIN && (width < sScreenParams[res - 1].width || height < sScreenParams[res - 1].height)) {
+        res--;
+    }
+    return res;
+#endif
+}
+
+// Select scaling parameters for rendering to the given surface
+MINTERNAL void Screen_SetForSurface(Surface* surface) {
+#ifndef FINTRO_SCREEN_RES_FIXED
+    sScreen = &surface->screen;
+#endif
+}
+
+MINTERNAL void SpanTemplates_Free(Surface* surface);
+
 void Surface_Init(Surface* surface, u16 width, u16 height) {
-    Surface_Free(surface);
+    memset(surface, 0, sizeof(Surface));
+#ifdef SPAN_FILL_SIMD
+    SpanFill_InitKernels();
+#endif
+    ConvertRGBA32_InitKernels();
     surface->width = width;
     surface->height = height;
-    surface->pixels = (u8*)MMalloc(sizeof(u8) * width * height);
+    surface->res = Surface_ResForSize(width, height);
+    surface->clipY2 = height;
+    surface->screen = sScreenParams[surface->res - 1];
+    surface->screen.width = width;
+    surface->screen.height = height;
+    Screen_SetForSurface(surface);
+    surface->pixels = (SurfacePixel*)MMalloc(sizeof(SurfacePixel) * width * height);
 #ifdef FINTRO_INSPECTOR
     surface->insOffset = (u32*)MMalloc(sizeof(u32) * width * height);
 #endif
+#ifdef FINTRO_RASTER_STATS
+    surface->overdraw = (u16*)MMalloc(sizeof(u16) * width * height);
+#endif
 }
 
 void Surface_Free(Surface* surface) {
-    MFree(surface->pixels, surface->width * surface->height); surface->pixels = 0;
+    MFree(surface->pixels, surface->width * surface->height * sizeof(SurfacePixel)); surface->pixels = 0;
+    Surface_SetDirtyRects(surface, FALSE);
+    SpanTemplates_Free(surface);
 #ifdef FINTRO_INSPECTOR
     MFree(surface->insOffset, surface->width * surface->height * sizeof(u32)); surface->insOffset = 0;
 #endif
+#ifdef FINTRO_RASTER_STATS
+    MFree(surface->overdraw, surface->width * surface->height * sizeof(u16)); surface->overdraw = 0;
+#endif
 }
 
-void Surface_Clear(Surface* surface, u8 colour) {
+void Surface_Clear(Surface* surface, SurfacePixel colour) {
+    if (surface->dirty) {
+        surface->dirty->redrawAll = TRUE;
+    }
+#ifdef FINTRO_RASTER_STATS
+    for (int i = 0; i < surface->width * surface->height; i++) {
+        surface->overdraw[i] = 0;
+    }
+    for (int i = 0; i < RASTER_STATS_FUNCS; i++) {
+        surface->stats.pixels[i] = 0;
+        surface->stats.calls[i] = 0;
+    }
+#endif
 #ifdef FINTRO_INSPECTOR
     surface->insOffsetTmp = 0;
     int d = surface->width * surface->height;
@@ -295,20 +553,26 @@ void Surface_Clear(Surface* surface, u8 colour) {
         surface->pixels[i] = colour;
         surface->insOffset[i] = 0;
     }
+#elif defined(SPAN_FILL_SIMD)
+    sSpanFill(surface->pixels, colour, SURFACE_H(surface) * SURFACE_W(surface));
 #else
     // Clear 4 bytes at a time for optimization purposes, 'pixels' will be at least 4 byte aligned.
     // If we don't do this GCC 6.5 will replace with a generic memset() that runs slower on the Amiga.
     u32* pixels32 = (u32*)surface->pixels;
     u32 colour32 = colour;
-    u32* end = pixels32 + ((SURFACE_HEIGHT * SURFACE_WIDTH) / 4);
+    u32* end = pixels32 + ((SURFACE_H(surface) * SURFACE_W(surface)) / (4 / sizeof(SurfacePixel)));
+#ifdef FINTRO_TRUECOLOUR
+    colour32 = (colour32 << 16) + colour32;
+#else
     colour32 = (colour32 << 24) + (colour32 << 16) + (colour32 << 8) + colour32;
+#endif
     for (; pixels32 < end; pixels32++) {
         *(pixels32) = colour32;
     }
 #endif
 }
 
-static void DrawSpanNoClip(u8* restrict pixelsLine, i16 x1, i16 x2, u8 colour) {
+static void DrawSpanNoClip(SurfacePixel* restrict pixelsLine, i16 x1, i16 x2, SurfacePixel colour) {
 #if defined(AMIGA) && defined(__GNUC__)
     u8* restrict dummy1;
     i16 dummy2;
@@ -329,51 +593,338 @@ static void DrawSpanNoClip(u8* restrict pixelsLine, i16 x1, i16 x2, u8 colour) {
        // 2          3  4  5
     );
 #else
-    u8* restrict cur = pixelsLine + x1;
-    u8* restrict end = pixelsLine + x2;
+    SurfacePixel* restrict cur = pixelsLine + x1;
+    SurfacePixel* restrict end = pixelsLine + x2;
+#ifdef SPAN_FILL_SIMD
+    if (end - cur >= SPAN_FILL_SIMD_MIN) {
+        sSpanFill(cur, colour, (u32)(end - cur));
+        return;
+    }
+#endif
     for (; cur < end; cur++) {
         *cur = colour;
     }
 #endif
 }
 
-MINTERNAL void DrawSpanClipped(Surface* restrict surface, int x1, int y, int x2, u8 colour) {
-    if (y < 0 || y >= SURFACE_HEIGHT) {
+#ifdef FINTRO_RASTER_STATS
+// Count writes to pixels x1 <= x < x2 of the row starting at 'offset'
+MINLINE void RasterStats_Span(Surface* surface, long offset, int x1, int x2) {
+    if (x2 <= x1) {
         return;
     }
+    u16* overdraw = surface->overdraw + offset;
+    for (int x = x1; x < x2; x++) {
+        overdraw[x]++;
+    }
+    surface->stats.pixels[surface->statsFunc] += x2 - x1;
+}
+#define RASTER_STATS_SPAN(surface, offset, x1, x2) RasterStats_Span(surface, offset, x1, x2)
+#else
+#define RASTER_STATS_SPAN(surface, offset, x1, x2)
+#endif
+
+// Span buffer, covered spans are kept per row so nodes drawn front to back only write the pixels still showing.
+// A node's own writes may overlap (it is drawn in its usual order), so spans written by the node drawing a row are
+// held as pending and only merged into the row's covered spans when the next node touches the row.  Rows that run
+// out of span slots fall back to a byte per pixel.
+#define SPANBUFFER_ROW_SPANS 32
+
+typedef enum eSpanBufferMaskEnum {
+    SPANBUFFER_MASK_FREE = 0,
+    SPANBUFFER_MASK_PENDING = 1,
+    SPANBUFFER_MASK_COVERED = 2,
+} SpanBufferMaskEnum;
+
+typedef struct sSpanBufferSpan {
+    i16 x1;
+    i16 x2;
+} SpanBufferSpan;
+
+typedef struct sSpanBufferRow {
+    u32 unit; // Node with pending spans
+    u16 numCovered; // Sorted, non overlapping covered spans
+    u16 numPending; // Spans written by 'unit', following the covered spans
+    u8 full; // Covered spans fill the row
+    u8 fullPending; // A pending span fills the row, already counted in spanFullRows
+    u8 mask; // Out of span slots, coverage is tracked per pixel
+} SpanBufferRow;
+
+typedef struct sSpanBuffer {
+    u16 width;
+    u16 height;
+    SpanBufferRow* rows;
+    SpanBufferSpan* spans; // SPANBUFFER_ROW_SPANS per row
+    u8* mask; // SpanBufferMaskEnum per pixel, only valid for rows in mask mode
+} SpanBuffer;
+
+MINTERNAL SpanBuffer* SpanBuffer_Alloc(u16 width, u16 height) {
+    SpanBuffer* spanBuffer = (SpanBuffer*)MMalloc(sizeof(SpanBuffer));
+    spanBuffer->width = width;
+    spanBuffer->height = height;
+    spanBuffer->rows = (SpanBufferRow*)MMalloc(sizeof(SpanBufferRow) * height);
+    spanBuffer->spans = (SpanBufferSpan*)MMalloc(sizeof(SpanBufferSpan) * SPANBUFFER_ROW_SPANS * height);
+    spanBuffer->mask = (u8*)MMalloc(width * height);
+    return spanBuffer;
+}
+
+MINTERNAL void SpanBuffer_Free(SpanBuffer* spanBuffer) {
+    MFree(spanBuffer->mask, spanBuffer->width * spanBuffer->height);
+    MFree(spanBuffer->spans, sizeof(SpanBufferSpan) * SPANBUFFER_ROW_SPANS * spanBuffer->height);
+    MFree(spanBuffer->rows, sizeof(SpanBufferRow) * spanBuffer->height);
+    MFree(spanBuffer, sizeof(SpanBuffer));
+}
+
+MINTERNAL void SpanBuffer_Clear(SpanBuffer* spanBuffer, u16 y1, u16 y2) {
+    for (u16 y = y1; y < y2; y++) {
+        SpanBufferRow* row = spanBuffer->rows + y;
+        row->unit = 0;
+        row->numCovered = 0;
+        row->numPending = 0;
+        row->full = 0;
+        row->fullPending = 0;
+        row->mask = 0;
+    }
+}
+
+// Switch a row to per pixel coverage, when it has run out of span slots
+MINTERNAL void SpanBufferRow_ToMask(SpanBuffer* spanBuffer, SpanBufferRow* row, int y) {
+    u8* mask = spanBuffer->mask + (y * spanBuffer->width);
+    SpanBufferSpan* spans = spanBuffer->spans + (y * SPANBUFFER_ROW_SPANS);
+    for (int x = 0; x < spanBuffer->width; x++) {
+        mask[x] = SPANBUFFER_MASK_FREE;
+    }
+    for (int i = 0; i < row->numCovered + row->numPending; i++) {
+        u8 state = i < row->numCovered ? SPANBUFFER_MASK_COVERED : SPANBUFFER_MASK_PENDING;
+        for (int x = spans[i].x1; x < spans[i].x2; x++) {
+            mask[x] = state;
+        }
+    }
+    row->mask = 1;
+}
+
+// Merge the pending spans of an earlier node into the covered spans
+MINTERNAL void SpanBufferRow_Commit(Surface* surface, SpanBufferRow* row, int y) {
+    SpanBuffer* spanBuffer = surface->spanBuffer;
+    u16 width = spanBuffer->width;
+
+    if (row->full) {
+        // Nothing more is written to full rows
+    } else if (row->mask) {
+        u8* mask = spanBuffer->mask + (y * width);
+        b32 full = TRUE;
+        for (int x = 0; x < width; x++) {
+            if (mask[x] == SPANBUFFER_MASK_PENDING) {
+                mask[x] = SPANBUFFER_MASK_COVERED;
+            } else if (mask[x] == SPANBUFFER_MASK_FREE) {
+                full = FALSE;
+            }
+        }
+        if (full && !row->fullPending) {
+            surface->spanFullRows++;
+        }
+        row->full = (u8)full;
+    } else if (row->numPending) {
+        SpanBufferSpan* spans = spanBuffer->spans + (y * SPANBUFFER_ROW_SPANS);
+
+        // Insertion sort pending spans into the covered spans, then merge any that overlap or touch
+        u16 num = row->numCovered + row->numPending;
+        for (u16 i = row->numCovered; i < num; i++) {
+            SpanBufferSpan span = spans[i];
+            u16 j = i;
+            for (; j > 0 && spans[j - 1].x1 > span.x1; j--) {
+                spans[j] = spans[j - 1];
+            }
+            spans[j] = span;
+        }
+
+        u16 numCovered = 1;
+        for (u16 i = 1; i < num; i++) {
+            SpanBufferSpan* last = spans + numCovered - 1;
+            if (spans[i].x1 <= last->x2) {
+                if (spans[i].x2 > last->x2) {
+                    last->x2 = spans[i].x2;
+                }
+            } else {
+                spans[numCovered++] = spans[i];
+            }
+        }
+        row->numCovered = numCovered;
+
+        b32 full = numCovered == 1 && spans[0].x1 <= 0 && spans[0].x2 >= width;
+        if (full && !row->fullPending) {
+            surface->spanFullRows++;
+        }
+        row->full = (u8)full;
+    }
+
+    row->numPending = 0;
+    row->fullPending = 0;
+    row->unit = surface->spanUnit;
+}
+
+MINTERNAL void SpanBuffer_DrawVisible(Surface* surface, long offset, int x1, int x2, SurfacePixel colour) {
+#ifdef FINTRO_INSPECTOR
+    for (int x = x1; x < x2; ++x) {
+        surface->insOffset[offset + x] = surface->insOffsetTmp;
+    }
+#endif
+    RASTER_STATS_SPAN(surface, offset, x1, x2);
+    DrawSpanNoClip(surface->pixels + offset, (i16)x1, (i16)x2, colour);
+}
 
+// Fill pixels x1 <= x < x2 of row 'y' that aren't covered by nodes drawn before the current one
+MINTERNAL void SpanBuffer_Fill(Surface* surface, int y, int x1, int x2, SurfacePixel colour) {
+    SpanBuffer* spanBuffer = surface->spanBuffer;
     if (x1 < 0) {
         x1 = 0;
     }
+    if (x2 > spanBuffer->width) {
+        x2 = spanBuffer->width;
+    }
+    if (x2 <= x1) {
+        return;
+    }
+
+    SpanBufferRow* row = spanBuffer->rows + y;
+    if (row->unit != surface->spanUnit) {
+        SpanBufferRow_Commit(surface, row, y);
+    }
+
+    if (row->full) {
+        return;
+    }
+
+    long offset = (long)y * spanBuffer->width;
+
+    if (row->mask) {
+        u8* mask = spanBuffer->mask + offset;
+        int x = x1;
+        while (x < x2) {
+            for (; x < x2 && mask[x] == SPANBUFFER_MASK_COVERED; x++) {}
+            int start = x;
+            for (; x < x2 && mask[x] != SPANBUFFER_MASK_COVERED; x++) {
+                mask[x] = SPANBUFFER_MASK_PENDING;
+            }
+            if (x > start) {
+                SpanBuffer_DrawVisible(surface, offset, start, x, colour);
+            }
+        }
+        if (x1 <= 0 && x2 >= spanBuffer->width && !row->fullPending) {
+            row->fullPending = 1;
+            surface->spanFullRows++;
+        }
+        return;
+    }
+
+    // Draw the gaps between covered spans
+    SpanBufferSpan* spans = spanBuffer->spans + (y * SPANBUFFER_ROW_SPANS);
+    int x = x1;
+    for (u16 i = 0; i < row->numCovered && x < x2; i++) {
+        SpanBufferSpan* span = spans + i;
+        if (span->x2 <= x) {
+            continue;
+        }
+        if (span->x1 >= x2) {
+            break;
+        }
+        if (span->x1 > x) {
+            SpanBuffer_DrawVisible(surface, offset, x, span->x1, colour);
+        }
+        x = span->x2;
+    }
+    if (x < x2) {
+        SpanBuffer_DrawVisible(surface, offset, x, x2, colour);
+    }
+
+    // Record the whole span as pending, its union with the covered spans is the same
+    if (x1 <= 0 && x2 >= spanBuffer->width && !row->fullPending) {
+        row->fullPending = 1;
+        surface->spanFullRows++;
+    }
+    if (row->numPending) {
+        SpanBufferSpan* last = spans + row->numCovered + row->numPending - 1;
+        if (x1 <= last->x2 && x2 >= last->x1) {
+            last->x1 = (i16)(x1 < last->x1 ? x1 : last->x1);
+            last->x2 = (i16)(x2 > last->x2 ? x2 : last->x2);
+            return;
+        }
+    }
+    if (row->numCovered + row->numPending < SPANBUFFER_ROW_SPANS) {
+        SpanBufferSpan* span = spans + row->numCovered + row->numPending;
+        span->x1 = (i16)x1;
+        span->x2 = (i16)x2;
+        row->numPending++;
+    } else {
+        SpanBufferRow_ToMask(spanBuffer, row, y);
+        u8* mask = spanBuffer->mask + offset;
+        for (x = x1; x < x2; x++) {
+            if (mask[x] == SPANBUFFER_MASK_FREE) {
+                mask[x] = SPANBUFFER_MASK_PENDING;
+            }
+        }
+    }
+}
 
-    if (x2 >= SURFACE_WIDTH) {
-        x2 = SURFACE_WIDTH - 1;
+// Draw a span already clipped to the surface
+MINLINE void DrawSpanRow(Surface* restrict surface, int x1, int y, int x2, SurfacePixel colour) {
+    if (surface->spanBuffer) {
+#ifdef FINTRO_INSPECTOR
+        SpanBuffer_Fill(surface, y, x1, x2 + 1, colour);
+#else
+        SpanBuffer_Fill(surface, y, x1, x2, colour);
+#endif
+        return;
     }
 
-    int d = (y * SURFACE_WIDTH);
+    int d = (y * SURFACE_W(surface));
 
 #ifdef FINTRO_INSPECTOR
+    RASTER_STATS_SPAN(surface, d, x1, x2 + 1);
     for (; x1 <= x2; ++x1) {
         surface->pixels[d + x1] = colour;
         surface->insOffset[d + x1] = surface->insOffsetTmp;
     }
 #else
+    RASTER_STATS_SPAN(surface, d, x1, x2);
     DrawSpanNoClip(surface->pixels + d, x1, x2, colour);
 #endif
 }
 
-MINTERNAL void DrawPixel(Surface* surface, int x, int y, u8 colour) {
-    if (y < 0 || y >= surface->height || x < 0 || x >= surface->width) {
+MINTERNAL void DrawSpanClipped(Surface* restrict surface, int x1, int y, int x2, SurfacePixel colour) {
+    if (y < surface->clipY1 || y >= surface->clipY2) {
+        return;
+    }
+
+    if (x1 < 0) {
+        x1 = 0;
+    }
+
+    if (x2 >= SURFACE_W(surface)) {
+        x2 = SURFACE_W(surface) - 1;
+    }
+
+    DrawSpanRow(surface, x1, y, x2, colour);
+}
+
+MINTERNAL void DrawPixel(Surface* surface, int x, int y, SurfacePixel colour) {
+    if (y < surface->clipY1 || y >= surface->clipY2 || x < 0 || x >= surface->width) {
+        return;
+    }
+
+    if (surface->spanBuffer) {
+        SpanBuffer_Fill(surface, y, x, x + 1, colour);
         return;
     }
 
     surface->pixels[y*surface->width + x] = colour;
+    RASTER_STATS_SPAN(surface, y*surface->width, x, x + 1);
 #ifdef FINTRO_INSPECTOR
     surface->insOffset[y*surface->width + x] = surface->insOffsetTmp;
 #endif
 }
 
-void Surface_DrawRect(Surface* surface, int x1, int y1, int x2, int y2, u8 colour) {
+void Surface_DrawRect(Surface* surface, int x1, int y1, int x2, int y2, SurfacePixel colour) {
     if (x1 < 0) {
         x1 = 0;
     }
@@ -399,6 +950,8 @@ void Surface_DrawRect(Surface* surface, int x1, int y1, int x2, int y2, u8 colou
 
     int d1 = x1 + (y1 * surface->width);
     int d2 = x1 + (y2 * surface->width);
+    RASTER_STATS_SPAN(surface, d1, 0, w + 1);
+    RASTER_STATS_SPAN(surface, d2, 0, w + 1);
     for (int i = 0; i < w + 1; i++) {
         surface->pixels[d1 + i] = colour;
         surface->pixels[d2 + i] = colour;
@@ -412,6 +965,8 @@ void Surface_DrawRect(Surface* surface, int x1, int y1, int x2, int y2, u8 colou
         int d = ((i + y1) * surface->width);
         surface->pixels[d + x1] = colour;
         surface->pixels[d + x2] = colour;
+        RASTER_STATS_SPAN(surface, d, x1, x1 + 1);
+        RASTER_STATS_SPAN(surface, d, x2, x2 + 1);
 #ifdef FINTRO_INSPECTOR
         surface->insOffset[d + x1] = surface->insOffsetTmp;
         surface->insOffset[d + x2] = surface->insOffsetTmp;
@@ -419,7 +974,7 @@ void Surface_DrawRect(Surface* surface, int x1, int y1, int x2, int y2, u8 colou
     }
 }
 
-void Surface_DrawRectFill(Surface* surface, int x1, int y1, int x2, int y2, u8 colour) {
+void Surface_DrawRectFill(Surface* surface, int x1, int y1, int x2, int y2, SurfacePixel colour) {
     if (x1 < 0) {
         x1 = 0;
     }
@@ -445,6 +1000,7 @@ void Surface_DrawRectFill(Surface* surface, int x1, int y1, int x2, int y2, u8 c
 
     for (int i = 0; i < h; i++) {
         int d = ((i + y1) * surface->width) + x1;
+        RASTER_STATS_SPAN(surface, d, 0, w);
         for (int j = 0; j < w; j++) {
             surface->pixels[d + j] = colour;
 #ifdef FINTRO_INSPECTOR
@@ -454,7 +1010,196 @@ void Surface_DrawRectFill(Surface* surface, int x1, int y1, int x2, int y2, u8 c
     }
 }
 
-void DrawCircleOutline(Surface* surface, int x, int y, int r, u8 colour) {
+#ifdef FINTRO_RASTER_STATS
+// Heatmap ramp, indexed by writes per pixel, saturates at the last entry
+static const RGB sOverdrawColours[] = {
+    {0x00, 0x00, 0x00},
+    {0x00, 0x00, 0xa0},
+    {0x00, 0xa0, 0x00},
+    {0xe0, 0xe0, 0x00},
+    {0xff, 0x80, 0x00},
+    {0xff, 0x00, 0x00},
+    {0xff, 0x00, 0xff},
+    {0xff, 0xff, 0xff},
+};
+
+u16 Surface_OverdrawToRGB(Surface* surface, RGB* dest) {
+    const u16 maxColour = (sizeof(sOverdrawColours) / sizeof(RGB)) - 1;
+    u16 maxCount = 0;
+    int d = surface->width * surface->height;
+    for (int i = 0; i < d; i++) {
+        u16 count = surface->overdraw[i];
+        if (count > maxCount) {
+            maxCount = count;
+        }
+        dest[i] = sOverdrawColours[count < maxColour ? count : maxColour];
+    }
+    return maxCount;
+}
+#endif
+
+MINLINE RGB Colour12ConvertToRGB(u16 colour12);
+
+#ifdef FINTRO_TRUECOLOUR
+void RGBA32Lut_Build(RGBA32Lut* lut, RGBA32OrderEnum order) {
+#else
+void RGBA32Lut_Build(RGBA32Lut* lut, RGB* palette, RGBA32OrderEnum order) {
+#endif
+    for (int i = 0; i < SURFACE_PIXEL_VALUES; i++) {
+        // Write the bytes in memory order so the table is correct on either endian
+        u8* bytes = (u8*)(lut->pixels + i);
+#ifdef FINTRO_TRUECOLOUR
+        RGB col = Colour12ConvertToRGB((u16)i);
+#else
+        RGB col = palette[i];
+#endif
+        if (order == RGBA32_ORDER_ABGR) {
+            bytes[0] = 0xff;
+            bytes[1] = col.b;
+            bytes[2] = col.g;
+            bytes[3] = col.r;
+        } else {
+            bytes[0] = col.r;
+            bytes[1] = col.g;
+            bytes[2] = col.b;
+            bytes[3] = 0xff;
+        }
+    }
+}
+
+void Surface_ConvertRowsToRGBA32(Surface* surface, const RGBA32Lut* lut, u8* dest, u32 pitch, u16 y1, u16 y2) {
+    SurfacePixel* src = surface->pixels + (y1 * surface->width);
+    dest += y1 * pitch;
+    for (u16 y = y1; y < y2; y++) {
+        sConvertRGBA32(src, (u32*)dest, lut->pixels, surface->width);
+        src += surface->width;
+        dest += pitch;
+    }
+}
+
+void Surface_ConvertToRGBA32(Surface* surface, const RGBA32Lut* lut, u8* dest, u32 pitch) {
+    Surface_ConvertRowsToRGBA32(surface, lut, dest, pitch, 0, surface->height);
+}
+
+MINTERNAL void DirtyRects_Free(DirtyRects* dirty) {
+    MFree(dirty->bands, dirty->numBands);
+    MFree(dirty->hashes, dirty->numBands * sizeof(u32));
+    MFree(dirty->newHashes, dirty->numBands * sizeof(u32));
+    MFree(dirty, sizeof(DirtyRects));
+}
+
+MINTERNAL DirtyRects* DirtyRects_Alloc(u16 width, u16 height) {
+    DirtyRects* dirty = (DirtyRects*)MMalloc(sizeof(DirtyRects));
+    dirty->width = width;
+    dirty->height = height;
+    dirty->numBands = (u16)((height + DIRTY_BAND_ROWS - 1) >> DIRTY_BAND_SHIFT);
+    dirty->redrawAll = TRUE;
+    dirty->clearColour = 0;
+    dirty->bands = (u8*)MMalloc(dirty->numBands);
+    dirty->hashes = (u32*)MMalloc(dirty->numBands * sizeof(u32));
+    dirty->newHashes = (u32*)MMalloc(dirty->numBands * sizeof(u32));
+    for (u16 i = 0; i < dirty->numBands; i++) {
+        dirty->bands[i] = DIRTY_BAND_CHANGED;
+        dirty->hashes[i] = DIRTY_HASH_SEED;
+    }
+    return dirty;
+}
+
+void Surface_SetDirtyRects(Surface* surface, b32 enable) {
+    if (enable && !surface->dirty) {
+        surface->dirty = DirtyRects_Alloc(surface->width, surface->height);
+    } else if (!enable && surface->dirty) {
+        DirtyRects_Free(surface->dirty);
+        surface->dirty = NULL;
+    }
+}
+
+void Surface_AddDamage(Surface* surface, int y1, int y2) {
+    DirtyRects* dirty = surface->dirty;
+    if (!dirty) {
+        return;
+    }
+    if (y1 < 0) {
+        y1 = 0;
+    }
+    if (y2 > dirty->height) {
+        y2 = dirty->height;
+    }
+    for (int y = y1; y < y2; y += DIRTY_BAND_ROWS) {
+        dirty->bands[y >> DIRTY_BAND_SHIFT] |= DIRTY_BAND_OVERLAY;
+    }
+    if (y1 < y2) {
+        dirty->bands[(y2 - 1) >> DIRTY_BAND_SHIFT] |= DIRTY_BAND_OVERLAY;
+    }
+}
+
+u32 Surface_GetDamage(Surface* surface, DamageRect* rects, u32 maxRects) {
+    DirtyRects* dirty = surface->dirty;
+    if (!dirty) {
+        rects[0].x1 = 0;
+        rects[0].y1 = 0;
+        rects[0].x2 = surface->width;
+        rects[0].y2 = surface->height;
+        return 1;
+    }
+
+    u32 numRects = 0;
+    for (u16 i = 0; i < dirty->numBands; i++) {
+        if (!dirty->bands[i]) {
+            continue;
+        }
+        u16 start = i;
+        while (i + 1 < dirty->numBands && dirty->bands[i + 1]) {
+            i++;
+        }
+        u16 y1 = (u16)(start << DIRTY_BAND_SHIFT);
+        u16 y2 = (u16)((i + 1) << DIRTY_BAND_SHIFT);
+        if (y2 > dirty->height) {
+            y2 = dirty->height;
+        }
+        if (numRects == maxRects) {
+            // Out of rects, extend the last one down to cover this one
+            rects[numRects - 1].y2 = y2;
+            continue;
+        }
+        rects[numRects].x1 = 0;
+        rects[numRects].y1 = y1;
+        rects[numRects].x2 = surface->width;
+        rects[numRects].y2 = y2;
+        numRects++;
+    }
+    return numRects;
+}
+
+MINTERNAL void Surface_ClearRows(Surface* surface, u16 y1, u16 y2, SurfacePixel colour) {
+    u32 offset = y1 * SURFACE_W(surface);
+    u32 n = (y2 - y1) * SURFACE_W(surface);
+#ifdef FINTRO_RASTER_STATS
+    for (u32 i = 0; i < n; i++) {
+        surface->overdraw[offset + i] = 0;
+    }
+#endif
+#ifdef FINTRO_INSPECTOR
+    for (u32 i = 0; i < n; i++) {
+        surface->pixels[offset + i] = colour;
+        surface->insOffset[offset + i] = 0;
+    }
+#elif defined(SPAN_FILL_SIMD)
+    if (n >= SPAN_FILL_SIMD_MIN) {
+        sSpanFill(surface->pixels + offset, colour, n);
+    } else {
+        DrawSpanNoClip(surface->pixels + offset, 0, (i16)n, colour);
+    }
+#elif defined(FINTRO_TRUECOLOUR)
+    for (u32 i = 0; i < n; i++) {
+        surface->pixels[offset + i] = colour;
+    }
+#else
+    memset(surface->pixels + offset, colour, n);
+#endif
+}
+
+void DrawCircleOutline(Surface* surface, int x, int y, int r, SurfacePixel colour) {
     int x1 = r;
     int y1 = 0;
     int d = 3 - 2 * r;
@@ -482,7 +1227,7 @@ void DrawCircleOutline(Surface* surface, int x, int y, int r, u8 colour) {
 
 // Axis aligned ellipse - just for debugging
 #ifdef ELLIPSE_DEBUG_FUNC
-void DrawEllipseOutline(Surface* surface, int x0, int y0, int xr, int yr, u8 colour) {
+void DrawEllipseOutline(Surface* surface, int x0, int y0, int xr, int yr, SurfacePixel colour) {
     int xr2 = xr * xr;
     int yr2 = yr * yr;
 
@@ -543,85 +1288,308 @@ void DrawEllipseOutline(Surface* surface, int x0, int y0, int xr, int yr, u8 col
 }
 #endif
 
-void DrawSmallCircle(Surface *surface, int x, int y, int d, u8 colour) {
-    if (x < 2 || x >= SURFACE_WIDTH - 1 || y < 2 || y >= SURFACE_HEIGHT - 1) {
+// Span templates, the spans of a circle or flare are built once per size and reused by every draw of that size.  Each
+// row holds the span's x offsets from the centre, so clipping is resolved once per primitive rather than per span.
+#define SPAN_TEMPLATE_MAX_DIAMETER 255 // Larger circles are built on the stack for each draw
+#define SPAN_TEMPLATE_FLARE_LAYERS 64  // Two layers per flare in sDrawFlareGraphics32
+#define SPAN_TEMPLATE_EMPTY I16_MAX
+
+typedef struct sSpanTemplate {
+    i16* spans; // x1, x2 offset pairs for each row, x1 is SPAN_TEMPLATE_EMPTY for rows without a span
+    i16 y1;     // Row offset of the first row
+    u16 rows;   // Zero until built
+    i16 minX;   // Extent of all the spans
+    i16 maxX;
+} SpanTemplate;
+
+typedef struct sSpanTemplates {
+    SpanTemplate circles[SPAN_TEMPLATE_MAX_DIAMETER + 1];
+    SpanTemplate flares[SPAN_TEMPLATE_FLARE_LAYERS];
+    u8 highlightsSize; // Flare size the flare templates were built for
+} SpanTemplates;
+
+MINTERNAL void SpanTemplate_Init(SpanTemplate* spanTemplate, i16* spans, int y1, int rows) {
+    spanTemplate->spans = spans;
+    spanTemplate->y1 = (i16)y1;
+    spanTemplate->rows = (u16)rows;
+    for (int i = 0; i < rows; i++) {
+        spans[i * 2] = SPAN_TEMPLATE_EMPTY;
+        spans[i * 2 + 1] = SPAN_TEMPLATE_EMPTY;
+    }
+}
+
+// Spans on the same row must overlap, a row only holds their union
+MINTERNAL void SpanTemplate_AddSpan(SpanTemplate* spanTemplate, int x1, int y, int x2) {
+    i16* span = spanTemplate->spans + ((y - spanTemplate->y1) * 2);
+    if (span[0] == SPAN_TEMPLATE_EMPTY) {
+        span[0] = (i16)x1;
+        span[1] = (i16)x2;
+    } else {
+        if (x1 < span[0]) {
+            span[0] = (i16)x1;
+        }
+        if (x2 > span[1]) {
+            span[1] = (i16)x2;
+        }
+    }
+}
+
+MINTERNAL void SpanTemplate_CalcExtent(SpanTemplate* spanTemplate) {
+    spanTemplate->minX = I16_MAX;
+    spanTemplate->maxX = -I16_MAX;
+    for (int i = 0; i < spanTemplate->rows; i++) {
+        i16* span = spanTemplate->spans + (i * 2);
+        if (span[0] != SPAN_TEMPLATE_EMPTY) {
+            if (span[0] < spanTemplate->minX) {
+                spanTemplate->minX = span[0];
+            }
+            if (span[1] > spanTemplate->maxX) {
+                spanTemplate->maxX = span[1];
+            }
+        }
+    }
+}
+
+MINTERNAL void SpanTemplate_Draw(Surface* surface, const SpanTemplate* spanTemplate, int x, int y, SurfacePixel colour) {
+    int w = SURFACE_W(surface);
+    if (x + spanTemplate->maxX < 0 || x + spanTemplate->minX >= w) {
         return;
     }
+
+    int y1 = y + spanTemplate->y1;
+    int y2 = y1 + spanTemplate->rows;
+    const i16* span = spanTemplate->spans;
+    if (y1 < surface->clipY1) {
+        span += (surface->clipY1 - y1) * 2;
+        y1 = surface->clipY1;
+    }
+    if (y2 > surface->clipY2) {
+        y2 = surface->clipY2;
+    }
+
+    if (x + spanTemplate->minX >= 0 && x + spanTemplate->maxX < w) {
+        for (; y1 < y2; y1++, span += 2) {
+            if (span[0] != SPAN_TEMPLATE_EMPTY) {
+                DrawSpanRow(surface, x + span[0], y1, x + span[1], colour);
+            }
+        }
+    } else {
+        for (; y1 < y2; y1++, span += 2) {
+            if (span[0] != SPAN_TEMPLATE_EMPTY) {
+                int x1 = x + span[0];
+                int x2 = x + span[1];
+                if (x1 < 0) {
+                    x1 = 0;
+                }
+                if (x2 >= w) {
+                    x2 = w - 1;
+                }
+                DrawSpanRow(surface, x1, y1, x2, colour);
+            }
+        }
+    }
+}
+
+#define SPAN_TEMPLATE_CIRCLE_RADIUS(diameter) (((diameter) / 2) + 1)
+#define SPAN_TEMPLATE_CIRCLE_ROWS(diameter) ((SPAN_TEMPLATE_CIRCLE_RADIUS(diameter) * 2) + 1)
+
+// Small circles use hand picked spans
+MINTERNAL void SpanTemplate_AddSmallCircle(SpanTemplate* spanTemplate, int d) {
+    int x = 0;
+    int y = 0;
     switch (d) {
         case 0:
-            DrawSpanClipped(surface, x, y, x + 1, colour);
+            SpanTemplate_AddSpan(spanTemplate, x, y, x + 1);
             break;
         case 1:
             x -= 1;
-            DrawSpanClipped(surface, x, y - 1, x + 2, colour);
-            DrawSpanClipped(surface, x, y, x + 2, colour);
+            SpanTemplate_AddSpan(spanTemplate, x, y - 1, x + 2);
+            SpanTemplate_AddSpan(spanTemplate, x, y, x + 2);
             break;
         case 2:
-            DrawSpanClipped(surface, x, y - 1, x + 1, colour);
-            DrawSpanClipped(surface, x - 1, y, x + 2, colour);
-            DrawSpanClipped(surface, x, y + 1, x + 1, colour);
+            SpanTemplate_AddSpan(spanTemplate, x, y - 1, x + 1);
+            SpanTemplate_AddSpan(spanTemplate, x - 1, y, x + 2);
+            SpanTemplate_AddSpan(spanTemplate, x, y + 1, x + 1);
             break;
         case 3:
             x -= 1;
-            DrawSpanClipped(surface, x, y - 1, x + 3, colour);
-            DrawSpanClipped(surface, x, y, x +  3, colour);
-            DrawSpanClipped(surface, x, y + 1, x + 3, colour);
+            SpanTemplate_AddSpan(spanTemplate, x, y - 1, x + 3);
+            SpanTemplate_AddSpan(spanTemplate, x, y, x +  3);
+            SpanTemplate_AddSpan(spanTemplate, x, y + 1, x + 3);
             break;
         case 4:
             x -= 1;
             y -= 1;
-            DrawSpanClipped(surface, x, y++, x + 2, colour);
-            DrawSpanClipped(surface, x - 1, y++, x + 3, colour);
-            DrawSpanClipped(surface, x - 1, y++, x + 3, colour);
-            DrawSpanClipped(surface, x, y, x + 2, colour);
+            SpanTemplate_AddSpan(spanTemplate, x, y++, x + 2);
+            SpanTemplate_AddSpan(spanTemplate, x - 1, y++, x + 3);
+            SpanTemplate_AddSpan(spanTemplate, x - 1, y++, x + 3);
+            SpanTemplate_AddSpan(spanTemplate, x, y, x + 2);
             break;
         case 5:
             y -= 2;
-            DrawSpanClipped(surface, x, y++, x + 1, colour);
-            DrawSpanClipped(surface, x - 1, y++, x + 2, colour);
-            DrawSpanClipped(surface, x - 2, y++, x + 3, colour);
-            DrawSpanClipped(surface, x - 1, y++, x + 2, colour);
-            DrawSpanClipped(surface, x, y, x + 1, colour);
+            SpanTemplate_AddSpan(spanTemplate, x, y++, x + 1);
+            SpanTemplate_AddSpan(spanTemplate, x - 1, y++, x + 2);
+            SpanTemplate_AddSpan(spanTemplate, x - 2, y++, x + 3);
+            SpanTemplate_AddSpan(spanTemplate, x - 1, y++, x + 2);
+            SpanTemplate_AddSpan(spanTemplate, x, y, x + 1);
             break;
     }
 }
 
-void Surface_DrawCircleFill(Surface* surface, int x, int y, int diameter, u8 colour) {
-    if (diameter < 0 || diameter > 0x3f0) {
-        return;
-    }
+MINTERNAL void SpanTemplate_BuildCircle(SpanTemplate* spanTemplate, i16* spans, int diameter) {
+    SpanTemplate_Init(spanTemplate, spans, -SPAN_TEMPLATE_CIRCLE_RADIUS(diameter), SPAN_TEMPLATE_CIRCLE_ROWS(diameter));
 
     if (diameter < 6) {
-        DrawSmallCircle(surface, x, y, diameter, colour);
-        return;
-    }
+        SpanTemplate_AddSmallCircle(spanTemplate, diameter);
+    } else {
+        int x1 = diameter / 2;
+        int y1 = 0;
+        int dx = 1 - diameter;
+        int dy = 1;
+        int errorTerm = 0;
 
-    int x1 = diameter / 2;
-    int y1 = 0;
-    int dx = 1 - diameter;
-    int dy = 1;
-    int errorTerm = 0;
+        while (x1 >= y1) {
+            SpanTemplate_AddSpan(spanTemplate, -x1, y1, x1);
+            SpanTemplate_AddSpan(spanTemplate, -x1, -y1, x1);
+            SpanTemplate_AddSpan(spanTemplate, -y1, x1, y1);
+            SpanTemplate_AddSpan(spanTemplate, -y1, -x1, y1);
+            y1++;
 
-    u8* pixelsLine = surface->pixels;
-    while (x1 >= y1) {
-        DrawSpanClipped(surface, x - x1, y + y1, x + x1, colour);
-        DrawSpanClipped(surface, x - x1, y - y1, x + x1, colour);
-        DrawSpanClipped(surface, x - y1, y + x1, x + y1, colour);
-        DrawSpanClipped(surface, x - y1, y - x1, x + y1, colour);
-        y1++;
+            errorTerm += dy;
+            dy += 2;
+
+            if (2 * errorTerm + dx > 0) {
+                x1--;
+                errorTerm += dx;
+                dx += 2;
+            }
+        }
+    }
 
-        errorTerm += dy;
-        dy += 2;
+    SpanTemplate_CalcExtent(spanTemplate);
+}
 
-        if (2 * errorTerm + dx > 0) {
-            x1--;
-            errorTerm += dx;
-            dx += 2;
+MINTERNAL SpanTemplates* SpanTemplates_Get(Surface* surface) {
+    SpanTemplates* templates = surface->spanTemplates;
+    if (!templates) {
+        templates = (SpanTemplates*)MMalloc(sizeof(SpanTemplates));
+        memset(templates, 0, sizeof(SpanTemplates));
+        templates->highlightsSize = HIGHLIGHTS_SIZE;
+        surface->spanTemplates = templates;
+    }
+    return templates;
+}
+
+MINTERNAL const SpanTemplate* SpanTemplates_Circle(Surface* surface, int diameter) {
+    SpanTemplate* spanTemplate = SpanTemplates_Get(surface)->circles + diameter;
+    if (!spanTemplate->rows) {
+        i16* spans = (i16*)MMalloc(SPAN_TEMPLATE_CIRCLE_ROWS(diameter) * 2 * sizeof(i16));
+        SpanTemplate_BuildCircle(spanTemplate, spans, diameter);
+    }
+    return spanTemplate;
+}
+
+MINTERNAL void SpanTemplates_Free(Surface* surface) {
+    SpanTemplates* templates = surface->spanTemplates;
+    if (!templates) {
+        return;
+    }
+    for (int i = 0; i <= SPAN_TEMPLATE_MAX_DIAMETER; i++) {
+        SpanTemplate* spanTemplate = templates->circles + i;
+        if (spanTemplate->rows) {
+            MFree(spanTemplate->spans, spanTemplate->rows * 2 * sizeof(i16));
+        }
+    }
+    for (int i = 0; i < SPAN_TEMPLATE_FLARE_LAYERS; i++) {
+        SpanTemplate* spanTemplate = templates->flares + i;
+        if (spanTemplate->rows) {
+            MFree(spanTemplate->spans, spanTemplate->rows * 2 * sizeof(i16));
+        }
+    }
+    MFree(templates, sizeof(SpanTemplates));
+    surface->spanTemplates = NULL;
+}
+
+void DrawSmallCircle(Surface *surface, int x, int y, int d, SurfacePixel colour) {
+    if (x < 2 || x >= SURFACE_W(surface) - 1 || y < 2 || y >= SURFACE_H(surface) - 1) {
+        return;
+    }
+    SpanTemplate_Draw(surface, SpanTemplates_Circle(surface, d), x, y, colour);
+}
+
+void Surface_DrawCircleFill(Surface* surface, int x, int y, int diameter, SurfacePixel colour) {
+    if (diameter < 0 || diameter > 0x3f0) {
+        return;
+    }
+
+    if (diameter < 6) {
+        DrawSmallCircle(surface, x, y, diameter, colour);
+        return;
+    }
+
+    if (diameter <= SPAN_TEMPLATE_MAX_DIAMETER) {
+        SpanTemplate_Draw(surface, SpanTemplates_Circle(surface, diameter), x, y, colour);
+        return;
+    }
+
+    // Too big to keep around, build the spans on the stack
+    i16 spans[SPAN_TEMPLATE_CIRCLE_ROWS(0x3f0) * 2];
+    SpanTemplate spanTemplate;
+    SpanTemplate_BuildCircle(&spanTemplate, spans, diameter);
+    SpanTemplate_Draw(surface, &spanTemplate, x, y, colour);
+}
+
+// Draw spans between two edges stepping down from row 'y', rows outside the surface's clip band are skipped.
+// Returns the row following the last span.
+MINLINE int DrawEdgeSpans(Surface* surface, int y, int spansToDraw, int* fx1Out, int dfx1, int* fx2Out, int dfx2,
+                          SurfacePixel colour) {
+    if (spansToDraw <= 0) {
+        return y;
+    }
+
+    int fx1 = *fx1Out;
+    int fx2 = *fx2Out;
+    int yEnd = y + spansToDraw;
+    if (y < surface->clipY1) {
+        int skip = surface->clipY1 - y;
+        if (skip > spansToDraw) {
+            skip = spansToDraw;
+        }
+        // Unsigned so this wraps the same as stepping one row at a time would
+        fx1 = (int)((u32)fx1 + (u32)dfx1 * (u32)skip);
+        fx2 = (int)((u32)fx2 + (u32)dfx2 * (u32)skip);
+        y += skip;
+    }
+
+    int yDrawEnd = yEnd < surface->clipY2 ? yEnd : surface->clipY2;
+    SurfacePixel* pixelsLine = surface->pixels + (SURFACE_W(surface) * y);
+    for (; y < yDrawEnd; ++y) {
+        i16 x1 = (i16)(fx1 >> 16);
+        i16 x2 = (i16)(fx2 >> 16);
+        if (surface->spanBuffer) {
+            SpanBuffer_Fill(surface, y, x1, x2, colour);
+        } else {
+#ifdef FINTRO_INSPECTOR
+            i16 x3 = x1;
+            for (; x3 < x2; ++x3) {
+                long d = pixelsLine - surface->pixels;
+                surface->insOffset[d + x3] = surface->insOffsetTmp;
+            }
+#endif
+            RASTER_STATS_SPAN(surface, pixelsLine - surface->pixels, x1, x2);
+            DrawSpanNoClip(pixelsLine, x1, x2, colour);
         }
+        fx1 += dfx1;
+        fx2 += dfx2;
+        pixelsLine += SURFACE_W(surface);
     }
+
+    *fx1Out = fx1;
+    *fx2Out = fx2;
+    return yEnd;
 }
 
-void Surface_DrawTriFill(Surface* surface, Vec2i16 points[3], u8 colour) {
+void Surface_DrawTriFill(Surface* surface, Vec2i16 points[3], SurfacePixel colour) {
     // Rotate to top y point
     while ((points[0].y > points[1].y) ||
            (points[0].y > points[2].y)) {
@@ -661,23 +1629,7 @@ void Surface_DrawTriFill(Surface* surface, Vec2i16 points[3], u8 colour) {
         incY = 1;
     }
 
-    u8* pixelsLine = surface->pixels + (SURFACE_WIDTH * yPos);
-    i16 xx1, xx2;
-    for (; spansToDraw > 0; --spansToDraw) {
-        xx1 = (i16)(fx1 >> 16);
-        xx2 = (i16)(fx2 >> 16);
-#ifdef FINTRO_INSPECTOR
-        i16 xx3 = xx1;
-        for (; xx3 < xx2; ++xx3) {
-            long d = pixelsLine - surface->pixels;
-            surface->insOffset[d + xx3] = surface->insOffsetTmp;
-        }
-#endif
-        DrawSpanNoClip(pixelsLine, xx1, xx2, colour);
-        fx1 += dfx1;
-        fx2 += dfx2;
-        pixelsLine += SURFACE_WIDTH;
-    }
+    yPos = DrawEdgeSpans(surface, yPos, spansToDraw, &fx1, dfx1, &fx2, dfx2, colour);
 
     // Draw bottom part
     if (incY) {
@@ -713,24 +1665,10 @@ void Surface_DrawTriFill(Surface* surface, Vec2i16 points[3], u8 colour) {
         MSWAP(fx1, fx2, int)
     }
 
-    for (; spansToDraw > 0; --spansToDraw) {
-        xx1 = (i16)(fx1 >> 16);
-        xx2 = (i16)(fx2 >> 16);
-#ifdef FINTRO_INSPECTOR
-        i16 xx3 = xx1;
-        for (; xx3 < xx2; ++xx3) {
-            long d = pixelsLine - surface->pixels;
-            surface->insOffset[d + xx3] = surface->insOffsetTmp;
-        }
-#endif
-        DrawSpanNoClip(pixelsLine, xx1, xx2, colour);
-        fx1 += dfx1;
-        fx2 += dfx2;
-        pixelsLine += SURFACE_WIDTH;
-    }
+    yPos = DrawEdgeSpans(surface, yPos, spansToDraw, &fx1, dfx1, &fx2, dfx2, colour);
 }
 
-void Surface_DrawQuadFill(Surface* surface, Vec2i16 points[4], u8 colour) {
+void Surface_DrawQuadFill(Surface* surface, Vec2i16 points[4], SurfacePixel colour) {
     // Rotate to top y point
     while ((points[0].y > points[1].y) ||
            (points[0].y > points[2].y) ||
@@ -774,23 +1712,7 @@ void Surface_DrawQuadFill(Surface* surface, Vec2i16 points[4], u8 colour) {
     dy1 -= spansToDraw;
     dy2 -= spansToDraw;
 
-    u8* pixelsLine = surface->pixels + (SURFACE_WIDTH * yPos);
-    i16 x1,x2;
-    for (; spansToDraw > 0; --spansToDraw) {
-        x1 = (i16)(fx1 >> 16);
-        x2 = (i16)(fx2 >> 16);
-#ifdef FINTRO_INSPECTOR
-        i16 xx3 = x1;
-        for (; xx3 < x2; ++xx3) {
-            long d = pixelsLine - surface->pixels;
-            surface->insOffset[d + xx3] = surface->insOffsetTmp;
-        }
-#endif
-        DrawSpanNoClip(pixelsLine, (i16)x1, (i16)x2, colour);
-        fx1 += dfx1;
-        fx2 += dfx2;
-        pixelsLine += SURFACE_WIDTH;
-    }
+    yPos = DrawEdgeSpans(surface, yPos, spansToDraw, &fx1, dfx1, &fx2, dfx2, colour);
 
     // Draw mid
     int curr = 0;
@@ -848,21 +1770,7 @@ void Surface_DrawQuadFill(Surface* surface, Vec2i16 points[4], u8 colour) {
         incX = 0;
     }
 
-    for (; spansToDraw > 0; --spansToDraw) {
-        x1 = (i16)(fx1 >> 16);
-        x2 = (i16)(fx2 >> 16);
-#ifdef FINTRO_INSPECTOR
-        i16 xx3 = x1;
-        for (; xx3 < x2; ++xx3) {
-            long d = pixelsLine - surface->pixels;
-            surface->insOffset[d + xx3] = surface->insOffsetTmp;
-        }
-#endif
-        DrawSpanNoClip(pixelsLine, x1, x2, colour);
-        fx1 += dfx1;
-        fx2 += dfx2;
-        pixelsLine += SURFACE_WIDTH;
-    }
+    yPos = DrawEdgeSpans(surface, yPos, spansToDraw, &fx1, dfx1, &fx2, dfx2, colour);
 
     // Draw end
     if (incY) {
@@ -906,35 +1814,22 @@ void Surface_DrawQuadFill(Surface* surface, Vec2i16 points[4], u8 colour) {
         MSWAP(fx1, fx2, int)
     }
 
-    for (; spansToDraw > 0; --spansToDraw) {
-        x1 = (i16)(fx1 >> 16);
-        x2 = (i16)(fx2 >> 16);
-#ifdef FINTRO_INSPECTOR
-        i16 xx3 = x1;
-        for (; xx3 < x2; ++xx3) {
-            long d = pixelsLine - surface->pixels;
-            surface->insOffset[d + xx3] = surface->insOffsetTmp;
-        }
-#endif
-        DrawSpanNoClip(pixelsLine, x1, x2, colour);
-        fx1 += dfx1;
-        fx2 += dfx2;
-        pixelsLine += SURFACE_WIDTH;
-    }
+    yPos = DrawEdgeSpans(surface, yPos, spansToDraw, &fx1, dfx1, &fx2, dfx2, colour);
 }
 
-static i8 sDrawHighlightIndex[] = {
-#if FINTRO_SCREEN_RES == 1
+// Flare diameter for distant light sources, for 16x16 and 32x32 flares
+static i8 sDrawHighlightIndex16[] = {
     -7, -6, -5, -5, -5, -4, -4, -4,
     -4, -3, -3, -3, -3, -2, -2, -2,
     -2, -2, -1, -1, -1, -1, -1, -1,
      0,  0,  0,  0,  0,  0,  0,  0
-#else
+};
+
+static i8 sDrawHighlightIndex32[] = {
     -9, -8, -7, -6, -6, -5, -5, -5,
     -4, -4, -4, -3, -3, -3, -3, -2,
     -2, -2, -2, -2, -1, -1, -1, -1,
     -1, -1,  0,  0,  0,  0,  0,  0
-#endif
 };
 
 // Original resolution flares (16x16)
@@ -1095,6 +1990,50 @@ static u8 sDrawFlareGraphics32[] = {
     0, 1, 1, 1, 2, 4, 6, 7, 8, 9, 10, 10, 11, 11, 12, 15,
 };
 
+MINTERNAL void SpanTemplate_BuildFlareLayer(SpanTemplate* spanTemplate, i16* spans, const u8* flareData) {
+    SpanTemplate_Init(spanTemplate, spans, -((HIGHLIGHTS_SIZE / 2) - 1), HIGHLIGHTS_SIZE - 1);
+
+    // Same spans as DrawFlareLayer()
+    int y = spanTemplate->y1;
+    int i = 0;
+    for (; i < (HIGHLIGHTS_SIZE / 2) - 1; i++) {
+        u8 width = flareData[i];
+        if (width == 0) {
+            continue;
+        }
+
+        int x1 = 1 - width;
+        width = (width << 1) - 1;
+        SpanTemplate_AddSpan(spanTemplate, x1, y + i, x1 + width);
+        SpanTemplate_AddSpan(spanTemplate, x1, y + (HIGHLIGHTS_SIZE - 2) - i, x1 + width);
+    }
+
+    u8 width = flareData[i];
+    int x1 = 1 - width;
+    width = (width << 1) - 1;
+    SpanTemplate_AddSpan(spanTemplate, x1, y + i, x1 + width);
+
+    SpanTemplate_CalcExtent(spanTemplate);
+}
+
+// Returns NULL if the layer is outside the flare graphics
+MINTERNAL const SpanTemplate* SpanTemplates_FlareLayer(Surface* surface, int offset) {
+    SpanTemplates* templates = SpanTemplates_Get(surface);
+    int layerSize = HIGHLIGHTS_SIZE / 2;
+    int tableSize = (HIGHLIGHTS_SIZE == 16) ? sizeof(sDrawFlareGraphics16) : sizeof(sDrawFlareGraphics32);
+    if (templates->highlightsSize != HIGHLIGHTS_SIZE || offset < 0 || offset + layerSize > tableSize) {
+        return NULL;
+    }
+
+    SpanTemplate* spanTemplate = templates->flares + (offset / layerSize);
+    if (!spanTemplate->rows) {
+        const u8* flareData = ((HIGHLIGHTS_SIZE == 16) ? sDrawFlareGraphics16 : sDrawFlareGraphics32) + offset;
+        i16* spans = (i16*)MMalloc((HIGHLIGHTS_SIZE - 1) * 2 * sizeof(i16));
+        SpanTemplate_BuildFlareLayer(spanTemplate, spans, flareData);
+    }
+    return spanTemplate;
+}
+
 void DrawFlareLayer(Surface* surface, i16 x, i16 y, const u8* flareData, int colourIndex) {
     y -= (HIGHLIGHTS_SIZE / 2) - 1;
     x += 1;
@@ -1119,16 +2058,37 @@ void DrawFlareLayer(Surface* surface, i16 x, i16 y, const u8* flareData, int col
 }
 
 void Surface_DrawFlare(Surface* surface, i16 x, i16 y, int diameter, u16 colour1, u16 colour2) {
+    Screen_SetForSurface(surface);
     i16 offset = (i16)((i16)(diameter + HIGHLIGHTS_SMALL) * HIGHLIGHTS_SIZE);
     u8* flareData;
-#if HIGHLIGHTS_SIZE == 16
-    flareData = sDrawFlareGraphics16;
-#else
-    flareData = sDrawFlareGraphics32;
-#endif
-    DrawFlareLayer(surface, x, y, flareData + offset, colour1);
-    DrawFlareLayer(surface, x, y, flareData + offset + (HIGHLIGHTS_SIZE / 2), colour2);
+    if (HIGHLIGHTS_SIZE == 16) {
+        flareData = sDrawFlareGraphics16;
+    } else {
+        flareData = sDrawFlareGraphics32;
+    }
+    const SpanTemplate* layer1 = SpanTemplates_FlareLayer(surface, offset);
+    const SpanTemplate* layer2 = SpanTemplates_FlareLayer(surface, offset + (HIGHLIGHTS_SIZE / 2));
+    if (layer1 && layer2) {
+        SpanTemplate_Draw(surface, layer1, x, y, (SurfacePixel)colour1);
+        SpanTemplate_Draw(surface, layer2, x, y, (SurfacePixel)colour2);
+    } else {
+        DrawFlareLayer(surface, x, y, flareData + offset, colour1);
+        DrawFlareLayer(surface, x, y, flareData + offset + (HIGHLIGHTS_SIZE / 2), colour2);
+    }
+}
+
+#ifdef RASTER_THREADS
+// Build every template up front, raster threads share the surface's templates and can't allocate
+MINTERNAL void SpanTemplates_BuildAll(Surface* surface) {
+    for (int i = 0; i <= SPAN_TEMPLATE_MAX_DIAMETER; i++) {
+        SpanTemplates_Circle(surface, i);
+    }
+    int layerSize = HIGHLIGHTS_SIZE / 2;
+    for (int i = 0; i < SPAN_TEMPLATE_FLARE_LAYERS; i++) {
+        SpanTemplates_FlareLayer(surface, i * layerSize);
+    }
 }
+#endif
 
 typedef struct sBezierSubDivision {
     i32 steps;
@@ -1144,7 +2104,8 @@ typedef struct sBezierSubDivision {
     i32 d3y;
 } BezierSubDivision;
 
-BezierSubDivision InitBezierSubdivision(Vec2i16* pts) {
+// 'detail' scales the curve length used to pick the number of steps, each +1 doubles it and each -1 halves it
+BezierSubDivision InitBezierSubdivision(Vec2i16* pts, i8 detail) {
     BezierSubDivision result;
     result.x = ((i32)pts[0].x) << 16;
     result.y = ((i32)pts[0].y) << 16;
@@ -1169,6 +2130,11 @@ BezierSubDivision InitBezierSubdivision(Vec2i16* pts) {
     lenY = abs(lenY - pts[0].y);
 
     i32 len = lenX + lenY;
+    if (detail > 0) {
+        len <<= detail;
+    } else if (detail < 0) {
+        len >>= -detail;
+    }
     if (len < BEZIER_STEP_3_LEN) {
         result.steps = 3;
         result.scaled = 14;
@@ -1280,6 +2246,19 @@ MINTERNAL void SpanRenderer_AddLine(SpanRenderer* spans, i16 x1, i16 y1, i16 x2,
     i32 ddx = (dx << 16) / dy;
     i32 x32 = x1 << 16;
 
+    // Only build rows within the clip band, stepping x as if the rows above had been built
+    if (y1 < spans->clipY1) {
+        i16 skip = (i16)(spans->clipY1 - y1);
+        if (skip > dy) {
+            skip = (i16)dy;
+        }
+        x32 = (i32)((u32)x32 + (u32)ddx * (u32)skip);
+        y1 += skip;
+    }
+    if (y2 > spans->clipY2) {
+        y2 = spans->clipY2;
+    }
+
     SpanLine* spanLine = spans->spans + y1;
     i16 yRemain = (i16)(y2 - y1);
     for (; yRemain > 0; yRemain--) {
@@ -1290,8 +2269,8 @@ MINTERNAL void SpanRenderer_AddLine(SpanRenderer* spans, i16 x1, i16 y1, i16 x2,
     }
 }
 
-MINTERNAL void SpanRenderer_AddLinesForBezier(SpanRenderer *spans, Vec2i16* pts) {
-    BezierSubDivision subDivision = InitBezierSubdivision(pts);
+MINTERNAL void SpanRenderer_AddLinesForBezier(SpanRenderer *spans, Vec2i16* pts, i8 detail) {
+    BezierSubDivision subDivision = InitBezierSubdivision(pts, detail);
 
     for (i32 i = 0; i <= subDivision.steps; i++) {
         i32 x1 = subDivision.x >> 16;
@@ -1318,6 +2297,8 @@ MINTERNAL void SpanRenderer_Clear(SpanRenderer *spanRenderer) {
     spanRenderer->height = 0;
     spanRenderer->spanStart = 0;
     spanRenderer->spanEnd = 0;
+    spanRenderer->clipY1 = 0;
+    spanRenderer->clipY2 = I16_MAX;
 }
 
 MINTERNAL void SpanRenderer_Free(SpanRenderer *spanRenderer) {
@@ -1368,11 +2349,19 @@ MINTERNAL void SpanRenderer_Print(SpanRenderer* spans, Surface* surface) {
     MLog("done");
 }
 
-MINTERNAL void SpanRenderer_Draw(SpanRenderer *spans, Surface *surface, u8 colour) {
+MINTERNAL void SpanRenderer_Draw(SpanRenderer *spans, Surface *surface, SurfacePixel colour) {
     // SpanPrint(spans, surface);
-    u8* pixelsLine = surface->pixels + (spans->spanStart * SURFACE_WIDTH);
-    SpanLine* spanLine = spans->spans + spans->spanStart;
-    i16 rowsLeft =  (i16)(spans->spanEnd - spans->spanStart);
+    i16 spanStart = spans->spanStart;
+    i16 spanEnd = spans->spanEnd;
+    if (spanStart < (i16)surface->clipY1) {
+        spanStart = (i16)surface->clipY1;
+    }
+    if (spanEnd >= (i16)surface->clipY2) {
+        spanEnd = (i16)(surface->clipY2 - 1);
+    }
+    SurfacePixel* pixelsLine = surface->pixels + (spanStart * SURFACE_W(surface));
+    SpanLine* spanLine = spans->spans + spanStart;
+    i16 rowsLeft =  (i16)(spanEnd - spanStart);
     for (; rowsLeft >= 0; rowsLeft--) {
         for (u16 i = 0; (i + 1) < spanLine->num; i += 2) {
             i16 x1 = spanLine->span[i];
@@ -1382,8 +2371,13 @@ MINTERNAL void SpanRenderer_Draw(SpanRenderer *spans, Surface *surface, u8 colou
                 x1 = 0;
             }
 
-            if (x2 > SURFACE_WIDTH) {
-                x2 = SURFACE_WIDTH;
+            if (x2 > SURFACE_W(surface)) {
+                x2 = SURFACE_W(surface);
+            }
+
+            if (surface->spanBuffer) {
+                SpanBuffer_Fill(surface, (int)(spanLine - spans->spans), x1, x2, colour);
+                continue;
             }
 
 #ifdef FINTRO_INSPECTOR
@@ -1393,9 +2387,10 @@ MINTERNAL void SpanRenderer_Draw(SpanRenderer *spans, Surface *surface, u8 colou
                 surface->insOffset[d + x3] = surface->insOffsetTmp;
             }
 #endif
+            RASTER_STATS_SPAN(surface, pixelsLine - surface->pixels, x1, x2);
             DrawSpanNoClip(pixelsLine, x1, x2, colour);
         }
-        pixelsLine += SURFACE_WIDTH;
+        pixelsLine += SURFACE_W(surface);
         spanLine++;
     }
 }
@@ -1407,6 +2402,8 @@ MINTERNAL void BodySpans_Clear(BodySpanRenderer* spanRenderer) {
     spanRenderer->spanStart = 0;
     spanRenderer->spanEnd = 0;
     spanRenderer->height = 0;
+    spanRenderer->clipY1 = 0;
+    spanRenderer->clipY2 = I16_MAX;
 }
 
 MINTERNAL void BodySpans_Free(BodySpanRenderer* spanRenderer) {
@@ -1501,6 +2498,19 @@ MINTERNAL void BodySpans_AddLine(BodySpanRenderer* spans, i16 x1, i16 y1, i16 x2
     int decInc = (dx << 16) / dy;
     i32 d1 = x1 << 16;
 
+    // Only build rows within the clip band, stepping x as if the rows above had been built
+    if (y1 < spans->clipY1) {
+        i16 skip = (i16)(spans->clipY1 - y1);
+        if (skip > dy) {
+            skip = (i16)dy;
+        }
+        d1 = (i32)((u32)d1 + (u32)decInc * (u32)skip);
+        y1 += skip;
+    }
+    if (y2 > spans->clipY2) {
+        y2 = spans->clipY2;
+    }
+
     BodySpan* spanLine = spans->spans + y1;
     for (; y1 < y2; y1 += 1) {
         i16 x = (i16)(d1 >> 16);
@@ -1510,8 +2520,8 @@ MINTERNAL void BodySpans_AddLine(BodySpanRenderer* spans, i16 x1, i16 y1, i16 x2
     }
 }
 
-MINTERNAL void BodySpans_AddBezier(BodySpanRenderer* spanRenderer, Vec2i16* pts, u16 colour) {
-    BezierSubDivision subDivision = InitBezierSubdivision(pts);
+MINTERNAL void BodySpans_AddBezier(BodySpanRenderer* spanRenderer, Vec2i16* pts, u16 colour, i8 detail) {
+    BezierSubDivision subDivision = InitBezierSubdivision(pts, detail);
 
     for (i32 i = 0; i <= subDivision.steps; i++) {
         i32 x1 = subDivision.x >> 16;
@@ -1542,7 +2552,7 @@ MINTERNAL void BodySpans_Print(BodySpanRenderer* spans) {
 
     u16 rowBeginColour = spans->rowBeginColour[spans->height - 1];
     u16* rowBeginColours = spans->rowBeginColour + cSpanY + 1;
-    if (cSpanY >= SURFACE_HEIGHT - 1) {
+    if (cSpanY >= SCREEN_HEIGHT - 1) {
         rowBeginColour = 0;
     }
 
@@ -1597,11 +2607,11 @@ MINTERNAL void BodySpans_Draw(BodySpanRenderer* spans, Surface* surface) {
     u16* rowBeginColours = spans->rowBeginColour + cSpansY + 1;
     u16 endColourEncoded = spans->rowBeginColour[spans->height - 1];
 
-    if (cSpansY >= SURFACE_HEIGHT - 1) {
+    if (cSpansY >= SURFACE_H(surface) - 1) {
         endColourEncoded = 0;
     }
 
-    u8* pixelsLine = surface->pixels + (cSpansY * SURFACE_WIDTH);
+    SurfacePixel* pixelsLine = surface->pixels + (cSpansY * SURFACE_W(surface));
 
     do {
         rowBeginColours--;
@@ -1610,7 +2620,14 @@ MINTERNAL void BodySpans_Draw(BodySpanRenderer* spans, Surface* surface) {
         endColourEncoded = prevEncodedColour ^ beginColour;
         i16 nSpansRow = (i16)bodySpan->num;
 
-        if (nSpansRow > 1) {
+        // Rows below the clip band are still walked, to track the colour coming into the rows above
+        if (nSpansRow > 1 && cSpansY < surface->clipY2 && cSpansY >= surface->clipY1) {
+            // The walk below can read one span past the end of the row, make that an empty span rather than whatever
+            // an earlier body left there, otherwise the result depends on the order bodies are drawn in
+            if (nSpansRow < BODY_MAX_SPANS) {
+                bodySpan->s[nSpansRow].x = 0;
+                bodySpan->s[nSpansRow].colour = 0;
+            }
             u16 curColour = beginColour;
             i16 j = nSpansRow;
             Span* span;
@@ -1628,23 +2645,33 @@ MINTERNAL void BodySpans_Draw(BodySpanRenderer* spans, Surface* surface) {
                 if (x1 < 0) {
                     x1 = 0;
                 }
-                if (x1 < SURFACE_WIDTH) {
+                if (x1 < SURFACE_W(surface)) {
                     span++;
                     i16 x2 = span->x;
                     if (x2 >= 0) {
-                        if (x2 >= SURFACE_WIDTH) {
-                            x2 = SURFACE_WIDTH - 1;
+                        if (x2 >= SURFACE_W(surface)) {
+                            x2 = SURFACE_W(surface) - 1;
                         }
                         u16 colour = spans->colours[curColour / 4];
+                        if (surface->spanBuffer) {
 #ifdef FINTRO_INSPECTOR
-                        int d = (cSpansY * SURFACE_WIDTH);
-                        for (; x1 <= x2; ++x1) {
-                            pixelsLine[x1] = colour;
-                            surface->insOffset[d + x1] = surface->insOffsetTmp;
-                        }
+                            SpanBuffer_Fill(surface, cSpansY, x1, x2 + 1, (SurfacePixel)colour);
+#else
+                            SpanBuffer_Fill(surface, cSpansY, x1, x2, (SurfacePixel)colour);
+#endif
+                        } else {
+#ifdef FINTRO_INSPECTOR
+                            int d = (cSpansY * SURFACE_W(surface));
+                            RASTER_STATS_SPAN(surface, d, x1, x2 + 1);
+                            for (; x1 <= x2; ++x1) {
+                                pixelsLine[x1] = colour;
+                                surface->insOffset[d + x1] = surface->insOffsetTmp;
+                            }
 #else
-                        DrawSpanNoClip(pixelsLine, x1, x2, colour);
+                            RASTER_STATS_SPAN(surface, pixelsLine - surface->pixels, x1, x2);
+                            DrawSpanNoClip(pixelsLine, x1, x2, colour);
 #endif
+                        }
                     }
                 }
                 u16 colour = span->colour;
@@ -1657,11 +2684,11 @@ MINTERNAL void BodySpans_Draw(BodySpanRenderer* spans, Surface* surface) {
         }
         bodySpan--;
         cSpansY--;
-        pixelsLine -= SURFACE_WIDTH;
-    } while (cSpansY >= spans->spanStart);
+        pixelsLine -= SURFACE_W(surface);
+    } while (cSpansY >= spans->spanStart && cSpansY >= surface->clipY1);
 }
 
-void Surface_DrawLine(Surface* surface, int x1, int y1, int x2, int y2, u8 colour) {
+void Surface_DrawLine(Surface* surface, int x1, int y1, int x2, int y2, SurfacePixel colour) {
     // MLogf("%d,%d -> %d,%d", x1, y1, x2, y2);
 
     if (y1 > y2) {
@@ -1675,17 +2702,28 @@ void Surface_DrawLine(Surface* surface, int x1, int y1, int x2, int y2, u8 colou
     if (yLen > abs(xLen)) {
         int fixedDelta = (yLen == 0) ? 0 : ((xLen << 16) / yLen);
         int x = 0x8000 + (x1 << 16);
-        u8* pixels = surface->pixels + y1 * SURFACE_WIDTH;
+        SurfacePixel* pixels = surface->pixels + y1 * SURFACE_W(surface);
+        int y = y1;
         while (yLen >= 0) {
-            pixels[(x >> 16)] = colour;
+            if (y >= surface->clipY1 && y < surface->clipY2) {
+                if (surface->spanBuffer) {
+                    SpanBuffer_Fill(surface, y, x >> 16, (x >> 16) + 1, colour);
+                } else {
+                    pixels[(x >> 16)] = colour;
+                    RASTER_STATS_SPAN(surface, pixels - surface->pixels, x >> 16, (x >> 16) + 1);
+                }
+            }
+            y++;
             x += fixedDelta;
-            pixels += SURFACE_WIDTH;
+            pixels += SURFACE_W(surface);
             yLen--;
         }
     } else {
-        int deltaY = SURFACE_WIDTH;
+        int deltaY = SURFACE_W(surface);
+        int yStep = 1;
         if (xLen < 0) {
             deltaY = -deltaY;
+            yStep = -1;
             y1 = y2;
             x1 = x2;
             xLen = - xLen;
@@ -1693,19 +2731,27 @@ void Surface_DrawLine(Surface* surface, int x1, int y1, int x2, int y2, u8 colou
         int fixedDelta = ((((xLen + 1) << 16)) / (yLen + 1));
         int xx1 = ((x1) << 16) + 0x8000;
         int xx2 = xx1;
-        u8* pixelsLine = surface->pixels + y1 * SURFACE_WIDTH;
+        SurfacePixel* pixelsLine = surface->pixels + y1 * SURFACE_W(surface);
         while (yLen >= 0) {
             xx2 += fixedDelta;
             x1 = (xx1 >> 16);
             x2 = (xx2 >> 16);
+            if (y1 >= surface->clipY1 && y1 < surface->clipY2) {
+                if (surface->spanBuffer) {
+                    SpanBuffer_Fill(surface, y1, x1, x2, colour);
+                } else {
 #ifdef FINTRO_INSPECTOR
-            i16 x3 = x1;
-            for (; x3 < x2; ++x3) {
-                long d = pixelsLine - surface->pixels;
-                surface->insOffset[d + x3] = surface->insOffsetTmp;
-            }
+                    i16 x3 = x1;
+                    for (; x3 < x2; ++x3) {
+                        long d = pixelsLine - surface->pixels;
+                        surface->insOffset[d + x3] = surface->insOffsetTmp;
+                    }
 #endif
-            DrawSpanNoClip(pixelsLine, x1, x2, colour);
+                    RASTER_STATS_SPAN(surface, pixelsLine - surface->pixels, x1, x2);
+                    DrawSpanNoClip(pixelsLine, x1, x2, colour);
+                }
+            }
+            y1 += yStep;
             pixelsLine += deltaY;
             yLen--;
             xx1 = xx2;
@@ -1713,8 +2759,8 @@ void Surface_DrawLine(Surface* surface, int x1, int y1, int x2, int y2, u8 colou
     }
 }
 
-MINTERNAL void Surface_DrawBezierLine(Surface* surface, Vec2i16* pts, u8 colour) {
-    BezierSubDivision subDivision = InitBezierSubdivision(pts);
+MINTERNAL void Surface_DrawBezierLine(Surface* surface, Vec2i16* pts, SurfacePixel colour, i8 detail) {
+    BezierSubDivision subDivision = InitBezierSubdivision(pts, detail);
 
     for (i32 i = 0; i <= subDivision.steps; i++) {
         Vec2i16 start;
@@ -1739,7 +2785,7 @@ MINTERNAL void Surface_DrawBezierLine(Surface* surface, Vec2i16* pts, u8 colour)
     }
 }
 
-void Surface_DrawLineClipped(Surface* surface, int x1, int y1, int x2, int y2, u8 colour) {
+void Surface_DrawLineClipped(Surface* surface, int x1, int y1, int x2, int y2, SurfacePixel colour) {
     Vec2i16 p1;
     p1.x = x1;
     p1.y = y1;
@@ -1759,21 +2805,195 @@ void Surface_DrawLineClipped(Surface* surface, int x1, int y1, int x2, int y2, u
     }
 }
 
-MINLINE u8 Palette_GetDynamicColourIndex(RasterContext* context, u8 paletteIndex) {
+#ifdef ENTITY_THREADS
+// Set while entity workers run, heap tracking isn't thread safe so worker arrays & depth tree chunks grow under it
+static SDL_mutex* sEntityHeapLock;
+
+#define WorkerArrayAdd(a, v) do { \
+    if (sEntityHeapLock && MArraySize(a) == (a).p.capacity) { \
+        SDL_LockMutex(sEntityHeapLock); \
+        MArrayAdd(a, v); \
+        SDL_UnlockMutex(sEntityHeapLock); \
+    } else { \
+        MArrayAdd(a, v); \
+    } \
+} while (0)
+#else
+#define WorkerArrayAdd(a, v) MArrayAdd(a, v)
+#endif
+
+#ifdef DEPTHTREE_LOG
+enum DepthTreeEventEnum {
+    DEPTHTREE_EVENT_NODE = 0,   // Node added at depth 'z', its data starts at the node's draw func
+    DEPTHTREE_EVENT_APPEND = 1, // Draw func appended to the current node
+    DEPTHTREE_EVENT_PUSH = 2,   // Sub tree pushed at depth 'z'
+    DEPTHTREE_EVENT_POP = 3,    // Sub tree popped
+};
+
+typedef struct sDepthTreeEvent {
+    u32 z;
+    u32 before; // Depth tree offset before the event, ends the data of the previous event
+    u32 start;  // Offset of the event's data, which runs up to the next event
+    u8 type;
+} DepthTreeEvent;
+
+MARRAY_TYPEDEF(DepthTreeEvent, DepthTreeEventArray)
+
+// Depth tree writes and colour lookups made by an entity worker, see EntityWorker_Run()
+typedef struct sDepthTreeLog {
+    DepthTreeEventArray events;
+    u32Array colours; // 12 bit colour in the low 16 bits, palette index it was given in the high 16 bits
+    b32 broken;       // Set if the depth tree writes couldn't be followed
+} DepthTreeLog;
+
+// Drop draw funcs from the end of the log that were written past 'offset' and then discarded, see NoOpLastDrawBatch()
+MINTERNAL void DepthTreeLog_Rewind(DepthTreeLog* log, u32 offset) {
+    while (MArraySize(log->events) && MArrayTop(log->events).start > offset) {
+        if (MArrayTop(log->events).type != DEPTHTREE_EVENT_APPEND) {
+            log->broken = TRUE;
+            return;
+        }
+        MArrayPop(log->events);
+    }
+}
+
+MINTERNAL void DepthTreeLog_Add(DepthTreeLog* log, u8 type, u32 z, u32 before, u32 start) {
+    DepthTreeLog_Rewind(log, before);
+    DepthTreeEvent event = { z, before, start, type };
+    WorkerArrayAdd(log->events, event);
+}
+#endif
+
+#ifdef FINTRO_PALETTE_STATS
+// Allocating a colour whose hardware entry was recycled this many frames ago or less counts as thrashing
+#define PALETTE_STATS_THRASH_FRAMES 8
+
+typedef struct sPaletteStats {
+    b32 recording;
+    PaletteFrameStats current;
+    PaletteFrameStatsArray frames;
+    u32 recycledFrame[4096]; // Frame (+1) each 12bit colour last lost its hardware entry, 0 if it never has
+} PaletteStats;
+
+#define PALETTE_STATS_COUNT(context, counter) \
+    do { if ((context)->stats && (context)->stats->recording) { (context)->stats->current.counter++; } } while (0)
+
+#if defined(M_USE_SDL)
+MINLINE u64 PaletteStats_Nanos() {
+    return (u64)(SDL_GetPerformanceCounter() * 1000000000.0 / SDL_GetPerformanceFrequency());
+}
+#elif defined(M_USE_STDLIB) && !defined(AMIGA)
+#include <time.h>
+MINLINE u64 PaletteStats_Nanos() {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (u64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+#else
+MINLINE u64 PaletteStats_Nanos() {
+    return 0;
+}
+#endif
+
+void Palette_SetStatsRecording(PaletteContext* context, b32 enabled) {
+    if (enabled && !context->stats) {
+        context->stats = (PaletteStats*)MMalloc(sizeof(PaletteStats));
+        memset(context->stats, 0, sizeof(PaletteStats));
+        MArrayInit(context->stats->frames);
+    }
+    if (context->stats) {
+        context->stats->recording = enabled;
+    }
+}
+
+void Palette_FreeStats(PaletteContext* context) {
+    if (context->stats) {
+        MArrayFree(context->stats->frames);
+        MFree(context->stats, sizeof(PaletteStats));
+        context->stats = NULL;
+    }
+}
+
+PaletteFrameStats* Palette_GetFrameStats(PaletteContext* context, u32* numFrames) {
+    if (!context->stats) {
+        *numFrames = 0;
+        return NULL;
+    }
+    *numFrames = MArraySize(context->stats->frames);
+    return context->stats->frames.arr;
+}
+
+void Palette_WriteStatsCSV(PaletteContext* context, MMemIO* output) {
+    MStringAppend(output, "frame,requests,allocated,dropped,assigned,recycled,reloaded,matched,updated,in_use,"
+                          "calc_ns\n");
+    u32 numFrames;
+    PaletteFrameStats* frames = Palette_GetFrameStats(context, &numFrames);
+    for (u32 i = 0; i < numFrames; i++) {
+        PaletteFrameStats* f = frames + i;
+        MStringAppendf(output, "%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n", f->frame, f->requests, f->allocated, f->dropped,
+                       f->assigned, f->recycled, f->reloaded, f->matched, f->updated, f->inUse, f->calcNanos);
+    }
+}
+
+// A colour that lost its hardware entry is being allocated again
+MINTERNAL void PaletteStats_Allocated(PaletteStats* stats, u16 colour12bit) {
+    u32 recycled = stats->recycledFrame[colour12bit];
+    if (recycled && stats->current.frame + 1 - recycled <= PALETTE_STATS_THRASH_FRAMES) {
+        stats->current.reloaded++;
+    }
+}
+
+// Add the frame's counts to the timeline, 'startNanos' is when Palette_CalcDynamicColourUpdates() started
+MINTERNAL void PaletteStats_EndFrame(PaletteContext* context, u64 startNanos) {
+    PaletteStats* stats = context->stats;
+    PaletteFrameStats* current = &stats->current;
+    current->updated = context->updatedColoursNum;
+    current->inUse = 0;
+    for (int i = 0; i < PALETTE_VIRTUAL_COLOURS - 1; ++i) {
+        VirtualPalette* colour = context->virtualPalette + i;
+        if (colour->state >= PALETTESTATE_REFD_NON_FRESH && colour->index >= 0x80) {
+            current->inUse++;
+        }
+    }
+    current->calcNanos = (u32)(PaletteStats_Nanos() - startNanos);
+    MArrayAdd(stats->frames, *current);
+
+    u32 frame = current->frame + 1;
+    memset(current, 0, sizeof(PaletteFrameStats));
+    current->frame = frame;
+}
+#else
+#define PALETTE_STATS_COUNT(context, counter)
+#endif
+
+// Draw params hold virtual palette indexes, or the 12bit colour itself with FINTRO_TRUECOLOUR
+MINLINE SurfacePixel Palette_GetDynamicColourIndex(RasterContext* context, SurfacePixel paletteIndex) {
+#ifdef FINTRO_TRUECOLOUR
+    return paletteIndex;
+#else
     return context->paletteContext.virtualPalette[paletteIndex].index;
+#endif
 }
 
-static u8 Palette_GetIndexFor12bitColour(PaletteContext* context, u16 colour12bit) {
+static u8 Palette_AllocIndexFor12bitColour(PaletteContext* context, u16 colour12bit) {
     colour12bit &= 0xfff;
+    PALETTE_STATS_COUNT(context, requests);
     u8 index = context->allColours[colour12bit];
     if (index == 0xff) {
         u8 newColourIndex = context->nextFreeColour;
         newColourIndex = context->freeColours[newColourIndex];
         if (newColourIndex == 0xff) {
             // no more available just return colour zero
+            PALETTE_STATS_COUNT(context, dropped);
             return context->allColours[0];
         }
 
+#ifdef FINTRO_PALETTE_STATS
+        if (context->stats && context->stats->recording) {
+            context->stats->current.allocated++;
+            PaletteStats_Allocated(context->stats, colour12bit);
+        }
+#endif
         context->nextFreeColour++;
         context->allColours[colour12bit] = newColourIndex;
         context->virtualPalette[newColourIndex].state = PALETTESTATE_REQUEST;
@@ -1787,6 +3007,30 @@ static u8 Palette_GetIndexFor12bitColour(PaletteContext* context, u16 colour12bi
     }
 }
 
+static SurfacePixel Palette_GetIndexFor12bitColour(PaletteContext* context, u16 colour12bit) {
+#ifdef FINTRO_TRUECOLOUR
+    return (SurfacePixel)(colour12bit & 0xfff);
+#else
+    u8 index = Palette_AllocIndexFor12bitColour(context, colour12bit);
+#ifdef DEPTHTREE_LOG
+    // Replayed output is only valid if its colours get the same palette indexes
+    if (context->depthTreeLog) {
+        WorkerArrayAdd(context->depthTreeLog->colours, (colour12bit & 0xfffu) | ((u32)index << 16));
+    }
+#endif
+    return index;
+#endif
+}
+
+// Pixel for one of the 16 fixed grey palette entries (see Palette_SetupForNewFrame())
+MINLINE SurfacePixel Palette_FixedColourPixel(u8 index) {
+#ifdef FINTRO_TRUECOLOUR
+    return (SurfacePixel)((index & 0xf) * 0x111);
+#else
+    return index;
+#endif
+}
+
 MINLINE RGB Colour12ConvertToRGB(u16 colour12) {
     RGB rgb = {((colour12 & 0xf00) >> 4) + 0xf, ((colour12 & 0x0f0)) + 0xf, ((colour12 & 0x00f) << 4) + 0xf};
     return rgb;
@@ -1799,6 +3043,7 @@ MINTERNAL void SetDefaultBackgroundColour(PaletteContext* context) {
 void Palette_SetupForNewFrame(PaletteContext* context, b32 resetAll) {
     if (resetAll) {
         memset(context->allColours, 0xff, 4096);
+        context->nearestColoursValid = FALSE;
 
         for (u8 i = 0; i < 16; ++i) {
             context->virtualPalette[i].state = PALETTESTATE_FIXED;
@@ -1847,51 +3092,313 @@ void Palette_SetupForNewFrame(PaletteContext* context, b32 resetAll) {
     context->nextFreeColour = 0;
 }
 
-typedef enum ePaletteEntryUnusedStateEnum {
-    PALETTEENTRY_FREE = 0,  // Never allocated / previously free'd
-    PALETTEENTRY_USED = 1,  // Currently allocated and used this frame
-    PALETTEENTRY_UNUSED = 2 // Currently allocated, but not used this frame
-} PaletteEntryUnusedStateEnum;
-
-typedef struct sPaletteEntryUnused {
-    PaletteEntryUnusedStateEnum state;
-    u8 index;
-} PaletteEntryUnused;
+// Channel weights for the distance between two 12bit colours, the eye is most sensitive to green and least to blue
+#define PALETTE_NEAREST_WEIGHT_R 3
+#define PALETTE_NEAREST_WEIGHT_G 4
+#define PALETTE_NEAREST_WEIGHT_B 2
 
-void Palette_CalcDynamicColourUpdates(PaletteContext* context) {
-    PaletteEntryUnused paletteEntryState[PALETTE_3D_COLOURS];
-    u16 freeColoursIx[PALETTE_3D_COLOURS];
-    u16 freeColours[PALETTE_3D_COLOURS];
+// Pass the nearest colour along a line of 'count' entries in both directions, one step adds 'weight' to the distance
+MINTERNAL void Palette_SweepNearestColours(u16* nearest, u16 start, u16 step, int count, u16 weight) {
+    u16* entry = nearest + start;
+    for (int i = 1; i < count; ++i) {
+        u32 fromPrev = (u32)entry[(i - 1) * step] + weight;
+        if (fromPrev < entry[i * step]) {
+            entry[i * step] = (u16)fromPrev;
+        }
+    }
+    for (int i = count - 2; i >= 0; --i) {
+        u32 fromNext = (u32)entry[(i + 1) * step] + weight;
+        if (fromNext < entry[i * step]) {
+            entry[i * step] = (u16)fromNext;
+        }
+    }
+}
 
-    UpdateColour* updateColours = context->updateColours;
+// Find the closest hardware palette colour for every 12bit colour, the distance adds up channel by channel so sweeping
+// along blue, then green, then red leaves each entry with its nearest colour
+MINTERNAL void Palette_BuildNearestColours(PaletteContext* context) {
+    u16* nearest = context->nearestColours;
+    u8 blueLines[256];
+    u16 greenPlanes = 0;
 
-    memset(paletteEntryState, 0x00, sizeof(paletteEntryState));
+    memset(nearest, 0xff, sizeof(context->nearestColours));
+    memset(blueLines, 0, sizeof(blueLines));
 
-    // Build current palette entry list
+    // Colours with a hardware palette entry, the fixed colours are always there
     for (int i = 0; i < PALETTE_VIRTUAL_COLOURS - 1; ++i) {
         u8 pState = context->virtualPalette[i].state;
-        if (pState >= PALETTESTATE_REFD_NON_FRESH) {
-            u8 a = context->virtualPalette[i].index;
-            if (a >= 0x80) {
-                PaletteEntryUnusedStateEnum state;
-                if (pState == PALETTESTATE_REFD_NON_FRESH) {
-                    state = PALETTEENTRY_UNUSED;
-                } else {
-                    state = PALETTEENTRY_USED;
-                }
-                paletteEntryState[a - 0x80].state = state;
-                paletteEntryState[a - 0x80].index = i;
+        if (pState == PALETTESTATE_FIXED || pState >= PALETTESTATE_REFD_NON_FRESH) {
+            u16 colour = context->virtualPalette[i].colourOf4096 & 0xfff;
+            if (nearest[colour] == 0xffff) {
+                nearest[colour] = (u16)i;
+                blueLines[colour >> 4] = 1;
+                greenPlanes |= 1 << (colour >> 8);
             }
         }
     }
 
-    // First add any palette entry's not allocated to free list
-    int o = 0;
-    for (int i = 0; i < PALETTE_3D_COLOURS; ++i) {
-        PaletteEntryUnusedStateEnum state = paletteEntryState[i].state;
-        if (state == PALETTEENTRY_FREE) {
-            freeColoursIx[o] = i + 0x80;
-            freeColours[o] = 0xff;
+    // Lines and planes without a colour in them have nothing to pass on until the later sweeps
+    for (u16 line = 0; line < 256; ++line) {
+        if (blueLines[line]) {
+            Palette_SweepNearestColours(nearest, line << 4, 0x001, 16, PALETTE_NEAREST_WEIGHT_B << 8);
+        }
+    }
+    for (u16 r = 0; r < 16; ++r) {
+        if (greenPlanes & (1 << r)) {
+            for (u16 b = 0; b < 16; ++b) {
+                Palette_SweepNearestColours(nearest, (r << 8) | b, 0x010, 16, PALETTE_NEAREST_WEIGHT_G << 8);
+            }
+        }
+    }
+    for (u16 line = 0; line < 256; ++line) {
+        Palette_SweepNearestColours(nearest, line, 0x100, 16, PALETTE_NEAREST_WEIGHT_R << 8);
+    }
+
+    context->nearestColoursValid = TRUE;
+    context->numNearestChanges = 0;
+}
+
+// Entry being added to or removed from the nearest colours, see Palette_WalkNearestColours()
+typedef struct sNearestColourWalk {
+    u16* nearest;
+    u8 index;
+    b32 remove;
+    // Channels of the colours cleared by a removal, blue, green then red
+    u8 low[3];
+    u8 high[3];
+} NearestColourWalk;
+
+// Offer the entry to a colour at 'distance', or clear the colour if it's nearest to the entry being removed.  Returns
+// TRUE if the colour changed.
+MINLINE b32 Palette_WalkNearestColour(NearestColourWalk* walk, u16 colour, u16 distance) {
+    u16* entry = walk->nearest + colour;
+    if (walk->remove) {
+        if ((*entry & 0xff) != walk->index) {
+            return FALSE;
+        }
+        *entry = 0xffff;
+        u8 channels[3] = { (u8)(colour & 0xf), (u8)((colour >> 4) & 0xf), (u8)(colour >> 8) };
+        for (int i = 0; i < 3; ++i) {
+            if (channels[i] < walk->low[i]) {
+                walk->low[i] = channels[i];
+            }
+            if (channels[i] > walk->high[i]) {
+                walk->high[i] = channels[i];
+            }
+        }
+        return TRUE;
+    }
+
+    u16 value = (u16)(distance << 8) | walk->index;
+    if (value >= *entry) {
+        return FALSE;
+    }
+    *entry = value;
+    return TRUE;
+}
+
+// Walk a line of blue outwards from 'centreB', returns FALSE if the colour at 'centreB' didn't change
+MINTERNAL b32 Palette_WalkNearestLine(NearestColourWalk* walk, u16 line, i16 centreB, u16 distance) {
+    if (!Palette_WalkNearestColour(walk, line | centreB, distance)) {
+        return FALSE;
+    }
+    u16 d = distance;
+    for (i16 b = centreB - 1; b >= 0; --b) {
+        d += PALETTE_NEAREST_WEIGHT_B;
+        if (!Palette_WalkNearestColour(walk, line | b, d)) {
+            break;
+        }
+    }
+    d = distance;
+    for (i16 b = centreB + 1; b < 16; ++b) {
+        d += PALETTE_NEAREST_WEIGHT_B;
+        if (!Palette_WalkNearestColour(walk, line | b, d)) {
+            break;
+        }
+    }
+    return TRUE;
+}
+
+// Walk a plane of red outwards from the centre's green, returns FALSE if the centre's line didn't change
+MINTERNAL b32 Palette_WalkNearestPlane(NearestColourWalk* walk, u16 r, i16 centreG, i16 centreB, u16 distance) {
+    if (!Palette_WalkNearestLine(walk, (r << 8) | (centreG << 4), centreB, distance)) {
+        return FALSE;
+    }
+    u16 d = distance;
+    for (i16 g = centreG - 1; g >= 0; --g) {
+        d += PALETTE_NEAREST_WEIGHT_G;
+        if (!Palette_WalkNearestLine(walk, (r << 8) | (g << 4), centreB, d)) {
+            break;
+        }
+    }
+    d = distance;
+    for (i16 g = centreG + 1; g < 16; ++g) {
+        d += PALETTE_NEAREST_WEIGHT_G;
+        if (!Palette_WalkNearestLine(walk, (r << 8) | (g << 4), centreB, d)) {
+            break;
+        }
+    }
+    return TRUE;
+}
+
+// The colours nearest to an entry are star shaped around its colour, every step back towards it is nearer still, so
+// adding or removing an entry walks outwards from its colour one channel at a time and stops in each direction at the
+// first colour it doesn't change
+MINTERNAL void Palette_WalkNearestColours(NearestColourWalk* walk, u16 colour) {
+    i16 centreR = (colour >> 8) & 0xf;
+    i16 centreG = (colour >> 4) & 0xf;
+    i16 centreB = colour & 0xf;
+    if (!Palette_WalkNearestPlane(walk, centreR, centreG, centreB, 0)) {
+        return;
+    }
+    u16 d = 0;
+    for (i16 r = centreR - 1; r >= 0; --r) {
+        d += PALETTE_NEAREST_WEIGHT_R;
+        if (!Palette_WalkNearestPlane(walk, r, centreG, centreB, d)) {
+            break;
+        }
+    }
+    d = 0;
+    for (i16 r = centreR + 1; r < 16; ++r) {
+        d += PALETTE_NEAREST_WEIGHT_R;
+        if (!Palette_WalkNearestPlane(walk, r, centreG, centreB, d)) {
+            break;
+        }
+    }
+}
+
+// Rebuild the colours a removed entry was nearest to.  The colours are cleared, then the sweeps in
+// Palette_BuildNearestColours() are run over the box around them.  The colours just outside the box are already
+// correct, so the sweeps only need to start one colour out.  No other entry's colour is cleared, allColours[] only lets
+// one entry have each colour.
+MINTERNAL void Palette_RemoveNearestColour(u16* nearest, u16 colour, u8 index) {
+    NearestColourWalk walk;
+    memset(&walk, 0, sizeof(walk));
+    walk.nearest = nearest;
+    walk.index = index;
+    walk.remove = TRUE;
+    memset(walk.low, 0xf, sizeof(walk.low));
+    Palette_WalkNearestColours(&walk, colour);
+    if (walk.low[0] > walk.high[0]) {
+        // Nothing was nearest to the entry
+        return;
+    }
+
+    // Box of blue, green & red, each widened by one colour for the sweeps
+    u8* low = walk.low;
+    u8* high = walk.high;
+    u16 start[3];
+    int count[3];
+    for (int i = 0; i < 3; ++i) {
+        start[i] = low[i] ? low[i] - 1 : 0;
+        count[i] = (high[i] < 15 ? high[i] + 1 : 15) - start[i] + 1;
+    }
+
+    for (u16 r = low[2]; r <= high[2]; ++r) {
+        for (u16 g = low[1]; g <= high[1]; ++g) {
+            Palette_SweepNearestColours(nearest, (r << 8) | (g << 4) | start[0], 0x001, count[0],
+                                        PALETTE_NEAREST_WEIGHT_B << 8);
+        }
+    }
+    for (u16 r = low[2]; r <= high[2]; ++r) {
+        for (u16 b = low[0]; b <= high[0]; ++b) {
+            Palette_SweepNearestColours(nearest, (r << 8) | (start[1] << 4) | b, 0x010, count[1],
+                                        PALETTE_NEAREST_WEIGHT_G << 8);
+        }
+    }
+    for (u16 g = low[1]; g <= high[1]; ++g) {
+        for (u16 b = low[0]; b <= high[0]; ++b) {
+            Palette_SweepNearestColours(nearest, (start[2] << 8) | (g << 4) | b, 0x100, count[2],
+                                        PALETTE_NEAREST_WEIGHT_R << 8);
+        }
+    }
+}
+
+// Queue an entry being given or losing a hardware palette colour, past PALETTE_NEAREST_CHANGES a rebuild is cheaper
+MINTERNAL void Palette_NearestColourChanged(PaletteContext* context, u8 index, b32 remove) {
+    if (!context->nearestColoursValid) {
+        return;
+    }
+    if (context->numNearestChanges == PALETTE_NEAREST_CHANGES) {
+        context->nearestColoursValid = FALSE;
+        return;
+    }
+    NearestColourChange* change = context->nearestChanges + context->numNearestChanges++;
+    change->colour = context->virtualPalette[index].colourOf4096 & 0xfff;
+    change->index = index;
+    change->remove = (u8)remove;
+}
+
+// Bring the nearest colours up to date for a lookup, applying the queued changes in order
+MINTERNAL void Palette_UpdateNearestColours(PaletteContext* context) {
+    if (!context->nearestColoursValid) {
+        Palette_BuildNearestColours(context);
+        return;
+    }
+    for (int i = 0; i < context->numNearestChanges; ++i) {
+        NearestColourChange* change = context->nearestChanges + i;
+        if (change->remove) {
+            Palette_RemoveNearestColour(context->nearestColours, change->colour, change->index);
+        } else {
+            NearestColourWalk walk;
+            memset(&walk, 0, sizeof(walk));
+            walk.nearest = context->nearestColours;
+            walk.index = change->index;
+            Palette_WalkNearestColours(&walk, change->colour);
+        }
+    }
+    context->numNearestChanges = 0;
+}
+
+typedef enum ePaletteEntryUnusedStateEnum {
+    PALETTEENTRY_FREE = 0,  // Never allocated / previously free'd
+    PALETTEENTRY_USED = 1,  // Currently allocated and used this frame
+    PALETTEENTRY_UNUSED = 2 // Currently allocated, but not used this frame
+} PaletteEntryUnusedStateEnum;
+
+typedef struct sPaletteEntryUnused {
+    PaletteEntryUnusedStateEnum state;
+    u8 index;
+} PaletteEntryUnused;
+
+void Palette_CalcDynamicColourUpdates(PaletteContext* context) {
+#ifdef FINTRO_PALETTE_STATS
+    u64 statsStart = (context->stats && context->stats->recording) ? PaletteStats_Nanos() : 0;
+#endif
+    PaletteEntryUnused paletteEntryState[PALETTE_3D_COLOURS];
+    // One extra entry for the list terminator when every entry is free
+    u16 freeColoursIx[PALETTE_3D_COLOURS + 1];
+    u16 freeColours[PALETTE_3D_COLOURS + 1];
+
+    UpdateColour* updateColours = context->updateColours;
+
+    memset(paletteEntryState, 0x00, sizeof(paletteEntryState));
+
+    // Build current palette entry list
+    for (int i = 0; i < PALETTE_VIRTUAL_COLOURS - 1; ++i) {
+        u8 pState = context->virtualPalette[i].state;
+        if (pState >= PALETTESTATE_REFD_NON_FRESH) {
+            u8 a = context->virtualPalette[i].index;
+            if (a >= 0x80) {
+                PaletteEntryUnusedStateEnum state;
+                if (pState == PALETTESTATE_REFD_NON_FRESH) {
+                    state = PALETTEENTRY_UNUSED;
+                } else {
+                    state = PALETTEENTRY_USED;
+                }
+                paletteEntryState[a - 0x80].state = state;
+                paletteEntryState[a - 0x80].index = i;
+            }
+        }
+    }
+
+    // First add any palette entry's not allocated to free list
+    int o = 0;
+    for (int i = 0; i < PALETTE_3D_COLOURS; ++i) {
+        PaletteEntryUnusedStateEnum state = paletteEntryState[i].state;
+        if (state == PALETTEENTRY_FREE) {
+            freeColoursIx[o] = i + 0x80;
+            freeColours[o] = 0xff;
             o++;
         }
     }
@@ -1924,42 +3431,31 @@ void Palette_CalcDynamicColourUpdates(PaletteContext* context) {
                     context->virtualPalette[matchedOffset].state = PALETTESTATE_FREE;
                     u16 colourToFree = context->virtualPalette[matchedOffset].colourOf4096;
                     context->allColours[colourToFree] = 0xff;
+                    Palette_NearestColourChanged(context, matchedOffset, TRUE);
+                    PALETTE_STATS_COUNT(context, recycled);
+#ifdef FINTRO_PALETTE_STATS
+                    if (context->stats && context->stats->recording) {
+                        context->stats->recycledFrame[colourToFree & 0xfff] = context->stats->current.frame + 1;
+                    }
+#endif
+                } else {
+                    PALETTE_STATS_COUNT(context, assigned);
                 }
 
                 context->virtualPalette[i].state = PALETTESTATE_REFD_FRESH;
                 context->virtualPalette[i].index = pOutOffset;
+                Palette_NearestColourChanged(context, (u8)i, FALSE);
 
                 updateColours[updateColourIndex].index = pOutOffset;
                 updateColours[updateColourIndex].colour = colour;
 
                 updateColourIndex++;
             } else {
-                // No more free / used colours find existing colour that matches closest
-                u16 newColour = colour;
-                while (newColour != 0) {
-                    if ((newColour & 0xf00) != 0) {
-                        newColour -= 0x100;
-                        matchedOffset = context->allColours[newColour];
-                        if (matchedOffset != 0xff && context->virtualPalette[matchedOffset].state != PALETTESTATE_REQUEST) {
-                            goto found;
-                        }
-                    }
-                    if ((newColour & 0x0f0) != 0) {
-                        newColour -= 0x10;
-                        matchedOffset = context->allColours[newColour];
-                        if (matchedOffset != 0xff && context->virtualPalette[matchedOffset].state != PALETTESTATE_REQUEST) {
-                            goto found;
-                        }
-                    }
-                    if ((newColour & 0x00f) != 0) {
-                        newColour -= 0x1;
-                        matchedOffset = context->allColours[newColour];
-                        if (matchedOffset != 0xff && context->virtualPalette[matchedOffset].state != PALETTESTATE_REQUEST) {
-                            goto found;
-                        }
-                    }
+                // No more free / used colours, use the closest colour already in the hardware palette
+                if (!context->nearestColoursValid || context->numNearestChanges) {
+                    Palette_UpdateNearestColours(context);
                 }
-                found:
+                matchedOffset = (u8)context->nearestColours[colour & 0xfff];
 
                 pState = context->virtualPalette[matchedOffset].state;
                 if (pState >= PALETTESTATE_REFD_NON_FRESH) {
@@ -1967,6 +3463,7 @@ void Palette_CalcDynamicColourUpdates(PaletteContext* context) {
                 }
                 context->virtualPalette[i].index = context->virtualPalette[matchedOffset].index;
                 context->virtualPalette[i].state = PALETTESTATE_MATCHED;
+                PALETTE_STATS_COUNT(context, matched);
             }
         }
     }
@@ -1982,6 +3479,11 @@ void Palette_CalcDynamicColourUpdates(PaletteContext* context) {
     }
 
     context->updatedColoursNum = updateColourIndex;
+#ifdef FINTRO_PALETTE_STATS
+    if (context->stats && context->stats->recording) {
+        PaletteStats_EndFrame(context, statsStart);
+    }
+#endif
 }
 
 void Palette_CopyDynamicColoursRGB(PaletteContext* context, RGB* palette) {
@@ -2050,120 +3552,378 @@ void Palette_CopyFixedColours16(PaletteContext* context, u16* palette) {
 
 MINTERNAL void DepthTree_Clear(DepthTree* depthTree) {
 #ifdef FINTRO_INSPECTOR
-    memset(depthTree->insOffset, 0, depthTree->size * sizeof(u32));
+    for (u32 i = 0; i < MArraySize(depthTree->chunks); i++) {
+        memset(depthTree->chunks.arr[i].insOffset, 0, DEPTHTREE_CHUNK_SIZE * sizeof(u32));
+    }
     depthTree->insOffsetTmp = 0;
 #endif
 
-    RasterOpNode* root = (RasterOpNode*)depthTree->data;
-    root->z = 0;
-    root->leftOffset = 0;
-    root->rightOffset = 0;
+    // Entry 0 is unused, so zero links mean no node
+    MArrayClear(depthTree->nodes);
+    DepthTreeNode none = { 0, 0, 0, 0 };
+    MArrayAdd(depthTree->nodes, none);
+    DepthTreeNode rootNode = { 0, 0, 0, 0 };
+    MArrayAdd(depthTree->nodes, rootNode);
+
+    RasterOpNode* root = (RasterOpNode*)DepthTree_Ptr(depthTree, 0);
+    root->index = DEPTHTREE_ROOT_NODE;
     root->func.func = DRAW_FUNC_NULL;
-    depthTree->firstNodeOffset = 0;
+    depthTree->root = DEPTHTREE_ROOT_NODE;
     depthTree->offset = sizeof(RasterOpNode);
+
+    MArrayClear(depthTree->subTrees);
+    MArrayClear(depthTree->keys);
+    MArrayClear(depthTree->sortedKeys);
+    MArrayClear(depthTree->rangeStart);
+    depthTree->numRanges = 1;
+}
+
+MINTERNAL void DepthTree_AddChunk(DepthTree* depthTree) {
+    DepthTreeChunk* chunk = MArrayAddPtr(depthTree->chunks);
+    chunk->data = (u8*)MMalloc(DEPTHTREE_CHUNK_SIZE);
+#ifdef FINTRO_INSPECTOR
+    chunk->insOffset = (u32*)MMalloc(DEPTHTREE_CHUNK_SIZE * sizeof(u32));
+    memset(chunk->insOffset, 0, DEPTHTREE_CHUNK_SIZE * sizeof(u32));
+#endif
 }
 
-MINTERNAL void DepthTree_Init(DepthTree* depthTree, u32 size) {
-    u16 maxDrawNodeSize = 0x200;
-    depthTree->size = size + maxDrawNodeSize;
-    depthTree->data = (u8*)MMalloc(depthTree->size);
-    depthTree->root = depthTree->data;
+MINTERNAL void DepthTree_Init(DepthTree* depthTree) {
+    MArrayInit(depthTree->chunks);
+    DepthTree_AddChunk(depthTree);
+    MArrayInit(depthTree->nodes);
+    depthTree->highWater = 0;
 
     MArrayInit(depthTree->subTrees);
 
-#ifdef FINTRO_INSPECTOR
-    depthTree->insOffset = (u32*)MMalloc((size + maxDrawNodeSize) * sizeof(u32));
-    depthTree->insOffsetTmp = 0;
-#endif
+    depthTree->sortMode = DEPTHSORT_TREE;
+    MArrayInit(depthTree->keys);
+    MArrayInit(depthTree->sortedKeys);
+    MArrayInit(depthTree->sortTmp);
+    MArrayInit(depthTree->rangeStart);
 
     DepthTree_Clear(depthTree);
 }
 
 MINTERNAL void DepthTree_Free(DepthTree* depthTree) {
-    MFree(depthTree->data, depthTree->size); depthTree->data = 0;
+    for (u32 i = 0; i < MArraySize(depthTree->chunks); i++) {
+        DepthTreeChunk* chunk = depthTree->chunks.arr + i;
+        MFree(chunk->data, DEPTHTREE_CHUNK_SIZE); chunk->data = 0;
+#ifdef FINTRO_INSPECTOR
+        MFree(chunk->insOffset, DEPTHTREE_CHUNK_SIZE * sizeof(u32)); chunk->insOffset = 0;
+#endif
+    }
+    MArrayFree(depthTree->chunks);
+    MArrayFree(depthTree->nodes);
     MArrayFree(depthTree->subTrees);
+    MArrayFree(depthTree->keys);
+    MArrayFree(depthTree->sortedKeys);
+    MArrayFree(depthTree->sortTmp);
+    MArrayFree(depthTree->rangeStart);
+}
 
 #ifdef FINTRO_INSPECTOR
-    MFree(depthTree->insOffset, (depthTree->size) * sizeof(u32));
+u32 DepthTree_InsOffsetForPtr(DepthTree* depthTree, void* ptr) {
+    for (u32 i = 0; i < MArraySize(depthTree->chunks); i++) {
+        DepthTreeChunk* chunk = depthTree->chunks.arr + i;
+        if ((u8*)ptr >= chunk->data && (u8*)ptr < chunk->data + DEPTHTREE_CHUNK_SIZE) {
+            return chunk->insOffset[(u8*)ptr - chunk->data];
+        }
+    }
+    return 0;
+}
+#endif
+
+// Make sure there's room to write the next node or draw func, moving on to the next chunk if the current one is full.
+// Draw funcs appended to a node are read in sequence, so set 'link' to add a func to continue reading in the new chunk.
+MINTERNAL void DepthTree_Reserve(DepthTree* depthTree, b32 link) {
+#ifdef DEPTHTREE_LOG
+    u32 before = depthTree->offset;
+#endif
+
+    if ((depthTree->offset & DEPTHTREE_CHUNK_MASK) > (DEPTHTREE_CHUNK_SIZE - DEPTHTREE_CHUNK_RESERVE)) {
+        u32 chunkIndex = (depthTree->offset >> DEPTHTREE_CHUNK_SHIFT) + 1;
+        if (chunkIndex >= MArraySize(depthTree->chunks)) {
+#ifdef ENTITY_THREADS
+            if (sEntityHeapLock) {
+                SDL_LockMutex(sEntityHeapLock);
+                DepthTree_AddChunk(depthTree);
+                SDL_UnlockMutex(sEntityHeapLock);
+            } else
+#endif
+            DepthTree_AddChunk(depthTree);
+        }
+
+        u32 nextOffset = chunkIndex << DEPTHTREE_CHUNK_SHIFT;
+        if (link) {
+            // SPANS_LINE_CONT reads its start point from the end of the previous draw func's params, so the new chunk
+            // starts with a copy of them
+            u8* prevParams = DepthTree_Ptr(depthTree, depthTree->offset) - sizeof(DrawParamsPoint);
+            memcpy(DepthTree_Ptr(depthTree, nextOffset), prevParams, sizeof(DrawParamsPoint));
+
+            DrawFunc* drawFunc = (DrawFunc*)DepthTree_Ptr(depthTree, depthTree->offset);
+            drawFunc->func = DRAW_FUNC_NEXT_CHUNK;
+            DrawParamsNextChunk* params = (DrawParamsNextChunk*)drawFunc->params;
+            nextOffset += sizeof(DrawParamsPoint);
+            params->offset = nextOffset;
+        }
+
+        depthTree->offset = nextOffset;
+    }
+
+#ifdef DEPTHTREE_LOG
+    // Each reserve starts a run of writes that fits in one chunk, replays reserve again before copying it back
+    if (link && depthTree->depthTreeLog) {
+        DepthTreeLog_Add(depthTree->depthTreeLog, DEPTHTREE_EVENT_APPEND, 0, before, depthTree->offset);
+    }
 #endif
 }
 
 MINTERNAL RasterOpNode* DepthTree_AddNode(DepthTree* depthTree, u32 z) {
-    RasterOpNode* node = (RasterOpNode*)depthTree->root;
+#ifdef DEPTHTREE_LOG
+    u32 before = depthTree->offset;
+#endif
+    // Headers start 4 byte aligned, draw funcs before them can end anywhere
+    depthTree->offset = (depthTree->offset + 3) & ~3u;
+    DepthTree_Reserve(depthTree, FALSE);
+
     u32 offset = depthTree->offset;
+    u32 index = MArraySize(depthTree->nodes);
+    DepthTreeNode newNode = { z, 0, 0, offset };
+    WorkerArrayAdd(depthTree->nodes, newNode);
+
+    DepthTreeNode* nodes = depthTree->nodes.arr;
+    u32 parent = depthTree->root;
+
+#ifdef FINTRO_ENTITY_THREADS
+    if (depthTree->unlinked) {
+        parent = 0;
+    } else
+#endif
+    if (depthTree->sortMode == DEPTHSORT_LIST) {
+        DepthListKey key = { z, offset, nodes[parent].z };
+        MArrayAdd(depthTree->keys, key);
+        parent = 0;
+    }
 
-    while (node) {
+    while (parent) {
+        DepthTreeNode* node = nodes + parent;
         if (z <= node->z) {
-            if (!node->leftOffset) {
-                node->leftOffset = offset;
+            if (!node->left) {
+                node->left = index;
                 break;
-            } else {
-                node = (RasterOpNode *) (depthTree->data + node->leftOffset);
             }
+            parent = node->left;
         } else {
-            if (!node->rightOffset) {
-                node->rightOffset = offset;
+            if (!node->right) {
+                node->right = index;
                 break;
-            } else {
-                node = (RasterOpNode *) (depthTree->data + node->rightOffset);
             }
+            parent = node->right;
         }
     }
 
-    RasterOpNode* newNode = (RasterOpNode *) (depthTree->data + offset);
-    newNode->z = z;
-    newNode->leftOffset = 0;
-    newNode->rightOffset = 0;
+    RasterOpNode* drawNode = (RasterOpNode*)DepthTree_Ptr(depthTree, offset);
+    drawNode->index = index;
     depthTree->offset += sizeof(RasterOpNode);
 
 #ifdef FINTRO_INSPECTOR
-    *(depthTree->insOffset + offset) = depthTree->insOffsetTmp;
+    *DepthTree_InsOffsetPtr(depthTree, offset) = depthTree->insOffsetTmp;
+#endif
+#ifdef DEPTHTREE_LOG
+    if (depthTree->depthTreeLog) {
+        DepthTreeLog_Add(depthTree->depthTreeLog, DEPTHTREE_EVENT_NODE, z, before,
+                         offset + (u32)(sizeof(RasterOpNode) - sizeof(DrawFunc)));
+    }
 #endif
 
-    return newNode;
+    return drawNode;
 }
 
 MINTERNAL void DepthTree_PushSubTree(DepthTree* depthTree, i32 z) {
     RasterOpNode* drawNode = DepthTree_AddNode(depthTree, z);
     drawNode->func.func = DRAW_FUNC_SUBTREE;
 
-    MArrayAdd(depthTree->subTrees, depthTree->root);
+    WorkerArrayAdd(depthTree->subTrees, depthTree->root);
+
+    // Sub tree's root node header is the sub tree func's params
+    DepthTreeNode root = { 0, 0, 0, depthTree->offset };
+    if (depthTree->sortMode == DEPTHSORT_LIST) {
+        root.z = depthTree->numRanges++;
+    }
+    depthTree->root = MArraySize(depthTree->nodes);
+    WorkerArrayAdd(depthTree->nodes, root);
 
     RasterOpNode* rootNode = drawNode + 1;
-    rootNode->z = 0;
-    rootNode->leftOffset = 0;
-    rootNode->rightOffset = 0;
+    rootNode->index = depthTree->root;
     rootNode->func.func = DRAW_FUNC_NULL;
-    depthTree->root = (u8*)(rootNode);
+    depthTree->offset += sizeof(RasterOpNode);
+
+#ifdef DEPTHTREE_LOG
+    if (depthTree->depthTreeLog) {
+        // Replays push the sub tree again, so there's no data after the logged node
+        DepthTreeEvent* event = MArrayTopPtr(depthTree->depthTreeLog->events);
+        event->type = DEPTHTREE_EVENT_PUSH;
+        event->start = depthTree->offset;
+    }
+#endif
 }
 
 MINTERNAL void DepthTree_PopSubTree(DepthTree* depthTree) {
     depthTree->root = MArrayPop(depthTree->subTrees);
+#ifdef DEPTHTREE_LOG
+    if (depthTree->depthTreeLog) {
+        DepthTreeLog_Add(depthTree->depthTreeLog, DEPTHTREE_EVENT_POP, 0, depthTree->offset, depthTree->offset);
+    }
+#endif
+}
+
+#ifdef DEPTHTREE_LOG
+// Write a logged event back into the depth tree, 'data' is the depth tree data that followed it
+MINTERNAL void DepthTree_ReplayEvent(DepthTree* depthTree, u8 type, u32 z, const u8* data, u32 size) {
+    switch (type) {
+        case DEPTHTREE_EVENT_NODE: {
+            RasterOpNode* node = DepthTree_AddNode(depthTree, z);
+            u32 nodeOffset = depthTree->offset - sizeof(RasterOpNode);
+            memcpy(&node->func, data, size);
+            depthTree->offset = nodeOffset + (u32)(sizeof(RasterOpNode) - sizeof(DrawFunc)) + size;
+            break;
+        }
+        case DEPTHTREE_EVENT_APPEND: {
+            DepthTree_Reserve(depthTree, TRUE);
+            memcpy(DepthTree_Ptr(depthTree, depthTree->offset), data, size);
+            depthTree->offset += size;
+            break;
+        }
+        case DEPTHTREE_EVENT_PUSH: {
+            DepthTree_PushSubTree(depthTree, (i32)z);
+            break;
+        }
+        case DEPTHTREE_EVENT_POP: {
+            DepthTree_PopSubTree(depthTree);
+            break;
+        }
+    }
+}
+#endif
+
+// One stable counting sort pass on a byte of the key, returns FALSE if all keys have the same byte (nothing to do)
+MINTERNAL b32 DepthList_RadixPass(const DepthListKey* src, DepthListKey* dest, u32 n, u32 pass) {
+    u32 count[256];
+    memset(count, 0, sizeof(count));
+
+    // Passes 0-3 sort on z high to low, 4-5 on range low to high
+#define DEPTHLIST_KEY_BYTE(key) ((pass < 4) ? (u8)(~(key).z >> (pass * 8)) : (u8)((key).range >> ((pass - 4) * 8)))
+    for (u32 i = 0; i < n; i++) {
+        count[DEPTHLIST_KEY_BYTE(src[i])]++;
+    }
+
+    if (count[DEPTHLIST_KEY_BYTE(src[0])] == n) {
+        return FALSE;
+    }
+
+    u32 total = 0;
+    for (u32 i = 0; i < 256; i++) {
+        u32 c = count[i];
+        count[i] = total;
+        total += c;
+    }
+
+    for (u32 i = 0; i < n; i++) {
+        dest[count[DEPTHLIST_KEY_BYTE(src[i])]++] = src[i];
+    }
+#undef DEPTHLIST_KEY_BYTE
+
+    return TRUE;
+}
+
+// Sort the draw list into draw order, sub trees become contiguous ranges in the sorted keys.  Nodes are drawn back to
+// front, nodes with equal z are drawn in the order they were added, same as the binary tree.
+MINTERNAL void DepthTree_SortList(DepthTree* depthTree) {
+    u32 n = MArraySize(depthTree->keys);
+
+    MArrayClear(depthTree->sortedKeys);
+    MArrayCopy(depthTree->keys, depthTree->sortedKeys);
+    MArrayClear(depthTree->sortTmp);
+    MArrayGrow(depthTree->sortTmp, n);
+
+    if (n > 1) {
+        u32 numPasses = 4;
+        if (depthTree->numRanges > 0x100) {
+            numPasses = 6;
+        } else if (depthTree->numRanges > 1) {
+            numPasses = 5;
+        }
+
+        for (u32 pass = 0; pass < numPasses; pass++) {
+            if (DepthList_RadixPass(depthTree->sortedKeys.arr, depthTree->sortTmp.arr, n, pass)) {
+                DepthListKey* sorted = depthTree->sortTmp.arr;
+                depthTree->sortTmp.arr = depthTree->sortedKeys.arr;
+                depthTree->sortedKeys.arr = sorted;
+                MSWAP(depthTree->sortTmp.p.capacity, depthTree->sortedKeys.p.capacity, u32)
+            }
+        }
+    }
+
+    MArrayClear(depthTree->rangeStart);
+    MArrayGrow(depthTree->rangeStart, depthTree->numRanges + 1);
+    u32 key = 0;
+    for (u32 range = 0; range <= depthTree->numRanges; range++) {
+        while (key < n && depthTree->sortedKeys.arr[key].range < range) {
+            key++;
+        }
+        MArrayAdd(depthTree->rangeStart, key);
+    }
 }
 
+MINTERNAL void RasterThreads_Free(RasterContext* raster);
+
 void Raster_Init(RasterContext* raster) {
     SpanRenderer_Clear(&(raster->spanRenderer));
     BodySpans_Clear(&(raster->bodySpanRenderer));
 
-    u16 maxDrawBufSize = 0xffff;
-    DepthTree_Init(&(raster->depthTree), maxDrawBufSize);
+    DepthTree_Init(&(raster->depthTree));
 
     MArrayInit(raster->drawNodeStack);
+
+    raster->numThreads = 1;
+    raster->threads = NULL;
+
+    raster->bezierDetail = 0;
+    raster->engine = RASTER_ENGINE_PAINTER;
+    raster->spanBuffer = NULL;
+    raster->nodeBounds = NODEBOUNDS_NONE;
+#ifdef FINTRO_PALETTE_STATS
+    raster->paletteContext.stats = NULL;
+#endif
 }
 
 void Raster_Free(RasterContext* raster) {
+    RasterThreads_Free(raster);
+#ifdef FINTRO_PALETTE_STATS
+    Palette_FreeStats(&raster->paletteContext);
+#endif
+    if (raster->spanBuffer) {
+        SpanBuffer_Free(raster->spanBuffer);
+        raster->spanBuffer = NULL;
+    }
     DepthTree_Free(&raster->depthTree);
     BodySpans_Free(&(raster->bodySpanRenderer));
     SpanRenderer_Free(&(raster->spanRenderer));
     MArrayFree(raster->drawNodeStack);
 }
 
-MINTERNAL void DoRasterTree(RasterContext* raster, u8* mem, RasterOpNode* drawNode);
+MINTERNAL void DoRasterTree(RasterContext* raster, u32 node);
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Waddress-of-packed-member"
 
 MINTERNAL int DoDrawFunc(RasterContext *context, DrawFunc *drawFunc) {
+#ifdef FINTRO_RASTER_STATS
+    if (drawFunc->func < RASTER_STATS_FUNCS) {
+        context->surface->statsFunc = (u8)drawFunc->func;
+        context->surface->stats.calls[drawFunc->func]++;
+    }
+#endif
     switch (drawFunc->func) {
         // Spans
         case DRAW_FUNC_SPANS_START:
@@ -2171,7 +3931,7 @@ MINTERNAL int DoDrawFunc(RasterContext *context, DrawFunc *drawFunc) {
             return 0;
         case DRAW_FUNC_SPANS_BEZIER: {
             DrawParamsBezier *params = (DrawParamsBezier *) (&drawFunc->params);
-            SpanRenderer_AddLinesForBezier(&(context->spanRenderer), params->pts);
+            SpanRenderer_AddLinesForBezier(&(context->spanRenderer), params->pts, context->bezierDetail);
             return sizeof(DrawParamsBezier);
         }
         case DRAW_FUNC_SPANS_LINE: {
@@ -2245,7 +4005,7 @@ MINTERNAL int DoDrawFunc(RasterContext *context, DrawFunc *drawFunc) {
         case DRAW_FUNC_BEZIER_LINE: {
             DrawParamsBezierColour* params = (DrawParamsBezierColour*)(&drawFunc->params);
             Surface_DrawBezierLine(context->surface, params->pts,
-                                   Palette_GetDynamicColourIndex(context, params->colour));
+                                   Palette_GetDynamicColourIndex(context, params->colour), context->bezierDetail);
             return sizeof(DrawParamsBezierColour);
         }
         case DRAW_FUNC_FLARE: {
@@ -2329,7 +4089,7 @@ MINTERNAL int DoDrawFunc(RasterContext *context, DrawFunc *drawFunc) {
         }
         case DRAW_FUNC_BODY_BEZIER: {
             DrawParamsBezierColour *params = (DrawParamsBezierColour *) (&drawFunc->params);
-            BodySpans_AddBezier(&(context->bodySpanRenderer), params->pts, params->colour);
+            BodySpans_AddBezier(&(context->bodySpanRenderer), params->pts, params->colour, context->bezierDetail);
             return sizeof(DrawParamsBezierColour);
         }
         case DRAW_FUNC_BODY_LINE: {
@@ -2378,7 +4138,7 @@ MINTERNAL int DoDrawFunc(RasterContext *context, DrawFunc *drawFunc) {
         }
         case DRAW_FUNC_SUBTREE: {
             RasterOpNode* subTree = (RasterOpNode*)(&drawFunc->params);
-            DoRasterTree(context, context->depthTree.data, subTree);
+            DoRasterTree(context, subTree->index);
             return 0;
         }
         default:
@@ -2387,27 +4147,253 @@ MINTERNAL int DoDrawFunc(RasterContext *context, DrawFunc *drawFunc) {
     }
 }
 
-#pragma GCC diagnostic pop
-
-MINTERNAL int DrawBatch(RasterContext* context, RasterOpNode* drawNode) {
-    u8* currentFunc = (u8*)&drawNode->func;
-
-    DrawFunc* drawFunc = (DrawFunc*)(currentFunc);
+// Area covered by a node, inclusive
+typedef struct sNodeBounds {
+    i32 x1;
+    i32 y1;
+    i32 x2;
+    i32 y2;
+} NodeBounds;
 
-    // Draw batch
-    int size = 0;
-    do {
-        currentFunc += sizeof(drawFunc->func);
-        currentFunc += size;
-        drawFunc = (DrawFunc*)(currentFunc);
-#ifdef FINTRO_INSPECTOR
-        u16 offset = (u8*)drawFunc - (u8*)context->depthTree.data;
-        context->surface->insOffsetTmp = context->depthTree.insOffset[offset];
-#endif
-        size = DoDrawFunc(context, drawFunc);
-    } while (size >= 0);
+MINLINE void NodeBounds_Add(NodeBounds* bounds, i32 x1, i32 y1, i32 x2, i32 y2) {
+    if (x1 < bounds->x1) {
+        bounds->x1 = x1;
+    }
+    if (y1 < bounds->y1) {
+        bounds->y1 = y1;
+    }
+    if (x2 > bounds->x2) {
+        bounds->x2 = x2;
+    }
+    if (y2 > bounds->y2) {
+        bounds->y2 = y2;
+    }
+}
 
-    return 0;
+MINLINE i16 NodeBounds_Clamp(i32 v, i32 max) {
+    return (i16)(v < 0 ? 0 : (v > max ? max : v));
+}
+
+MINLINE void NodeBounds_AddPoints(NodeBounds* bounds, Vec2i16* pts, int n) {
+    for (int i = 0; i < n; i++) {
+        NodeBounds_Add(bounds, pts[i].x, pts[i].y, pts[i].x, pts[i].y);
+    }
+}
+
+MINLINE void NodeBounds_AddCircle(NodeBounds* bounds, i32 x, i32 y, i32 diameter) {
+    i32 r = (diameter / 2) + 1;
+    NodeBounds_Add(bounds, x - r, y - r, x + r, y + r);
+}
+
+MINTERNAL void NodeBounds_AddFlare(NodeBounds* bounds, i32 x, i32 y, int diameter) {
+    i16 offset = (i16)((i16)(diameter + HIGHLIGHTS_SMALL) * HIGHLIGHTS_SIZE);
+    u8* flareData = (HIGHLIGHTS_SIZE == 16) ? sDrawFlareGraphics16 : sDrawFlareGraphics32;
+    flareData += offset;
+    i32 width = 0;
+    for (int i = 0; i < HIGHLIGHTS_SIZE; i++) {
+        if (flareData[i] > width) {
+            width = flareData[i];
+        }
+    }
+    NodeBounds_Add(bounds, x - width, y - (HIGHLIGHTS_SIZE / 2), x + width + 1, y + (HIGHLIGHTS_SIZE / 2));
+}
+
+// Same walk as DoDrawFunc(), but only adds the area the func draws to 'bounds'
+MINTERNAL int DrawFunc_Measure(RasterContext* context, DrawFunc* drawFunc, NodeBounds* bounds) {
+    switch (drawFunc->func) {
+        case DRAW_FUNC_SPANS_START:
+        case DRAW_FUNC_BODY_START:
+        case DRAW_FUNC_NOP:
+            return 0;
+        case DRAW_FUNC_BATCH_END1:
+            return -1;
+        case DRAW_FUNC_BATCH_END:
+            return -2;
+        case DRAW_FUNC_NULL:
+            return -3;
+        case DRAW_FUNC_SPANS_BEZIER: {
+            DrawParamsBezier* params = (DrawParamsBezier*)(&drawFunc->params);
+            NodeBounds_AddPoints(bounds, params->pts, 4);
+            return sizeof(DrawParamsBezier);
+        }
+        case DRAW_FUNC_SPANS_LINE:
+        case DRAW_FUNC_LINE:
+        case DRAW_FUNC_BODY_LINE: {
+            // Coloured lines start with the same points
+            DrawParamsLine* params = (DrawParamsLine*)(&drawFunc->params);
+            NodeBounds_Add(bounds, params->x1, params->y1, params->x1, params->y1);
+            NodeBounds_Add(bounds, params->x2, params->y2, params->x2, params->y2);
+            return drawFunc->func == DRAW_FUNC_SPANS_LINE ? sizeof(DrawParamsLine) : sizeof(DrawParamsLineColour);
+        }
+        case DRAW_FUNC_SPANS_LINE_CONT:
+        case DRAW_FUNC_SPANS_POINT: {
+            DrawParamsPoint* params = (DrawParamsPoint*)(&drawFunc->params);
+            NodeBounds_Add(bounds, params->x, params->y, params->x, params->y);
+            return sizeof(DrawParamsPoint);
+        }
+        case DRAW_FUNC_SPANS_DRAW:
+        case DRAW_FUNC_SPANS_END:
+            return sizeof(DrawParamsColour);
+        case DRAW_FUNC_TRI: {
+            DrawParamsTri* params = (DrawParamsTri*)(&drawFunc->params);
+            NodeBounds_AddPoints(bounds, params->points, 3);
+            return sizeof(DrawParamsTri);
+        }
+        case DRAW_FUNC_QUAD: {
+            DrawParamsQuad* params = (DrawParamsQuad*)(&drawFunc->params);
+            NodeBounds_AddPoints(bounds, params->points, 4);
+            return sizeof(DrawParamsQuad);
+        }
+        case DRAW_FUNC_BEZIER_LINE:
+        case DRAW_FUNC_BODY_BEZIER: {
+            DrawParamsBezierColour* params = (DrawParamsBezierColour*)(&drawFunc->params);
+            NodeBounds_AddPoints(bounds, params->pts, 4);
+            return sizeof(DrawParamsBezierColour);
+        }
+        case DRAW_FUNC_FLARE: {
+            DrawParamsFlare* params = (DrawParamsFlare*)(&drawFunc->params);
+            NodeBounds_AddFlare(bounds, (i16)params->x, (i16)params->y, params->diameter);
+            return sizeof(DrawParamsFlare);
+        }
+        case DRAW_FUNC_CIRCLE: {
+            DrawParamsCircle* params = (DrawParamsCircle*)(&drawFunc->params);
+            NodeBounds_AddCircle(bounds, params->x, params->y, params->diameter);
+            return sizeof(DrawParamsCircle);
+        }
+        case DRAW_FUNC_RINGED_CIRCLE: {
+            DrawParamsRingedCircle* params = (DrawParamsRingedCircle*)(&drawFunc->params);
+            i32 d = params->diameter;
+            if (d >= 0 && d < 10) {
+                d = sRingedCircleDiametersOuter[d];
+            } else {
+                d = d + (d >> 3);
+            }
+            NodeBounds_AddCircle(bounds, params->x, params->y, d);
+            return sizeof(DrawParamsRingedCircle);
+        }
+        case DRAW_FUNC_TEXT:
+            return sizeof(DrawParamsText);
+        case DRAW_FUNC_CIRCLES: {
+            if (context->legacy) {
+                DrawParamsLegacyCircles* params = (DrawParamsLegacyCircles*)(&drawFunc->params);
+                int i = 0;
+                while (params->pos[i] != 0xffff) {
+                    i16 x = params->pos[i++];
+                    i16 y = params->pos[i++];
+                    NodeBounds_AddCircle(bounds, x, y, params->width);
+                }
+                return sizeof(DrawParamsLegacyCircles) + ((i + 1) * 2);
+            } else {
+                DrawParamsCircles* params = (DrawParamsCircles*)(&drawFunc->params);
+                for (int i = 0; i < params->num;) {
+                    i16 x = params->pos[i++];
+                    i16 y = params->pos[i++];
+                    NodeBounds_AddCircle(bounds, x, y, params->width);
+                }
+                return sizeof(DrawParamsCircles) + (params->num * 2);
+            }
+        }
+        case DRAW_FUNC_BODY_TOGGLE_COLOUR:
+            return sizeof(DrawParamsBodyToggleColour);
+        case DRAW_FUNC_BODY_DRAW_1:
+        case DRAW_FUNC_BODY_DRAW_2:
+        case DRAW_FUNC_BODY_DRAW_3:
+            // Body rows can start filled from the left edge, so they cover the whole width of their rows
+            NodeBounds_Add(bounds, 0, bounds->y1, context->surface->width, bounds->y2);
+            return drawFunc->func == DRAW_FUNC_BODY_DRAW_2 ? sizeof(DrawParamsColour16) : sizeof(DrawParamsColour8);
+        case DRAW_FUNC_SUBTREE: {
+            // Nodes in the sub tree are measured as they are visited, the sub tree itself is never culled
+            NodeBounds_Add(bounds, 0, 0, context->surface->width, context->surface->height);
+            DoRasterTree(context, ((RasterOpNode*)(&drawFunc->params))->index);
+            return 0;
+        }
+        default:
+            NodeBounds_Add(bounds, 0, 0, context->surface->width, context->surface->height);
+            return -1;
+    }
+}
+
+#pragma GCC diagnostic pop
+
+MINLINE u32 DirtyRects_Hash(u32 hash, const u8* data, int size) {
+    for (int i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * DIRTY_HASH_PRIME;
+    }
+    return hash;
+}
+
+// Record the node's bounds and hash its draw funcs into the dirty bands it overlaps.  Walks the funcs the same way as
+// DoRenderNode().
+MINTERNAL void DirtyRects_MeasureNode(RasterContext* raster, RasterOpNode* node) {
+    Surface* surface = raster->surface;
+    DirtyRects* dirty = surface->dirty;
+    NodeBounds bounds = { I32_MAX, I32_MAX, -I32_MAX, -I32_MAX };
+    u32 hash = DIRTY_HASH_SEED;
+
+    u8* currentFunc = (u8*)&node->func;
+    DrawFunc* drawFunc = (DrawFunc*)currentFunc;
+    u16 startFunc = drawFunc->func;
+    for (;;) {
+        u16 func = drawFunc->func;
+        int size = DrawFunc_Measure(raster, drawFunc, &bounds);
+        hash = DirtyRects_Hash(hash, currentFunc, (int)sizeof(drawFunc->func) + (size > 0 ? size : 0));
+
+        b32 last;
+        if (startFunc == DRAW_FUNC_BATCH_START) {
+            last = size < 0;
+        } else if (startFunc == DRAW_FUNC_SPANS_START) {
+            last = func == DRAW_FUNC_SPANS_END;
+        } else if (startFunc == DRAW_FUNC_BODY_START) {
+            last = func == DRAW_FUNC_BODY_DRAW_1 || func == DRAW_FUNC_BODY_DRAW_2 || func == DRAW_FUNC_BODY_DRAW_3;
+        } else {
+            last = TRUE;
+        }
+        if (last || size < 0) {
+            break;
+        }
+
+        currentFunc += sizeof(drawFunc->func) + size;
+        currentFunc = DepthTree_FollowFunc(&raster->depthTree, currentFunc);
+        drawFunc = (DrawFunc*)currentFunc;
+    }
+
+    if (bounds.x1 > bounds.x2 || bounds.y1 > bounds.y2) {
+        node->x1 = node->y1 = node->x2 = node->y2 = 0;
+        return;
+    }
+
+    node->x1 = NodeBounds_Clamp(bounds.x1 - DIRTY_BOUNDS_PAD, surface->width);
+    node->y1 = NodeBounds_Clamp(bounds.y1 - DIRTY_BOUNDS_PAD, surface->height);
+    node->x2 = NodeBounds_Clamp(bounds.x2 + DIRTY_BOUNDS_PAD + 1, surface->width);
+    node->y2 = NodeBounds_Clamp(bounds.y2 + DIRTY_BOUNDS_PAD + 1, surface->height);
+
+    if (node->y1 < node->y2) {
+        u16 lastBand = (u16)((node->y2 - 1) >> DIRTY_BAND_SHIFT);
+        for (u16 i = (u16)(node->y1 >> DIRTY_BAND_SHIFT); i <= lastBand; i++) {
+            dirty->newHashes[i] = (dirty->newHashes[i] ^ hash) * DIRTY_HASH_PRIME;
+        }
+    }
+}
+
+MINTERNAL int DrawBatch(RasterContext* context, RasterOpNode* drawNode) {
+    u8* currentFunc = (u8*)&drawNode->func;
+
+    DrawFunc* drawFunc = (DrawFunc*)(currentFunc);
+
+    // Draw batch
+    int size = 0;
+    do {
+        currentFunc += sizeof(drawFunc->func);
+        currentFunc += size;
+        currentFunc = DepthTree_FollowFunc(&context->depthTree, currentFunc);
+        drawFunc = (DrawFunc*)(currentFunc);
+#ifdef FINTRO_INSPECTOR
+        context->surface->insOffsetTmp = DepthTree_InsOffsetForPtr(&context->depthTree, drawFunc);
+#endif
+        size = DoDrawFunc(context, drawFunc);
+    } while (size >= 0);
+
+    return 0;
 }
 
 MINTERNAL int DoSpanFunc(RasterContext* context, RasterOpNode* drawNode) {
@@ -2415,8 +4401,7 @@ MINTERNAL int DoSpanFunc(RasterContext* context, RasterOpNode* drawNode) {
 
     DrawFunc* drawFunc = (DrawFunc*)(currentFunc);
 #ifdef FINTRO_INSPECTOR
-    u16 offset1 = (u8*)drawFunc - (u8*)context->depthTree.data;
-    context->surface->insOffsetTmp = context->depthTree.insOffset[offset1];
+    context->surface->insOffsetTmp = DepthTree_InsOffsetForPtr(&context->depthTree, drawFunc);
 #endif
 
     int size = 0;
@@ -2424,10 +4409,10 @@ MINTERNAL int DoSpanFunc(RasterContext* context, RasterOpNode* drawNode) {
         size = DoDrawFunc(context, drawFunc);
         currentFunc += sizeof(drawFunc->func);
         currentFunc += size;
+        currentFunc = DepthTree_FollowFunc(&context->depthTree, currentFunc);
         drawFunc = (DrawFunc*)(currentFunc);
 #ifdef FINTRO_INSPECTOR
-        u16 offset2 = (u8*)drawFunc - (u8*)context->depthTree.data;
-        context->surface->insOffsetTmp = context->depthTree.insOffset[offset2];
+        context->surface->insOffsetTmp = DepthTree_InsOffsetForPtr(&context->depthTree, drawFunc);
 #endif
     }
 
@@ -2441,8 +4426,7 @@ MINTERNAL int DoBodySpanFunc(RasterContext* context, RasterOpNode* drawNode) {
 
     DrawFunc* drawFunc = (DrawFunc*)(currentFunc);
 #ifdef FINTRO_INSPECTOR
-    u16 offset1 = (u8*)drawFunc - (u8*)context->depthTree.data;
-    context->surface->insOffsetTmp = context->depthTree.insOffset[offset1];
+    context->surface->insOffsetTmp = DepthTree_InsOffsetForPtr(&context->depthTree, drawFunc);
 #endif
 
     int size = 0;
@@ -2453,10 +4437,10 @@ MINTERNAL int DoBodySpanFunc(RasterContext* context, RasterOpNode* drawNode) {
         size = DoDrawFunc(context, drawFunc);
         currentFunc += sizeof(drawFunc->func);
         currentFunc += size;
+        currentFunc = DepthTree_FollowFunc(&context->depthTree, currentFunc);
         drawFunc = (DrawFunc*)(currentFunc);
 #ifdef FINTRO_INSPECTOR
-        u16 offset2 = (u8*)drawFunc - (u8*)context->depthTree.data;
-        context->surface->insOffsetTmp = context->depthTree.insOffset[offset2];
+        context->surface->insOffsetTmp = DepthTree_InsOffsetForPtr(&context->depthTree, drawFunc);
 #endif
     }
 
@@ -2466,9 +4450,16 @@ MINTERNAL int DoBodySpanFunc(RasterContext* context, RasterOpNode* drawNode) {
 }
 
 MINTERNAL int DoRenderNode(RasterContext* context, RasterOpNode* renderNode) {
+    if (context->nodeBounds == NODEBOUNDS_MEASURE) {
+        DirtyRects_MeasureNode(context, renderNode);
+        return 0;
+    } else if (context->nodeBounds == NODEBOUNDS_CULL &&
+               (renderNode->y2 <= (i16)context->surface->clipY1 || renderNode->y1 >= (i16)context->surface->clipY2)) {
+        return 0;
+    }
+
 #ifdef FINTRO_INSPECTOR
-    u16 offset = (u8*)renderNode - (u8*)context->depthTree.data;
-    context->surface->insOffsetTmp = context->depthTree.insOffset[offset];
+    context->surface->insOffsetTmp = DepthTree_InsOffsetForPtr(&context->depthTree, renderNode);
 #endif
 
     DrawFunc* drawFunc = &renderNode->func;
@@ -2506,143 +4497,781 @@ MINTERNAL int DoRenderNode(RasterContext* context, RasterOpNode* renderNode) {
     return 0;
 }
 
-MINTERNAL void DoRasterTree(RasterContext* raster, u8* mem, RasterOpNode* drawNode) {
-    u32 initialSize = MArraySize(raster->drawNodeStack);
-
-    do {
-        while (drawNode != NULL) {
-            MArrayAdd(raster->drawNodeStack, drawNode);
-            if (drawNode->rightOffset) {
-                drawNode = (RasterOpNode*)(mem + drawNode->rightOffset);
-            } else {
-                drawNode = NULL;
-            }
-        }
-
-        drawNode = MArrayPop(raster->drawNodeStack);
-
+MINTERNAL void DoRasterList(RasterContext* raster, u32 range) {
+    DepthTree* depthTree = &raster->depthTree;
+    u32 end = depthTree->rangeStart.arr[range + 1];
+    for (u32 i = depthTree->rangeStart.arr[range]; i < end; i++) {
+        RasterOpNode* drawNode = (RasterOpNode*)DepthTree_Ptr(depthTree, depthTree->sortedKeys.arr[i].offset);
         if (DoRenderNode(raster, drawNode) < 0) {
             break;
         }
+    }
+}
 
-        if (drawNode->leftOffset) {
-            drawNode = (RasterOpNode*)(mem + drawNode->leftOffset);
-        } else {
-            drawNode = NULL;
+// Span buffer engine, draws the nodes in exactly the reverse of painter's order.  Stops once every row in the clip
+// band is covered.
+MINTERNAL void DoRasterListFrontToBack(RasterContext* raster, u32 range) {
+    Surface* surface = raster->surface;
+    u16 bandRows = surface->clipY2 - surface->clipY1;
+    DepthTree* depthTree = &raster->depthTree;
+    u32 start = depthTree->rangeStart.arr[range];
+    for (u32 i = depthTree->rangeStart.arr[range + 1]; i > start && surface->spanFullRows < bandRows; i--) {
+        RasterOpNode* drawNode = (RasterOpNode*)DepthTree_Ptr(depthTree, depthTree->sortedKeys.arr[i - 1].offset);
+        surface->spanUnit++;
+        if (DoRenderNode(raster, drawNode) < 0) {
+            break;
         }
-    } while (drawNode != NULL || MArraySize(raster->drawNodeStack) > initialSize);
+    }
 }
 
-void Raster_Draw(RasterContext* raster) {
-    raster->paletteContext.nextFreeColour = 0;
+MINTERNAL void DoRasterTreeFrontToBack(RasterContext* raster, u32 node) {
+    DepthTree* depthTree = &raster->depthTree;
+    if (depthTree->sortMode == DEPTHSORT_LIST) {
+        DoRasterListFrontToBack(raster, depthTree->nodes.arr[node].z);
+        return;
+    }
+
+    Surface* surface = raster->surface;
+    u16 bandRows = surface->clipY2 - surface->clipY1;
+    u32 initialSize = MArraySize(raster->drawNodeStack);
 
-    u8* depthTreeMem = raster->depthTree.data;
+    do {
+        while (node) {
+            MArrayAdd(raster->drawNodeStack, node);
+            node = depthTree->nodes.arr[node].left;
+        }
 
-    RasterOpNode* drawNode = (RasterOpNode*)(depthTreeMem + raster->depthTree.firstNodeOffset);
+        node = MArrayPop(raster->drawNodeStack);
 
-    MArrayClear(raster->drawNodeStack);
-    DoRasterTree(raster, depthTreeMem, drawNode);
-#ifdef MEMDEBUG
-    // Check rasterizer hasn't overwriten memory as far as we can tell
-    MMemDebugCheck(raster->surface->pixels);
-#ifdef FINTRO_INSPECTOR
-    MMemDebugCheck(raster->surface->insOffset);
-#endif
-#endif
-}
+        surface->spanUnit++;
+        if (DoRenderNode(raster, DepthTree_Node(depthTree, node)) < 0 || surface->spanFullRows >= bandRows) {
+            raster->drawNodeStack.p.size = initialSize;
+            break;
+        }
 
-MINTERNAL void CopyVertexView(VertexData* vertex, Vec3i32 d) {
-    d[0] = vertex->vVec[0];
-    d[1] = vertex->vVec[1];
-    d[2] = vertex->vVec[2];
+        node = depthTree->nodes.arr[node].right;
+    } while (node || MArraySize(raster->drawNodeStack) > initialSize);
 }
 
-typedef struct sRenderFrame {
-    // model normals offset (in modelData)
-    // / char offset when rendering text
-    u16 normalOffset;
+MINTERNAL void DoRasterTree(RasterContext* raster, u32 node) {
+    if (raster->surface->spanBuffer) {
+        DoRasterTreeFrontToBack(raster, node);
+        return;
+    }
 
-    u16* vertexData; // into modelData->data, typically packed vertex data, vertex per dword
+    DepthTree* depthTree = &raster->depthTree;
+    if (depthTree->sortMode == DEPTHSORT_LIST) {
+        // Root node holds the draw list range
+        DoRasterList(raster, depthTree->nodes.arr[node].z);
+        return;
+    }
 
-    RenderEntity* entity;
+    u32 initialSize = MArraySize(raster->drawNodeStack);
 
-    // Current byte code position
-    u8* byteCodePos;
+    do {
+        while (node) {
+            MArrayAdd(raster->drawNodeStack, node);
+            node = depthTree->nodes.arr[node].right;
+        }
 
-    u16 scale; // model scaling factor
+        node = MArrayPop(raster->drawNodeStack);
 
-    VertexData* parentVertices;
+        if (DoRenderNode(raster, DepthTree_Node(depthTree, node)) < 0) {
+            break;
+        }
 
-    // Light direction from view space
-    Vec3i16 lightDirView;
+        node = depthTree->nodes.arr[node].left;
+    } while (node || MArraySize(raster->drawNodeStack) > initialSize);
+}
+
+#ifdef RASTER_THREADS
+// Each band replays the whole depth tree in painter's order, but only rasterizes the rows inside its band, so the
+// output is identical to drawing on a single thread.
+typedef enum eRasterBandJobEnum {
+    RASTER_BAND_JOB_DRAW = 0,
+    RASTER_BAND_JOB_CONVERT = 1, // Convert the band rows to RGBA32
+} RasterBandJobEnum;
+
+typedef struct sRasterBand {
+    RasterContext raster; // Copy of the main context, with its own span renderers & node stack
+    Surface surface;      // Main surface, clipped to the band
+    u32 firstNode;
+    u8 job; // RasterBandJobEnum
+    const RGBA32Lut* lut; // RASTER_BAND_JOB_CONVERT output
+    u8* dest;
+    u32 pitch;
+    SDL_Thread* thread;
+    SDL_sem* start;
+    SDL_sem* done;
+    b32 quit;
+} RasterBand;
+
+typedef struct sRasterThreads {
+    u16 numBands;
+    RasterBand bands[RASTER_MAX_THREADS];
+} RasterThreads;
+
+MINTERNAL void RasterBand_Draw(RasterBand* band) {
+    Screen_SetForSurface(&band->surface);
+    MArrayClear(band->raster.drawNodeStack);
+    DoRasterTree(&band->raster, band->firstNode);
+}
+
+MINTERNAL void RasterBand_Run(RasterBand* band) {
+    if (band->job == RASTER_BAND_JOB_CONVERT) {
+        Surface_ConvertRowsToRGBA32(&band->surface, band->lut, band->dest, band->pitch,
+                                    band->surface.clipY1, band->surface.clipY2);
+    } else {
+        RasterBand_Draw(band);
+    }
+}
 
-    i16 depthScale; // viewport vec transform scale
+MINTERNAL int RasterBand_ThreadMain(void* data) {
+    RasterBand* band = (RasterBand*)data;
+    for (;;) {
+        SDL_SemWait(band->start);
+        if (band->quit) {
+            break;
+        }
+        RasterBand_Run(band);
+        SDL_SemPost(band->done);
+    }
+    return 0;
+}
 
-    u8 complexSkipIfPointZClipped;
-    u16 complexNormalIndex;
-    Vec3i32 complexNormal;
-    i16 complexLastVertexIx;
-    i16 complexBeginVertexIx;
-    u16 complexCurrentlyZClipped;
-    Vec2i16 complexLastZClipPt;
-    u16 complexJoinToBeginning;
-    u16 complexColour;
+MINTERNAL void RasterThreads_Init(RasterContext* raster, u16 numBands) {
+    RasterThreads* threads = (RasterThreads*)MMalloc(sizeof(RasterThreads));
+    memset(threads, 0, sizeof(RasterThreads));
+    threads->numBands = numBands;
 
-    i16 newMatrixWinding;
-    i16 matrixWinding;
+    for (u16 i = 0; i < numBands; i++) {
+        RasterBand* band = threads->bands + i;
+        SpanRenderer_Clear(&band->raster.spanRenderer);
+        BodySpans_Clear(&band->raster.bodySpanRenderer);
+        MArrayInit(band->raster.drawNodeStack);
 
-    // Base colour for current model
-    u16 baseColour;
+        // First band is drawn on the calling thread
+        if (i > 0) {
+            band->start = SDL_CreateSemaphore(0);
+            band->done = SDL_CreateSemaphore(0);
+            band->thread = SDL_CreateThread(RasterBand_ThreadMain, "raster", band);
+        }
+    }
 
-    u8 frameId; // each new transform increments this, so that cached vertices can be reprojected
+    raster->threads = threads;
+}
 
-    Vec3i32 lineStartVec;
+MINTERNAL void RasterThreads_Free(RasterContext* raster) {
+    RasterThreads* threads = raster->threads;
+    if (!threads) {
+        return;
+    }
 
-    u16 shadeRamp[8];
+    for (u16 i = 0; i < threads->numBands; i++) {
+        RasterBand* band = threads->bands + i;
+        if (band->thread) {
+            band->quit = TRUE;
+            SDL_SemPost(band->start);
+            SDL_WaitThread(band->thread, NULL);
+            SDL_DestroySemaphore(band->start);
+            SDL_DestroySemaphore(band->done);
+        }
+        BodySpans_Free(&band->raster.bodySpanRenderer);
+        SpanRenderer_Free(&band->raster.spanRenderer);
+        MArrayFree(band->raster.drawNodeStack);
+    }
 
-    VertexData* parentVertexTrans;
-    i16 parentFrameVertexIndexes[5];
+    MFree(threads, sizeof(RasterThreads));
+    raster->threads = NULL;
+}
 
-    // Tmp variables for byte code to write/read
-    u16 tmpVariable[8];
+// Run each band's job, the first band on the calling thread
+MINTERNAL void RasterThreads_Run(RasterThreads* threads) {
+    for (u16 i = 1; i < threads->numBands; i++) {
+        SDL_SemPost(threads->bands[i].start);
+    }
 
-    // Tmp matrix variable used by model code to build new matrices
-    Matrix3x3i16 tmpMatrix;
+    RasterBand_Run(threads->bands);
 
-    // View direction in object space
-    Vec3i16 viewDirObject;
+    for (u16 i = 1; i < threads->numBands; i++) {
+        SDL_SemWait(threads->bands[i].done);
+    }
+}
 
-    // Light direction in object space
-    Vec3i16 lightDirObject;
+MINTERNAL void RasterThreads_Draw(RasterContext* raster, u32 firstNode) {
+    RasterThreads* threads = raster->threads;
+    Surface* surface = raster->surface;
+    u16 numBands = threads->numBands;
+    u32 rows = surface->clipY2 - surface->clipY1;
+    u32 maxNodes = MArraySize(raster->depthTree.nodes);
 
-    // Matrix 3x3
-    // Rotation from object space to view space - combination of both object and view rotations
-    Matrix3x3i16 entityToView;
+    SpanTemplates_BuildAll(surface);
 
-    // Object pos in view space
-    Vec3i32 entityPos;
+    for (u16 i = 0; i < numBands; i++) {
+        RasterBand* band = threads->bands + i;
+        band->surface = *surface;
+#ifdef FINTRO_RASTER_STATS
+        // Bands count into their own stats, overdraw rows don't overlap so the buffer is shared
+        for (int f = 0; f < RASTER_STATS_FUNCS; f++) {
+            band->surface.stats.pixels[f] = 0;
+            band->surface.stats.calls[f] = 0;
+        }
+#endif
+        band->surface.clipY1 = (u16)(surface->clipY1 + ((rows * i) / numBands));
+        band->surface.clipY2 = (u16)(surface->clipY1 + ((rows * (i + 1)) / numBands));
 
-    // Scaling for object position
-    u16 viewDirScale;
+        RasterContext* bandRaster = &band->raster;
+        bandRaster->surface = &band->surface;
+        // Draw funcs only read the virtual palette, the rest of the palette context is ~14KB per band per frame
+        memcpy(bandRaster->paletteContext.virtualPalette, raster->paletteContext.virtualPalette,
+               sizeof(raster->paletteContext.virtualPalette));
+        bandRaster->depthTree = raster->depthTree;
+        bandRaster->legacy = raster->legacy;
+        bandRaster->bezierDetail = raster->bezierDetail;
+        bandRaster->numThreads = 1;
+        bandRaster->threads = NULL;
+        bandRaster->engine = raster->engine;
+        bandRaster->nodeBounds = raster->nodeBounds;
+        bandRaster->spanBuffer = NULL; // Shared through the band surface, rows don't overlap between bands
 
-    // Model currently being rendered
-    ModelData* modelData;
+        // Workers must not allocate (heap tracking isn't thread safe), so size everything up front.  Span & body draws
+        // start by clearing their renderer, so they only need initialising here when the surface has grown.
+        if (bandRaster->spanRenderer.memSize < surface->height * sizeof(SpanLine)) {
+            SpanRenderer_Init(&bandRaster->spanRenderer, surface->height);
+        }
+        if (bandRaster->bodySpanRenderer.height < surface->height) {
+            BodySpans_Init(&bandRaster->bodySpanRenderer, surface->height);
+        }
+        MArrayClear(bandRaster->drawNodeStack);
+        MArrayGrow(bandRaster->drawNodeStack, maxNodes);
 
-    u16 numVertexTmp;
-    u16 numVertexModel;
-    VertexData* vertexTrans;
+        bandRaster->spanRenderer.clipY1 = (i16)band->surface.clipY1;
+        bandRaster->spanRenderer.clipY2 = (i16)band->surface.clipY2;
+        bandRaster->bodySpanRenderer.clipY1 = (i16)band->surface.clipY1;
+        bandRaster->bodySpanRenderer.clipY2 = (i16)band->surface.clipY2;
 
-    u16 numNormals;
-    u16* normalColours;
+        band->firstNode = firstNode;
+        band->job = RASTER_BAND_JOB_DRAW;
+    }
 
-#ifdef FINTRO_INSPECTOR
-    InspectorDebugInfo* debug;
-    u8* fileDataStartAddress;
-#endif
-} RenderFrame;
+    RasterThreads_Run(threads);
 
-MINTERNAL b32 ByteCodeIsDone(RenderFrame* rf) {
-    return rf->byteCodePos == NULL;
+#ifdef FINTRO_RASTER_STATS
+    // Every band executes every draw func, so only count calls once
+    for (int f = 0; f < RASTER_STATS_FUNCS; f++) {
+        surface->stats.calls[f] += threads->bands[0].surface.stats.calls[f];
+        for (u16 i = 0; i < numBands; i++) {
+            surface->stats.pixels[f] += threads->bands[i].surface.stats.pixels[f];
+        }
+    }
+#endif
+}
+
+MINTERNAL void RasterThreads_Convert(RasterContext* raster, const RGBA32Lut* lut, u8* dest, u32 pitch) {
+    RasterThreads* threads = raster->threads;
+    Surface* surface = raster->surface;
+    u16 numBands = threads->numBands;
+
+    for (u16 i = 0; i < numBands; i++) {
+        RasterBand* band = threads->bands + i;
+        band->surface = *surface;
+        band->surface.clipY1 = (u16)((surface->height * i) / numBands);
+        band->surface.clipY2 = (u16)((surface->height * (i + 1)) / numBands);
+        band->job = RASTER_BAND_JOB_CONVERT;
+        band->lut = lut;
+        band->dest = dest;
+        band->pitch = pitch;
+    }
+
+    RasterThreads_Run(threads);
+}
+#else
+MINTERNAL void RasterThreads_Free(RasterContext* raster) {
+}
+#endif
+
+void Raster_ConvertToRGBA32(RasterContext* raster, const RGBA32Lut* lut, u8* dest, u32 pitch) {
+#ifdef RASTER_THREADS
+    if (raster->threads) {
+        RasterThreads_Convert(raster, lut, dest, pitch);
+        return;
+    }
+#endif
+    Surface_ConvertToRGBA32(raster->surface, lut, dest, pitch);
+}
+
+void Raster_SetNumThreads(RasterContext* raster, u16 numThreads) {
+#ifdef RASTER_THREADS
+    if (numThreads < 1) {
+        numThreads = 1;
+    } else if (numThreads > RASTER_MAX_THREADS) {
+        numThreads = RASTER_MAX_THREADS;
+    }
+#else
+    numThreads = 1;
+#endif
+
+    if (numThreads == raster->numThreads) {
+        return;
+    }
+
+    RasterThreads_Free(raster);
+    raster->numThreads = numThreads;
+#ifdef RASTER_THREADS
+    if (numThreads > 1) {
+        RasterThreads_Init(raster, numThreads);
+    }
+#endif
+}
+
+void Raster_SetDepthSort(RasterContext* raster, DepthSortEnum sortMode) {
+    raster->depthTree.sortMode = (u8)sortMode;
+    DepthTree_Clear(&raster->depthTree);
+}
+
+void Raster_SetEngine(RasterContext* raster, RasterEngineEnum engine) {
+    raster->engine = (u8)engine;
+    if (engine != RASTER_ENGINE_SPAN_BUFFER && raster->spanBuffer) {
+        SpanBuffer_Free(raster->spanBuffer);
+        raster->spanBuffer = NULL;
+    }
+}
+
+MINTERNAL void Raster_BeginSpanBuffer(RasterContext* raster) {
+    Surface* surface = raster->surface;
+    SpanBuffer* spanBuffer = raster->spanBuffer;
+    if (spanBuffer && (spanBuffer->width != surface->width || spanBuffer->height != surface->height)) {
+        SpanBuffer_Free(spanBuffer);
+        spanBuffer = NULL;
+    }
+    if (!spanBuffer) {
+        spanBuffer = SpanBuffer_Alloc(surface->width, surface->height);
+        raster->spanBuffer = spanBuffer;
+    }
+    SpanBuffer_Clear(spanBuffer, surface->clipY1, surface->clipY2);
+
+    surface->spanBuffer = spanBuffer;
+    surface->spanUnit = 0;
+    surface->spanFullRows = 0;
+}
+
+// Get the depth tree ready to draw, returns the first node
+MINTERNAL u32 Raster_BeginDraw(RasterContext* raster) {
+    Screen_SetForSurface(raster->surface);
+    raster->paletteContext.nextFreeColour = 0;
+
+    if (raster->depthTree.sortMode == DEPTHSORT_LIST) {
+        DepthTree_SortList(&raster->depthTree);
+    }
+
+    if (raster->depthTree.offset > raster->depthTree.highWater) {
+        raster->depthTree.highWater = raster->depthTree.offset;
+    }
+
+    return DEPTHTREE_ROOT_NODE;
+}
+
+// Draw the rows inside the surface's clip band
+MINTERNAL void Raster_DrawRows(RasterContext* raster, u32 drawNode) {
+    if (raster->engine == RASTER_ENGINE_SPAN_BUFFER) {
+        Raster_BeginSpanBuffer(raster);
+    }
+
+    MArrayClear(raster->drawNodeStack);
+#ifdef RASTER_THREADS
+    if (raster->threads) {
+        RasterThreads_Draw(raster, drawNode);
+    } else {
+        DoRasterTree(raster, drawNode);
+    }
+#else
+    DoRasterTree(raster, drawNode);
+#endif
+
+    raster->surface->spanBuffer = NULL;
+}
+
+MINTERNAL void Raster_EndDraw(RasterContext* raster) {
+#ifdef MEMDEBUG
+    // Check rasterizer hasn't overwriten memory as far as we can tell
+    MMemDebugCheck(raster->surface->pixels);
+#ifdef FINTRO_INSPECTOR
+    MMemDebugCheck(raster->surface->insOffset);
+#endif
+#ifdef FINTRO_RASTER_STATS
+    MMemDebugCheck(raster->surface->overdraw);
+#endif
+#endif
+}
+
+void Raster_Draw(RasterContext* raster) {
+    u32 drawNode = Raster_BeginDraw(raster);
+    Raster_DrawRows(raster, drawNode);
+    Raster_EndDraw(raster);
+}
+
+// Hash the depth tree into the dirty bands, and flag the bands that need to be redrawn
+MINTERNAL void DirtyRects_Update(RasterContext* raster, u32 drawNode, SurfacePixel clearColour) {
+    Surface* surface = raster->surface;
+    DirtyRects* dirty = surface->dirty;
+    if (dirty->width != surface->width || dirty->height != surface->height) {
+        DirtyRects_Free(dirty);
+        dirty = DirtyRects_Alloc(surface->width, surface->height);
+        surface->dirty = dirty;
+    }
+
+    for (u16 i = 0; i < dirty->numBands; i++) {
+        dirty->newHashes[i] = DIRTY_HASH_SEED;
+    }
+
+    raster->nodeBounds = NODEBOUNDS_MEASURE;
+    MArrayClear(raster->drawNodeStack);
+    DoRasterTree(raster, drawNode);
+    raster->nodeBounds = NODEBOUNDS_NONE;
+
+    // Colour indexes aren't part of the hashes, so any change to the mapping redraws everything
+    b32 redrawAll = dirty->redrawAll || dirty->clearColour != clearColour;
+#ifndef FINTRO_TRUECOLOUR
+    for (int i = 0; i < PALETTE_VIRTUAL_COLOURS; i++) {
+        u8 index = raster->paletteContext.virtualPalette[i].index;
+        if (dirty->paletteIndexes[i] != index) {
+            dirty->paletteIndexes[i] = index;
+            redrawAll = TRUE;
+        }
+    }
+#endif
+    dirty->redrawAll = FALSE;
+    dirty->clearColour = clearColour;
+
+    for (u16 i = 0; i < dirty->numBands; i++) {
+        b32 changed = redrawAll || (dirty->bands[i] & DIRTY_BAND_OVERLAY) || dirty->newHashes[i] != dirty->hashes[i];
+        dirty->bands[i] = changed ? DIRTY_BAND_CHANGED : 0;
+    }
+
+    u32* hashes = dirty->hashes;
+    dirty->hashes = dirty->newHashes;
+    dirty->newHashes = hashes;
+}
+
+void Raster_ClearAndDraw(RasterContext* raster, SurfacePixel clearColour) {
+    Surface* surface = raster->surface;
+    if (!surface->dirty) {
+        Surface_Clear(surface, clearColour);
+        Raster_Draw(raster);
+        return;
+    }
+
+    u32 drawNode = Raster_BeginDraw(raster);
+    DirtyRects_Update(raster, drawNode, clearColour);
+    DirtyRects* dirty = surface->dirty;
+
+#ifdef FINTRO_RASTER_STATS
+    for (int i = 0; i < RASTER_STATS_FUNCS; i++) {
+        surface->stats.pixels[i] = 0;
+        surface->stats.calls[i] = 0;
+    }
+#endif
+
+    // Redraw each run of changed bands, skipping nodes outside of it
+    raster->nodeBounds = NODEBOUNDS_CULL;
+    for (u16 i = 0; i < dirty->numBands; i++) {
+        if (!(dirty->bands[i] & DIRTY_BAND_CHANGED)) {
+            continue;
+        }
+        u16 start = i;
+        while (i + 1 < dirty->numBands && (dirty->bands[i + 1] & DIRTY_BAND_CHANGED)) {
+            i++;
+        }
+        surface->clipY1 = (u16)(start << DIRTY_BAND_SHIFT);
+        surface->clipY2 = (u16)((i + 1) << DIRTY_BAND_SHIFT);
+        if (surface->clipY2 > surface->height) {
+            surface->clipY2 = surface->height;
+        }
+        Surface_ClearRows(surface, surface->clipY1, surface->clipY2, clearColour);
+        Raster_DrawRows(raster, drawNode);
+    }
+    raster->nodeBounds = NODEBOUNDS_NONE;
+    surface->clipY1 = 0;
+    surface->clipY2 = surface->height;
+
+    Raster_EndDraw(raster);
+}
+
+#ifdef FINTRO_DRAW_CAPTURE
+// Captured frame:
+//   u32 magic, u16 surface width, u16 height, u8 flags, u8 sort mode, i8 bezier detail, u8 legacy,
+//   u16 background colour, u32 nodes, u32 draw list keys, u32 draw list ranges, u32 depth tree data size
+//   virtual palette, without DRAW_CAPTURE_TRUECOLOUR
+//   nodes, draw list keys, then the depth tree data chunk by chunk
+// The header is little endian, the rest is copied as it is in memory.
+#define DRAW_CAPTURE_MAGIC 0x31434446 // 'FDC1'
+#define DRAW_CAPTURE_TRUECOLOUR 0x1
+
+void Raster_WriteCapture(RasterContext* raster, MMemIO* output) {
+    DepthTree* depthTree = &raster->depthTree;
+    PaletteContext* palette = &raster->paletteContext;
+    u8 header[4] = { 0, depthTree->sortMode, (u8)raster->bezierDetail, (u8)raster->legacy };
+#ifdef FINTRO_TRUECOLOUR
+    header[0] |= DRAW_CAPTURE_TRUECOLOUR;
+#endif
+
+    MMemWriteU32LE(output, DRAW_CAPTURE_MAGIC);
+    MMemWriteU16LE(output, raster->surface->width);
+    MMemWriteU16LE(output, raster->surface->height);
+    MMemWriteU8CopyN(output, header, sizeof(header));
+    MMemWriteU16LE(output, palette->backgroundColour);
+    MMemWriteU32LE(output, MArraySize(depthTree->nodes));
+    MMemWriteU32LE(output, MArraySize(depthTree->keys));
+    MMemWriteU32LE(output, depthTree->numRanges);
+    MMemWriteU32LE(output, depthTree->offset);
+#ifndef FINTRO_TRUECOLOUR
+    MMemWriteU8CopyN(output, (u8*)palette->virtualPalette, sizeof(palette->virtualPalette));
+#endif
+    MMemWriteU8CopyN(output, (u8*)depthTree->nodes.arr, MArraySize(depthTree->nodes) * sizeof(DepthTreeNode));
+    MMemWriteU8CopyN(output, (u8*)depthTree->keys.arr, MArraySize(depthTree->keys) * sizeof(DepthListKey));
+
+    u32 lastChunk = depthTree->offset >> DEPTHTREE_CHUNK_SHIFT;
+    for (u32 chunk = 0; chunk <= lastChunk; chunk++) {
+        u32 size = chunk < lastChunk ? DEPTHTREE_CHUNK_SIZE : (depthTree->offset & DEPTHTREE_CHUNK_MASK);
+        MMemWriteU8CopyN(output, depthTree->chunks.arr[chunk].data, size);
+    }
+}
+
+// Is there room for 'size' bytes of node data at 'offset', without crossing the end of the data or a chunk boundary
+MINTERNAL b32 DrawCapture_ValidOffset(u32 offset, u32 size, u32 dataSize) {
+    return size <= dataSize && offset <= dataSize - size && (offset & DEPTHTREE_CHUNK_MASK) <= DEPTHTREE_CHUNK_SIZE - size;
+}
+
+// Check everything the depth tree walk follows is in range: node and key offsets, node links and sub tree roots.
+// Nodes are always linked to nodes added after them, so links have to point forwards, which also rules out loops.
+MINTERNAL b32 DrawCapture_Validate(DepthTree* depthTree, u32 dataSize) {
+    u32 numNodes = MArraySize(depthTree->nodes);
+    b32 list = depthTree->sortMode == DEPTHSORT_LIST;
+    if (depthTree->sortMode > DEPTHSORT_LIST || !depthTree->numRanges) {
+        return FALSE;
+    }
+    if (list && depthTree->nodes.arr[DEPTHTREE_ROOT_NODE].z >= depthTree->numRanges) {
+        return FALSE;
+    }
+
+    for (u32 i = DEPTHTREE_ROOT_NODE; i < numNodes; i++) {
+        DepthTreeNode* node = depthTree->nodes.arr + i;
+        if (!DrawCapture_ValidOffset(node->offset, sizeof(RasterOpNode), dataSize)
+                || (node->left && (node->left <= i || node->left >= numNodes))
+                || (node->right && (node->right <= i || node->right >= numNodes))) {
+            return FALSE;
+        }
+
+        RasterOpNode* drawNode = DepthTree_Node(depthTree, i);
+        if (drawNode->func.func == DRAW_FUNC_SUBTREE) {
+            // Sub tree's root node header is the sub tree func's params
+            if (!DrawCapture_ValidOffset(node->offset, 2 * sizeof(RasterOpNode), dataSize)) {
+                return FALSE;
+            }
+            u32 root = ((RasterOpNode*)(&drawNode->func.params))->index;
+            if (root <= i || root >= numNodes || (list && depthTree->nodes.arr[root].z >= depthTree->numRanges)) {
+                return FALSE;
+            }
+        }
+    }
+
+    for (u32 i = 0; i < MArraySize(depthTree->keys); i++) {
+        DepthListKey* key = depthTree->keys.arr + i;
+        if (!DrawCapture_ValidOffset(key->offset, sizeof(RasterOpNode), dataSize) || key->range >= depthTree->numRanges) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+b32 Raster_ReadCapture(RasterContext* raster, MMemIO* input, u16* width, u16* height) {
+    DepthTree* depthTree = &raster->depthTree;
+    PaletteContext* palette = &raster->paletteContext;
+
+    u32 magic;
+    u8 header[4];
+    u16 backgroundColour;
+    u32 numNodes, numKeys, numRanges, dataSize;
+    if (MMemReadU32LE(input, &magic) || magic != DRAW_CAPTURE_MAGIC
+            || MMemReadU16LE(input, width) || MMemReadU16LE(input, height)
+            || MMemReadU8CopyN(input, header, sizeof(header)) || MMemReadU16LE(input, &backgroundColour)
+            || MMemReadU32LE(input, &numNodes) || MMemReadU32LE(input, &numKeys)
+            || MMemReadU32LE(input, &numRanges) || MMemReadU32LE(input, &dataSize)) {
+        return FALSE;
+    }
+
+#ifdef FINTRO_TRUECOLOUR
+    b32 truecolour = TRUE;
+#else
+    b32 truecolour = FALSE;
+#endif
+    if (truecolour != ((header[0] & DRAW_CAPTURE_TRUECOLOUR) != 0)) {
+        MLog("Draw capture colours don't match the build, check FINTRO_TRUECOLOUR");
+        return FALSE;
+    }
+#ifndef FINTRO_TRUECOLOUR
+    if (MMemReadU8CopyN(input, (u8*)palette->virtualPalette, sizeof(palette->virtualPalette))) {
+        return FALSE;
+    }
+#endif
+
+    u32 remaining = input->size - (u32)(input->pos - input->mem);
+    if (numNodes <= DEPTHTREE_ROOT_NODE || numNodes > remaining / sizeof(DepthTreeNode)
+            || numKeys > remaining / sizeof(DepthListKey)) {
+        return FALSE;
+    }
+
+    MArrayClear(depthTree->nodes);
+    MArrayGrow(depthTree->nodes, numNodes);
+    MArrayClear(depthTree->keys);
+    MArrayGrow(depthTree->keys, numKeys);
+    if (MMemReadU8CopyN(input, (u8*)depthTree->nodes.arr, numNodes * sizeof(DepthTreeNode))
+            || MMemReadU8CopyN(input, (u8*)depthTree->keys.arr, numKeys * sizeof(DepthListKey))) {
+        return FALSE;
+    }
+    depthTree->nodes.p.size = numNodes;
+    depthTree->keys.p.size = numKeys;
+
+    u32 lastChunk = dataSize >> DEPTHTREE_CHUNK_SHIFT;
+    if (lastChunk > remaining >> DEPTHTREE_CHUNK_SHIFT) {
+        return FALSE;
+    }
+    while (MArraySize(depthTree->chunks) <= lastChunk) {
+        DepthTree_AddChunk(depthTree);
+    }
+    for (u32 chunk = 0; chunk <= lastChunk; chunk++) {
+        u32 size = chunk < lastChunk ? DEPTHTREE_CHUNK_SIZE : (dataSize & DEPTHTREE_CHUNK_MASK);
+        if (MMemReadU8CopyN(input, depthTree->chunks.arr[chunk].data, size)) {
+            return FALSE;
+        }
+    }
+
+    depthTree->offset = dataSize;
+    depthTree->root = DEPTHTREE_ROOT_NODE;
+    MArrayClear(depthTree->subTrees);
+    depthTree->sortMode = header[1];
+    depthTree->numRanges = numRanges;
+    if (!DrawCapture_Validate(depthTree, dataSize)) {
+        MLog("Draw capture depth tree is out of range");
+        return FALSE;
+    }
+    raster->bezierDetail = (i8)header[2];
+    raster->legacy = header[3];
+    palette->backgroundColour = backgroundColour;
+    return TRUE;
+}
+#endif
+
+MINTERNAL void CopyVertexView(VertexData* vertex, Vec3i32 d) {
+    d[0] = vertex->vVec[0];
+    d[1] = vertex->vVec[1];
+    d[2] = vertex->vVec[2];
+}
+
+#ifdef FINTRO_VM_PROFILE
+// Profile slots for the models, then the fonts vector text can use
+#define VM_PROFILE_FONTS 256
+#define VM_PROFILE_MODELS (VM_PROFILE_FONTS + 16)
+#endif
+
+typedef struct sRenderFrame {
+    // model normals offset (in modelData)
+    // / char offset when rendering text
+    u16 normalOffset;
+
+    u16* vertexData; // into modelData->data, typically packed vertex data, vertex per dword
+
+    RenderEntity* entity;
+
+    // Current byte code position
+    u8* byteCodePos;
+
+    u16 scale; // model scaling factor
+
+    VertexData* parentVertices;
+
+    // Light direction from view space
+    Vec3i16 lightDirView;
+
+    i16 depthScale; // viewport vec transform scale
+
+    u8 complexSkipIfPointZClipped;
+    u16 complexNormalIndex;
+    Vec3i32 complexNormal;
+    i16 complexLastVertexIx;
+    i16 complexBeginVertexIx;
+    u16 complexCurrentlyZClipped;
+    Vec2i16 complexLastZClipPt;
+    u16 complexJoinToBeginning;
+    u16 complexColour;
+
+    i16 newMatrixWinding;
+    i16 matrixWinding;
+
+    // Base colour for current model
+    u16 baseColour;
+
+    u8 frameId; // each new transform increments this, so that cached vertices can be reprojected
+
+    Vec3i32 lineStartVec;
+
+    u16 shadeRamp[8];
+
+    VertexData* parentVertexTrans;
+    i16 parentFrameVertexIndexes[5];
+
+    // Tmp variables for byte code to write/read
+    u16 tmpVariable[8];
+
+    // Tmp matrix variable used by model code to build new matrices
+    Matrix3x3i16 tmpMatrix;
+
+    // View direction in object space
+    Vec3i16 viewDirObject;
+
+    // Light direction in object space
+    Vec3i16 lightDirObject;
+
+    // Matrix 3x3
+    // Rotation from object space to view space - combination of both object and view rotations
+    Matrix3x3i16 entityToView;
+
+    // Object pos in view space
+    Vec3i32 entityPos;
+
+    // Scaling for object position
+    u16 viewDirScale;
+
+    // Model currently being rendered
+    ModelData* modelData;
+
+    u16 numVertexTmp;
+    u16 numVertexModel;
+    VertexData* vertexTrans;
+
+#ifdef VERTEX_BATCH_SIMD
+    // Packed vertices transformed up front, x, y and z arrays of batchStride each, NULL if not batching this frame
+    i32* batchVertices;
+    u16 batchStride;
+    b32 batchValid;
+#endif
+
+    u16 numNormals;
+    u16* normalColours;
+
+#ifdef FINTRO_VM_PROFILE
+    // Model index, or VM_PROFILE_FONTS + font index for vector text
+    u16 profileModel;
+#endif
+
+#ifdef FINTRO_INSPECTOR
+    InspectorDebugInfo* debug;
+    u8* fileDataStartAddress;
+#endif
+} RenderFrame;
+
+MINTERNAL b32 ByteCodeIsDone(RenderFrame* rf) {
+    return rf->byteCodePos == NULL;
 }
 
 MINTERNAL void ByteCodeSkipToEnd(RenderFrame* rf) {
@@ -2723,6 +5352,7 @@ typedef struct sRenderContext {
     u16 planetDetail;
 
     i16 planetMinAtmosBandWidth;
+    i8 bezierDetail;
 
     PaletteContext* palette;
     RenderEntity* entity;
@@ -2740,6 +5370,7 @@ MINLINE RenderFrame* GetRenderFrame(RenderContext* renderContext) {
 
 MINTERNAL RenderFrame* PushRenderFrame(RenderContext* renderContext) {
     renderContext->currentRenderFrameIx++;
+    // Models that nest this deep are reported by Render_AnalyseModels()
     if (renderContext->currentRenderFrameIx >= RENDER_FRAMES_DEPTH) {
         renderContext->currentRenderFrameIx = RENDER_FRAMES_DEPTH - 1;
     }
@@ -2756,25 +5387,96 @@ MINTERNAL RenderFrame* PopRenderFrame(RenderContext* renderContext) {
     return renderContext->currentRenderFrame;
 }
 
-MINTERNAL void WriteDrawFunc(DepthTree* depthTree, u16 drawFunc) {
-    *((u16 *)(depthTree->data + depthTree->offset)) = drawFunc;
-#ifdef FINTRO_INSPECTOR
-    depthTree->insOffset[depthTree->offset] = depthTree->insOffsetTmp;
-#endif
-    depthTree->offset += 2;
+#ifdef FINTRO_VM_PROFILE
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define VM_PROFILE_TICKS "cycles"
+MINLINE u64 VMProfile_Now() {
+    return __rdtsc();
 }
-
-MINTERNAL RasterOpNode* AddDrawNode(DepthTree* depthTree, i32 z, DrawFuncEnum drawFunc) {
-    RasterOpNode* drawNode = DepthTree_AddNode(depthTree, z);
-    drawNode->func.func = drawFunc;
-    return drawNode;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define VM_PROFILE_TICKS "cycles"
+MINLINE u64 VMProfile_Now() {
+    return __rdtsc();
+}
+#else
+#include <time.h>
+#define VM_PROFILE_TICKS "ns"
+MINLINE u64 VMProfile_Now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+#endif
+
+// Byte code offsets and call stacks tracked, both are open addressed hash tables
+#define VM_PROFILE_OFFSETS 0x1000
+#define VM_PROFILE_STACKS 0x800
+#define VM_PROFILE_EMPTY 0xffff
+
+static const char* sVMProfileOpNames[32] = {
+        "DONE", "CIRCLE", "LINE", "TRI", "QUAD", "COMPLEX", "BATCH", "MIRRORED_TRI",
+        "MIRRORED_QUAD", "TEARDROP", "VTEXT", "IF", "IF_NOT", "CALC_A", "MODEL", "AUDIO_CUE",
+        "CYLINDER", "CYLINDER_COLOUR_CAP", "BITMAP_TEXT", "IF_NOT_VAR", "IF_VAR", "DEPTH_TREE_PUSH_POP", "LINE_BEZIER",
+        "IF_SCREENSPACE_DIST", "CICLES", "MATRIX_SETUP", "COLOUR", "MODEL_SCALE", "MATRIX_TRANSFORM", "CALC_B",
+        "MATRIX_COPY", "PLANET",
+};
+
+typedef struct sVMProfileCount {
+    u32 calls;
+    u64 ticks; // Self time, time spent in sub model byte code is counted against the sub model
+} VMProfileCount;
+
+typedef struct sVMProfileOffset {
+    u16 model; // VM_PROFILE_EMPTY if unused
+    u16 offset; // From the start of the model's byte code
+    u8 op;
+    VMProfileCount count;
+} VMProfileOffset;
+
+typedef struct sVMProfileStack {
+    u32 hash;
+    u8 depth; // 0 if unused
+    u8 op;
+    u16 models[RENDER_FRAMES_DEPTH];
+    VMProfileCount count;
+} VMProfileStack;
+
+typedef struct sVMProfile {
+    VMProfileCount ops[32];
+    VMProfileCount models[VM_PROFILE_MODELS];
+    u64 modelTotalTicks[VM_PROFILE_MODELS]; // Including sub models
+    VMProfileOffset offsets[VM_PROFILE_OFFSETS];
+    VMProfileStack stacks[VM_PROFILE_STACKS];
+    u32 dropped; // Ops not counted per offset or stack as the tables were full
+
+    // Per frame depth while running
+    u64 modelStart[RENDER_FRAMES_DEPTH];
+    u64 childTicks[RENDER_FRAMES_DEPTH]; // Sub model byte code time under the op being run
+} VMProfile;
+#endif
+
+MINTERNAL void WriteDrawFunc(DepthTree* depthTree, u16 drawFunc) {
+    DepthTree_Reserve(depthTree, TRUE);
+    *((u16 *)DepthTree_Ptr(depthTree, depthTree->offset)) = drawFunc;
+#ifdef FINTRO_INSPECTOR
+    *DepthTree_InsOffsetPtr(depthTree, depthTree->offset) = depthTree->insOffsetTmp;
+#endif
+    depthTree->offset += 2;
+}
+
+MINTERNAL RasterOpNode* AddDrawNode(DepthTree* depthTree, i32 z, DrawFuncEnum drawFunc) {
+    RasterOpNode* drawNode = DepthTree_AddNode(depthTree, z);
+    drawNode->func.func = drawFunc;
+    return drawNode;
 }
 
 #define DEPTHNODE_ADD_FUNC(funcName, drawFuncEnum, ParamType) \
 MINTERNAL ParamType* funcName(DepthTree *depthTree, i32 z) { \
     RasterOpNode* drawNode = DepthTree_AddNode(depthTree, z); \
     drawNode->func.func = drawFuncEnum; \
-    ParamType* drawParams = (ParamType*)(depthTree->data + depthTree->offset); \
+    ParamType* drawParams = (ParamType*)DepthTree_Ptr(depthTree, depthTree->offset); \
     depthTree->offset += sizeof(ParamType); \
     return drawParams; \
 }
@@ -2782,41 +5484,45 @@ MINTERNAL ParamType* funcName(DepthTree *depthTree, i32 z) { \
 #ifdef FINTRO_INSPECTOR
 #define DEPTHNODE_APPEND_FUNC(funcName, drawFuncEnum, ParamType) \
 MINTERNAL ParamType* funcName(DepthTree *depthTree) { \
-    depthTree->insOffset[depthTree->offset] = depthTree->insOffsetTmp; \
-    u16* func = (u16*)(depthTree->data + depthTree->offset); \
+    DepthTree_Reserve(depthTree, TRUE); \
+    *DepthTree_InsOffsetPtr(depthTree, depthTree->offset) = depthTree->insOffsetTmp; \
+    u16* func = (u16*)DepthTree_Ptr(depthTree, depthTree->offset); \
     *func = drawFuncEnum; \
     depthTree->offset += sizeof(u16); \
-    ParamType* drawParams = (ParamType*)(depthTree->data + depthTree->offset); \
+    ParamType* drawParams = (ParamType*)DepthTree_Ptr(depthTree, depthTree->offset); \
     depthTree->offset += sizeof(ParamType); \
     return drawParams; \
 }
 #else
 #define DEPTHNODE_APPEND_FUNC(funcName, drawFuncEnum, ParamType) \
 ParamType* funcName(DepthTree *depthTree) { \
-    u16* func = (u16*)(depthTree->data + depthTree->offset); \
+    DepthTree_Reserve(depthTree, TRUE); \
+    u16* func = (u16*)DepthTree_Ptr(depthTree, depthTree->offset); \
     *func = drawFuncEnum; \
     depthTree->offset += sizeof(u16); \
-    ParamType* drawParams = (ParamType*)(depthTree->data + depthTree->offset); \
+    ParamType* drawParams = (ParamType*)DepthTree_Ptr(depthTree, depthTree->offset); \
     depthTree->offset += sizeof(ParamType); \
     return drawParams; \
 }
 #endif
 
 MINTERNAL u16* BatchSpanStart(DepthTree *depthTree) {
+    DepthTree_Reserve(depthTree, TRUE);
 #ifdef FINTRO_INSPECTOR
-    depthTree->insOffset[depthTree->offset] = depthTree->insOffsetTmp;
+    *DepthTree_InsOffsetPtr(depthTree, depthTree->offset) = depthTree->insOffsetTmp;
 #endif
-    u16* func = (u16*)(depthTree->data + depthTree->offset);
+    u16* func = (u16*)DepthTree_Ptr(depthTree, depthTree->offset);
     *func = DRAW_FUNC_SPANS_START;
     depthTree->offset += sizeof(u16);
     return func;
 }
 
 MINTERNAL u16* BatchBodySpanStart(DepthTree *depthTree) {
+    DepthTree_Reserve(depthTree, TRUE);
 #ifdef FINTRO_INSPECTOR
-    depthTree->insOffset[depthTree->offset] = depthTree->insOffsetTmp;
+    *DepthTree_InsOffsetPtr(depthTree, depthTree->offset) = depthTree->insOffsetTmp;
 #endif
-    u16* func = (u16*)(depthTree->data + depthTree->offset);
+    u16* func = (u16*)DepthTree_Ptr(depthTree, depthTree->offset);
     *func = DRAW_FUNC_BODY_START;
     depthTree->offset += sizeof(u16);
     return func;
@@ -2853,8 +5559,8 @@ DEPTHNODE_ADD_FUNC(AddHighlightNode, DRAW_FUNC_FLARE, DrawParamsFlare)
 DEPTHNODE_ADD_FUNC(AddQuadNode, DRAW_FUNC_QUAD, DrawParamsQuad)
 
 MINTERNAL Vec2i16 ScreenCoords(Vec2i16 pos) {
-    pos.x = (i16)(pos.x + (SURFACE_WIDTH >> 1));
-    pos.y = (i16)((SURFACE_HEIGHT >> 1) - pos.y);
+    pos.x = (i16)(pos.x + (SCREEN_WIDTH >> 1));
+    pos.y = (i16)((SCREEN_HEIGHT >> 1) - pos.y);
     return pos;
 }
 
@@ -3080,11 +5786,14 @@ MINTERNAL u16 GetValueForParam16(RenderFrame* rf, u16 param16) {
     return (param16 << 9) | (param16 >> 7);
 }
 
+MINTERNAL int IsModelVisibleAt(ModelData* modelData, u16 scale, const Vec3i32 pos) {
+    i32 radius = modelData->radius << scale;
+    return IsInViewport(radius, pos[0], pos[1], pos[2]);
+}
+
 MINTERNAL int IsModelVisible(RenderContext* objectContext, ModelData* modelData) {
     RenderFrame* rf = GetRenderFrame(objectContext);
-
-    i32 radius = modelData->radius << rf->scale;
-    return IsInViewport(radius, rf->entityPos[0], rf->entityPos[1], rf->entityPos[2]);
+    return IsModelVisibleAt(modelData, rf->scale, rf->entityPos);
 }
 
 MINTERNAL void TranslateProjectVertexDirect(RenderFrame* rf, VertexData* vertex) {
@@ -3136,6 +5845,110 @@ MINTERNAL VertexData* TransformVertexRecursive(RenderContext *rc, RenderFrame* r
 
 MINTERNAL VertexData* TransformAndProjectVertex(RenderContext *rc, RenderFrame* rf, i16 vertexIndex);
 
+// Transform a pair of packed vertices, the second vertex is the first mirrored in the x axis
+MINTERNAL void TransformPackedVertexPair(RenderFrame* rf, u16 vertexData1, u16 vertexData2, Vec3i32 r1, Vec3i32 r2) {
+    Vec3i32 v;
+    v[0] = lo8s32(vertexData1) << 8;
+    v[1] = hi8s32(vertexData2) << 8;
+    v[2] = lo8s32(vertexData2) << 8;
+
+    i32 dx = rf->entityToView[0][0] * v[0];
+    i32 dy = rf->entityToView[0][1] * v[0];
+    i32 dz = rf->entityToView[0][2] * v[0];
+
+    i32 x = dx + rf->entityToView[1][0] * v[1] + rf->entityToView[2][0] * v[2];
+    i32 y = dy + rf->entityToView[1][1] * v[1] + rf->entityToView[2][1] * v[2];
+    i32 z = dz + rf->entityToView[1][2] * v[1] + rf->entityToView[2][2] * v[2];
+
+    u16 scale = (u16)0x17 - rf->scale;
+
+    x >>= scale;
+    y >>= scale;
+    z >>= scale;
+    dx >>= scale;
+    dy >>= scale;
+    dz >>= scale;
+
+    r1[0] = x;
+    r1[1] = y;
+    r1[2] = z;
+
+    r2[0] = x - (dx * 2);
+    r2[1] = y - (dy * 2);
+    r2[2] = z - (dz * 2);
+}
+
+#ifdef VERTEX_BATCH_SIMD
+// One axis for 4 vertex pairs, 'v0' holds the x coord in the low word of each lane, 'v12' holds y and z.  The
+// madd of the packed words is the same 16x16->32 bit sum as the scalar code.
+MINLINE void VertexBatchAxis(i32* dest, __m128i v0, __m128i v12, __m128i m0, __m128i m12, __m128i shift) {
+    __m128i d = _mm_madd_epi16(v0, m0);
+    __m128i a = _mm_add_epi32(d, _mm_madd_epi16(v12, m12));
+    d = _mm_sra_epi32(d, shift);
+    a = _mm_sra_epi32(a, shift);
+    __m128i b = _mm_sub_epi32(a, _mm_add_epi32(d, d));
+    _mm_storeu_si128((__m128i*)dest, _mm_unpacklo_epi32(a, b));
+    _mm_storeu_si128((__m128i*)(dest + 4), _mm_unpackhi_epi32(a, b));
+}
+
+MINLINE __m128i VertexBatchMatrixRow(i16 m1, i16 m2) {
+    return _mm_set1_epi32((i32)((u32)(u16)m1 | ((u32)(u16)m2 << 16)));
+}
+
+// Transform every packed vertex pair of the current model, 4 pairs at a time.  Done on the first packed vertex a
+// frame asks for, and again if the model code replaces the frame matrix.  Pairs that aren't packed vertices give
+// junk entries, they are never read.
+MINTERNAL void VertexBatch_Transform(RenderFrame* rf) {
+    i32* xs = rf->batchVertices;
+    i32* ys = xs + rf->batchStride;
+    i32* zs = ys + rf->batchStride;
+    const u16* vertexData = rf->vertexData;
+    u16 numPairs = rf->numVertexModel >> 1;
+
+    __m128i shift = _mm_cvtsi32_si128((u16)0x17 - rf->scale);
+    __m128i m0x = VertexBatchMatrixRow(rf->entityToView[0][0], 0);
+    __m128i m0y = VertexBatchMatrixRow(rf->entityToView[0][1], 0);
+    __m128i m0z = VertexBatchMatrixRow(rf->entityToView[0][2], 0);
+    __m128i m12x = VertexBatchMatrixRow(rf->entityToView[1][0], rf->entityToView[2][0]);
+    __m128i m12y = VertexBatchMatrixRow(rf->entityToView[1][1], rf->entityToView[2][1]);
+    __m128i m12z = VertexBatchMatrixRow(rf->entityToView[1][2], rf->entityToView[2][2]);
+    __m128i loByte = _mm_set1_epi32(0x0000ff00);
+    __m128i hiByte = _mm_set1_epi32((i32)0xff000000);
+
+    u16 i = 0;
+    for (; i + 4 <= numPairs; i += 4) {
+        // Each lane is one pair: type | x, y | z
+        __m128i d = _mm_loadu_si128((const __m128i*)(vertexData + i * 2));
+        __m128i d8 = _mm_slli_epi32(d, 8);
+        __m128i v0 = _mm_and_si128(d8, loByte);
+        __m128i v12 = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(d, 16), loByte), _mm_and_si128(d8, hiByte));
+        VertexBatchAxis(xs + i * 2, v0, v12, m0x, m12x, shift);
+        VertexBatchAxis(ys + i * 2, v0, v12, m0y, m12y, shift);
+        VertexBatchAxis(zs + i * 2, v0, v12, m0z, m12z, shift);
+    }
+
+    for (; i < numPairs; i++) {
+        Vec3i32 r1, r2;
+        TransformPackedVertexPair(rf, vertexData[i * 2], vertexData[i * 2 + 1], r1, r2);
+        xs[i * 2] = r1[0];
+        ys[i * 2] = r1[1];
+        zs[i * 2] = r1[2];
+        xs[i * 2 + 1] = r2[0];
+        ys[i * 2 + 1] = r2[1];
+        zs[i * 2 + 1] = r2[2];
+    }
+
+    rf->batchValid = TRUE;
+}
+
+MINLINE void VertexBatch_Get(RenderFrame* rf, i16 vertexIndex, Vec3i32 r) {
+    const i32* xs = rf->batchVertices;
+    r[0] = xs[vertexIndex];
+    r[1] = xs[rf->batchStride + vertexIndex];
+    r[2] = xs[rf->batchStride * 2 + vertexIndex];
+}
+#endif
+
 MINTERNAL VertexData* TransformProjectVertexRecursive(RenderContext* rc, RenderFrame* rf, i16 vertexIndex, i16 projectedState) {
 #ifdef FINTRO_INSPECTOR
     rf->debug->transformedVertices++;
@@ -3172,35 +5985,19 @@ MINTERNAL VertexData* TransformProjectVertexRecursive(RenderContext* rc, RenderF
             v1->projectedState = projectedState;
             v2->projectedState = projectedState;
 
-            Vec3i32 v;
-            v[0] = lo8s32(vertexData1) << 8;
-            v[1] = hi8s32(vertexData2) << 8;
-            v[2] = lo8s32(vertexData2) << 8;
-
-            i32 dx = rf->entityToView[0][0] * v[0];
-            i32 dy = rf->entityToView[0][1] * v[0];
-            i32 dz = rf->entityToView[0][2] * v[0];
-
-            i32 x = dx + rf->entityToView[1][0] * v[1] + rf->entityToView[2][0] * v[2];
-            i32 y = dy + rf->entityToView[1][1] * v[1] + rf->entityToView[2][1] * v[2];
-            i32 z = dz + rf->entityToView[1][2] * v[1] + rf->entityToView[2][2] * v[2];
-
-            u16 scale = (u16)0x17 - rf->scale;
-
-            x >>= scale;
-            y >>= scale;
-            z >>= scale;
-            dx >>= scale;
-            dy >>= scale;
-            dz >>= scale;
-
-            v1->rVec[0] = x;
-            v1->rVec[1] = y;
-            v1->rVec[2] = z;
-
-            v2->rVec[0] = x - (dx * 2);
-            v2->rVec[1] = y - (dy * 2);
-            v2->rVec[2] = z - (dz * 2);
+#ifdef VERTEX_BATCH_SIMD
+            if (rf->batchVertices && (u16)vertexEvenIndex + 1 < rf->numVertexModel) {
+                if (!rf->batchValid) {
+                    VertexBatch_Transform(rf);
+                }
+                VertexBatch_Get(rf, vertexEvenIndex, v1->rVec);
+                VertexBatch_Get(rf, (i16)(vertexEvenIndex + 1), v2->rVec);
+            } else {
+                TransformPackedVertexPair(rf, vertexData1, vertexData2, v1->rVec, v2->rVec);
+            }
+#else
+            TransformPackedVertexPair(rf, vertexData1, vertexData2, v1->rVec, v2->rVec);
+#endif
 
             VertexData* vOrig = rf->vertexTrans + vertexIndex;
             TranslateProjectVertex(rf, vOrig);
@@ -3657,11 +6454,11 @@ MINTERNAL u16 CalcNormalLightTint(RenderFrame* rf, u8 normalIndex) {
 
 #ifdef NON_TRICKY_POINT_CHECK
 MINTERNAL bool IsPointVisible(i16 x, i16 y) {
-    return (x < SURFACE_WIDTH && x >= 0 && y < SURFACE_HEIGHT && y >= 0);
+    return (x < SCREEN_WIDTH && x >= 0 && y < SCREEN_HEIGHT && y >= 0);
 }
 #else
 MINTERNAL b32 IsPointVisible(i16 x, i16 y) {
-    return ((u16)x) < SURFACE_WIDTH && ((u16)y) < SURFACE_HEIGHT;
+    return ((u16)x) < SCREEN_WIDTH && ((u16)y) < SCREEN_HEIGHT;
 }
 #endif
 
@@ -3674,11 +6471,11 @@ MINTERNAL b32 IsCircleVisible(i16 x, i16 y, i16 r) {
         return FALSE;
     }
 
-    if (x - r >= SURFACE_WIDTH) {
+    if (x - r >= SCREEN_WIDTH) {
         return FALSE;
     }
 
-    return (y - r) < SURFACE_HEIGHT;
+    return (y - r) < SCREEN_HEIGHT;
 }
 
 MINTERNAL Vec2i16 ClipLineZVec3i32(const Vec3i32 v1, const Vec3i32 v2) {
@@ -3717,8 +6514,8 @@ MINTERNAL Vec2i16 ClipLineZVec3i32(const Vec3i32 v1, const Vec3i32 v2) {
     }
 
     Vec2i16 pos;
-    pos.x = (i16)(((i16)x3) + (SURFACE_WIDTH >> 1));
-    pos.y = (i16)((SURFACE_HEIGHT >> 1) - ((i16)y3));
+    pos.x = (i16)(((i16)x3) + (SCREEN_WIDTH >> 1));
+    pos.y = (i16)((SCREEN_HEIGHT >> 1) - ((i16)y3));
     return pos;
 }
 
@@ -3850,7 +6647,7 @@ MINTERNAL int SetupNewTransformMatrix(RenderContext* renderContext, RenderFrame*
     return 0;
 }
 
-MINTERNAL void FrameRenderObjects(RenderContext* rc, ModelData* model);
+MINTERNAL void FrameRenderObjects(RenderContext* rc, ModelData* model, u16 modelIndex);
 
 // Calc the vertex 12 bit colour (4 red / 4 green / 4 blue), given a normal and colour.
 //
@@ -4046,8 +6843,8 @@ MINTERNAL i32 CalcVec3i32DepthOffset(RenderFrame* rf, const Vec3i32 v, i32 depth
     }
 }
 
-MINTERNAL i32 CalcVec3i32Depth(RenderFrame* rf, const Vec3i32 v) {
-    i16 scale = (i16)(3 - rf->depthScale);
+MINTERNAL i32 CalcVec3i32DepthForScale(i16 depthScale, const Vec3i32 v) {
+    i16 scale = (i16)(3 - depthScale);
     i32 z = v[2];
     if (scale <= 0) {
         scale += 24;
@@ -4086,6 +6883,10 @@ MINTERNAL i32 CalcVec3i32Depth(RenderFrame* rf, const Vec3i32 v) {
     return z;
 }
 
+MINTERNAL i32 CalcVec3i32Depth(RenderFrame* rf, const Vec3i32 v) {
+    return CalcVec3i32DepthForScale(rf->depthScale, v);
+}
+
 MINTERNAL i32 CalcObjectOffsetDepth(RenderFrame* rf, i32 depthOffset) {
     i16 scale = (i16)(3 - rf->depthScale);
     i32 z = depthOffset + rf->entityPos[2];
@@ -4607,61 +7408,69 @@ u32 Render_LoadFormattedString(SceneSetup* sceneSetup, RenderEntity* entity, u16
     return 0;
 }
 
-MINTERNAL i16 DrawBitmapChar(u8* bitmapFontData, u8* pixels, i16 x, i16 y, u8 charIndex, u8 colour) {
-    if (x < 0 || x >= (SURFACE_WIDTH - FONT_MIN_WIDTH)) {
+// Draws the glyph's set bits as fontScale x fontScale blocks, inlined with a constant scale for the common scales so
+// the block writes are unrolled
+MINLINE void DrawBitmapGlyph(const u8* glyph, SurfacePixel* pixels, u32 stride, u8 fontScale, SurfacePixel colour) {
+    for (i32 i = 0; i < FONT_HEIGHT; i++) {
+        u8 bits = glyph[i];
+        SurfacePixel* pixelsStartLine = pixels;
+        while (bits) {
+            if (bits & 0x80) {
+                SurfacePixel* block = pixels;
+                for (int by = 0; by < fontScale; by++) {
+                    for (int bx = 0; bx < fontScale; bx++) {
+                        block[bx] = colour;
+                    }
+                    block += stride;
+                }
+            }
+            pixels += fontScale;
+            bits <<= 1;
+        }
+        pixels = pixelsStartLine + (fontScale * stride);
+    }
+}
+
+MINTERNAL i16 DrawBitmapChar(u8* bitmapFontData, Surface* surface, i16 x, i16 y, u8 charIndex, SurfacePixel colour) {
+    if (x < 0 || x >= (SURFACE_W(surface) - FONT_MIN_WIDTH)) {
         return 0;
     }
 
     u32 charDataOffset = ((u32)(charIndex) * (FONT_HEIGHT + 1));
     bitmapFontData += charDataOffset;
 
-    u32 drawOffset = (x * FONT_SCALE) + (y * FONT_SCALE * SURFACE_WIDTH);
-    pixels += drawOffset;
+    const u32 stride = SURFACE_W(surface);
+    const u8 fontScale = FONT_SCALE;
+    u32 drawOffset = (x * fontScale) + (y * fontScale * stride);
+    Surface_AddDamage(surface, y * fontScale, (y + FONT_HEIGHT) * fontScale);
+    SurfacePixel* pixels = surface->pixels + drawOffset;
 
-    i32 i = 0;
-    for (; i < FONT_HEIGHT; i++) {
-        u8 bits = bitmapFontData[i];
-        u8* pixelsStartLine = pixels;
-        while (bits) {
-            if (bits & 0x80) {
-                *pixels = colour;
-#if FONT_SCALE == 2
-                *(pixels + 1) = colour;
-                *(pixels + SURFACE_WIDTH) = colour;
-                *(pixels + SURFACE_WIDTH + 1) = colour;
-#elif FONT_SCALE == 4
-                *(pixels + 1) = colour;
-                *(pixels + 2) = colour;
-                *(pixels + 3) = colour;
-                *(pixels + SURFACE_WIDTH) = colour;
-                *(pixels + SURFACE_WIDTH + 1) = colour;
-                *(pixels + SURFACE_WIDTH + 2) = colour;
-                *(pixels + SURFACE_WIDTH + 3) = colour;
-                *(pixels + (SURFACE_WIDTH*2)) = colour;
-                *(pixels + (SURFACE_WIDTH*2) + 1) = colour;
-                *(pixels + (SURFACE_WIDTH*2) + 2) = colour;
-                *(pixels + (SURFACE_WIDTH*2) + 3) = colour;
-                *(pixels + (SURFACE_WIDTH*3)) = colour;
-                *(pixels + (SURFACE_WIDTH*3) + 1) = colour;
-                *(pixels + (SURFACE_WIDTH*3) + 2) = colour;
-                *(pixels + (SURFACE_WIDTH*3) + 3) = colour;
-#endif
-            }
-            pixels += FONT_SCALE;
-            bits <<= 1;
-        }
-        pixels = pixelsStartLine + (FONT_SCALE * SURFACE_WIDTH);
+    // Scale is picked once per char rather than per pixel
+    switch (fontScale) {
+        case 1:
+            DrawBitmapGlyph(bitmapFontData, pixels, stride, 1, colour);
+            break;
+        case 2:
+            DrawBitmapGlyph(bitmapFontData, pixels, stride, 2, colour);
+            break;
+        case 4:
+            DrawBitmapGlyph(bitmapFontData, pixels, stride, 4, colour);
+            break;
+        default:
+            DrawBitmapGlyph(bitmapFontData, pixels, stride, fontScale, colour);
+            break;
     }
 
     return bitmapFontData[FONT_HEIGHT];
 }
 
 void Render_DrawBitmapText(SceneSetup* sceneSetup, const i8* text, Vec2i16 pos, u8 colour, b32 drawShadow) {
-    if ((pos.y < 0) || (pos.y > (SURFACE_HEIGHT - FONT_HEIGHT))) {
+    Surface* surface = sceneSetup->raster->surface;
+    Screen_SetForSurface(surface);
+    if ((pos.y < 0) || (pos.y > (SURFACE_H(surface) - FONT_HEIGHT))) {
         return;
     }
 
-    u8* pixels = sceneSetup->raster->surface->pixels;
     u8* bitmapFontData = sceneSetup->assets.bitmapFontData;
 
     i16 initialX = pos.x;
@@ -4689,11 +7498,12 @@ void Render_DrawBitmapText(SceneSetup* sceneSetup, const i8* text, Vec2i16 pos,
                 }
             }
         } else {
-            if (pos.x >= 0 && pos.x < (SURFACE_WIDTH - FONT_MIN_WIDTH)) {
+            if (pos.x >= 0 && pos.x < (SURFACE_W(surface) - FONT_MIN_WIDTH)) {
                 if (drawShadow) {
-                    DrawBitmapChar(bitmapFontData, pixels, (i16)(pos.x + 1), (i16)(pos.y + 1), c,0);
+                    DrawBitmapChar(bitmapFontData, surface, (i16)(pos.x + 1), (i16)(pos.y + 1), c,0);
                 }
-                pos.x = pos.x + (i16)DrawBitmapChar(bitmapFontData, pixels, pos.x, pos.y, c, colour);
+                pos.x = pos.x + (i16)DrawBitmapChar(bitmapFontData, surface, pos.x, pos.y, c,
+                                                    Palette_FixedColourPixel(colour));
             }
         }
         c = text[i++];
@@ -4793,15 +7603,18 @@ void Render_BlitNoClip(Surface* surface, Image8Bit* image, Vec2i16 pos) {
     u16 width = image->w;
     u16 height = image->h;
 
-    u8* pixels = (u8*)surface->pixels;
+    Surface_AddDamage(surface, pos.y, pos.y + height);
+
+    SurfacePixel* pixels = surface->pixels;
     pixels += (surface->width * pos.y) + pos.x;
 
+    // Image pixels are fixed palette indexes, zero is transparent
     u8* src = image->data;
     for (u16 y = 0; y < height; y++) {
         for (u16 x = 0; x < width; x++) {
             u8 c = *src;
             if (c) {
-                pixels[x] = c;
+                pixels[x] = Palette_FixedColourPixel(c);
             }
             src++;
         }
@@ -5511,7 +8324,8 @@ MINTERNAL void RenderCircleParams(RenderContext* renderContext, RenderFrame* rf,
 
                 if (d) {
                     d >>= 3;
-                    i16 diameter2 = (i16)sDrawHighlightIndex[d & 0x1f];
+                    const i8* highlightIndex = (HIGHLIGHTS_SIZE == 16) ? sDrawHighlightIndex16 : sDrawHighlightIndex32;
+                    i16 diameter2 = (i16)highlightIndex[d & 0x1f];
 
                     AddHighlight(renderContext, rf, v, diameter2, screenX, screenY, colour);
                 } else {
@@ -5744,7 +8558,7 @@ doneProjects:
 #ifdef FINTRO_INSPECTOR
     if (AllowModelRender(renderContext, modelIndex)) {
 #endif
-    FrameRenderObjects(renderContext, modelData);
+    FrameRenderObjects(renderContext, modelData, modelIndex);
 #ifdef FINTRO_INSPECTOR
     }
 #endif
@@ -6261,6 +9075,13 @@ MINTERNAL int RenderVectorTextNewFrame(RenderContext* rc, RenderFrame* rf, u16 p
     newRenderFrame->numNormals = 4;
 
     newRenderFrame->modelData = (ModelData*)font;
+#ifdef FINTRO_VM_PROFILE
+    newRenderFrame->profileModel = VM_PROFILE_FONTS + fontIndex;
+#endif
+#ifdef VERTEX_BATCH_SIMD
+    // Entity position moves per char, font vertices are always transformed on demand
+    newRenderFrame->batchVertices = NULL;
+#endif
 
 #ifdef FINTRO_INSPECTOR
     newRenderFrame->debug = &rc->sceneSetup->debug;
@@ -6277,7 +9098,7 @@ MINTERNAL int RenderVectorTextNewFrame(RenderContext* rc, RenderFrame* rf, u16 p
     newRenderFrame->vertexTrans = (VertexData*)MMemStackAlloc(rc->memStack, sizeof(VertexData) * (newRenderFrame->numVertexTmp + newRenderFrame->numVertexModel));
 #endif
 
-    for (int i = 0; i <= newRenderFrame->numVertexModel; i++) {
+    for (int i = 0; i < newRenderFrame->numVertexModel; i++) {
         VertexData* vertex = newRenderFrame->vertexTrans + i;
         vertex->projectedState = 0;
     }
@@ -6288,13 +9109,13 @@ MINTERNAL int RenderVectorTextNewFrame(RenderContext* rc, RenderFrame* rf, u16 p
     i8* stackData = (i8*)alloca(newRenderFrame->numNormals * 2 + textBufSize);
     i8* textBuffer = stackData;
 
-    newRenderFrame->normals = (u16 *)(stackData + textBufSize);
+    newRenderFrame->normalColours = (u16 *)(stackData + textBufSize);
 #elif FRAME_MEM_USE_STACK_DARY
     i8 textBuffer[textBufSize];
     u16 normals[newRenderFrame->numNormals];
     newRenderFrame->normalColours = normals;
 #elif FRAME_MEM_USE_MALLOC
-    newRenderFrame->normals = (u16 *)MMemStackAlloc(rc->memStack, newRenderFrame->numNormals * sizeof(u16));
+    newRenderFrame->normalColours = (u16 *)MMemStackAlloc(rc->memStack, newRenderFrame->numNormals * sizeof(u16));
 
     i8* textBuffer = (i8*)MMemStackAlloc(rc->memStack, textBufSize);
 #endif
@@ -6644,6 +9465,14 @@ MINTERNAL int RenderAudioCue(RenderContext* renderContext, u16 funcParam) {
     i32 volume = AUDIO_SAMPLE_VOL_MAX - t;
     u16 sampleId = funcParam >> 5;
 
+#ifdef FINTRO_ENTITY_THREADS
+    // Workers can't play samples in entity order, the entity is rendered again when its output is merged
+    if (renderContext->depthTree->unlinked) {
+        renderContext->depthTree->depthTreeLog->broken = TRUE;
+        return 0;
+    }
+#endif
+
     if (renderContext->sceneSetup->audio) {
         Audio_PlaySample(renderContext->sceneSetup->audio, sampleId, volume);
     }
@@ -6884,7 +9713,7 @@ MINTERNAL void RenderConeParams(RenderContext* renderContext, RenderFrame* rf, u
             pts[1] = cap2BezierPts[1];
             pts[2] = cap2BezierPts[4];
             pts[3] = cap2BezierPts[3];
-            BezierSubDivision subDivision1 = InitBezierSubdivision(pts);
+            BezierSubDivision subDivision1 = InitBezierSubdivision(pts, renderContext->bezierDetail);
 
             u16 inUnsigned = (u16) lightCutoffAngle;
             i32 end = inUnsigned >> subDivision1.scaled;
@@ -6899,7 +9728,7 @@ MINTERNAL void RenderConeParams(RenderContext* renderContext, RenderFrame* rf, u
             pts[1] = cap1BezierPts[1];
             pts[2] = cap1BezierPts[4];
             pts[3] = cap1BezierPts[3];
-            BezierSubDivision subDivision2 = InitBezierSubdivision(pts);
+            BezierSubDivision subDivision2 = InitBezierSubdivision(pts, renderContext->bezierDetail);
 
             end = inUnsigned >> subDivision2.scaled;
             AddBezierLinePathToBatch(renderContext, &subDivision2, end);
@@ -7422,6 +10251,9 @@ MINTERNAL int RenderMatrixCopy(RenderContext* scene, u16 funcParam) {
                 MLogf("Unhandled matrix setup %d 2", param0);
                 Matrix3i16Copy(rf->tmpMatrix, rf->entityToView);
             }
+#ifdef VERTEX_BATCH_SIMD
+            rf->batchValid = FALSE;
+#endif
             return 0;
         }
     } else {
@@ -7656,12 +10488,12 @@ MINTERNAL void PlanetProjectPoint(BodyWorkspace* workspace, Vec3i16 vec, BodyPoi
 
     point.x += PLANET_CLIP_BORDER;
     point.y += PLANET_CLIP_BORDER;
-    if ((point.x < 0) || (point.x > (SURFACE_WIDTH + (2 * PLANET_CLIP_BORDER)))) {
+    if ((point.x < 0) || (point.x > (SCREEN_WIDTH + (2 * PLANET_CLIP_BORDER)))) {
         result->clip = (i16)((result->clip & 0x21) | 0x40);
-        if ((point.y < 0) || (point.y > (SURFACE_HEIGHT + (2 * PLANET_CLIP_BORDER)))) {
+        if ((point.y < 0) || (point.y > (SCREEN_HEIGHT + (2 * PLANET_CLIP_BORDER)))) {
             result->clip |= 0x4;
         }
-    } else if ((point.y < 0) || (point.y > (SURFACE_HEIGHT + (2 * PLANET_CLIP_BORDER)))) {
+    } else if ((point.y < 0) || (point.y > (SCREEN_HEIGHT + (2 * PLANET_CLIP_BORDER)))) {
         result->clip = (i16)((result->clip & 0x21) | 0x42);
     }
 
@@ -8034,16 +10866,16 @@ MINTERNAL void PlanetFeatureLineSegSplit(RenderContext* rc, RenderFrame* rf, Bod
     }
 
     // Clipper : TODO - check this is right it looks to be only partial
-    if (pt.y > (SURFACE_HEIGHT - 1)) {
+    if (pt.y > (SCREEN_HEIGHT - 1)) {
         // Feature & planet edge intersection after screen height
-        if (workspace->y2Last >= SURFACE_HEIGHT) {
+        if (workspace->y2Last >= SCREEN_HEIGHT) {
             if (pt.x >= workspace->xLast) {
                 if (pt.x != workspace->xLast || arcClipped >= 0) {
                     return;
                 }
             }
         } else {
-            workspace->y2Last = SURFACE_HEIGHT;
+            workspace->y2Last = SCREEN_HEIGHT;
         }
 
         workspace->xLast = pt.x;
@@ -8051,7 +10883,7 @@ MINTERNAL void PlanetFeatureLineSegSplit(RenderContext* rc, RenderFrame* rf, Bod
         workspace->yMaxHit++;
         return;
     } else {
-        if (pt.x >= SURFACE_WIDTH) {
+        if (pt.x >= SCREEN_WIDTH) {
             if (pt.y < workspace->y2Last) {
                 return;
             }
@@ -8423,8 +11255,8 @@ MINTERNAL void PlanetDrawHalfMode(RenderContext* renderContext, BodyWorkspace* w
     }
 
     i32 farMajorAxisBy2 = (i32)workspace->farMajorAxisDist.v << 1;
-    i32 screenSpaceFarX = ((SURFACE_WIDTH << 15) + ((farMajorAxisBy2 * workspace->axisX) << 1)) >> 16;
-    i32 screenSpaceFarY = ((SURFACE_HEIGHT << 15) - ((farMajorAxisBy2 * workspace->axisY) << 1)) >> 16;
+    i32 screenSpaceFarX = ((SCREEN_WIDTH << 15) + ((farMajorAxisBy2 * workspace->axisX) << 1)) >> 16;
+    i32 screenSpaceFarY = ((SCREEN_HEIGHT << 15) - ((farMajorAxisBy2 * workspace->axisY) << 1)) >> 16;
 
     u16 skyColour = ByteCodeRead16u(rf);
     if (skyColour) {
@@ -9032,7 +11864,7 @@ MINTERNAL int RenderPlanet(RenderContext* renderContext, u16 funcParam) {
     // Add bottom colour toggle if needed
     if (workspace.startToggleColour) {
         DrawParamsBodyToggleColour* bodyXor = BatchBodyToggleColour(renderContext->depthTree);
-        bodyXor->offset = SURFACE_HEIGHT - 1;
+        bodyXor->offset = SCREEN_HEIGHT - 1;
         bodyXor->colour = workspace.startToggleColour;
     }
 
@@ -9054,13 +11886,393 @@ MINTERNAL int RenderPlanet(RenderContext* renderContext, u16 funcParam) {
     return 0;
 }
 
-MINTERNAL void FrameRenderObjects(RenderContext* rc, ModelData* model) {
+#ifdef FINTRO_MODELS_AOT
+// Models translated to C ahead of time (see TranslateModels() in modelcode.c).
+// Each translated instruction calls its handler directly with the func param folded in, then checks the
+// byte code position the handler left behind. If an IF jumped or the size was only known at runtime,
+// 'resume' looks up the translated instruction at the new position, or falls back to the interpreter.
+typedef void (*CompiledModelFunc)(RenderContext* renderContext, RenderFrame* rf, u8* code);
+
+typedef struct sCompiledModel {
+    u16 modelIndex;
+    u16 codeSize;
+    const u8* code; // byte code the function was translated from
+    CompiledModelFunc func;
+} CompiledModel;
+
+#define MODEL_OP(offset, next, func, funcParam) \
+    L##offset: \
+    rf->byteCodePos = code + (offset) + 2; \
+    if (func(renderContext, funcParam) < 0) return; \
+    if (rf->byteCodePos != code + (next)) goto resume;
+
+#define MODEL_OP_END(offset, func, funcParam) \
+    L##offset: \
+    rf->byteCodePos = code + (offset) + 2; \
+    if (func(renderContext, funcParam) < 0) return; \
+    goto resume;
+
+#define MODEL_DONE(offset) \
+    L##offset: \
+    rf->byteCodePos = code + (offset) + 2; \
+    return;
+
+#define MODEL_RESUME_BEGIN \
+    resume: \
+    if (ByteCodeIsDone(rf)) return; \
+    switch (rf->byteCodePos - code) {
+
+#define MODEL_RESUME(offset) case offset: goto L##offset;
+
+#define MODEL_RESUME_END \
+        default: \
+            InterpretModelCode(renderContext, rf); \
+            return; \
+    }
+
+#include "modelsaot.h"
+
+#define NUM_COMPILED_MODELS (sizeof(sCompiledModels) / sizeof(CompiledModel))
+
+MINTERNAL ModelAnalysis* GetModelAnalysis(SceneSetup* sceneSetup, u16 modelIndex, ModelData* model);
+
+// Get the compiled function for a model, if the model's byte code is the same as the code it was compiled from.
+// Models are only compared once analysed (see Render_AnalyseModels()), so the compare can't read past the end of a
+// shorter model's code.
+MINTERNAL CompiledModelFunc CompiledModel_Get(SceneSetup* sceneSetup, ModelData* model, u16 modelIndex) {
+    for (u32 i = 0; i < NUM_COMPILED_MODELS && i < MODELS_AOT_MAX; i++) {
+        const CompiledModel* compiledModel = sCompiledModels + i;
+        if (compiledModel->modelIndex != modelIndex) {
+            continue;
+        }
+        if (sceneSetup->compiledModelsChecked[i] != model) {
+            const u8* code = ((u8*)model) + model->codeOffset;
+            ModelAnalysis* analysis = GetModelAnalysis(sceneSetup, modelIndex, model);
+            b32 match = analysis && analysis->codeSize >= compiledModel->codeSize;
+            for (u32 j = 0; match && j < compiledModel->codeSize; j++) {
+                if (code[j] != compiledModel->code[j]) {
+                    match = FALSE;
+                    break;
+                }
+            }
+            sceneSetup->compiledModelsChecked[i] = model;
+            sceneSetup->compiledModelsMatch[i] = match;
+        }
+        return sceneSetup->compiledModelsMatch[i] ? compiledModel->func : NULL;
+    }
+    return NULL;
+}
+#endif
+
+void Render_ResetCompiledModels(SceneSetup* sceneSetup) {
+#ifdef FINTRO_MODELS_AOT
+    for (int i = 0; i < MODELS_AOT_MAX; i++) {
+        sceneSetup->compiledModelsChecked[i] = NULL;
+        sceneSetup->compiledModelsMatch[i] = FALSE;
+    }
+#endif
+}
+
+// Tmp vertices at the start of each model frame, parent vertices are copied into these
+#define MODEL_TMP_VERTICES 6
+
+// Frame memory FrameRenderObjects() takes for a model
+MINTERNAL u32 ModelAnalysis_FrameBytes(u16 numVertices, u16 numNormals) {
+    u32 bytes = sizeof(VertexData) * (MODEL_TMP_VERTICES + numVertices) + sizeof(u16) * numNormals;
+#ifdef VERTEX_BATCH_SIMD
+    bytes += sizeof(i32) * ((numVertices + 8) & ~7) * 3;
+#endif
+    return bytes;
+}
+
+// See GetValueForParam8()
+MINTERNAL void ModelAnalysis_Param8(ModelAnalysis* analysis, u16 param8) {
+    u16 val = param8 & 0x3f;
+    switch (param8 & 0xc0) {
+        case 0x80:
+            analysis->entityVarsRead |= (u64)1 << val;
+            break;
+        case 0xc0:
+            if (val > 7) {
+                analysis->flags |= MODEL_ANALYSIS_DYNAMIC_VARS;
+            } else {
+                analysis->tmpVarsRead |= (u8)(1 << val);
+            }
+            break;
+    }
+}
+
+// See GetValueForParam16()
+MINTERNAL void ModelAnalysis_Param16(ModelAnalysis* analysis, u16 param16) {
+    if (param16 & 0x80) {
+        ModelAnalysis_Param8(analysis, param16 & 0xff);
+    }
+}
+
+// Walk the byte code reachable by falling through or by IF jumps, noting variables used and the sub models
+// rendered.  Sets a bit in 'children' per sub model, returns the frame memory needed for vector text.
+MINTERNAL u32 ModelAnalysis_Code(SceneSetup* sceneSetup, ModelData* model, ModelAnalysis* analysis, u8* found,
+                                 u32Array* pending, u32* children) {
+    const u8* code = ((u8*)model) + model->codeOffset;
+    u32 textBytes = 0;
+    u32 codeSize = 0;
+
+    MArrayClear(*pending);
+    MArrayAdd(*pending, 0);
+    found[0] = 1;
+    while (MArraySize(*pending)) {
+        u32 offset = MArrayPop(*pending);
+        u16 funcParam = ModelCode_Read16(code, offset);
+        u32 size = ModelCode_InstructionSize(code, offset);
+        u16 param1 = size == 2 ? 0 : ModelCode_Read16(code, offset + 2);
+        if (offset + 2 > codeSize) {
+            codeSize = offset + 2;
+        }
+
+        switch (funcParam & 0x1f) {
+            case Render_DONE:
+                continue;
+            case Render_CIRCLE:
+            case Render_CICLES:
+            case Render_MATRIX_TRANSFORM:
+                ModelAnalysis_Param16(analysis, param1);
+                break;
+            case Render_IF_VAR:
+            case Render_IF_NOT_VAR:
+                ModelAnalysis_Param8(analysis, param1 & 0xff);
+                break;
+            case Render_CALC_A:
+            case Render_CALC_B: {
+                ModelAnalysis_Param8(analysis, param1 & 0xff);
+                ModelAnalysis_Param8(analysis, param1 >> 8);
+                if (((funcParam >> 4) & 0xf) == MathFunc_GetModelVar) {
+                    analysis->flags |= MODEL_ANALYSIS_DYNAMIC_VARS;
+                }
+                analysis->tmpVarsWritten |= (u8)(1 << ((funcParam >> 8) & 0x7));
+                break;
+            }
+            case Render_COLOUR:
+                if (param1 >> 8) {
+                    ModelAnalysis_Param8(analysis, param1 >> 8);
+                }
+                break;
+            case Render_MATRIX_COPY:
+                if (!(funcParam & 0x8000)) {
+                    ModelAnalysis_Param8(analysis, (funcParam >> 4) & 0xff);
+                }
+                break;
+            case Render_MODEL_SCALE: {
+                u16 param2 = ModelCode_Read16(code, offset + 4);
+                if (param2 & 0x800) {
+                    if ((param2 >> 12) > 7) {
+                        analysis->flags |= MODEL_ANALYSIS_DYNAMIC_VARS;
+                    } else {
+                        analysis->tmpVarsRead |= (u8)(1 << (param2 >> 12));
+                    }
+                }
+                u16 modelIndex = (funcParam >> 5) & 0xff;
+                children[modelIndex >> 5] |= 1u << (modelIndex & 0x1f);
+                break;
+            }
+            case Render_MODEL: {
+                u16 modelIndex = (funcParam >> 5) & 0xff;
+                children[modelIndex >> 5] |= 1u << (modelIndex & 0x1f);
+                break;
+            }
+            case Render_VTEXT: {
+                // Text strings can be formatted from entity variables
+                analysis->flags |= MODEL_ANALYSIS_DYNAMIC_VARS;
+                u16 fontIndex = param1 >> 12;
+                if (fontIndex < MArraySize(sceneSetup->assets.fonts) && MArrayGet(sceneSetup->assets.fonts, fontIndex)) {
+                    FontModelData* font = GetFontModel(sceneSetup, fontIndex);
+                    u32 bytes = font->verticesDataSize + 4 * sizeof(u16) + 0x80;
+                    if (bytes > textBytes) {
+                        textBytes = bytes;
+                    }
+                } else if (!textBytes) {
+                    // Still takes a frame
+                    textBytes = 1;
+                }
+                break;
+            }
+            case Render_PLANET:
+                analysis->entityVarsRead |= (1 << 2) | (1 << 3);
+                analysis->flags |= MODEL_ANALYSIS_DYNAMIC_VARS;
+                break;
+            default:
+                break;
+        }
+
+        if (!size) {
+            analysis->flags |= MODEL_ANALYSIS_PARTIAL;
+            continue;
+        }
+        if (offset + size > codeSize) {
+            codeSize = offset + size;
+        }
+
+        u32 next[2] = { offset + size, ModelCode_BranchTarget(code, offset, size) };
+        for (int i = 0; i < 2; i++) {
+            if (!next[i]) {
+                continue;
+            }
+            if (next[i] + 4 > MODEL_CODE_MAX_SIZE) {
+                analysis->flags |= MODEL_ANALYSIS_PARTIAL;
+            } else if (!found[next[i]]) {
+                found[next[i]] = 1;
+                MArrayAdd(*pending, next[i]);
+            }
+        }
+    }
+
+    memset(found, 0, codeSize + 4 < MODEL_CODE_MAX_SIZE ? codeSize + 4 : MODEL_CODE_MAX_SIZE);
+    analysis->codeSize = codeSize;
+
+    // Vertices that lerp by a variable
+    u16* vertexData = (u16*)(((u8*)model) + model->vertexDataOffset);
+    for (int i = 0; i + 1 < analysis->numVertices; i += 2) {
+        u8 vertexType = vertexData[i] >> 8;
+        if (vertexType == 0x13 || vertexType == 0x14) {
+            ModelAnalysis_Param8(analysis, vertexData[i] & 0xff);
+        }
+    }
+
+    return textBytes;
+}
+
+// Combine a model's analysis with its sub models, depth first
+MINTERNAL void ModelAnalysis_Tree(SceneSetup* sceneSetup, u32 modelIndex, u32* children, u32* textBytes, u8* state) {
+    ModelAnalysis* analysis = MArrayGetPtr(sceneSetup->modelAnalysis, modelIndex);
+    u16 depth = textBytes[modelIndex] ? 1 : 0;
+    u32 stackBytes = textBytes[modelIndex];
+
+    state[modelIndex] = 1;
+    for (u32 i = 0; i < 256; i++) {
+        if (!(children[modelIndex * 8 + (i >> 5)] & (1u << (i & 0x1f)))) {
+            continue;
+        }
+        if (i >= MArraySize(sceneSetup->modelAnalysis) || !MArrayGet(sceneSetup->assets.models, i)) {
+            continue;
+        }
+        if (state[i] == 1) {
+            analysis->flags |= MODEL_ANALYSIS_RECURSIVE;
+            continue;
+        }
+        if (state[i] == 0) {
+            ModelAnalysis_Tree(sceneSetup, i, children, textBytes, state);
+        }
+        ModelAnalysis* child = MArrayGetPtr(sceneSetup->modelAnalysis, i);
+        if (child->depth > depth) {
+            depth = child->depth;
+        }
+        if (child->stackBytes > stackBytes) {
+            stackBytes = child->stackBytes;
+        }
+        analysis->flags |= child->flags;
+        analysis->entityVarsRead |= child->entityVarsRead;
+    }
+    state[modelIndex] = 2;
+
+    analysis->depth = depth + 1;
+    analysis->stackBytes = analysis->frameBytes + stackBytes;
+
+    // Frame 0 is never rendered to
+    if (analysis->depth > RENDER_FRAMES_DEPTH - 1) {
+        analysis->flags |= MODEL_ANALYSIS_OVERFLOW;
+    }
+}
+
+void Render_AnalyseModels(SceneSetup* sceneSetup) {
+    ModelsArray* models = &sceneSetup->assets.models;
+    u32 numModels = MArraySize(*models) < 256 ? MArraySize(*models) : 256;
+
+    MArrayClear(sceneSetup->modelAnalysis);
+    MArrayGrow(sceneSetup->modelAnalysis, numModels);
+    sceneSetup->modelAnalysis.p.size = numModels;
+    memset(sceneSetup->modelAnalysis.arr, 0, sizeof(ModelAnalysis) * numModels);
+
+    u8* found = (u8*)MMalloc(MODEL_CODE_MAX_SIZE);
+    memset(found, 0, MODEL_CODE_MAX_SIZE);
+    u32Array pending;
+    MArrayInit(pending);
+    u32* children = (u32*)MMalloc(sizeof(u32) * 8 * numModels);
+    memset(children, 0, sizeof(u32) * 8 * numModels);
+    u32* textBytes = (u32*)MMalloc(sizeof(u32) * numModels);
+    u8* state = (u8*)MMalloc(numModels);
+    memset(state, 0, numModels);
+
+    for (u32 i = 0; i < numModels; i++) {
+        ModelData* model = MArrayGet(*models, i);
+        ModelAnalysis* analysis = MArrayGetPtr(sceneSetup->modelAnalysis, i);
+        textBytes[i] = 0;
+        if (!model) {
+            continue;
+        }
+        analysis->model = model;
+        analysis->numVertices = model->verticesDataSize / sizeof(VertexData);
+        analysis->numNormals = model->normalDataSize >> (u16)1;
+        if (analysis->numNormals < 2) {
+            analysis->numNormals = 2;
+        }
+        analysis->frameBytes = ModelAnalysis_FrameBytes(analysis->numVertices, analysis->numNormals);
+        textBytes[i] = ModelAnalysis_Code(sceneSetup, model, analysis, found, &pending, children + i * 8);
+    }
+
+#if FRAME_MEM_USE_MALLOC
+    u32 stackBytes = 0;
+#endif
+    for (u32 i = 0; i < numModels; i++) {
+        ModelAnalysis* analysis = MArrayGetPtr(sceneSetup->modelAnalysis, i);
+        if (!analysis->model) {
+            continue;
+        }
+        if (!state[i]) {
+            ModelAnalysis_Tree(sceneSetup, i, children, textBytes, state);
+        }
+#if FRAME_MEM_USE_MALLOC
+        if (analysis->stackBytes > stackBytes) {
+            stackBytes = analysis->stackBytes;
+        }
+#endif
+        if (analysis->flags & MODEL_ANALYSIS_RECURSIVE) {
+            MLogf("Model %d renders itself as a sub model, frames past %d are reused", i, RENDER_FRAMES_DEPTH - 1);
+        } else if (analysis->flags & MODEL_ANALYSIS_OVERFLOW) {
+            MLogf("Model %d nests sub models %d frames deep, frames past %d are reused", i, analysis->depth,
+                  RENDER_FRAMES_DEPTH - 1);
+        }
+    }
+
+#if FRAME_MEM_USE_MALLOC
+    // Only ever grow, so anything the walk under-estimates still has the default size to spare
+    if (stackBytes > sceneSetup->memStack.size) {
+        MMemStackFree(&sceneSetup->memStack);
+        MMemStackInit(&sceneSetup->memStack, stackBytes);
+    }
+#endif
+
+    MFree(state, numModels);
+    MFree(textBytes, sizeof(u32) * numModels);
+    MFree(children, sizeof(u32) * 8 * numModels);
+    MArrayFree(pending);
+    MFree(found, MODEL_CODE_MAX_SIZE);
+}
+
+// Analysis for a model, or NULL if the model was not analysed or has been replaced since
+MINTERNAL ModelAnalysis* GetModelAnalysis(SceneSetup* sceneSetup, u16 modelIndex, ModelData* model) {
+    if (modelIndex >= MArraySize(sceneSetup->modelAnalysis)) {
+        return NULL;
+    }
+    ModelAnalysis* analysis = MArrayGetPtr(sceneSetup->modelAnalysis, modelIndex);
+    return analysis->model == model ? analysis : NULL;
+}
+
+MINTERNAL void FrameRenderObjects(RenderContext* rc, ModelData* model, u16 modelIndex) {
     RenderFrame* rf = GetRenderFrame(rc);
 
     rf->vertexData = (u16*) (((u8*)model) + model->vertexDataOffset);
 
     rf->numVertexModel = model->verticesDataSize / sizeof(VertexData);
-    rf->numVertexTmp = 6;
+    rf->numVertexTmp = MODEL_TMP_VERTICES;
     rf->numNormals = model->normalDataSize >> (u16)1;
     if (rf->numNormals < 2) {
         rf->numNormals = 2;
@@ -9068,6 +12280,9 @@ MINTERNAL void FrameRenderObjects(RenderContext* rc, ModelData* model) {
 
     rf->modelData = model;
     rf->normalOffset = model->normalsOffset;
+#ifdef FINTRO_VM_PROFILE
+    rf->profileModel = modelIndex & 0xff;
+#endif
 
     // Normalize view direction down if we need to
     int scale = rf->scale - (8 + rf->viewDirScale);
@@ -9094,6 +12309,26 @@ MINTERNAL void FrameRenderObjects(RenderContext* rc, ModelData* model) {
     // Skip past the tmp vertices
     rf->vertexTrans += rf->numVertexTmp;
 
+#ifdef VERTEX_BATCH_SIMD
+    // Room for the 4 pair writes past the last pair, shifts outside 0..31 stay on the scalar path
+    rf->batchStride = (u16)((rf->numVertexModel + 8) & ~7);
+#if FRAME_MEM_USE_STACK_DARY
+    i32 batchVertices[rf->batchStride * 3];
+#endif
+    if ((u16)((u16)0x17 - rf->scale) < 32) {
+#if FRAME_MEM_USE_STACK_ALLOC
+        rf->batchVertices = (i32*)alloca(sizeof(i32) * rf->batchStride * 3);
+#elif FRAME_MEM_USE_STACK_DARY
+        rf->batchVertices = batchVertices;
+#elif FRAME_MEM_USE_MALLOC
+        rf->batchVertices = (i32*)MMemStackAlloc(rc->memStack, sizeof(i32) * rf->batchStride * 3);
+#endif
+    } else {
+        rf->batchVertices = NULL;
+    }
+    rf->batchValid = FALSE;
+#endif
+
 #if FRAME_MEM_USE_STACK_DARY
     u16 normals[rf->numNormals];
 #endif
@@ -9122,7 +12357,16 @@ MINTERNAL void FrameRenderObjects(RenderContext* rc, ModelData* model) {
     rf->debug = &rc->sceneSetup->debug;
     rf->fileDataStartAddress = rc->sceneSetup->debug.modelDataFileStartAddress;
 #endif
+#ifdef FINTRO_MODELS_AOT
+    CompiledModelFunc compiledFunc = CompiledModel_Get(rc->sceneSetup, model, modelIndex);
+    if (compiledFunc) {
+        compiledFunc(rc, rf, data);
+    } else {
+        InterpretModelCode(rc, rf);
+    }
+#else
     InterpretModelCode(rc, rf);
+#endif
 
 #if FRAME_MEM_USE_MALLOC
     MMemStackReset(rc->memStack, stackMemStart);
@@ -9130,6 +12374,9 @@ MINTERNAL void FrameRenderObjects(RenderContext* rc, ModelData* model) {
 
     rf->vertexTrans = NULL;
     rf->normalColours = NULL;
+#ifdef VERTEX_BATCH_SIMD
+    rf->batchVertices = NULL;
+#endif
 }
 
 void Entity_Init(RenderEntity* entity) {
@@ -9149,16 +12396,53 @@ void SceneSetup_InitDefaultShadeRamp(SceneSetup* sceneSetup) {
     sceneSetup->shadeRamp[7] = 0x0111;
 }
 
+#ifdef FINTRO_ENTITY_THREADS
+MINTERNAL void EntityThreads_Free(SceneSetup* sceneSetup);
+#endif
+
 void Render_Init(SceneSetup* sceneSetup, RasterContext* raster) {
     sceneSetup->audio = NULL;
     sceneSetup->raster = raster;
     sceneSetup->random1 = 0x12345678;
     sceneSetup->random2 = 0x89abcdef;
     MMemStackInit(&sceneSetup->memStack, 0x4000);
+    MArrayInit(sceneSetup->modelAnalysis);
+    MArrayInit(sceneSetup->entityKeys);
+    MArrayInit(sceneSetup->entityKeysTmp);
+#ifdef FINTRO_ENTITY_THREADS
+    sceneSetup->numEntityThreads = 1;
+    sceneSetup->entityThreads = NULL;
+#endif
+    Render_ResetCompiledModels(sceneSetup);
+#ifdef FINTRO_DETAIL_GOVERNOR
+    memset(&sceneSetup->governor, 0, sizeof(DetailGovernor));
+    sceneSetup->governor.level = DETAIL_LEVEL_DEFAULT;
+#endif
+
+#ifdef FINTRO_VM_PROFILE
+    sceneSetup->vmProfile = NULL;
+    sceneSetup->vmProfileEnabled = FALSE;
+#endif
 }
 
 void Render_Free(SceneSetup* sceneSetup) {
     MMemStackFree(&sceneSetup->memStack);
+    MArrayFree(sceneSetup->modelAnalysis);
+    MArrayFree(sceneSetup->entityKeys);
+    MArrayFree(sceneSetup->entityKeysTmp);
+
+#ifdef FINTRO_ENTITY_THREADS
+    EntityThreads_Free(sceneSetup);
+    sceneSetup->numEntityThreads = 1;
+#endif
+
+#ifdef FINTRO_VM_PROFILE
+    if (sceneSetup->vmProfile) {
+        MFree(sceneSetup->vmProfile, sizeof(VMProfile));
+        sceneSetup->vmProfile = NULL;
+    }
+    sceneSetup->vmProfileEnabled = FALSE;
+#endif
 
 #ifdef FINTRO_INSPECTOR
     MArrayFree(sceneSetup->debug.byteCodeTrace);
@@ -9166,46 +12450,55 @@ void Render_Free(SceneSetup* sceneSetup) {
 #endif
 }
 
-void Render_RenderScene(SceneSetup* sceneSetup, RenderEntity* entity) {
-    RenderContext renderContext;
+// Set up the context for rendering entities into the scene's depth tree, clears the depth tree
+MINTERNAL void RenderScene_Begin(RenderContext* renderContext, SceneSetup* sceneSetup) {
+    renderContext->random1 = sceneSetup->random1;
+    renderContext->random2 = sceneSetup->random2;
 
-    memset(renderContext.renderFrame, 0, sizeof(renderContext.renderFrame));
+    renderContext->depthTree = &sceneSetup->raster->depthTree;
+    DepthTree_Clear(renderContext->depthTree);
 
-    renderContext.currentRenderFrame = renderContext.renderFrame;
-    renderContext.currentRenderFrameIx = 0;
+    Screen_SetForSurface(sceneSetup->raster->surface);
+    renderContext->width = sceneSetup->raster->surface->width;
+    renderContext->height = sceneSetup->raster->surface->height;
 
-    renderContext.random1 = sceneSetup->random1;
-    renderContext.random2 = sceneSetup->random2;
+    renderContext->renderDetail = sceneSetup->renderDetail;
+    renderContext->planetDetail = sceneSetup->planetDetail;
+    renderContext->planetMinAtmosBandWidth = sceneSetup->planetMinAtmosBandWidth;
+    renderContext->bezierDetail = sceneSetup->raster->bezierDetail;
 
-    renderContext.depthTree = &sceneSetup->raster->depthTree;
-    DepthTree_Clear(renderContext.depthTree);
+    renderContext->currentBatchId = 0;
 
-    renderContext.width = sceneSetup->raster->surface->width;
-    renderContext.height = sceneSetup->raster->surface->height;
+    renderContext->palette = &(sceneSetup->raster->paletteContext);
+    renderContext->memStack = &sceneSetup->memStack;
+    renderContext->sceneSetup = sceneSetup;
 
-    renderContext.renderDetail = sceneSetup->renderDetail;
-    renderContext.planetDetail = sceneSetup->planetDetail;
-    renderContext.planetMinAtmosBandWidth = sceneSetup->planetMinAtmosBandWidth;
-
-    renderContext.currentBatchId = 0;
+#ifdef FINTRO_INSPECTOR
+    renderContext->debug = &sceneSetup->debug;
+#endif
+}
 
-    renderContext.palette = &(sceneSetup->raster->paletteContext);
+MINTERNAL void RenderScene_Entity(RenderContext* renderContext, RenderEntity* entity, ModelData* modelData) {
+    SceneSetup* sceneSetup = renderContext->sceneSetup;
 
-    renderContext.currentRenderFrame = NULL;
-    RenderFrame* rf = PushRenderFrame(&renderContext);
+    // Only clear the frames the model can reach
+    u32 numFrames = RENDER_FRAMES_DEPTH;
+    ModelAnalysis* analysis = GetModelAnalysis(sceneSetup, entity->modelIndex, modelData);
+    if (analysis && !(analysis->flags & (MODEL_ANALYSIS_PARTIAL | MODEL_ANALYSIS_RECURSIVE | MODEL_ANALYSIS_OVERFLOW))) {
+        numFrames = 1 + analysis->depth;
+    }
+    memset(renderContext->renderFrame, 0, sizeof(RenderFrame) * numFrames);
 
-    renderContext.entity = entity;
-    renderContext.memStack = &sceneSetup->memStack;
+    renderContext->currentRenderFrame = NULL;
+    renderContext->currentRenderFrameIx = 0;
+    RenderFrame* rf = PushRenderFrame(renderContext);
 
-    renderContext.sceneSetup = sceneSetup;
+    renderContext->entity = entity;
 
     rf->entity = entity;
     rf->matrixWinding = 0;
 
-    ModelData* modelData = Render_GetModel(sceneSetup, entity->modelIndex);
-
 #ifdef FINTRO_INSPECTOR
-    renderContext.debug = &sceneSetup->debug;
     rf->debug = &sceneSetup->debug;
 #endif
 
@@ -9221,7 +12514,7 @@ void Render_RenderScene(SceneSetup* sceneSetup, RenderEntity* entity) {
     rf->debug->modelsVisited++;
 #endif
 
-    if (!IsModelVisible(&renderContext, modelData)) {
+    if (!IsModelVisible(renderContext, modelData)) {
 #ifdef FINTRO_INSPECTOR
         rf->debug->modelsSkipped++;
 #endif
@@ -9239,21 +12532,589 @@ void Render_RenderScene(SceneSetup* sceneSetup, RenderEntity* entity) {
         rf->shadeRamp[i] = sceneSetup->shadeRamp[i];
     }
 
-    TransformLightAndViewVectors(&renderContext);
+    TransformLightAndViewVectors(renderContext);
 
-    FrameRenderObjects(&renderContext, modelData);
+    FrameRenderObjects(renderContext, modelData, entity->modelIndex);
 
-    if (renderContext.currentBatchId != 0) {
-        WriteDrawFunc(renderContext.depthTree, DRAW_FUNC_BATCH_END);
+    if (renderContext->currentBatchId != 0) {
+        WriteDrawFunc(renderContext->depthTree, DRAW_FUNC_BATCH_END);
     }
-    renderContext.currentBatchId = 0;
+    renderContext->currentBatchId = 0;
+}
 
+MINTERNAL void RenderScene_End(RenderContext* renderContext, SceneSetup* sceneSetup) {
     // Save updated seed for next frame
-    sceneSetup->random1 = renderContext.random1;
-    sceneSetup->random2 = renderContext.random2;
+    sceneSetup->random1 = renderContext->random1;
+    sceneSetup->random2 = renderContext->random2;
+}
+
+void Render_RenderScene(SceneSetup* sceneSetup, RenderEntity* entity) {
+    RenderContext renderContext;
+    RenderScene_Begin(&renderContext, sceneSetup);
+    RenderScene_Entity(&renderContext, entity, Render_GetModel(sceneSetup, entity->modelIndex));
+    RenderScene_End(&renderContext, sceneSetup);
+}
+
+// Each entity's random values are seeded by its index, so they don't depend on the order entities are rendered in
+MINTERNAL void RenderScene_SeedEntity(RenderContext* renderContext, SceneSetup* sceneSetup, u32 entityIndex) {
+    renderContext->random1 = sceneSetup->random1 + entityIndex * 0x9e3779b9u;
+    renderContext->random2 = sceneSetup->random2;
+}
+
+#ifdef FINTRO_ENTITY_THREADS
+// Output of an entity rendered by a worker, a range of the worker's log
+typedef struct sEntityRecord {
+    u32 startEvent;
+    u32 endEvent;
+    u32 startColour;
+    u32 endColour;
+    u32 endOffset; // End of the last event's data
+    b32 broken;    // Output couldn't be logged, the entity is rendered again when merged
+} EntityRecord;
+
+MARRAY_TYPEDEF(EntityRecord, EntityRecordArray)
+
+typedef struct sEntityWorker {
+    RenderContext renderContext;
+    DepthTree depthTree;    // Unlinked, the output of all the worker's entities one after another
+    DepthTreeLog log;
+    PaletteContext palette; // Copy of the scene palette, merged output is only valid if colours get the same indexes
+    MMemStack memStack;
+    struct sEntityThreads* threads;
+    u16 index;
+#ifdef ENTITY_THREADS
+    SDL_Thread* thread;
+    SDL_sem* start;
+    SDL_sem* done;
+    b32 quit;
+#endif
+} EntityWorker;
+
+typedef struct sEntityThreads {
+    u16 numWorkers;
+    EntityWorker workers[ENTITY_MAX_THREADS];
+
+    // Entities being rendered, in depth order, 'numEntities' is 0 while not using the workers
+    RenderEntity* entities;
+    DepthListKey* keys;
+    u32 numEntities;
+    EntityRecordArray records;
+
+#ifdef ENTITY_THREADS
+    SDL_mutex* heapLock;
+#endif
+} EntityThreads;
+
+MINTERNAL void EntityWorker_Run(EntityWorker* worker) {
+    EntityThreads* threads = worker->threads;
+    RenderContext* rc = &worker->renderContext;
+    DepthTree* depthTree = &worker->depthTree;
+    DepthTreeLog* log = &worker->log;
+    Screen_SetForSurface(rc->sceneSetup->raster->surface);
+
+    DepthTree_Clear(depthTree);
+    MArrayClear(log->events);
+    MArrayClear(log->colours);
+
+    // Entities are shared out in turn by depth order
+    for (u32 i = worker->index; i < threads->numEntities; i += threads->numWorkers) {
+        EntityRecord* record = threads->records.arr + i;
+        u32 entityIndex = threads->keys[i].offset;
+        RenderEntity* entity = threads->entities + entityIndex;
+
+        // Same as the scene's depth tree, pops past the end of the model's own sub trees pop the entity's
+        u32 numSubTrees = MArraySize(depthTree->subTrees);
+        DepthTree_PushSubTree(depthTree, (i32)threads->keys[i].z);
+        u32 startOffset = depthTree->offset;
+
+        depthTree->depthTreeLog = log;
+        worker->palette.depthTreeLog = log;
+        log->broken = FALSE;
+        record->startEvent = MArraySize(log->events);
+        record->startColour = MArraySize(log->colours);
+
+        RenderScene_SeedEntity(rc, rc->sceneSetup, entityIndex);
+        RenderScene_Entity(rc, entity, Render_GetModel(rc->sceneSetup, entity->modelIndex));
+
+        DepthTreeLog_Rewind(log, depthTree->offset);
+        record->endEvent = MArraySize(log->events);
+        record->endColour = MArraySize(log->colours);
+        record->endOffset = depthTree->offset;
+        // Output written before the first event wasn't seen
+        record->broken = log->broken || (record->endEvent < record->startEvent)
+                || (record->endEvent > record->startEvent && log->events.arr[record->startEvent].before != startOffset);
+
+        depthTree->depthTreeLog = NULL;
+        worker->palette.depthTreeLog = NULL;
+        while (MArraySize(depthTree->subTrees) > numSubTrees) {
+            DepthTree_PopSubTree(depthTree);
+        }
+    }
+}
+
+#ifdef ENTITY_THREADS
+MINTERNAL int EntityWorker_ThreadMain(void* data) {
+    EntityWorker* worker = (EntityWorker*)data;
+    for (;;) {
+        SDL_SemWait(worker->start);
+        if (worker->quit) {
+            break;
+        }
+        EntityWorker_Run(worker);
+        SDL_SemPost(worker->done);
+    }
+    return 0;
+}
+#endif
+
+MINTERNAL void EntityThreads_Init(SceneSetup* sceneSetup, u16 numWorkers) {
+    EntityThreads* threads = (EntityThreads*)MMalloc(sizeof(EntityThreads));
+    memset(threads, 0, sizeof(EntityThreads));
+    threads->numWorkers = numWorkers;
+    MArrayInit(threads->records);
+
+    for (u16 i = 0; i < numWorkers; i++) {
+        EntityWorker* worker = threads->workers + i;
+        worker->threads = threads;
+        worker->index = i;
+        DepthTree_Init(&worker->depthTree);
+        worker->depthTree.unlinked = TRUE;
+        MArrayInit(worker->log.events);
+        MArrayInit(worker->log.colours);
+        MMemStackInit(&worker->memStack, sceneSetup->memStack.size);
+
+#ifdef ENTITY_THREADS
+        // First worker runs on the calling thread
+        if (i > 0) {
+            worker->start = SDL_CreateSemaphore(0);
+            worker->done = SDL_CreateSemaphore(0);
+            worker->thread = SDL_CreateThread(EntityWorker_ThreadMain, "entity", worker);
+        }
+#endif
+    }
+
+#ifdef ENTITY_THREADS
+    threads->heapLock = SDL_CreateMutex();
+#endif
+
+    sceneSetup->entityThreads = threads;
+}
+
+MINTERNAL void EntityThreads_Free(SceneSetup* sceneSetup) {
+    EntityThreads* threads = sceneSetup->entityThreads;
+    if (!threads) {
+        return;
+    }
+
+    for (u16 i = 0; i < threads->numWorkers; i++) {
+        EntityWorker* worker = threads->workers + i;
+#ifdef ENTITY_THREADS
+        if (worker->thread) {
+            worker->quit = TRUE;
+            SDL_SemPost(worker->start);
+            SDL_WaitThread(worker->thread, NULL);
+            SDL_DestroySemaphore(worker->start);
+            SDL_DestroySemaphore(worker->done);
+        }
+#endif
+        DepthTree_Free(&worker->depthTree);
+        MArrayFree(worker->log.events);
+        MArrayFree(worker->log.colours);
+        MMemStackFree(&worker->memStack);
+    }
+
+#ifdef ENTITY_THREADS
+    SDL_DestroyMutex(threads->heapLock);
+#endif
+    MArrayFree(threads->records);
+    MFree(threads, sizeof(EntityThreads));
+    sceneSetup->entityThreads = NULL;
+}
+
+// Run the model code of the sorted entities on the workers, their output is merged by RenderScene_EntityRange()
+MINTERNAL void EntityThreads_Render(RenderContext* sceneContext, EntityThreads* threads, RenderEntity* entities,
+                                    DepthListKey* keys, u32 numEntities) {
+    SceneSetup* sceneSetup = sceneContext->sceneSetup;
+    threads->entities = entities;
+    threads->keys = keys;
+    threads->numEntities = numEntities;
+    MArrayClear(threads->records);
+    MArrayGrow(threads->records, numEntities);
+    threads->records.p.size = numEntities;
+
+#ifdef FINTRO_MODELS_AOT
+    // Check the compiled models up front, workers only read the results
+    for (u32 i = 0; i < NUM_COMPILED_MODELS && i < MODELS_AOT_MAX; i++) {
+        u16 modelIndex = sCompiledModels[i].modelIndex;
+        if (modelIndex < MArraySize(sceneSetup->assets.models) && Render_GetModel(sceneSetup, modelIndex)) {
+            CompiledModel_Get(sceneSetup, Render_GetModel(sceneSetup, modelIndex), modelIndex);
+        }
+    }
+#endif
+
+    for (u16 i = 0; i < threads->numWorkers; i++) {
+        EntityWorker* worker = threads->workers + i;
+        RenderContext* rc = &worker->renderContext;
+        rc->depthTree = &worker->depthTree;
+        rc->width = sceneContext->width;
+        rc->height = sceneContext->height;
+        rc->renderDetail = sceneContext->renderDetail;
+        rc->planetDetail = sceneContext->planetDetail;
+        rc->planetMinAtmosBandWidth = sceneContext->planetMinAtmosBandWidth;
+        rc->bezierDetail = sceneContext->bezierDetail;
+        rc->currentBatchId = 0;
+        rc->palette = &worker->palette;
+        rc->memStack = &worker->memStack;
+        rc->sceneSetup = sceneSetup;
+
+        memcpy(&worker->palette, sceneContext->palette, sizeof(PaletteContext));
+#ifdef FINTRO_PALETTE_STATS
+        // Worker lookups are repeated on the scene palette when their output is replayed, that's where they're counted
+        worker->palette.stats = NULL;
+#endif
+        // Frame memory is sized by Render_AnalyseModels()
+        if (worker->memStack.size != sceneSetup->memStack.size) {
+            MMemStackFree(&worker->memStack);
+            MMemStackInit(&worker->memStack, sceneSetup->memStack.size);
+        }
+    }
+
+#ifdef ENTITY_THREADS
+    sEntityHeapLock = threads->heapLock;
+    for (u16 i = 1; i < threads->numWorkers; i++) {
+        SDL_SemPost(threads->workers[i].start);
+    }
+
+    EntityWorker_Run(threads->workers);
+
+    for (u16 i = 1; i < threads->numWorkers; i++) {
+        SDL_SemWait(threads->workers[i].done);
+    }
+    sEntityHeapLock = NULL;
+#else
+    for (u16 i = 0; i < threads->numWorkers; i++) {
+        EntityWorker_Run(threads->workers + i);
+    }
+#endif
+}
+
+// Replay the worker output for the i'th entity in depth order into the scene's depth tree, returns FALSE if it has to
+// be rendered again instead
+MINTERNAL b32 EntityThreads_Replay(RenderContext* renderContext, u32 i) {
+    EntityThreads* threads = renderContext->sceneSetup->entityThreads;
+    if (!threads || !threads->numEntities) {
+        return FALSE;
+    }
+
+    EntityRecord* record = threads->records.arr + i;
+    if (record->broken) {
+        return FALSE;
+    }
+
+    // Look the colours up in the same order as the model code did, if they are given different indexes the entity is
+    // rendered again and repeats the same lookups
+    EntityWorker* worker = threads->workers + (i % threads->numWorkers);
+    DepthTreeLog* log = &worker->log;
+    for (u32 c = record->startColour; c < record->endColour; c++) {
+        u32 colour = log->colours.arr[c];
+        if (Palette_AllocIndexFor12bitColour(renderContext->palette, (u16)colour) != (u8)(colour >> 16)) {
+            return FALSE;
+        }
+    }
+
+    for (u32 e = record->startEvent; e < record->endEvent; e++) {
+        DepthTreeEvent* event = log->events.arr + e;
+        u32 end = (e + 1 < record->endEvent) ? event[1].before : record->endOffset;
+        DepthTree_ReplayEvent(renderContext->depthTree, event->type, event->z,
+                              DepthTree_Ptr(&worker->depthTree, event->start), end - event->start);
+    }
+    return TRUE;
+}
+#endif
+
+// Render the sorted entities median first, so their sub tree nodes form a balanced tree rather than a list
+MINTERNAL void RenderScene_EntityRange(RenderContext* renderContext, RenderEntity* entities, DepthListKey* keys,
+                                       u32 start, u32 end) {
+    if (start >= end) {
+        return;
+    }
+
+    u32 mid = start + ((end - start) >> 1);
+    RenderEntity* entity = entities + keys[mid].offset;
+    DepthTree* depthTree = renderContext->depthTree;
+    u32 numSubTrees = MArraySize(depthTree->subTrees);
+    DepthTree_PushSubTree(depthTree, (i32)keys[mid].z);
+    RenderScene_SeedEntity(renderContext, renderContext->sceneSetup, keys[mid].offset);
+#ifdef FINTRO_ENTITY_THREADS
+    if (!EntityThreads_Replay(renderContext, mid))
+#endif
+    {
+        RenderScene_Entity(renderContext, entity, Render_GetModel(renderContext->sceneSetup, entity->modelIndex));
+    }
+    // Model code can skip past its own sub tree pops, the next entity must start at the top level again
+    while (MArraySize(depthTree->subTrees) > numSubTrees) {
+        DepthTree_PopSubTree(depthTree);
+    }
+
+    RenderScene_EntityRange(renderContext, entities, keys, start, mid);
+    RenderScene_EntityRange(renderContext, entities, keys, mid + 1, end);
+}
+
+u32 Render_RenderSceneEntities(SceneSetup* sceneSetup, RenderEntity* entities, u32 numEntities) {
+    RenderContext renderContext;
+    RenderScene_Begin(&renderContext, sceneSetup);
+
+    // Cull before running any model code, keys are the depth each entity's sub tree is sorted at
+    DepthListKeyArray* keys = &sceneSetup->entityKeys;
+    MArrayClear(*keys);
+    for (u32 i = 0; i < numEntities; i++) {
+        RenderEntity* entity = entities + i;
+        ModelData* modelData = NULL;
+        if (entity->modelIndex < MArraySize(sceneSetup->assets.models)) {
+            modelData = Render_GetModel(sceneSetup, entity->modelIndex);
+        }
+        if (!modelData) {
+            MLogf("Entity %u has no model loaded for model %d, skipped", i, entity->modelIndex);
+            continue;
+        }
+        u16 scale = (u16)(modelData->scale1 + modelData->scale2 - entity->depthScale);
+        if (IsModelVisibleAt(modelData, scale, entity->entityPos)) {
+            // Offset holds the entity index
+            DepthListKey key = { (u32)CalcVec3i32DepthForScale(entity->depthScale, entity->entityPos), i, 0 };
+            MArrayAdd(*keys, key);
+        }
+    }
+
+    // Back to front, same as the depth list
+    u32 n = MArraySize(*keys);
+    MArrayClear(sceneSetup->entityKeysTmp);
+    MArrayGrow(sceneSetup->entityKeysTmp, n);
+    if (n > 1) {
+        for (u32 pass = 0; pass < 4; pass++) {
+            if (DepthList_RadixPass(keys->arr, sceneSetup->entityKeysTmp.arr, n, pass)) {
+                DepthListKey* sorted = sceneSetup->entityKeysTmp.arr;
+                sceneSetup->entityKeysTmp.arr = keys->arr;
+                keys->arr = sorted;
+                MSWAP(sceneSetup->entityKeysTmp.p.capacity, keys->p.capacity, u32)
+            }
+        }
+    }
+
+#ifdef FINTRO_ENTITY_THREADS
+    if (sceneSetup->entityThreads && n > 1) {
+        EntityThreads_Render(&renderContext, sceneSetup->entityThreads, entities, keys->arr, n);
+    }
+#endif
+
+    RenderScene_EntityRange(&renderContext, entities, keys->arr, 0, n);
+
+#ifdef FINTRO_ENTITY_THREADS
+    if (sceneSetup->entityThreads) {
+        sceneSetup->entityThreads->numEntities = 0;
+    }
+#endif
+
+    // Move the scene seed on once for the next frame
+    renderContext.random1 = sceneSetup->random1;
+    renderContext.random2 = sceneSetup->random2;
+    NextRandom(&renderContext, 0);
+    RenderScene_End(&renderContext, sceneSetup);
+    return n;
+}
+
+#ifdef FINTRO_ENTITY_THREADS
+void Render_SetNumEntityThreads(SceneSetup* sceneSetup, u16 numThreads) {
+    if (numThreads < 1) {
+        numThreads = 1;
+    } else if (numThreads > ENTITY_MAX_THREADS) {
+        numThreads = ENTITY_MAX_THREADS;
+    }
+
+    if (numThreads == sceneSetup->numEntityThreads) {
+        return;
+    }
+
+    EntityThreads_Free(sceneSetup);
+    sceneSetup->numEntityThreads = numThreads;
+    if (numThreads > 1) {
+        EntityThreads_Init(sceneSetup, numThreads);
+    }
+}
+#endif
+
+// Run the byte code func, returns < 0 once the model's code is done
+MINLINE int RunModelCodeFunc(RenderContext* renderContext, u16 funcParam) {
+    switch (funcParam & (u16)0x1f) {
+        case Render_DONE:
+            return -1;
+        case Render_CIRCLE:
+            return RenderCircle(renderContext, funcParam);
+        case Render_LINE:
+            return RenderLine(renderContext, funcParam);
+        case Render_TRI:
+            return RenderTri(renderContext, funcParam);
+        case Render_QUAD:
+            return RenderQuad(renderContext, funcParam);
+        case Render_COMPLEX:
+            return RenderComplex(renderContext, funcParam);
+        case Render_BATCH:
+            return RenderBatch(renderContext, funcParam);
+        case Render_MIRRORED_TRI:
+            return Render2TriMirrored(renderContext, funcParam);
+        case Render_MIRRORED_QUAD:
+            return Render2QuadMirrored(renderContext, funcParam);
+        case Render_TEARDROP:
+            return RenderTeardrop(renderContext, funcParam);
+        case Render_VTEXT:
+            return RenderVectorText(renderContext, funcParam);
+        case Render_IF:
+            return RenderIf(renderContext, funcParam);
+        case Render_IF_NOT:
+            return RenderIfNot(renderContext, funcParam);
+        case Render_CALC_A:
+        case Render_CALC_B:
+            return RenderCalc(renderContext, funcParam);
+        case Render_MODEL:
+            return RenderModel(renderContext, funcParam);
+        case Render_AUDIO_CUE:
+            return RenderAudioCue(renderContext, funcParam);
+        case Render_CYLINDER:
+            return RenderCone(renderContext, funcParam);
+        case Render_CYLINDER_COLOUR_CAP:
+            return RenderConeCapped(renderContext, funcParam);
+        case Render_BITMAP_TEXT:
+            return RenderBitmapText(renderContext, funcParam);
+        case Render_IF_NOT_VAR:
+            return RenderIfVar(renderContext, funcParam);
+        case Render_IF_VAR:
+            return RenderIfNotVar(renderContext, funcParam);
+        case Render_DEPTH_TREE_PUSH_POP:
+            return RenderDepthTreePushPop(renderContext, funcParam);
+        case Render_LINE_BEZIER:
+            return RenderLineBezier(renderContext, funcParam);
+        case Render_IF_SCREENSPACE_DIST:
+            return RenderScreenSpaceDist(renderContext, funcParam);
+        case Render_CICLES:
+            return RenderCircles(renderContext, funcParam);
+        case Render_MATRIX_SETUP:
+            return RenderMatrixSetup(renderContext, funcParam);
+        case Render_COLOUR:
+            return RenderColour(renderContext, funcParam);
+        case Render_MODEL_SCALE:
+            return RenderModelScale(renderContext, funcParam);
+        case Render_MATRIX_TRANSFORM:
+            return RenderMatrixTransform(renderContext, funcParam);
+        case Render_MATRIX_COPY:
+            return RenderMatrixCopy(renderContext, funcParam);
+        case Render_PLANET:
+            return RenderPlanet(renderContext, funcParam);
+        default:
+            return -1;
+    }
+}
+
+#ifdef FINTRO_VM_PROFILE
+MINTERNAL void VMProfile_AddOffset(VMProfile* profile, u16 model, u16 offset, u8 op, u64 ticks) {
+    u32 slot = ((model * 0x9e3779b1u) ^ (offset * 0x85ebca6bu)) & (VM_PROFILE_OFFSETS - 1);
+    for (int i = 0; i < VM_PROFILE_OFFSETS; i++) {
+        VMProfileOffset* entry = profile->offsets + slot;
+        if (entry->model == VM_PROFILE_EMPTY) {
+            entry->model = model;
+            entry->offset = offset;
+            entry->op = op;
+        }
+        if (entry->model == model && entry->offset == offset) {
+            entry->count.calls++;
+            entry->count.ticks += ticks;
+            return;
+        }
+        slot = (slot + 1) & (VM_PROFILE_OFFSETS - 1);
+    }
+    profile->dropped++;
+}
+
+MINTERNAL void VMProfile_AddStack(VMProfile* profile, RenderContext* rc, u8 op, u64 ticks) {
+    u8 depth = (u8)rc->currentRenderFrameIx;
+    u32 hash = 2166136261u ^ op;
+    for (int i = 1; i <= depth; i++) {
+        hash = (hash ^ rc->renderFrame[i].profileModel) * 16777619u;
+    }
+
+    u32 slot = hash & (VM_PROFILE_STACKS - 1);
+    for (int i = 0; i < VM_PROFILE_STACKS; i++) {
+        VMProfileStack* entry = profile->stacks + slot;
+        if (!entry->depth) {
+            entry->hash = hash;
+            entry->depth = depth;
+            entry->op = op;
+            for (int j = 1; j <= depth; j++) {
+                entry->models[j - 1] = rc->renderFrame[j].profileModel;
+            }
+        }
+        if (entry->hash == hash && entry->depth == depth && entry->op == op) {
+            b32 match = TRUE;
+            for (int j = 1; j <= depth && match; j++) {
+                match = entry->models[j - 1] == rc->renderFrame[j].profileModel;
+            }
+            if (match) {
+                entry->count.calls++;
+                entry->count.ticks += ticks;
+                return;
+            }
+        }
+        slot = (slot + 1) & (VM_PROFILE_STACKS - 1);
+    }
+    profile->dropped++;
+}
+
+MINTERNAL void VMProfile_BeginModel(VMProfile* profile, RenderContext* rc, RenderFrame* rf) {
+    profile->models[rf->profileModel].calls++;
+    profile->modelStart[rc->currentRenderFrameIx] = VMProfile_Now();
+}
+
+MINTERNAL void VMProfile_EndModel(VMProfile* profile, RenderContext* rc, RenderFrame* rf) {
+    i32 depth = rc->currentRenderFrameIx;
+    u64 ticks = VMProfile_Now() - profile->modelStart[depth];
+    profile->modelTotalTicks[rf->profileModel] += ticks;
+    if (depth > 0) {
+        profile->childTicks[depth - 1] += ticks;
+    }
 }
 
+// Run the op at the byte code position, counting its time
+MINTERNAL int VMProfile_RunOp(VMProfile* profile, RenderContext* rc, RenderFrame* rf, u16 offset) {
+    i32 depth = rc->currentRenderFrameIx;
+    profile->childTicks[depth] = 0;
+
+    u64 start = VMProfile_Now();
+    u16 funcParam = ByteCodeRead16u(rf);
+    u8 op = funcParam & (u16)0x1f;
+    int result = RunModelCodeFunc(rc, funcParam);
+    u64 ticks = VMProfile_Now() - start;
+
+    // Frames past the maximum depth are reused, so nested sub models can overlap the op
+    u64 childTicks = profile->childTicks[depth];
+    ticks = ticks > childTicks ? ticks - childTicks : 0;
+
+    u16 model = rf->profileModel;
+    profile->ops[op].calls++;
+    profile->ops[op].ticks += ticks;
+    profile->models[model].ticks += ticks;
+    VMProfile_AddOffset(profile, model, offset, op, ticks);
+    VMProfile_AddStack(profile, rc, op, ticks);
+    return result;
+}
+#endif
+
 MINTERNAL void InterpretModelCode(RenderContext* renderContext, RenderFrame* rf) {
+#ifdef FINTRO_VM_PROFILE
+    SceneSetup* sceneSetup = renderContext->sceneSetup;
+    VMProfile* profile = sceneSetup->vmProfileEnabled ? sceneSetup->vmProfile : NULL;
+    const u8* codeStart = ((u8*)rf->modelData) + rf->modelData->codeOffset;
+    if (profile) {
+        VMProfile_BeginModel(profile, renderContext, rf);
+    }
+#endif
     // Call render funcs until hit end byte code, or draw buffer is full
     while (!ByteCodeIsDone(rf)) {
 #ifdef FINTRO_INSPECTOR
@@ -9266,146 +13127,221 @@ MINTERNAL void InterpretModelCode(RenderContext* renderContext, RenderFrame* rf)
         }
         renderContext->depthTree->insOffsetTmp = byteCodeOffset;
 #endif
-        u16 funcParam = ByteCodeRead16u(rf);
-        u8 funcOffset = (funcParam & (u16)0x1f);
-        int ret = 0;
-
-        switch (funcOffset) {
-            case Render_DONE:
-                ret = -1;
-                break;
-            case Render_CIRCLE: {
-                ret = RenderCircle(renderContext, funcParam);
-                break;
-            }
-            case Render_LINE: {
-                ret = RenderLine(renderContext, funcParam);
-                break;
-            }
-            case Render_TRI: {
-                ret = RenderTri(renderContext, funcParam);
-                break;
-            }
-            case Render_QUAD: {
-                ret = RenderQuad(renderContext, funcParam);
-                break;
-            }
-            case Render_COMPLEX: {
-                ret = RenderComplex(renderContext, funcParam);
-                break;
-            }
-            case Render_BATCH: {
-                ret = RenderBatch(renderContext, funcParam);
-                break;
-            }
-            case Render_MIRRORED_TRI: {
-                ret = Render2TriMirrored(renderContext, funcParam);
-                break;
-            }
-            case Render_MIRRORED_QUAD: {
-                ret = Render2QuadMirrored(renderContext, funcParam);
-                break;
-            }
-            case Render_TEARDROP: {
-                ret = RenderTeardrop(renderContext, funcParam);
-                break;
-            }
-            case Render_VTEXT: {
-                ret = RenderVectorText(renderContext, funcParam);
-                break;
-            }
-            case Render_IF: {
-                ret = RenderIf(renderContext, funcParam);
-                break;
-            }
-            case Render_IF_NOT: {
-                ret = RenderIfNot(renderContext, funcParam);
-                break;
-            }
-            case Render_CALC_A:
-            case Render_CALC_B: {
-                ret = RenderCalc(renderContext, funcParam);
-                break;
-            }
-            case Render_MODEL: {
-                ret = RenderModel(renderContext, funcParam);
-                break;
-            }
-            case Render_AUDIO_CUE: {
-                ret = RenderAudioCue(renderContext, funcParam);
-                break;
-            }
-            case Render_CYLINDER: {
-                ret = RenderCone(renderContext, funcParam);
-                break;
-            }
-            case Render_CYLINDER_COLOUR_CAP: {
-                ret = RenderConeCapped(renderContext, funcParam);
-                break;
-            }
-            case Render_BITMAP_TEXT: {
-                ret = RenderBitmapText(renderContext, funcParam);
-                break;
-            }
-            case Render_IF_NOT_VAR: {
-                ret = RenderIfVar(renderContext, funcParam);
-                break;
-            }
-            case Render_IF_VAR: {
-                ret = RenderIfNotVar(renderContext, funcParam);
-                break;
-            }
-            case Render_DEPTH_TREE_PUSH_POP: {
-                ret = RenderDepthTreePushPop(renderContext, funcParam);
-                break;
-            }
-            case Render_LINE_BEZIER: {
-                ret = RenderLineBezier(renderContext, funcParam);
-                break;
-            }
-            case Render_IF_SCREENSPACE_DIST: {
-                ret = RenderScreenSpaceDist(renderContext, funcParam);
-                break;
-            }
-            case Render_CICLES: {
-                ret = RenderCircles(renderContext, funcParam);
-                break;
-            }
-            case Render_MATRIX_SETUP: {
-                ret = RenderMatrixSetup(renderContext, funcParam);
-                break;
-            }
-            case Render_COLOUR: {
-                ret = RenderColour(renderContext, funcParam);
-                break;
-            }
-            case Render_MODEL_SCALE: {
-                ret = RenderModelScale(renderContext, funcParam);
-                break;
-            }
-            case Render_MATRIX_TRANSFORM: {
-                ret = RenderMatrixTransform(renderContext, funcParam);
-                break;
-            }
-            case Render_MATRIX_COPY: {
-                ret = RenderMatrixCopy(renderContext, funcParam);
+#ifdef FINTRO_VM_PROFILE
+        if (profile) {
+            if (VMProfile_RunOp(profile, renderContext, rf, (u16)(rf->byteCodePos - codeStart)) < 0) {
                 break;
             }
-            case Render_PLANET: {
-                ret = RenderPlanet(renderContext, funcParam);
-                break;
-            }
-            default:
-                ret = -1;
-                break;
+            continue;
         }
-
-        if (ret < 0) {
+#endif
+        u16 funcParam = ByteCodeRead16u(rf);
+        if (RunModelCodeFunc(renderContext, funcParam) < 0) {
             break;
         }
     }
+#ifdef FINTRO_VM_PROFILE
+    if (profile) {
+        VMProfile_EndModel(profile, renderContext, rf);
+    }
+#endif
+}
+
+#ifdef FINTRO_VM_PROFILE
+void Render_ResetVMProfile(SceneSetup* sceneSetup) {
+    VMProfile* profile = sceneSetup->vmProfile;
+    if (!profile) {
+        return;
+    }
+    memset(profile, 0, sizeof(VMProfile));
+    for (int i = 0; i < VM_PROFILE_OFFSETS; i++) {
+        profile->offsets[i].model = VM_PROFILE_EMPTY;
+    }
+}
+
+void Render_SetVMProfile(SceneSetup* sceneSetup, b32 enabled) {
+    if (enabled && !sceneSetup->vmProfile) {
+        sceneSetup->vmProfile = (VMProfile*)MMalloc(sizeof(VMProfile));
+        Render_ResetVMProfile(sceneSetup);
+    }
+    sceneSetup->vmProfileEnabled = enabled;
+}
+
+MINTERNAL void VMProfile_AppendModelName(MMemIO* output, u16 model) {
+    if (model >= VM_PROFILE_FONTS) {
+        MStringAppendf(output, "font%d", model - VM_PROFILE_FONTS);
+    } else {
+        MStringAppendf(output, "model%d", model);
+    }
+}
+
+void Render_WriteVMProfileCollapsed(SceneSetup* sceneSetup, MMemIO* output) {
+    VMProfile* profile = sceneSetup->vmProfile;
+    if (!profile) {
+        return;
+    }
+    for (int i = 0; i < VM_PROFILE_STACKS; i++) {
+        VMProfileStack* stack = profile->stacks + i;
+        if (!stack->depth || !stack->count.ticks) {
+            continue;
+        }
+        for (int j = 0; j < stack->depth; j++) {
+            VMProfile_AppendModelName(output, stack->models[j]);
+            MStringAppend(output, ";");
+        }
+        MStringAppendf(output, "%s %llu\n", sVMProfileOpNames[stack->op], (unsigned long long)stack->count.ticks);
+    }
 }
 
+void Render_WriteVMProfileCSV(SceneSetup* sceneSetup, MMemIO* output) {
+    VMProfile* profile = sceneSetup->vmProfile;
+    if (!profile) {
+        return;
+    }
+    MStringAppendf(output, "type,model,offset,op,calls,self_%s,total_%s\n", VM_PROFILE_TICKS, VM_PROFILE_TICKS);
+    for (int i = 0; i < 32; i++) {
+        VMProfileCount* count = profile->ops + i;
+        if (count->calls) {
+            MStringAppendf(output, "op,,,%s,%u,%llu,\n", sVMProfileOpNames[i], count->calls,
+                           (unsigned long long)count->ticks);
+        }
+    }
+    for (int i = 0; i < VM_PROFILE_MODELS; i++) {
+        VMProfileCount* count = profile->models + i;
+        if (count->calls) {
+            MStringAppend(output, "model,");
+            VMProfile_AppendModelName(output, i);
+            MStringAppendf(output, ",,,%u,%llu,%llu\n", count->calls, (unsigned long long)count->ticks,
+                           (unsigned long long)profile->modelTotalTicks[i]);
+        }
+    }
+    for (int i = 0; i < VM_PROFILE_OFFSETS; i++) {
+        VMProfileOffset* offset = profile->offsets + i;
+        if (offset->model != VM_PROFILE_EMPTY) {
+            MStringAppend(output, "offset,");
+            VMProfile_AppendModelName(output, offset->model);
+            MStringAppendf(output, ",0x%04x,%s,%u,%llu,\n", offset->offset, sVMProfileOpNames[offset->op],
+                           offset->count.calls, (unsigned long long)offset->count.ticks);
+        }
+    }
+    if (profile->dropped) {
+        MLogf("VM profile tables full, %u ops not counted per offset or stack", profile->dropped);
+    }
+}
+#endif
+
+#ifdef FINTRO_DETAIL_GOVERNOR
+#if defined(M_USE_SDL)
+#define DETAIL_GOVERNOR_TIMED
+MINLINE u64 DetailGovernor_Micros() {
+    return (u64)(SDL_GetPerformanceCounter() * 1000000.0 / SDL_GetPerformanceFrequency());
+}
+#elif defined(M_USE_STDLIB) && !defined(AMIGA)
+#include <time.h>
+#define DETAIL_GOVERNOR_TIMED
+MINLINE u64 DetailGovernor_Micros() {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (u64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+#endif
+
+// Frames the smoothed time must stay over budget before dropping a level, drops are quick to avoid stutter
+#define DETAIL_GOVERNOR_OVER_FRAMES 8
+// Frames the smoothed time must leave room for more detail before raising a level, raises are slow to avoid popping
+#define DETAIL_GOVERNOR_UNDER_FRAMES 90
+// Frames to let the smoothed time settle after a change
+#define DETAIL_GOVERNOR_HOLD_FRAMES 30
+
+typedef struct sDetailLevel {
+    i16 renderDetail;
+    i16 planetDetail;
+    i16 planetMinAtmosBandWidth;
+    i8 bezierDetail;
+} DetailLevel;
+
+// Band widths are 1.14 fixed point, 0x4000 is the narrowest
+static const DetailLevel sDetailLevels[DETAIL_LEVELS] = {
+    // render planet atmosBand bezier
+    {  0,     0,     0x4010,   -2 },
+    {  1,     0,     0x4008,   -1 },
+    {  1,     1,     0x4004,   -1 },
+    {  2,     1,     0x0000,    0 },
+    {  2,     2,     0x0000,    0 },
+    {  3,     2,     0x0000,    1 },
+    {  4,     2,     0x0000,    1 },
+};
+
+MINTERNAL void DetailGovernor_SetLevel(SceneSetup* sceneSetup, u16 level) {
+    const DetailLevel* detail = sDetailLevels + level;
+    sceneSetup->governor.level = level;
+    sceneSetup->renderDetail = detail->renderDetail;
+    sceneSetup->planetDetail = detail->planetDetail;
+    sceneSetup->planetMinAtmosBandWidth = detail->planetMinAtmosBandWidth;
+    sceneSetup->raster->bezierDetail = detail->bezierDetail;
+}
+
+void Render_SetDetailBudget(SceneSetup* sceneSetup, u32 budgetMicros) {
+    DetailGovernor* governor = &sceneSetup->governor;
+    governor->budgetMicros = budgetMicros;
+    governor->avgMicros = 0;
+    governor->overFrames = 0;
+    governor->underFrames = 0;
+    governor->holdFrames = 0;
+    DetailGovernor_SetLevel(sceneSetup, budgetMicros ? governor->level : DETAIL_LEVEL_DEFAULT);
+}
+
+void Render_UpdateDetailGovernor(SceneSetup* sceneSetup, u32 renderMicros, u32 rasterMicros) {
+    DetailGovernor* governor = &sceneSetup->governor;
+    governor->renderMicros = renderMicros;
+    governor->rasterMicros = rasterMicros;
+    if (!governor->budgetMicros) {
+        return;
+    }
+
+    // Smooth over ~8 frames, so one slow frame (e.g. a scene change) doesn't change the level
+    i32 frameMicros = (i32)(renderMicros + rasterMicros);
+    if (!governor->avgMicros) {
+        governor->avgMicros = frameMicros;
+    } else {
+        governor->avgMicros = (u32)((i32)governor->avgMicros + (frameMicros - (i32)governor->avgMicros) / 8);
+    }
+
+    if (governor->holdFrames) {
+        governor->holdFrames--;
+        return;
+    }
+
+    // Only raise when well under budget, the gap stops the level flipping between two neighbours
+    if (governor->avgMicros > governor->budgetMicros) {
+        governor->overFrames++;
+        governor->underFrames = 0;
+    } else if (governor->avgMicros < (governor->budgetMicros * 5) / 8) {
+        governor->underFrames++;
+        governor->overFrames = 0;
+    } else {
+        governor->overFrames = 0;
+        governor->underFrames = 0;
+    }
+
+    u16 level = governor->level;
+    if (governor->overFrames >= DETAIL_GOVERNOR_OVER_FRAMES && level > 0) {
+        level--;
+    } else if (governor->underFrames >= DETAIL_GOVERNOR_UNDER_FRAMES && level < DETAIL_LEVELS - 1) {
+        level++;
+    }
+
+    if (level != governor->level) {
+        MLogf("Detail level %d -> %d: avg %uus (last render %uus, raster %uus), budget %uus", governor->level, level,
+              governor->avgMicros, renderMicros, rasterMicros, governor->budgetMicros);
+        DetailGovernor_SetLevel(sceneSetup, level);
+        governor->overFrames = 0;
+        governor->underFrames = 0;
+        governor->holdFrames = DETAIL_GOVERNOR_HOLD_FRAMES;
+    }
+}
+#endif
+
 void Render_RenderAndDrawScene(SceneSetup* sceneSetup, RenderEntity* renderEntity, b32 resetPalette) {
 #ifdef FINTRO_INSPECTOR
     MArrayClear(sceneSetup->debug.loadedModelIndexes);
@@ -9417,18 +13353,36 @@ void Render_RenderAndDrawScene(SceneSetup* sceneSetup, RenderEntity* renderEntit
     sceneSetup->debug.planetRendered = 0;
     u64 startTime = SDL_GetPerformanceCounter();
 #endif
+#ifdef DETAIL_GOVERNOR_TIMED
+    u64 governorStart = DetailGovernor_Micros();
+#endif
 
+#ifdef FINTRO_TRUECOLOUR
+    // Only the background colour is kept, model code may change it
+    SetDefaultBackgroundColour(&sceneSetup->raster->paletteContext);
+#else
     Palette_SetupForNewFrame(&sceneSetup->raster->paletteContext, resetPalette);
+#endif
     Render_RenderScene(sceneSetup, renderEntity);
 #ifdef FINTRO_INSPECTOR
     u64 renderTime = SDL_GetPerformanceCounter();
     sceneSetup->debug.renderTime = renderTime - startTime;
 #endif
+#ifdef DETAIL_GOVERNOR_TIMED
+    u64 governorRendered = DetailGovernor_Micros();
+#endif
+#ifdef FINTRO_TRUECOLOUR
+    Raster_ClearAndDraw(sceneSetup->raster, sceneSetup->raster->paletteContext.backgroundColour & 0xfff);
+#else
     Palette_CalcDynamicColourUpdates(&sceneSetup->raster->paletteContext);
-    Surface_Clear(sceneSetup->raster->surface, BACKGROUND_COLOUR_INDEX);
-    Raster_Draw(sceneSetup->raster);
+    Raster_ClearAndDraw(sceneSetup->raster, BACKGROUND_COLOUR_INDEX);
+#endif
 #ifdef FINTRO_INSPECTOR
     u64 drawTime = SDL_GetPerformanceCounter();
     sceneSetup->debug.drawTime = drawTime - renderTime;
 #endif
+#ifdef DETAIL_GOVERNOR_TIMED
+    Render_UpdateDetailGovernor(sceneSetup, (u32)(governorRendered - governorStart),
+                                (u32)(DetailGovernor_Micros() - governorRendered));
+#endif
 }
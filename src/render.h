@@ -10,10 +10,57 @@
 #include "fmath.h"
 #include "assets.h"
 #include "audio.h"
-#ifdef FINTRO_INSPECTOR
+
+// Compiled models skip the byte code trace, so the inspector always interprets model code
+#if defined(FINTRO_MODELS_AOT) && defined(FINTRO_INSPECTOR)
+#undef FINTRO_MODELS_AOT
+#endif
+
+#if defined(FINTRO_INSPECTOR) || defined(FINTRO_MODELS_AOT)
 #include "modelcode.h"
 #endif
 
+// FINTRO_VM_PROFILE times every model byte code op run while profiling is on (see Render_SetVMProfile()), per op, model,
+// byte code offset and sub model call stack.  Compiled models don't go through the interpreter, so are interpreted.
+#if defined(FINTRO_MODELS_AOT) && defined(FINTRO_VM_PROFILE)
+#undef FINTRO_MODELS_AOT
+#endif
+
+// FINTRO_DETAIL_GOVERNOR measures scene render & raster time and steps the detail settings (renderDetail, planetDetail,
+// planetMinAtmosBandWidth and bezier steps) up or down a level at a time to keep frames within a time budget, see
+// Render_SetDetailBudget().
+
+// FINTRO_ENTITY_THREADS runs the model code of the entities passed to Render_RenderSceneEntities() on worker threads (see
+// Render_SetNumEntityThreads()), each into its own depth tree.  The output is replayed into the scene's depth tree in
+// depth order, so the image is the same for any number of threads.  Workers run one after another on the calling
+// thread where there are no threads (M_USE_SDL).  Disabled with the inspector and the VM profiler, which keep
+// their state across entities.
+#if defined(FINTRO_ENTITY_THREADS) && (defined(FINTRO_INSPECTOR) || defined(FINTRO_VM_PROFILE))
+#undef FINTRO_ENTITY_THREADS
+#endif
+
+// Depth tree writes are logged by entity workers and replayed into the scene's depth tree
+#ifdef FINTRO_ENTITY_THREADS
+#define DEPTHTREE_LOG 1
+#endif
+
+// FINTRO_TRUECOLOUR draws 12bit colours straight into a 16-bit surface, so there's no palette to allocate each frame or
+// look up when converting the surface.  The Amiga's display is indexed, and the inspector's tools expect palette
+// indexes, so both keep the 256 colour surface.
+#if defined(FINTRO_TRUECOLOUR) && (defined(AMIGA) || defined(FINTRO_INSPECTOR))
+#undef FINTRO_TRUECOLOUR
+#endif
+
+// FINTRO_PALETTE_STATS counts colour requests, allocations, recycled & matched colours and palette updates for every
+// frame while recording (see Palette_SetStatsRecording()), to find where the dynamic colours run short.  There's no
+// palette to count with FINTRO_TRUECOLOUR.
+#if defined(FINTRO_PALETTE_STATS) && defined(FINTRO_TRUECOLOUR)
+#undef FINTRO_PALETTE_STATS
+#endif
+
+// FINTRO_DRAW_CAPTURE saves the depth tree and palette each frame is drawn from (see Raster_WriteCapture()), so frames
+// can be rasterized again without the models or the VM, see src/platform/replay/main-replay.c.
+
 #define FONT_HEIGHT 9
 #define FONT_NEW_LINE 10
 #define FONT_MIN_WIDTH 8
@@ -22,10 +69,22 @@
 // '1' is the original resolution of 320x168
 // '2' is 2x the original resolution: 640x336
 // '3' is 4x the original resolution: 1280x672
+// '4' is 8x the original resolution: 2560x1344
+//
+// FINTRO_SCREEN_RES sets the default surface size, the renderer picks the resolution multiplier from the surface size
+// at runtime (see Surface_ResForSize()).  Define FINTRO_SCREEN_RES_FIXED to instead fix the resolution at compile time,
+// which lets the compiler fold the surface size and scaling parameters into constants (used for the Amiga).
 #ifndef FINTRO_SCREEN_RES
 #define FINTRO_SCREEN_RES 2
 #endif
 
+#define SCREEN_RES_MIN 1
+#define SCREEN_RES_MAX 4
+
+#if defined(AMIGA) && !defined(FINTRO_SCREEN_RES_FIXED)
+#define FINTRO_SCREEN_RES_FIXED 1
+#endif
+
 #ifndef SURFACE_WIDTH
 #if FINTRO_SCREEN_RES == 1
 #define SURFACE_WIDTH 320
@@ -33,6 +92,8 @@
 #define SURFACE_WIDTH 640
 #elif FINTRO_SCREEN_RES == 3
 #define SURFACE_WIDTH 1280
+#elif FINTRO_SCREEN_RES == 4
+#define SURFACE_WIDTH 2560
 #endif
 #endif
 
@@ -43,6 +104,8 @@
 #define SURFACE_HEIGHT 400
 #elif FINTRO_SCREEN_RES == 3
 #define SURFACE_HEIGHT 672
+#elif FINTRO_SCREEN_RES == 4
+#define SURFACE_HEIGHT 1344
 #endif
 #endif
 
@@ -54,14 +117,65 @@
 extern "C" {
 #endif
 
-// 256 colour surface for drawing into
+#ifdef FINTRO_RASTER_STATS
+// Slots in the per draw func counters, covers every DrawFuncEnum
+#define RASTER_STATS_FUNCS 32
+
+// Fill-rate counters, reset whenever the surface is cleared
+typedef struct sRasterStats {
+    u32 pixels[RASTER_STATS_FUNCS]; // Pixel writes per draw func
+    u32 calls[RASTER_STATS_FUNCS]; // Draw funcs executed
+} RasterStats;
+#endif
+
+#ifdef FINTRO_TRUECOLOUR
+typedef u16 SurfacePixel; // 12bit colour, 0x0RGB
+#define SURFACE_PIXEL_VALUES 4096
+#else
+typedef u8 SurfacePixel; // Hardware palette index
+#define SURFACE_PIXEL_VALUES 256
+#endif
+
+// Resolution dependent scaling parameters, each resolution multiplier doubles the projection scale
+typedef struct sScreenParams {
+    u16 width;
+    u16 height;
+    u8 res;
+    u8 screenScale;
+    u8 zScale;
+    u8 fontScale;
+    u8 teardropScale;
+    u8 highlightsSmall;
+    u8 highlightsBig;
+    u8 highlightsSize;
+    i32 zClipNear;
+    i32 planetScreenspaceAtmosDist;
+    i32 planetScreenspaceMajorAxisMax;
+    i32 planetScreenspaceHalfRender;
+} ScreenParams;
+
+// 256 colour (or 12bit colour with FINTRO_TRUECOLOUR) surface for drawing into
 typedef struct sSurface {
     u16 width;
     u16 height;
-    u8* pixels;
+    u8 res; // Resolution multiplier (see FINTRO_SCREEN_RES) the surface is rendered at
+    ScreenParams screen; // Scales for res and the surface size, set by Surface_Init()
+    u16 clipY1; // Only rows clipY1 <= y < clipY2 are rasterized, lets raster threads split the surface into bands
+    u16 clipY2;
+    SurfacePixel* pixels;
 #ifdef FINTRO_INSPECTOR
     u32* insOffset;
     u32 insOffsetTmp;
+#endif
+    struct sSpanBuffer* spanBuffer; // Set while drawing with RASTER_ENGINE_SPAN_BUFFER, rejects covered pixels
+    u32 spanUnit; // Node being drawn front to back, writes from the same node may overlap each other
+    u16 spanFullRows; // Rows inside the clip band that are completely covered
+    struct sDirtyRects* dirty; // Rows changed since the last frame, NULL unless enabled with Surface_SetDirtyRects()
+    struct sSpanTemplates* spanTemplates; // Circle & flare spans, built as each size is first drawn
+#ifdef FINTRO_RASTER_STATS
+    u16* overdraw; // Writes per pixel since the last clear
+    u8 statsFunc; // Draw func being executed, pixel writes are counted against it
+    RasterStats stats;
 #endif
 } Surface;
 
@@ -71,34 +185,147 @@ typedef struct sRGB {
     u8 b;
 } RGB;
 
+// Sets every field, the surface doesn't need clearing first.  Free an initialised surface with Surface_Free() before
+// initialising it again.
 void Surface_Init(Surface* surface, u16 width, u16 height);
+// Largest resolution multiplier whose view fits in the given surface size, larger surfaces see a wider field of view
+u8 Surface_ResForSize(u16 width, u16 height);
 void Surface_Free(Surface* surface);
 
-void Surface_Clear(Surface* surface, u8 colour);
-void Surface_DrawLine(Surface* surface, int x1, int y1, int x2, int y2, u8 colour);
-void Surface_DrawLineClipped(Surface* surface, int x1, int y1, int x2, int y2, u8 colour);
-void Surface_DrawTriFill(Surface* surface, Vec2i16 points[3], u8 colour);
-void Surface_DrawQuadFill(Surface* surface, Vec2i16 points[4], u8 colour);
-void Surface_DrawCircleFill(Surface* surface, int x, int y, int diameter, u8 colour);
+void Surface_Clear(Surface* surface, SurfacePixel colour);
+void Surface_DrawLine(Surface* surface, int x1, int y1, int x2, int y2, SurfacePixel colour);
+void Surface_DrawLineClipped(Surface* surface, int x1, int y1, int x2, int y2, SurfacePixel colour);
+void Surface_DrawTriFill(Surface* surface, Vec2i16 points[3], SurfacePixel colour);
+void Surface_DrawQuadFill(Surface* surface, Vec2i16 points[4], SurfacePixel colour);
+void Surface_DrawCircleFill(Surface* surface, int x, int y, int diameter, SurfacePixel colour);
 void Surface_DrawFlare(Surface* surface, i16 x, i16 y, int diameter, u16 colour1, u16 colour2);
-void Surface_DrawRect(Surface* surface, int x1, int y1, int x2, int y2, u8 colour);
-void Surface_DrawRectFill(Surface* surface, int x1, int y1, int x2, int y2, u8 colour);
+void Surface_DrawRect(Surface* surface, int x1, int y1, int x2, int y2, SurfacePixel colour);
+void Surface_DrawRectFill(Surface* surface, int x1, int y1, int x2, int y2, SurfacePixel colour);
+#ifdef FINTRO_RASTER_STATS
+// Colour code the overdraw counts into 'dest' (width * height), returns the largest count
+u16 Surface_OverdrawToRGB(Surface* surface, RGB* dest);
+#endif
+
+// Byte order in memory of the 32-bit pixels written by Surface_ConvertToRGBA32()
+typedef enum eRGBA32OrderEnum {
+    RGBA32_ORDER_RGBA = 0, // r, g, b, a (GL_RGBA, canvas ImageData)
+    RGBA32_ORDER_ABGR = 1, // a, b, g, r (SDL_PIXELFORMAT_RGBA8888 on little endian)
+} RGBA32OrderEnum;
+
+// Surface pixel to output pixel lookup, rebuild whenever the palette changes
+typedef struct sRGBA32Lut {
+    u32 pixels[SURFACE_PIXEL_VALUES];
+} RGBA32Lut;
+
+#ifdef FINTRO_TRUECOLOUR
+// Every 12bit colour, only needs building once
+void RGBA32Lut_Build(RGBA32Lut* lut, RGBA32OrderEnum order);
+#else
+void RGBA32Lut_Build(RGBA32Lut* lut, RGB* palette, RGBA32OrderEnum order);
+#endif
+// Convert the surface to 32-bit pixels through 'lut', 'pitch' is the byte offset between rows in 'dest'
+void Surface_ConvertToRGBA32(Surface* surface, const RGBA32Lut* lut, u8* dest, u32 pitch);
+// Convert only rows y1 <= y < y2, 'dest' still points at row 0
+void Surface_ConvertRowsToRGBA32(Surface* surface, const RGBA32Lut* lut, u8* dest, u32 pitch, u16 y1, u16 y2);
+
+// Part of the surface that changed, x2 / y2 are exclusive
+typedef struct sDamageRect {
+    u16 x1;
+    u16 y1;
+    u16 x2;
+    u16 y2;
+} DamageRect;
+
+// Track which rows change between frames, so Raster_ClearAndDraw() only clears & redraws those rows and front-ends
+// only upload them.  Anything drawn to the surface outside the depth tree must be cleared or marked with
+// Surface_AddDamage().
+void Surface_SetDirtyRects(Surface* surface, b32 enable);
+// Mark rows y1 <= y < y2 as drawn over outside the depth tree, they are redrawn next frame
+void Surface_AddDamage(Surface* surface, int y1, int y2);
+// Fill 'rects' with the areas changed by the last frame drawn, returns the number of rects.  Adjacent areas are merged
+// once 'maxRects' is reached.  Without dirty rects this is always the whole surface.
+u32 Surface_GetDamage(Surface* surface, DamageRect* rects, u32 maxRects);
 
 MARRAY_TYPEDEF(u8*, PtrsU8)
 
-typedef struct sDepthTree {
+typedef enum eDepthSortEnum {
+    DEPTHSORT_TREE = 0, // Nodes are inserted into a binary tree on z as they are added
+    DEPTHSORT_LIST = 1, // Nodes are appended to a draw list, which is radix sorted on z before drawing
+} DepthSortEnum;
+
+typedef enum eRasterEngineEnum {
+    RASTER_ENGINE_PAINTER = 0, // Nodes are drawn back to front, overwriting what is behind them
+    RASTER_ENGINE_SPAN_BUFFER = 1, // Nodes are drawn front to back, each row tracks covered spans so pixels are written once
+} RasterEngineEnum;
+
+// Draw list sort key, one per node, in the order the nodes were added
+typedef struct sDepthListKey {
+    u32 z;
+    u32 offset; // offset of the RasterOpNode in the depth tree data
+    u32 range;  // sub tree the node was added to, 0 is the top level
+} DepthListKey;
+
+MARRAY_TYPEDEF(DepthListKey, DepthListKeyArray)
+
+// Depth key and child links of a node, kept apart from the node's draw funcs so inserting and walking the tree only
+// reads these 16 byte records.  Nodes are referenced by index, index 0 is never used so a link of 0 means no node.
+typedef struct sDepthTreeNode {
+    u32 z;      // sort order, the root node of a sub tree has z of 0 (draw lists, its range index)
+    u32 left;   // left node or zero if no node
+    u32 right;  // right node or zero if no node
+    u32 offset; // offset of the node's RasterOpNode in the depth tree data
+} DepthTreeNode;
+
+MARRAY_TYPEDEF(DepthTreeNode, DepthTreeNodeArray)
+
+// Top level root node, always the first node after a clear
+#define DEPTHTREE_ROOT_NODE 1
+
+// Depth tree memory is allocated in chunks as needed.  Nodes and draw funcs are referenced by 32-bit offsets:
+// (chunk index << DEPTHTREE_CHUNK_SHIFT) + offset within the chunk.
+#define DEPTHTREE_CHUNK_SHIFT 16
+#define DEPTHTREE_CHUNK_SIZE (1 << DEPTHTREE_CHUNK_SHIFT)
+#define DEPTHTREE_CHUNK_MASK (DEPTHTREE_CHUNK_SIZE - 1)
+// Space kept free at the end of a chunk for the next node or draw func written, larger than any single one
+#define DEPTHTREE_CHUNK_RESERVE 0x400
+
+typedef struct sDepthTreeChunk {
     u8* data;
-    u8* root;
+#ifdef FINTRO_INSPECTOR
+    u32* insOffset;
+#endif
+} DepthTreeChunk;
+
+MARRAY_TYPEDEF(DepthTreeChunk, DepthTreeChunkArray)
+
+typedef struct sDepthTree {
+    DepthTreeChunkArray chunks;
+    DepthTreeNodeArray nodes;
+    u32 root; // Node new nodes are added under, the top level or the current sub tree's root
     u32 offset;
-    u32 size;
-    u32 firstNodeOffset;
+    u32 highWater; // Largest offset drawn since init
 
 #ifdef FINTRO_INSPECTOR
     u32 insOffsetTmp;
-    u32* insOffset;
 #endif
 
-    PtrsU8 subTrees;
+#ifdef DEPTHTREE_LOG
+    struct sDepthTreeLog* depthTreeLog; // Set while entity worker output is recorded
+#endif
+#ifdef FINTRO_ENTITY_THREADS
+    b32 unlinked; // Nodes are only logged, they're linked when replayed into the scene's depth tree (entity workers)
+#endif
+
+    u32Array subTrees;
+
+    // Draw list mode, each sub tree is a range of the sorted keys.  The root node of a sub tree holds its range index
+    // in 'z' instead of a depth.
+    u8 sortMode;
+    u32 numRanges;
+    DepthListKeyArray keys;       // Keys in the order nodes were added
+    DepthListKeyArray sortedKeys; // Keys sorted by range, then back to front, then order added
+    DepthListKeyArray sortTmp;
+    u32Array rangeStart;          // Index of first sorted key for each range, plus end of the last range
 } DepthTree;
 
 enum PaletteEntryStateEnum {
@@ -122,8 +349,38 @@ typedef struct sUpdateColour {
 } UpdateColour;
 
 #define PALETTE_3D_COLOURS 0x80
+#define BACKGROUND_COLOUR_INDEX 0x7f // Hardware palette entry holding the background colour
 #define PALETTE_VIRTUAL_COLOURS 0x100
 
+// Entry given or losing a hardware palette colour, queued for the nearest colours
+typedef struct sNearestColourChange {
+    u16 colour;
+    u8 index;
+    u8 remove;
+} NearestColourChange;
+
+// Changes queued before rebuilding the nearest colours is cheaper
+#define PALETTE_NEAREST_CHANGES 16
+
+#ifdef FINTRO_PALETTE_STATS
+// Palette activity for one frame, counted from Palette_SetupForNewFrame() to Palette_CalcDynamicColourUpdates()
+typedef struct sPaletteFrameStats {
+    u32 frame;        // Frames since recording started
+    u32 requests;     // 12bit colours looked up
+    u16 allocated;    // Colours given a new virtual palette entry
+    u16 dropped;      // Colours given colour 0 as the virtual palette was full
+    u16 assigned;     // New colours given a free hardware entry
+    u16 recycled;     // New colours given the hardware entry of a colour unused this frame (REFD_NON_FRESH)
+    u16 reloaded;     // Allocated colours that had their entry recycled in the last few frames, the palette is thrashing
+    u16 matched;      // New colours left with the closest hardware colour, as there were no entries left
+    u16 updated;      // Hardware palette entries written, updatedColoursNum
+    u16 inUse;        // Dynamic hardware entries held by colours after the update
+    u32 calcNanos;    // Time spent in Palette_CalcDynamicColourUpdates(), 0 where there's no timer
+} PaletteFrameStats;
+
+MARRAY_TYPEDEF(PaletteFrameStats, PaletteFrameStatsArray)
+#endif
+
 typedef struct sPaletteContext {
     // Current set of colours
     VirtualPalette virtualPalette[PALETTE_VIRTUAL_COLOURS];
@@ -135,6 +392,14 @@ typedef struct sPaletteContext {
     u8 freeColours[PALETTE_VIRTUAL_COLOURS];
     u8 nextFreeColour;
 
+    // Closest colour in the hardware palette to each 12bit colour, distance in the high byte and palette index in the
+    // low byte, used once the dynamic colours run out.  Built on the first lookup after a reset, then kept up to date by
+    // applying the entries given or losing a hardware colour since the last lookup.
+    u16 nearestColours[4096];
+    b32 nearestColoursValid;
+    NearestColourChange nearestChanges[PALETTE_NEAREST_CHANGES];
+    u8 numNearestChanges;
+
     u16 backgroundColour;
     u16 lastBackgroundColour;
 
@@ -143,6 +408,13 @@ typedef struct sPaletteContext {
 
     // New / updated colours this frame
     UpdateColour updateColours[PALETTE_VIRTUAL_COLOURS];
+
+#ifdef DEPTHTREE_LOG
+    struct sDepthTreeLog* depthTreeLog; // Set while entity worker output is recorded
+#endif
+#ifdef FINTRO_PALETTE_STATS
+    struct sPaletteStats* stats; // NULL unless recording, see Palette_SetStatsRecording()
+#endif
 } PaletteContext;
 
 typedef struct sSpanLine {
@@ -154,6 +426,8 @@ typedef struct sSpanRenderer {
     i16 spanStart;
     i16 spanEnd;
     u16 height;
+    i16 clipY1; // Only build rows clipY1 <= y < clipY2
+    i16 clipY2;
     SpanLine* spans;
     u32 memSize;
 } SpanRenderer;
@@ -174,6 +448,8 @@ typedef struct sBodySpanRenderer {
     u16 maxSpan;
     u16 maxSpansPerLine;
     u16 height;
+    i16 clipY1; // Only build rows clipY1 <= y < clipY2
+    i16 clipY2;
 
     u16 numColours;
     u16 colours[16];
@@ -187,14 +463,58 @@ typedef struct sRasterFunc {
     u8 params[]; // list of params to func (size depends on rasterop)
 } MSTRUCTPACKED DrawFunc;
 
+// Node header in the depth tree data, nodes start on a 4 byte boundary.  The depth key and links are in the depth
+// tree's nodes array, see DepthTree_NodeZ() etc.
 typedef struct sRasterOpNode {
-    u32 z;           // top node has z of 0, sort order
-    u16 leftOffset;  // left node or zero if no node
-    u16 rightOffset; // left node or zero if no node
+    u32 index;       // node's entry in the depth tree's nodes array
+    i16 x1;          // screen bounds of everything the node draws, x2 / y2 are exclusive, only set with dirty rects
+    i16 y1;
+    i16 x2;
+    i16 y2;
     DrawFunc func;   // draw func
 } MSTRUCTPACKED RasterOpNode; // packed so we can read raw memdumps
 
-MARRAY_TYPEDEF(RasterOpNode*, RasterOpNodeArray)
+MINLINE u8* DepthTree_Ptr(DepthTree* depthTree, u32 offset) {
+    return depthTree->chunks.arr[offset >> DEPTHTREE_CHUNK_SHIFT].data + (offset & DEPTHTREE_CHUNK_MASK);
+}
+
+MINLINE RasterOpNode* DepthTree_Node(DepthTree* depthTree, u32 index) {
+    return (RasterOpNode*)DepthTree_Ptr(depthTree, depthTree->nodes.arr[index].offset);
+}
+
+MINLINE u32 DepthTree_NodeZ(DepthTree* depthTree, RasterOpNode* node) {
+    return depthTree->nodes.arr[node->index].z;
+}
+
+// Child nodes, NULL if there's no node
+MINLINE RasterOpNode* DepthTree_NodeLeft(DepthTree* depthTree, RasterOpNode* node) {
+    u32 left = depthTree->nodes.arr[node->index].left;
+    return left ? DepthTree_Node(depthTree, left) : NULL;
+}
+
+MINLINE RasterOpNode* DepthTree_NodeRight(DepthTree* depthTree, RasterOpNode* node) {
+    u32 right = depthTree->nodes.arr[node->index].right;
+    return right ? DepthTree_Node(depthTree, right) : NULL;
+}
+
+// Draw funcs following a node continue in the next chunk, if the chunk filled up while writing them
+MINLINE u8* DepthTree_FollowFunc(DepthTree* depthTree, u8* func) {
+    DrawFunc* drawFunc = (DrawFunc*)func;
+    if (drawFunc->func == DRAW_FUNC_NEXT_CHUNK) {
+        DrawParamsNextChunk* params = (DrawParamsNextChunk*)drawFunc->params;
+        return DepthTree_Ptr(depthTree, params->offset);
+    }
+    return func;
+}
+
+#ifdef FINTRO_INSPECTOR
+MINLINE u32* DepthTree_InsOffsetPtr(DepthTree* depthTree, u32 offset) {
+    return depthTree->chunks.arr[offset >> DEPTHTREE_CHUNK_SHIFT].insOffset + (offset & DEPTHTREE_CHUNK_MASK);
+}
+
+// Model code offset that wrote the node or draw func at 'ptr'
+u32 DepthTree_InsOffsetForPtr(DepthTree* depthTree, void* ptr);
+#endif
 
 typedef struct sRasterContext {
     Surface* surface;
@@ -203,14 +523,44 @@ typedef struct sRasterContext {
     DepthTree depthTree;
     SpanRenderer spanRenderer;
     BodySpanRenderer bodySpanRenderer;
-    RasterOpNodeArray drawNodeStack;
+    u32Array drawNodeStack; // Node indexes
 
     u16 legacy; // set to 1 to enable legacy mode
+    i8 bezierDetail; // Bezier curve steps, each +1 doubles the curve length used to pick the step count, -1 halves it
+
+    u16 numThreads; // Number of horizontal bands the surface is split into, each drawn on its own thread
+    struct sRasterThreads* threads;
+
+    u8 engine; // RasterEngineEnum
+    struct sSpanBuffer* spanBuffer;
+
+    u8 nodeBounds; // NodeBoundsEnum, node bounds are being measured / are valid for culling
 } RasterContext;
 
+// Max raster threads, only available for threaded platforms (M_USE_SDL) otherwise always draws on calling thread
+#define RASTER_MAX_THREADS 16
+
 void Raster_Init(RasterContext* raster);
 void Raster_Free(RasterContext* raster);
 void Raster_Draw(RasterContext* raster);
+void Raster_SetNumThreads(RasterContext* raster, u16 numThreads);
+// Select depth sort mode, takes effect from the next scene rendered
+void Raster_SetDepthSort(RasterContext* raster, DepthSortEnum sortMode);
+// Select how the depth tree is rasterized, both engines produce the same image
+void Raster_SetEngine(RasterContext* raster, RasterEngineEnum engine);
+// Clear the surface and draw the depth tree, with dirty rects enabled only the rows that changed are cleared & drawn
+void Raster_ClearAndDraw(RasterContext* raster, SurfacePixel clearColour);
+// Surface_ConvertToRGBA32() for the raster surface, split by rows across the raster threads
+void Raster_ConvertToRGBA32(RasterContext* raster, const RGBA32Lut* lut, u8* dest, u32 pitch);
+
+#ifdef FINTRO_DRAW_CAPTURE
+// Append the frame in the depth tree to 'output': the nodes & draw funcs, the virtual palette and background colour.
+// Captures are read back on the same build, without FINTRO_TRUECOLOUR draw funcs hold virtual palette indexes.
+void Raster_WriteCapture(RasterContext* raster, MMemIO* output);
+// Read the next frame into the depth tree & palette, ready to draw on a surface of the frame's size.  Returns FALSE at
+// the end of the input, or if the frame can't be read.
+b32 Raster_ReadCapture(RasterContext* raster, MMemIO* input, u16* width, u16* height);
+#endif
 
 void Palette_SetupForNewFrame(PaletteContext* context, b32 resetAll);
 void Palette_CalcDynamicColourUpdates(PaletteContext* context);
@@ -220,12 +570,45 @@ void Palette_CopyAllColoursRGB(PaletteContext* context, RGB* palette);
 void Palette_CopyDynamicColours16(PaletteContext* context, u16* palette);
 void Palette_CopyFixedColours16(PaletteContext* context, u16* palette);
 
+#ifdef FINTRO_PALETTE_STATS
+// Start or stop adding a PaletteFrameStats per frame, the frames recorded are kept until Palette_FreeStats()
+void Palette_SetStatsRecording(PaletteContext* context, b32 enabled);
+void Palette_FreeStats(PaletteContext* context);
+// Frames recorded so far, oldest first
+PaletteFrameStats* Palette_GetFrameStats(PaletteContext* context, u32* numFrames);
+// CSV timeline, a row per frame recorded
+void Palette_WriteStatsCSV(PaletteContext* context, MMemIO* output);
+#endif
+
 typedef struct MMemStack {
     u8* mem;
     u8* pos;
     size_t size;
 } MMemStack;
 
+// Model analysis flags
+#define MODEL_ANALYSIS_PARTIAL 0x1      // Some byte code is only reachable when running (e.g. after circle lists)
+#define MODEL_ANALYSIS_DYNAMIC_VARS 0x2 // Reads variables that can't be listed statically (e.g. text & planet params)
+#define MODEL_ANALYSIS_RECURSIVE 0x4    // Model is its own sub model, directly or indirectly
+#define MODEL_ANALYSIS_OVERFLOW 0x8     // Sub models nest deeper than the renderer's frame stack
+
+// Load time analysis of a model and the sub models it can render, see Render_AnalyseModels()
+typedef struct sModelAnalysis {
+    ModelData* model;    // Model data analysed, results are ignored once the model is replaced
+    u16 numVertices;     // Model vertices, not including the tmp vertices for parent vertices
+    u16 numNormals;      // Normal colour slots
+    u16 depth;           // Frames used by the model and its deepest sub model chain
+    u16 flags;           // MODEL_ANALYSIS_*
+    u8 tmpVarsRead;      // Tmp variables read by the model's own code
+    u8 tmpVarsWritten;   // Tmp variables written by the model's own code
+    u64 entityVarsRead;  // Entity variables read by the model and its sub models
+    u32 frameBytes;      // Frame memory for the model's own vertices & normals
+    u32 stackBytes;      // Frame memory for the model and its deepest sub model chain
+    u32 codeSize;        // Bytes of byte code reachable from the start of the model's code
+} ModelAnalysis;
+
+MARRAY_TYPEDEF(ModelAnalysis, ModelAnalysisArray)
+
 
 #ifdef FINTRO_INSPECTOR
 typedef struct sInspectorDebugInfo {
@@ -273,6 +656,23 @@ typedef struct sSceneAssets {
     ModelsArray fonts; // 3d fonts
 } SceneAssets;
 
+#ifdef FINTRO_DETAIL_GOVERNOR
+// Detail levels, lowest first, the default level matches the original renderer
+#define DETAIL_LEVELS 7
+#define DETAIL_LEVEL_DEFAULT 4
+
+typedef struct sDetailGovernor {
+    u32 budgetMicros; // Scene render + raster time per frame to aim for, 0 when the governor is off
+    u32 renderMicros; // Last frame's times
+    u32 rasterMicros;
+    u32 avgMicros;    // Smoothed render + raster time
+    u16 level;
+    u16 overFrames;   // Consecutive frames the smoothed time was over budget
+    u16 underFrames;  // Consecutive frames the smoothed time left room for the next level up
+    u16 holdFrames;   // Frames until the level can change again
+} DetailGovernor;
+#endif
+
 typedef struct sSceneSetup {
     // Random seed vars, mutated everytime a new random is generated
     u32 random1;
@@ -301,6 +701,33 @@ typedef struct sSceneSetup {
 
     MMemStack memStack;
 
+    // Indexed by model, filled in by Render_AnalyseModels()
+    ModelAnalysisArray modelAnalysis;
+
+    // Render_RenderSceneEntities() visible entities, sorted by depth
+    DepthListKeyArray entityKeys;
+    DepthListKeyArray entityKeysTmp;
+
+#ifdef FINTRO_ENTITY_THREADS
+    u16 numEntityThreads;
+    struct sEntityThreads* entityThreads;
+#endif
+
+#ifdef FINTRO_MODELS_AOT
+    // Model data each compiled model was last checked against, and if its byte code matched
+    ModelData* compiledModelsChecked[MODELS_AOT_MAX];
+    b32 compiledModelsMatch[MODELS_AOT_MAX];
+#endif
+
+#ifdef FINTRO_DETAIL_GOVERNOR
+    DetailGovernor governor;
+#endif
+
+#ifdef FINTRO_VM_PROFILE
+    struct sVMProfile* vmProfile;
+    b32 vmProfileEnabled;
+#endif
+
 #ifdef FINTRO_INSPECTOR
     InspectorDebugInfo debug;
 #endif
@@ -338,6 +765,45 @@ void Render_Free(SceneSetup* sceneSetup);
 void Render_RenderScene(SceneSetup* sceneSetup, RenderEntity* entity);
 void Render_RenderAndDrawScene(SceneSetup* sceneSetup, RenderEntity* entity, b32 resetPalette);
 
+// Render many entities into one depth tree, each entity is sorted as a whole by its depth (like models that push a
+// depth sub tree).  Entities outside the viewport, or whose model isn't loaded, are skipped before running any model
+// code.  Returns the number of entities rendered.  Each entity's random values are seeded from the scene seed and its index in 'entities'.
+u32 Render_RenderSceneEntities(SceneSetup* sceneSetup, RenderEntity* entities, u32 numEntities);
+
+#ifdef FINTRO_ENTITY_THREADS
+#define ENTITY_MAX_THREADS 16
+
+// Number of workers Render_RenderSceneEntities() runs entity model code on, 1 renders straight into the depth tree
+void Render_SetNumEntityThreads(SceneSetup* sceneSetup, u16 numThreads);
+#endif
+
+// Analyse the loaded models, sizing frame memory and reporting models that nest too deep for the renderer.
+// Call after models are loaded or replaced, models that aren't analysed still render.
+void Render_AnalyseModels(SceneSetup* sceneSetup);
+
+// Re-check compiled models against the loaded model data, call after models are reloaded
+void Render_ResetCompiledModels(SceneSetup* sceneSetup);
+
+#ifdef FINTRO_DETAIL_GOVERNOR
+// Keep scene render + raster time under 'budgetMicros' by adjusting the detail settings, 0 turns the governor off and
+// restores the default detail.  Render_RenderAndDrawScene() times itself, platforms that render & draw separately call
+// Render_UpdateDetailGovernor() with their own times after each frame.
+void Render_SetDetailBudget(SceneSetup* sceneSetup, u32 budgetMicros);
+void Render_UpdateDetailGovernor(SceneSetup* sceneSetup, u32 renderMicros, u32 rasterMicros);
+#endif
+
+#ifdef FINTRO_VM_PROFILE
+// Start or stop timing model byte code, counts add up until Render_ResetVMProfile()
+void Render_SetVMProfile(SceneSetup* sceneSetup, b32 enabled);
+void Render_ResetVMProfile(SceneSetup* sceneSetup);
+
+// Collapsed stacks for flamegraph tools, a "model20;model34;QUAD <ticks>" line per sub model call stack and op
+void Render_WriteVMProfileCollapsed(SceneSetup* sceneSetup, MMemIO* output);
+
+// CSV summary, a row per op, model and byte code offset
+void Render_WriteVMProfileCSV(SceneSetup* sceneSetup, MMemIO* output);
+#endif
+
 static ModelData* Render_GetModel(SceneSetup* sceneSetup, u16 offset) {
     return MArrayGet(sceneSetup->assets.models, offset);
 }
@@ -0,0 +1,1389 @@
+#include "render.c"
+#include "mtest.h"
+#ifdef FINTRO_MODELS_AOT
+#include "modelcode.h"
+#endif
+
+// Compares the span buffer raster engine against painter's order on generated depth trees, both should produce
+// exactly the same image. Dirty rect redraws are compared against full redraws of the same frames, and flares drawn
+// through span templates against flares drawn straight from the flare graphics.  Batched vertex transforms are
+// compared against the per vertex transform.  With raster threads (render-test-threads) surfaces drawn in bands are
+// compared against a single thread.
+
+void Audio_PlaySample(AudioContext* audio, u16 sampleIndex, u16 volume) {
+}
+
+static u32 sSeed;
+
+static int RandN(int n) {
+    sSeed = sSeed * 1103515245 + 12345;
+    return n > 0 ? (int)((sSeed >> 8) % (u32)n) : 0;
+}
+
+static i16 RandX(int w) {
+    return (i16)RandN(w);
+}
+
+static i16 RandY(int h) {
+    return (i16)RandN(h);
+}
+
+static void BuildPolygon(i16* px, i16* py, int n, int w, int h) {
+    int cx = RandN(w);
+    int cy = RandN(h);
+    int r = 4 + RandN(h / 3);
+    for (int i = 0; i < n; i++) {
+        int x = cx + (((i & 1) ? r : r / 2) * ((i < n / 2) ? 1 : -1));
+        int y = cy + ((r * ((i % 4) - 2)) / 2);
+        px[i] = (i16)(x < 0 ? 0 : (x >= w ? w - 1 : x));
+        py[i] = (i16)(y < 0 ? 0 : (y >= h ? h - 1 : y));
+    }
+}
+
+// Every node is seeded separately, so for later frames only the nodes picked by moveEvery change
+static void BuildSceneFrame(DepthTree* depthTree, u32 seed, int numNodes, int zRange, int frame, int moveEvery) {
+    int w = SURFACE_WIDTH;
+    int h = SURFACE_HEIGHT;
+    int s = h / 4;
+
+    DepthTree_Clear(depthTree);
+
+    for (int i = 0; i < numNodes; i++) {
+        sSeed = seed * 7919 + i * 31;
+        if (frame && (i % moveEvery) == 0) {
+            sSeed += frame * 104729;
+        }
+        i32 z = RandN(zRange);
+        switch (RandN(8)) {
+            case 0: {
+                DrawParamsTri* tri = AddTriNode(depthTree, z);
+                i16 x = RandX(w - s), y = RandY(h - s);
+                for (int j = 0; j < 3; j++) {
+                    tri->points[j].x = (i16)(x + RandN(s));
+                    tri->points[j].y = (i16)(y + RandN(s));
+                }
+                tri->colour = RandN(16);
+                break;
+            }
+            case 1: {
+                DrawParamsQuad* quad = AddQuadNode(depthTree, z);
+                i16 x = RandX(w - s), y = RandY(h - s), qw = (i16)RandN(s), qh = (i16)RandN(s);
+                quad->points[0].x = x; quad->points[0].y = y;
+                quad->points[1].x = (i16)(x + qw); quad->points[1].y = (i16)(y + qh / 3);
+                quad->points[2].x = (i16)(x + qw); quad->points[2].y = (i16)(y + qh);
+                quad->points[3].x = x; quad->points[3].y = (i16)(y + qh - qh / 4);
+                quad->colour = RandN(16);
+                break;
+            }
+            case 2: {
+                DrawParamsCircle* circle = AddCircleNode(depthTree, z);
+                circle->x = RandX(w); circle->y = RandY(h); circle->diameter = RandN(s); circle->colour = RandN(16);
+                break;
+            }
+            case 3: {
+                DrawParamsFlare* flare = AddHighlightNode(depthTree, z);
+                flare->x = RandX(w); flare->y = RandY(h); flare->diameter = -RandN(8);
+                flare->innerColour = RandN(16); flare->outerColour = RandN(16);
+                break;
+            }
+            case 4: {
+                DrawParamsLineColour* line = AddLineNode(depthTree, z);
+                line->x1 = RandX(w); line->y1 = RandY(h); line->x2 = RandX(w); line->y2 = RandY(h);
+                line->colour = RandN(16);
+                break;
+            }
+            case 5: {
+                i16 px[8], py[8];
+                int n = 3 + RandN(5);
+                BuildPolygon(px, py, n, w, h);
+                AddDrawNode(depthTree, z, DRAW_FUNC_SPANS_START);
+                for (int j = 0; j < n; j++) {
+                    DrawParamsLine* line = BatchSpanLine(depthTree);
+                    line->x1 = px[j]; line->y1 = py[j];
+                    line->x2 = px[(j + 1) % n]; line->y2 = py[(j + 1) % n];
+                }
+                BatchSpanEnd(depthTree)->colour = RandN(16);
+                break;
+            }
+            case 6: {
+                i16 px[8], py[8];
+                int n = 3 + RandN(5);
+                BuildPolygon(px, py, n, w, h);
+                AddDrawNode(depthTree, z, DRAW_FUNC_BODY_START);
+                for (int j = 0; j < n; j++) {
+                    DrawParamsLineColour* line = BatchBodyLine(depthTree);
+                    line->x1 = px[j]; line->y1 = py[j];
+                    line->x2 = px[(j + 1) % n]; line->y2 = py[(j + 1) % n];
+                    line->colour = RandN(4);
+                }
+                DrawParamsColour8* colours = BatchBodyDraw3(depthTree);
+                for (int j = 0; j < 8; j++) {
+                    colours->colour[j] = RandN(16);
+                }
+                break;
+            }
+            default: {
+                DepthTree_PushSubTree(depthTree, z);
+                for (int j = 0; j < 4; j++) {
+                    DrawParamsCircle* circle = AddCircleNode(depthTree, RandN(zRange));
+                    circle->x = RandX(w); circle->y = RandY(h); circle->diameter = RandN(s / 2);
+                    circle->colour = RandN(16);
+                }
+                DepthTree_PopSubTree(depthTree);
+                break;
+            }
+        }
+    }
+}
+
+static void BuildScene(DepthTree* depthTree, u32 seed, int numNodes, int zRange) {
+    BuildSceneFrame(depthTree, seed, numNodes, zRange, 0, 1);
+}
+
+// Node indexes in painter's order, back to front
+static void CollectPainterOrder(DepthTree* depthTree, RasterOpNode* node, u32* order, int* num) {
+    if (!node) {
+        return;
+    }
+    CollectPainterOrder(depthTree, DepthTree_NodeRight(depthTree, node), order, num);
+    order[(*num)++] = node->index;
+    CollectPainterOrder(depthTree, DepthTree_NodeLeft(depthTree, node), order, num);
+}
+
+void test_depth_tree_nodes() {
+    DepthTree depthTree;
+    memset(&depthTree, 0, sizeof(depthTree));
+    DepthTree_Init(&depthTree);
+
+    // Node headers are aligned, whatever size of data the previous node wrote
+    u32 zs[] = { 5, 3, 8, 3, 5 };
+    for (int i = 0; i < 5; i++) {
+        RasterOpNode* node = DepthTree_AddNode(&depthTree, zs[i]);
+        node->func.func = DRAW_FUNC_NULL;
+        MASSERT_INT_EQ((u32)(((u8*)node - depthTree.chunks.arr[0].data) & 3), 0);
+        MASSERT_INT_EQ(DepthTree_NodeZ(&depthTree, node), zs[i]);
+        depthTree.offset += i + 1;
+    }
+
+    DepthTree_PushSubTree(&depthTree, 4);
+    RasterOpNode* subRoot = DepthTree_Node(&depthTree, depthTree.root);
+    DepthTree_AddNode(&depthTree, 1)->func.func = DRAW_FUNC_NULL;
+    DepthTree_PopSubTree(&depthTree);
+    MASSERT_INT_EQ(depthTree.root, DEPTHTREE_ROOT_NODE);
+    MASSERT_INT_EQ(MArraySize(depthTree.nodes), DEPTHTREE_ROOT_NODE + 9);
+    MASSERT_INT_EQ(DepthTree_NodeRight(&depthTree, subRoot)->index, DEPTHTREE_ROOT_NODE + 8);
+
+    // Equal depths are drawn in the order they were added, the root last
+    u32 expected[] = { 4, 2, 6, 7, 3, 5, 1 };
+    u32 order[16];
+    int num = 0;
+    CollectPainterOrder(&depthTree, DepthTree_Node(&depthTree, DEPTHTREE_ROOT_NODE), order, &num);
+    MASSERT_INT_EQ(num, 7);
+    for (int i = 0; i < num; i++) {
+        MASSERT_INT_EQ(order[i], expected[i]);
+    }
+
+    DepthTree_Free(&depthTree);
+}
+
+static int CountDifferentPixels(Surface* a, Surface* b) {
+    int different = 0;
+    for (int i = 0; i < a->width * a->height; i++) {
+        if (a->pixels[i] != b->pixels[i]) {
+            different++;
+        }
+    }
+    return different;
+}
+
+static void CompareEngines(DepthSortEnum sortMode, int numNodes, int zRange) {
+    Surface painterSurface = {0};
+    Surface spanSurface = {0};
+    Surface_Init(&painterSurface, SURFACE_WIDTH, SURFACE_HEIGHT);
+    Surface_Init(&spanSurface, SURFACE_WIDTH, SURFACE_HEIGHT);
+
+    RasterContext raster;
+    memset(&raster, 0, sizeof(raster));
+    Raster_Init(&raster);
+    Raster_SetDepthSort(&raster, sortMode);
+    for (int i = 0; i < 256; i++) {
+        raster.paletteContext.virtualPalette[i].index = (u8)i;
+    }
+
+    for (u32 seed = 1; seed <= 8; seed++) {
+        BuildScene(&raster.depthTree, seed, numNodes, zRange);
+
+        Raster_SetEngine(&raster, RASTER_ENGINE_PAINTER);
+        raster.surface = &painterSurface;
+        Surface_Clear(&painterSurface, BACKGROUND_COLOUR_INDEX);
+        Raster_Draw(&raster);
+
+        Raster_SetEngine(&raster, RASTER_ENGINE_SPAN_BUFFER);
+        raster.surface = &spanSurface;
+        Surface_Clear(&spanSurface, BACKGROUND_COLOUR_INDEX);
+        Raster_Draw(&raster);
+
+        MASSERT_INT_EQ(CountDifferentPixels(&painterSurface, &spanSurface), 0);
+    }
+
+    Raster_Free(&raster);
+    Surface_Free(&spanSurface);
+    Surface_Free(&painterSurface);
+}
+
+void test_span_buffer_tree() {
+    CompareEngines(DEPTHSORT_TREE, 400, 0x10000);
+}
+
+void test_span_buffer_tree_equal_z() {
+    // Nodes with the same z are drawn in insertion order
+    CompareEngines(DEPTHSORT_TREE, 400, 4);
+}
+
+void test_span_buffer_list() {
+    CompareEngines(DEPTHSORT_LIST, 400, 0x10000);
+}
+
+void test_span_buffer_list_equal_z() {
+    CompareEngines(DEPTHSORT_LIST, 400, 4);
+}
+
+static void CompareDirtyRects(DepthSortEnum sortMode, RasterEngineEnum engine, int moveEvery) {
+    Surface fullSurface = {0};
+    Surface dirtySurface = {0};
+    Surface_Init(&fullSurface, SURFACE_WIDTH, SURFACE_HEIGHT);
+    Surface_Init(&dirtySurface, SURFACE_WIDTH, SURFACE_HEIGHT);
+    Surface_SetDirtyRects(&dirtySurface, TRUE);
+
+    RasterContext raster;
+    memset(&raster, 0, sizeof(raster));
+    Raster_Init(&raster);
+    Raster_SetDepthSort(&raster, sortMode);
+    Raster_SetEngine(&raster, engine);
+    for (int i = 0; i < 256; i++) {
+        raster.paletteContext.virtualPalette[i].index = (u8)i;
+    }
+
+    DamageRect rects[8];
+    int partialFrames = 0;
+    for (int frame = 0; frame < 12; frame++) {
+        BuildSceneFrame(&raster.depthTree, 3, 60, 0x10000, frame / 2, moveEvery);
+
+        raster.surface = &fullSurface;
+        Raster_ClearAndDraw(&raster, BACKGROUND_COLOUR_INDEX);
+
+        raster.surface = &dirtySurface;
+        Raster_ClearAndDraw(&raster, BACKGROUND_COLOUR_INDEX);
+
+        MASSERT_INT_EQ(CountDifferentPixels(&fullSurface, &dirtySurface), 0);
+
+        u32 numRects = Surface_GetDamage(&dirtySurface, rects, 8);
+        if (numRects == 0 || rects[0].y1 > 0 || rects[numRects - 1].y2 < SURFACE_HEIGHT) {
+            partialFrames++;
+        }
+
+        if (frame == 5) {
+            // Overlays drawn after the scene are erased on the next frame
+            memset(dirtySurface.pixels + SURFACE_WIDTH * 10, 1, SURFACE_WIDTH * 4);
+            Surface_AddDamage(&dirtySurface, 10, 14);
+        }
+    }
+
+    // Repeated frames should only redraw what moved
+    MASSERT_TRUE(partialFrames > 0);
+
+    Raster_Free(&raster);
+    Surface_Free(&dirtySurface);
+    Surface_Free(&fullSurface);
+}
+
+void test_dirty_rects_tree() {
+    CompareDirtyRects(DEPTHSORT_TREE, RASTER_ENGINE_PAINTER, 20);
+}
+
+void test_dirty_rects_list() {
+    CompareDirtyRects(DEPTHSORT_LIST, RASTER_ENGINE_PAINTER, 20);
+}
+
+void test_dirty_rects_span_buffer() {
+    CompareDirtyRects(DEPTHSORT_TREE, RASTER_ENGINE_SPAN_BUFFER, 20);
+}
+
+void test_dirty_rects_all_moving() {
+    CompareDirtyRects(DEPTHSORT_TREE, RASTER_ENGINE_PAINTER, 1);
+}
+
+#ifdef RASTER_THREADS
+// Each raster thread only draws the rows in its band, uneven splits of odd surface heights mustn't change any pixels
+static void CompareRasterBands(RasterEngineEnum engine, u16 height) {
+    Surface singleSurface = {0};
+    Surface bandSurface = {0};
+    Surface_Init(&singleSurface, SURFACE_WIDTH, height);
+    Surface_Init(&bandSurface, SURFACE_WIDTH, height);
+
+    RasterContext raster;
+    memset(&raster, 0, sizeof(raster));
+    Raster_Init(&raster);
+    Raster_SetEngine(&raster, engine);
+    for (int i = 0; i < 256; i++) {
+        raster.paletteContext.virtualPalette[i].index = (u8)i;
+    }
+
+    u16 numBands[] = { 2, 3, 5, 7, RASTER_MAX_THREADS };
+    for (u32 seed = 1; seed <= 4; seed++) {
+        BuildScene(&raster.depthTree, seed, 400, 0x10000);
+
+        Raster_SetNumThreads(&raster, 1);
+        raster.surface = &singleSurface;
+        Raster_ClearAndDraw(&raster, BACKGROUND_COLOUR_INDEX);
+
+        for (int i = 0; i < (int)(sizeof(numBands) / sizeof(numBands[0])); i++) {
+            Raster_SetNumThreads(&raster, numBands[i]);
+            raster.surface = &bandSurface;
+            Raster_ClearAndDraw(&raster, BACKGROUND_COLOUR_INDEX);
+            MASSERT_INT_EQ(CountDifferentPixels(&singleSurface, &bandSurface), 0);
+        }
+    }
+
+    Raster_Free(&raster);
+    Surface_Free(&bandSurface);
+    Surface_Free(&singleSurface);
+}
+
+void test_raster_bands() {
+    CompareRasterBands(RASTER_ENGINE_PAINTER, SURFACE_HEIGHT);
+    CompareRasterBands(RASTER_ENGINE_PAINTER, SURFACE_HEIGHT - 3);
+}
+
+void test_raster_bands_span_buffer() {
+    CompareRasterBands(RASTER_ENGINE_SPAN_BUFFER, SURFACE_HEIGHT);
+    CompareRasterBands(RASTER_ENGINE_SPAN_BUFFER, SURFACE_HEIGHT - 3);
+}
+#endif
+
+void test_span_template_flares() {
+    Surface templateSurface = {0};
+    Surface layerSurface = {0};
+    Surface_Init(&templateSurface, SURFACE_WIDTH, SURFACE_HEIGHT);
+    Surface_Init(&layerSurface, SURFACE_WIDTH, SURFACE_HEIGHT);
+    Surface_Clear(&templateSurface, BACKGROUND_COLOUR_INDEX);
+    Surface_Clear(&layerSurface, BACKGROUND_COLOUR_INDEX);
+
+    const u8* flareData = (HIGHLIGHTS_SIZE == 16) ? sDrawFlareGraphics16 : sDrawFlareGraphics32;
+    int numFlares = (HIGHLIGHTS_SIZE == 16) ? sizeof(sDrawFlareGraphics16) / 16 : sizeof(sDrawFlareGraphics32) / 32;
+
+    // Include flares hanging off each edge of the surface
+    sSeed = 1;
+    for (int i = 0; i < 2000; i++) {
+        i16 x = (i16)(RandN(SURFACE_WIDTH + 40) - 20);
+        i16 y = (i16)(RandN(SURFACE_HEIGHT + 40) - 20);
+        int flare = RandN(numFlares);
+        u8 colour1 = (u8)RandN(16);
+        u8 colour2 = (u8)RandN(16);
+
+        Surface_DrawFlare(&templateSurface, x, y, flare - HIGHLIGHTS_SMALL, colour1, colour2);
+
+        const u8* layers = flareData + (flare * HIGHLIGHTS_SIZE);
+        DrawFlareLayer(&layerSurface, x, y, layers, colour1);
+        DrawFlareLayer(&layerSurface, x, y, layers + (HIGHLIGHTS_SIZE / 2), colour2);
+    }
+
+    MASSERT_INT_EQ(CountDifferentPixels(&templateSurface, &layerSurface), 0);
+
+    Surface_Free(&layerSurface);
+    Surface_Free(&templateSurface);
+}
+
+#ifdef SPAN_FILL_SIMD
+// Fill every span length from SPAN_FILL_SIMD_MIN to 300 at each alignment of a vector, comparing the whole buffer
+// against a scalar fill so that the overlapping head & tail stores can't write outside the span
+static int CountSpanFillMismatches(SpanFillFunc fill) {
+    enum { GUARD = 64, MAX_LEN = 300, BUF_LEN = GUARD + 32 + MAX_LEN + GUARD };
+    SurfacePixel buffer[BUF_LEN];
+    SurfacePixel expected[BUF_LEN];
+    int mismatches = 0;
+    for (u32 start = GUARD; start < GUARD + 32; start++) {
+        for (u32 n = SPAN_FILL_SIMD_MIN; n <= MAX_LEN; n++) {
+            SurfacePixel colour = (SurfacePixel)(0xa5 + n);
+#ifdef FINTRO_TRUECOLOUR
+            for (u32 i = 0; i < BUF_LEN; i++) {
+                buffer[i] = 0x123;
+            }
+            memcpy(expected, buffer, sizeof(buffer));
+            for (u32 i = 0; i < n; i++) {
+                expected[start + i] = colour;
+            }
+#else
+            memset(buffer, 0x12, sizeof(buffer));
+            memset(expected, 0x12, sizeof(expected));
+            memset(expected + start, colour, n);
+#endif
+            fill(buffer + start, colour, n);
+            mismatches += memcmp(buffer, expected, sizeof(buffer)) != 0;
+        }
+    }
+    return mismatches;
+}
+#endif
+
+void test_span_fill_kernels() {
+#ifdef SPAN_FILL_SIMD
+#ifdef SPAN_FILL_NEON
+    MASSERT_INT_EQ(CountSpanFillMismatches(SpanFill_NEON), 0);
+#else
+    MASSERT_INT_EQ(CountSpanFillMismatches(SpanFill_SSE2), 0);
+#ifdef SPAN_FILL_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        MASSERT_INT_EQ(CountSpanFillMismatches(SpanFill_AVX2), 0);
+    }
+#endif
+#endif
+#endif
+}
+
+void test_vertex_batch_transform() {
+#ifdef VERTEX_BATCH_SIMD
+    // Odd pair count so the scalar tail is covered too
+    u16 vertexData[23 * 2];
+    i32 batchVertices[3 * 56];
+    RenderFrame rf;
+    memset(&rf, 0, sizeof(rf));
+    rf.vertexData = vertexData;
+    rf.numVertexModel = 47;
+    rf.batchStride = 56;
+    rf.batchVertices = batchVertices;
+
+    sSeed = 7;
+    int mismatches = 0;
+    for (int i = 0; i < 200; i++) {
+        for (int j = 0; j < 23 * 2; j++) {
+            vertexData[j] = (u16)((RandN(3) << 8) | RandN(256));
+            if (j & 1) {
+                vertexData[j] = (u16)RandN(0x10000);
+            }
+        }
+        for (int r = 0; r < 3; r++) {
+            for (int c = 0; c < 3; c++) {
+                rf.entityToView[r][c] = (i16)((i & 1) ? (RandN(2) ? -0x8000 : 0x7fff) : RandN(0x10000) - 0x8000);
+            }
+        }
+        rf.scale = (u16)RandN(0x18);
+
+        VertexBatch_Transform(&rf);
+        for (int p = 0; p < 23; p++) {
+            Vec3i32 r1, r2, b1, b2;
+            TransformPackedVertexPair(&rf, vertexData[p * 2], vertexData[p * 2 + 1], r1, r2);
+            VertexBatch_Get(&rf, (i16)(p * 2), b1);
+            VertexBatch_Get(&rf, (i16)(p * 2 + 1), b2);
+            for (int k = 0; k < 3; k++) {
+                mismatches += (r1[k] != b1[k]) + (r2[k] != b2[k]);
+            }
+        }
+    }
+
+    MASSERT_INT_EQ(mismatches, 0);
+#endif
+}
+
+void test_model_analysis() {
+    // Header, then vertex data at 0x1e and code at 0x22
+    u16 model0[] = {
+        0x22, 0x1e, 64, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0x1385, 0x0000,                       // vertex lerped by entity var 5
+        0x030d, 0x82c1,                       // tmp3 = tmp1 + entity var 2
+        0x002e, 0x0000,                       // sub model 1
+        0x0000,
+    };
+    u16 model1[] = {
+        0x1e, 0x1e, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0x0014, 0x0087,                       // if entity var 7
+        0x0000,
+    };
+    u16 model2[] = {
+        0x1e, 0x1e, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0x004e, 0x0000,                       // sub model 2, itself
+        0x0000,
+    };
+
+    SceneSetup sceneSetup;
+    memset(&sceneSetup, 0, sizeof(sceneSetup));
+    MArrayInit(sceneSetup.assets.models);
+    MArrayInit(sceneSetup.assets.fonts);
+    MArrayInit(sceneSetup.modelAnalysis);
+    MArrayAdd(sceneSetup.assets.models, (ModelData*)model0);
+    MArrayAdd(sceneSetup.assets.models, (ModelData*)model1);
+    MArrayAdd(sceneSetup.assets.models, (ModelData*)model2);
+
+    Render_AnalyseModels(&sceneSetup);
+
+    ModelAnalysis* analysis = GetModelAnalysis(&sceneSetup, 0, (ModelData*)model0);
+    MASSERT_TRUE(analysis != NULL);
+    MASSERT_INT_EQ(analysis->numVertices, 2);
+    MASSERT_INT_EQ(analysis->depth, 2);
+    MASSERT_INT_EQ(analysis->flags, 0);
+    MASSERT_INT_EQ(analysis->tmpVarsRead, 0x2);
+    MASSERT_INT_EQ(analysis->tmpVarsWritten, 0x8);
+    MASSERT_INT_EQ(analysis->entityVarsRead, (1 << 2) | (1 << 5) | (1 << 7));
+    MASSERT_INT_EQ(analysis->stackBytes, analysis->frameBytes + sceneSetup.modelAnalysis.arr[1].frameBytes);
+
+    analysis = GetModelAnalysis(&sceneSetup, 2, (ModelData*)model2);
+    MASSERT_TRUE(analysis->flags & MODEL_ANALYSIS_RECURSIVE);
+
+    // Replaced models are no longer analysed
+    MASSERT_TRUE(GetModelAnalysis(&sceneSetup, 1, (ModelData*)model2) == NULL);
+
+    MArrayFree(sceneSetup.modelAnalysis);
+    MArrayFree(sceneSetup.assets.models);
+}
+
+// Count top level nodes that hold an empty sub tree, returns -1 if a node is reached twice
+static int CountEmptySubTrees(DepthTree* depthTree, RasterOpNode* node, int* visits) {
+    if (!node || ++(*visits) > 1000) {
+        return 0;
+    }
+    RasterOpNode* subRoot = node + 1;
+    int count = (node->func.func == DRAW_FUNC_SUBTREE && subRoot->func.func == DRAW_FUNC_NULL
+                 && !DepthTree_NodeLeft(depthTree, subRoot) && !DepthTree_NodeRight(depthTree, subRoot)) ? 1 : 0;
+    return count + CountEmptySubTrees(depthTree, DepthTree_NodeLeft(depthTree, node), visits)
+           + CountEmptySubTrees(depthTree, DepthTree_NodeRight(depthTree, node), visits);
+}
+
+static void RenderSceneEntities(DepthSortEnum sortMode) {
+    // Model that draws nothing, radius 64
+    u16 model0[] = {
+        0x1e, 0x1e, 0, 0, 0, 0, 0, 64, 0, 0, 0, 0, 0, 0, 0,
+        0x0000,
+    };
+
+    Surface surface = {0};
+    Surface_Init(&surface, SURFACE_WIDTH, SURFACE_HEIGHT);
+    RasterContext raster;
+    memset(&raster, 0, sizeof(raster));
+    Raster_Init(&raster);
+    Raster_SetDepthSort(&raster, sortMode);
+    raster.surface = &surface;
+
+    SceneSetup sceneSetup;
+    memset(&sceneSetup, 0, sizeof(sceneSetup));
+    Render_Init(&sceneSetup, &raster);
+    MArrayInit(sceneSetup.assets.models);
+    MArrayAdd(sceneSetup.assets.models, (ModelData*)model0);
+
+    RenderEntity entities[20];
+    for (int i = 0; i < 20; i++) {
+        Entity_Init(entities + i);
+        entities[i].modelIndex = 0;
+        Matrix3x3i16Identity(entities[i].viewMatrix);
+        entities[i].entityPos[2] = 1000 + (i * 3000) % 7000;
+    }
+    // Behind the view and off to the side are culled
+    entities[1].entityPos[2] = -1000;
+    entities[3].entityPos[0] = 100000;
+
+    MASSERT_INT_EQ(Render_RenderSceneEntities(&sceneSetup, entities, 20), 18);
+    MASSERT_INT_EQ(MArraySize(sceneSetup.entityKeys), 18);
+    // Sorted back to front
+    MASSERT_INT_EQ(entities[sceneSetup.entityKeys.arr[0].offset].entityPos[2], 7000);
+    MASSERT_INT_EQ(entities[sceneSetup.entityKeys.arr[17].offset].entityPos[2], 1000);
+
+    // Entities that draw nothing leave valid empty sub trees
+    if (sortMode == DEPTHSORT_TREE) {
+        RasterOpNode* root = DepthTree_Node(&raster.depthTree, DEPTHTREE_ROOT_NODE);
+        int visits = 0;
+        MASSERT_INT_EQ(CountEmptySubTrees(&raster.depthTree, DepthTree_NodeRight(&raster.depthTree, root), &visits)
+                       + CountEmptySubTrees(&raster.depthTree, DepthTree_NodeLeft(&raster.depthTree, root), &visits), 18);
+    }
+    Raster_ClearAndDraw(&raster, BACKGROUND_COLOUR_INDEX);
+    MASSERT_INT_EQ(MArraySize(raster.depthTree.subTrees), 0);
+
+    // Entities whose model isn't loaded are skipped
+    MArrayAdd(sceneSetup.assets.models, NULL);
+    entities[5].modelIndex = 1;
+    entities[6].modelIndex = 200;
+    MASSERT_INT_EQ(Render_RenderSceneEntities(&sceneSetup, entities, 20), 16);
+    Raster_ClearAndDraw(&raster, BACKGROUND_COLOUR_INDEX);
+
+    MArrayFree(sceneSetup.assets.models);
+    Render_Free(&sceneSetup);
+    Raster_Free(&raster);
+    Surface_Free(&surface);
+}
+
+void test_render_scene_entities_tree() {
+    RenderSceneEntities(DEPTHSORT_TREE);
+}
+
+void test_render_scene_entities_list() {
+    RenderSceneEntities(DEPTHSORT_LIST);
+}
+
+#ifdef FINTRO_ENTITY_THREADS
+// Render the same moving entities straight into the depth tree and on 'numThreads' entity workers, both should produce
+// exactly the same depth tree and image each frame
+static void CompareEntityThreads(DepthSortEnum sortMode, u16 numThreads) {
+    // Circle and a line to a randomly offset vertex, two colours each
+    u16 model0[] = {
+        0x26, 0x1e, 0x80, 0x26, 4, 8, 0, 64, 0, 0, 0, 0, 0, 0, 0,
+        0x0100, 0x0000,                       // 0, 0, 0
+        0x070f, 0x0000,                       // rand 0, 0, 15
+        0xf001, 0x0a00, 0x0000,               // circle vertex:0 radius:20 colour:#f00
+        0x0f02, 0x0002,                       // line 0, 2 colour:#0f0
+        0x0000,
+    };
+    u16 model1[] = {
+        0x26, 0x1e, 0x80, 0x26, 4, 8, 0, 64, 0, 0, 0, 0, 0, 0, 0,
+        0x0100, 0x0000,                       // 0, 0, 0
+        0x070f, 0x0000,                       // rand 0, 0, 15
+        0x00e1, 0x0500, 0x0000,               // circle vertex:0 radius:10 colour:#00f
+        0xff02, 0x0002,                       // line 0, 2 colour:#ff0
+        0x0000,
+    };
+
+    Surface surfaces[2];
+    RasterContext rasters[2];
+    SceneSetup scenes[2];
+    for (int i = 0; i < 2; i++) {
+        memset(surfaces + i, 0, sizeof(Surface));
+        Surface_Init(surfaces + i, SURFACE_WIDTH, SURFACE_HEIGHT);
+        memset(rasters + i, 0, sizeof(RasterContext));
+        Raster_Init(rasters + i);
+        Raster_SetDepthSort(rasters + i, sortMode);
+        rasters[i].surface = surfaces + i;
+        Palette_SetupForNewFrame(&rasters[i].paletteContext, TRUE);
+
+        memset(scenes + i, 0, sizeof(SceneSetup));
+        Render_Init(scenes + i, rasters + i);
+        MArrayInit(scenes[i].assets.models);
+        MArrayAdd(scenes[i].assets.models, (ModelData*)model0);
+        MArrayAdd(scenes[i].assets.models, (ModelData*)model1);
+        Render_SetNumEntityThreads(scenes + i, i ? numThreads : 1);
+    }
+    MASSERT_INT_EQ(scenes[1].numEntityThreads, numThreads);
+#ifdef ENTITY_THREADS
+    // Workers after the first run on their own threads
+    for (u16 i = 1; i < numThreads; i++) {
+        MASSERT_TRUE(scenes[1].entityThreads->workers[i].thread != NULL);
+    }
+#endif
+
+    // The workers meet the two models in a different order to the scene, so on the first frame some colours are given
+    // different palette indexes and those entities have to be rendered again
+    RenderEntity entities[60];
+    for (int i = 0; i < 60; i++) {
+        Entity_Init(entities + i);
+        entities[i].modelIndex = (u16)(i % 5 == 0);
+        Matrix3x3i16Identity(entities[i].viewMatrix);
+        entities[i].entityPos[0] = ((i * 7919) % 1001) - 500;
+        entities[i].entityPos[1] = ((i * 104729) % 601) - 300;
+        entities[i].entityPos[2] = 1000 + (i * 31337) % 8000;
+    }
+
+    u32 drawn = 0;
+    for (int frame = 0; frame < 3; frame++) {
+        for (int i = 0; i < 2; i++) {
+            Palette_SetupForNewFrame(&rasters[i].paletteContext, FALSE);
+            u32 rendered = Render_RenderSceneEntities(scenes + i, entities, 60);
+            MASSERT_INT_EQ(rendered, 60);
+            Palette_CalcDynamicColourUpdates(&rasters[i].paletteContext);
+            Surface_Clear(surfaces + i, BACKGROUND_COLOUR_INDEX);
+            Raster_Draw(rasters + i);
+        }
+        MASSERT_INT_EQ(rasters[1].depthTree.offset, rasters[0].depthTree.offset);
+        MASSERT_INT_EQ(CountDifferentPixels(surfaces, surfaces + 1), 0);
+
+        for (u32 p = 0; p < (u32)surfaces[0].width * surfaces[0].height; p++) {
+            drawn += surfaces[0].pixels[p] != BACKGROUND_COLOUR_INDEX;
+        }
+        for (int i = 0; i < 60; i++) {
+            entities[i].entityPos[0] += 20;
+            entities[i].entityPos[2] += (i & 1) ? 200 : -200;
+        }
+    }
+    MASSERT_TRUE(drawn > 0);
+
+    for (int i = 0; i < 2; i++) {
+        MArrayFree(scenes[i].assets.models);
+        Render_Free(scenes + i);
+        Raster_Free(rasters + i);
+        Surface_Free(surfaces + i);
+    }
+}
+
+static const u16 sEntityThreadCounts[] = { 2, 3, 5, 7, ENTITY_MAX_THREADS };
+
+void test_entity_threads_tree() {
+    for (int i = 0; i < (int)(sizeof(sEntityThreadCounts) / sizeof(sEntityThreadCounts[0])); i++) {
+        CompareEntityThreads(DEPTHSORT_TREE, sEntityThreadCounts[i]);
+    }
+}
+
+void test_entity_threads_list() {
+    for (int i = 0; i < (int)(sizeof(sEntityThreadCounts) / sizeof(sEntityThreadCounts[0])); i++) {
+        CompareEntityThreads(DEPTHSORT_LIST, sEntityThreadCounts[i]);
+    }
+}
+#endif
+
+void test_bezier_detail() {
+    Vec2i16 pts[4] = {{0, 0}, {10, 20}, {30, 20}, {40, 0}};
+
+    MASSERT_INT_EQ(InitBezierSubdivision(pts, 0).steps, 7);
+    MASSERT_INT_EQ(InitBezierSubdivision(pts, 1).steps, 15);
+    MASSERT_INT_EQ(InitBezierSubdivision(pts, -2).steps, 3);
+
+    // Each step count ends on the last control point
+    for (i8 detail = -2; detail <= 2; detail++) {
+        BezierSubDivision subDivision = InitBezierSubdivision(pts, detail);
+        for (i32 i = 0; i <= subDivision.steps; i++) {
+            subDivision.x += subDivision.dx;
+            subDivision.dx += subDivision.d2x;
+            subDivision.d2x += subDivision.d3x;
+        }
+        MASSERT_TRUE(abs((subDivision.x >> 16) - pts[3].x) <= 1);
+    }
+}
+
+// Hardware palette index the 12bit colour was given
+static u8 PaletteIndexOf(PaletteContext* palette, u16 colour) {
+    return palette->virtualPalette[palette->allColours[colour]].index;
+}
+
+void test_palette_nearest_colour() {
+    PaletteContext palette;
+    memset(&palette, 0, sizeof(palette));
+    Palette_SetupForNewFrame(&palette, TRUE);
+
+    // Take all the dynamic colours with reds
+    for (u16 i = 0; i < PALETTE_3D_COLOURS; i++) {
+        Palette_AllocIndexFor12bitColour(&palette, 0x800 | i);
+    }
+    Palette_CalcDynamicColourUpdates(&palette);
+    MASSERT_INT_EQ(palette.updatedColoursNum, PALETTE_3D_COLOURS + 1);
+
+    // Stepping down the channels would have gone all the way to black
+    Palette_SetupForNewFrame(&palette, FALSE);
+    for (u16 i = 0; i < PALETTE_3D_COLOURS; i++) {
+        Palette_AllocIndexFor12bitColour(&palette, 0x800 | i);
+    }
+    u8 green = Palette_AllocIndexFor12bitColour(&palette, 0x8a0);
+    u8 grey = Palette_AllocIndexFor12bitColour(&palette, 0xeed);
+    Palette_CalcDynamicColourUpdates(&palette);
+    MASSERT_INT_EQ(palette.virtualPalette[green].state, PALETTESTATE_MATCHED);
+    MASSERT_INT_EQ(palette.virtualPalette[green].index, PaletteIndexOf(&palette, 0x870));
+    MASSERT_INT_EQ(palette.virtualPalette[grey].index, PaletteIndexOf(&palette, 0xeee));
+
+    // Once half the reds have gone unused their entries are given to bright reds, which are then the closest
+    for (int frame = 0; frame < 3; frame++) {
+        Palette_SetupForNewFrame(&palette, FALSE);
+        for (u16 i = 0; i < PALETTE_3D_COLOURS / 2; i++) {
+            Palette_AllocIndexFor12bitColour(&palette, 0x800 | i);
+        }
+        if (frame == 2) {
+            for (u16 i = PALETTE_3D_COLOURS / 2; i > 0; i--) {
+                Palette_AllocIndexFor12bitColour(&palette, 0x93f + i);
+            }
+            green = Palette_AllocIndexFor12bitColour(&palette, 0x9a0);
+        }
+        Palette_CalcDynamicColourUpdates(&palette);
+    }
+    MASSERT_INT_EQ(palette.virtualPalette[green].state, PALETTESTATE_MATCHED);
+    MASSERT_INT_EQ(palette.virtualPalette[green].index, PaletteIndexOf(&palette, 0x970));
+}
+
+// Shade ramps under a moving light, with more colours than hardware entries.  The nearest colours kept up to date
+// entry by entry must match a rebuild from scratch.
+void test_palette_nearest_colour_changes() {
+    static const u16 bases[] = { 0x448, 0x262, 0x228, 0x548, 0x374, 0x004, 0x444, 0x008, 0x646, 0x536, 0x426, 0x416 };
+    PaletteContext palette;
+    PaletteContext rebuilt;
+    memset(&palette, 0, sizeof(palette));
+    Palette_SetupForNewFrame(&palette, TRUE);
+
+    u32 checked = 0;
+    for (int frame = 0; frame < 200; frame++) {
+        b32 wasValid = palette.nearestColoursValid;
+        Palette_SetupForNewFrame(&palette, FALSE);
+        for (int b = 0; b < 12; b++) {
+            for (int l = 0; l < 16; l++) {
+                int level = (l + frame / 4 + b) % 16;
+                int haze = (frame / 16 + b) % 3;
+                u16 colour = 0;
+                for (int shift = 0; shift < 12; shift += 4) {
+                    int channel = ((bases[b] >> shift) & 0xf) * level / 6 + haze;
+                    colour |= (u16)((channel > 15 ? 15 : channel) << shift);
+                }
+                Palette_AllocIndexFor12bitColour(&palette, colour);
+            }
+        }
+        Palette_CalcDynamicColourUpdates(&palette);
+
+        if (palette.nearestColoursValid) {
+            Palette_UpdateNearestColours(&palette);
+            memcpy(&rebuilt, &palette, sizeof(PaletteContext));
+            Palette_BuildNearestColours(&rebuilt);
+            MASSERT_INT_EQ(memcmp(palette.nearestColours, rebuilt.nearestColours, sizeof(palette.nearestColours)), 0);
+            // Not rebuilt since the last frame, but entries changed colour
+            if (wasValid && palette.updatedColoursNum) {
+                checked++;
+            }
+        }
+    }
+    MASSERT_TRUE(checked > 50);
+}
+
+void test_palette_stats() {
+#ifdef FINTRO_PALETTE_STATS
+    PaletteContext palette;
+    memset(&palette, 0, sizeof(palette));
+    Palette_SetupForNewFrame(&palette, TRUE);
+    Palette_SetStatsRecording(&palette, TRUE);
+
+    // Fill the dynamic colours with reds, one more colour than there are entries is matched
+    for (u16 i = 0; i < PALETTE_3D_COLOURS; i++) {
+        Palette_AllocIndexFor12bitColour(&palette, 0x800 | i);
+    }
+    Palette_AllocIndexFor12bitColour(&palette, 0x800);
+    Palette_AllocIndexFor12bitColour(&palette, 0x8a0);
+    Palette_CalcDynamicColourUpdates(&palette);
+
+    // Half the reds go unused, their entries are given to bright reds
+    for (int frame = 0; frame < 2; frame++) {
+        Palette_SetupForNewFrame(&palette, FALSE);
+        for (u16 i = 0; i < PALETTE_3D_COLOURS / 2; i++) {
+            Palette_AllocIndexFor12bitColour(&palette, 0x800 | i);
+        }
+        if (frame == 1) {
+            for (u16 i = 0; i < PALETTE_3D_COLOURS / 2; i++) {
+                Palette_AllocIndexFor12bitColour(&palette, 0x900 | i);
+            }
+        }
+        Palette_CalcDynamicColourUpdates(&palette);
+    }
+
+    // Asking for some of the old reds straight away is thrashing
+    Palette_SetupForNewFrame(&palette, FALSE);
+    for (u16 i = 0; i < 16; i++) {
+        Palette_AllocIndexFor12bitColour(&palette, 0x840 | i);
+    }
+    Palette_CalcDynamicColourUpdates(&palette);
+
+    u32 numFrames;
+    PaletteFrameStats* frames = Palette_GetFrameStats(&palette, &numFrames);
+    MASSERT_INT_EQ(numFrames, 4);
+    MASSERT_INT_EQ(frames[0].requests, PALETTE_3D_COLOURS + 2);
+    MASSERT_INT_EQ(frames[0].allocated, PALETTE_3D_COLOURS + 1);
+    MASSERT_INT_EQ(frames[0].assigned, PALETTE_3D_COLOURS);
+    MASSERT_INT_EQ(frames[0].matched, 1);
+    MASSERT_INT_EQ(frames[0].updated, PALETTE_3D_COLOURS + 1);
+    MASSERT_INT_EQ(frames[0].inUse, PALETTE_3D_COLOURS);
+    MASSERT_INT_EQ(frames[1].allocated, 0);
+    MASSERT_INT_EQ(frames[1].updated, 0);
+    MASSERT_INT_EQ(frames[2].frame, 2);
+    MASSERT_INT_EQ(frames[2].allocated, PALETTE_3D_COLOURS / 2);
+    MASSERT_INT_EQ(frames[2].recycled, PALETTE_3D_COLOURS / 2);
+    MASSERT_INT_EQ(frames[2].reloaded, 0);
+    MASSERT_INT_EQ(frames[3].allocated, 16);
+    MASSERT_INT_EQ(frames[3].reloaded, 16);
+
+    MMemIO output;
+    MMemInitAlloc(&output, 256);
+    Palette_WriteStatsCSV(&palette, &output);
+    int lines = 0;
+    for (u32 i = 0; i < output.size; i++) {
+        lines += output.mem[i] == '\n';
+    }
+    MASSERT_INT_EQ(lines, 5);
+    MMemFree(&output);
+
+    // Stopped recording keeps the frames
+    Palette_SetStatsRecording(&palette, FALSE);
+    Palette_SetupForNewFrame(&palette, FALSE);
+    Palette_CalcDynamicColourUpdates(&palette);
+    Palette_GetFrameStats(&palette, &numFrames);
+    MASSERT_INT_EQ(numFrames, 4);
+    Palette_FreeStats(&palette);
+#endif
+}
+
+#ifdef FINTRO_DRAW_CAPTURE
+static void CheckDrawCapture(DepthSortEnum sortMode) {
+    Surface drawnSurface = {0};
+    Surface replaySurface = {0};
+    Surface_Init(&drawnSurface, SURFACE_WIDTH, SURFACE_HEIGHT);
+    Surface_Init(&replaySurface, SURFACE_WIDTH, SURFACE_HEIGHT);
+
+    RasterContext raster;
+    memset(&raster, 0, sizeof(raster));
+    Raster_Init(&raster);
+    Raster_SetDepthSort(&raster, sortMode);
+    for (int i = 0; i < 256; i++) {
+        raster.paletteContext.virtualPalette[i].index = (u8)i;
+    }
+    raster.surface = &drawnSurface;
+
+    // Two frames, the second smaller than the first
+    MMemIO capture;
+    MMemInitAlloc(&capture, 1024);
+    BuildScene(&raster.depthTree, 5, 600, 0x10000);
+    Raster_Draw(&raster);
+    Raster_WriteCapture(&raster, &capture);
+    BuildScene(&raster.depthTree, 6, 200, 0x10000);
+    Surface_Clear(&drawnSurface, BACKGROUND_COLOUR_INDEX);
+    Raster_Draw(&raster);
+    Raster_WriteCapture(&raster, &capture);
+
+    RasterContext replay;
+    memset(&replay, 0, sizeof(replay));
+    Raster_Init(&replay);
+    replay.surface = &replaySurface;
+
+    MMemIO input;
+    MMemReadInit(&input, capture.mem, capture.size);
+    u16 width, height;
+    MASSERT_TRUE(Raster_ReadCapture(&replay, &input, &width, &height));
+    MASSERT_TRUE(Raster_ReadCapture(&replay, &input, &width, &height));
+    MASSERT_INT_EQ(width, SURFACE_WIDTH);
+    MASSERT_INT_EQ(height, SURFACE_HEIGHT);
+    MASSERT_INT_EQ(replay.depthTree.sortMode, sortMode);
+    MASSERT_TRUE(!Raster_ReadCapture(&replay, &input, &width, &height));
+
+    Surface_Clear(&replaySurface, BACKGROUND_COLOUR_INDEX);
+    Raster_Draw(&replay);
+    MASSERT_INT_EQ(CountDifferentPixels(&drawnSurface, &replaySurface), 0);
+
+    // Replays on the other engine too
+    Raster_SetEngine(&replay, RASTER_ENGINE_SPAN_BUFFER);
+    Surface_Clear(&replaySurface, BACKGROUND_COLOUR_INDEX);
+    Raster_Draw(&replay);
+    MASSERT_INT_EQ(CountDifferentPixels(&drawnSurface, &replaySurface), 0);
+
+    MMemFree(&capture);
+    Raster_Free(&replay);
+    Raster_Free(&raster);
+    Surface_Free(&replaySurface);
+    Surface_Free(&drawnSurface);
+}
+
+void test_draw_capture_tree() {
+    CheckDrawCapture(DEPTHSORT_TREE);
+}
+
+void test_draw_capture_list() {
+    CheckDrawCapture(DEPTHSORT_LIST);
+}
+
+// Read back a copy of the capture with the u32 at 'pos' overwritten
+static b32 ReadCorruptCapture(MMemIO* capture, u32 pos, u32 value) {
+    u8* copy = (u8*)malloc(capture->size);
+    memcpy(copy, capture->mem, capture->size);
+    memcpy(copy + pos, &value, sizeof(value));
+
+    RasterContext replay;
+    memset(&replay, 0, sizeof(replay));
+    Raster_Init(&replay);
+    MMemIO input;
+    MMemReadInit(&input, copy, capture->size);
+    u16 width, height;
+    b32 read = Raster_ReadCapture(&replay, &input, &width, &height);
+    Raster_Free(&replay);
+    free(copy);
+    return read;
+}
+
+static void CheckInvalidDrawCapture(DepthSortEnum sortMode) {
+    Surface surface = {0};
+    Surface_Init(&surface, SURFACE_WIDTH, SURFACE_HEIGHT);
+
+    RasterContext raster;
+    memset(&raster, 0, sizeof(raster));
+    Raster_Init(&raster);
+    Raster_SetDepthSort(&raster, sortMode);
+    raster.surface = &surface;
+    BuildScene(&raster.depthTree, 5, 600, 0x10000);
+
+    MMemIO capture;
+    MMemInitAlloc(&capture, 1024);
+    Raster_WriteCapture(&raster, &capture);
+
+    DepthTree* depthTree = &raster.depthTree;
+    u32 numNodes = MArraySize(depthTree->nodes);
+    u32 numKeys = MArraySize(depthTree->keys);
+    u32 nodesPos = 30;
+#ifndef FINTRO_TRUECOLOUR
+    nodesPos += sizeof(raster.paletteContext.virtualPalette);
+#endif
+    u32 keysPos = nodesPos + numNodes * sizeof(DepthTreeNode);
+    u32 dataPos = keysPos + numKeys * sizeof(DepthListKey);
+    MASSERT_INT_EQ(dataPos + depthTree->offset, capture.size);
+    MASSERT_TRUE(ReadCorruptCapture(&capture, nodesPos, 0));
+
+    // Node offsets past the end of the data or across a chunk boundary
+    u32 nodeOffset = nodesPos + 2 * sizeof(DepthTreeNode) + offsetof(DepthTreeNode, offset);
+    MASSERT_TRUE(!ReadCorruptCapture(&capture, nodeOffset, depthTree->offset));
+    MASSERT_TRUE(!ReadCorruptCapture(&capture, nodeOffset, 0xfffffff0));
+    MASSERT_TRUE(!ReadCorruptCapture(&capture, nodeOffset, DEPTHTREE_CHUNK_SIZE - 4));
+
+    // Links past the last node, or back up the tree
+    u32 nodePos = nodesPos + 3 * sizeof(DepthTreeNode);
+    MASSERT_TRUE(!ReadCorruptCapture(&capture, nodePos + offsetof(DepthTreeNode, left), numNodes));
+    MASSERT_TRUE(!ReadCorruptCapture(&capture, nodePos + offsetof(DepthTreeNode, right), 0xffffffff));
+    MASSERT_TRUE(!ReadCorruptCapture(&capture, nodePos + offsetof(DepthTreeNode, left), 3));
+    MASSERT_TRUE(!ReadCorruptCapture(&capture, nodePos + offsetof(DepthTreeNode, right), DEPTHTREE_ROOT_NODE));
+
+    // Sub tree funcs pointing at nodes outside the sub tree
+    u32 numSubTrees = 0;
+    for (u32 i = DEPTHTREE_ROOT_NODE; i < numNodes; i++) {
+        if (DepthTree_Node(depthTree, i)->func.func == DRAW_FUNC_SUBTREE) {
+            u32 rootPos = dataPos + depthTree->nodes.arr[i].offset + sizeof(RasterOpNode);
+            MASSERT_TRUE(!ReadCorruptCapture(&capture, rootPos, i));
+            MASSERT_TRUE(!ReadCorruptCapture(&capture, rootPos, numNodes));
+            numSubTrees++;
+        }
+    }
+    MASSERT_TRUE(numSubTrees > 0);
+
+    if (sortMode == DEPTHSORT_LIST) {
+        // Draw list keys past the end of the data, and ranges that don't exist
+        MASSERT_TRUE(numKeys > 0);
+        MASSERT_TRUE(!ReadCorruptCapture(&capture, keysPos + offsetof(DepthListKey, offset), depthTree->offset));
+        MASSERT_TRUE(!ReadCorruptCapture(&capture, keysPos + offsetof(DepthListKey, range), depthTree->numRanges));
+        MASSERT_TRUE(!ReadCorruptCapture(&capture, nodesPos + sizeof(DepthTreeNode), depthTree->numRanges));
+    } else {
+        MASSERT_INT_EQ(numKeys, 0);
+    }
+
+    MMemFree(&capture);
+    Raster_Free(&raster);
+    Surface_Free(&surface);
+}
+
+void test_draw_capture_invalid_tree() {
+    CheckInvalidDrawCapture(DEPTHSORT_TREE);
+}
+
+void test_draw_capture_invalid_list() {
+    CheckInvalidDrawCapture(DEPTHSORT_LIST);
+}
+#endif
+
+// 12bit colour shown for a surface pixel
+static u16 SurfacePixelColour(PaletteContext* palette, SurfacePixel pixel) {
+#ifdef FINTRO_TRUECOLOUR
+    return pixel;
+#else
+    u16 colours[256];
+    memset(colours, 0, sizeof(colours));
+    Palette_CopyFixedColours16(palette, colours);
+    Palette_CopyDynamicColours16(palette, colours);
+    return colours[pixel];
+#endif
+}
+
+#ifdef FINTRO_MODELS_AOT
+// Model that draws nothing, stands in for the models the model source doesn't override
+static u16 sEmptyModel[] = {
+    0x1e, 0x1e, 0, 0, 0, 0, 0, 64, 0, 0, 0, 0, 0, 0, 0,
+    0x0000,
+};
+
+// Run the models translated to C, or mark them all as not matching their byte code so they're interpreted
+static void SetCompiledModels(SceneSetup* sceneSetup, b32 enable) {
+    Render_ResetCompiledModels(sceneSetup);
+    if (!enable) {
+        for (u32 i = 0; i < NUM_COMPILED_MODELS; i++) {
+            sceneSetup->compiledModelsChecked[i] = Render_GetModel(sceneSetup, sCompiledModels[i].modelIndex);
+        }
+    }
+}
+
+static void RenderModelPose(SceneSetup* sceneSetup, RenderEntity* entity, u16 modelIndex, int pose) {
+    entity->modelIndex = modelIndex;
+    Matrix3x3i16Identity(entity->viewMatrix);
+    Matrix3x3i16RotateAxisAngle(entity->viewMatrix, 1, (u16)(pose * 0x1000 + modelIndex * 77));
+    Matrix3x3i16RotateAxisAngle(entity->viewMatrix, 0, (u16)(pose * 0x700));
+    entity->entityPos[0] = (pose % 3 - 1) * 200;
+    entity->entityPos[1] = (pose % 5 - 2) * 100;
+    entity->entityPos[2] = 600 + pose * 700 + modelIndex * 10;
+    entity->entityVars[0] = pose * 97;
+    entity->entityVars[1] = pose * 31;
+    sceneSetup->random1 = 0x1234;
+    sceneSetup->random2 = 0x5678;
+    Palette_SetupForNewFrame(&sceneSetup->raster->paletteContext, TRUE);
+    Render_RenderScene(sceneSetup, entity);
+    Raster_ClearAndDraw(sceneSetup->raster, BACKGROUND_COLOUR_INDEX);
+}
+
+// Models translated to C in src/modelsaot.h must draw the same as the interpreter running the byte code they were
+// translated from, both are compiled from the model source here
+void test_models_aot() {
+    MReadFileRet file = MFileReadFully(FINTRO_TEST_DATA_DIR "/intro-overrides.txt");
+    MASSERT_TRUE(file.data != NULL);
+    if (!file.data) {
+        return;
+    }
+
+    MMemIO modelMem;
+    MMemInitAlloc(&modelMem, 1024);
+    ModelsArray models;
+    MArrayInit(models);
+    ModelCompileResult result = CompileMultipleModels((const char*)file.data, file.size, &modelMem, &models,
+                                                      ModelEndian_LITTLE, FALSE);
+    MASSERT_TRUE(result.error == NULL);
+    while (MArraySize(models) < 256) {
+        MArrayAdd(models, NULL);
+    }
+    for (int i = 0; i < 256; i++) {
+        if (!models.arr[i]) {
+            models.arr[i] = (ModelData*)sEmptyModel;
+        }
+    }
+
+    Surface compiledSurface = {0};
+    Surface interpretedSurface = {0};
+    Surface_Init(&compiledSurface, SURFACE_WIDTH, SURFACE_HEIGHT);
+    Surface_Init(&interpretedSurface, SURFACE_WIDTH, SURFACE_HEIGHT);
+    RasterContext raster;
+    memset(&raster, 0, sizeof(raster));
+    Raster_Init(&raster);
+
+    SceneSetup sceneSetup;
+    memset(&sceneSetup, 0, sizeof(sceneSetup));
+    Render_Init(&sceneSetup, &raster);
+    sceneSetup.assets.models = models;
+    Render_AnalyseModels(&sceneSetup);
+
+    // Vector text characters are empty code blocks
+    static u16 fontMem[2048];
+    FontModelData* font = (FontModelData*)fontMem;
+    font->vertexDataOffset = 0x200;
+    font->verticesDataSize = 8;
+    for (int i = 0; i < 0xe0; i++) {
+        font->offsets[i] = 0x402 + i * 4;
+    }
+    MArrayInit(sceneSetup.assets.fonts);
+    MArrayAdd(sceneSetup.assets.fonts, (ModelData*)font);
+    MArrayAdd(sceneSetup.assets.fonts, (ModelData*)font);
+    static u8* strings[512];
+    for (int i = 0; i < 512; i++) {
+        strings[i] = (u8*)"AB C";
+    }
+    sceneSetup.assets.mainStrings = strings;
+    sceneSetup.moduleStrings = strings;
+    sceneSetup.moduleStringNum = 128;
+    SceneSetup_InitDefaultShadeRamp(&sceneSetup);
+
+    RenderEntity entity;
+    Entity_Init(&entity);
+    entity.entityText = (i8*)"XY";
+
+    for (u32 i = 0; i < NUM_COMPILED_MODELS; i++) {
+        u16 modelIndex = sCompiledModels[i].modelIndex;
+        ModelData* model = Render_GetModel(&sceneSetup, modelIndex);
+        SetCompiledModels(&sceneSetup, TRUE);
+        MASSERT_TRUE(CompiledModel_Get(&sceneSetup, model, modelIndex) == sCompiledModels[i].func);
+        if (modelIndex == 106) {
+            // Engine sub model, reads its parent ship's vertices so can't be drawn on its own
+            continue;
+        }
+
+        for (int pose = 0; pose < 8; pose++) {
+            SetCompiledModels(&sceneSetup, TRUE);
+            raster.surface = &compiledSurface;
+            RenderModelPose(&sceneSetup, &entity, modelIndex, pose);
+            u32 compiledOffset = raster.depthTree.offset;
+
+            SetCompiledModels(&sceneSetup, FALSE);
+            raster.surface = &interpretedSurface;
+            RenderModelPose(&sceneSetup, &entity, modelIndex, pose);
+
+            MASSERT_INT_EQ(raster.depthTree.offset, compiledOffset);
+            MASSERT_INT_EQ(CountDifferentPixels(&compiledSurface, &interpretedSurface), 0);
+        }
+    }
+
+    MArrayFree(sceneSetup.assets.fonts);
+    Render_Free(&sceneSetup);
+    Raster_Free(&raster);
+    Surface_Free(&interpretedSurface);
+    Surface_Free(&compiledSurface);
+    MArrayFree(models);
+    MMemFree(&modelMem);
+    MFree(file.data, file.size);
+}
+#endif
+
+// Front ends declare surfaces on the stack without clearing them first
+void test_surface_init_uncleared() {
+    Surface surface;
+    memset(&surface, 0xcd, sizeof(surface));
+    Surface_Init(&surface, 64, 32);
+    MASSERT_TRUE(surface.dirty == NULL);
+    MASSERT_TRUE(surface.spanTemplates == NULL);
+    MASSERT_TRUE(surface.spanBuffer == NULL);
+    MASSERT_INT_EQ(surface.clipY1, 0);
+
+    Surface_SetDirtyRects(&surface, TRUE);
+    Surface_Clear(&surface, BACKGROUND_COLOUR_INDEX);
+    Surface_Free(&surface);
+}
+
+#ifndef FINTRO_SCREEN_RES_FIXED
+// The view has to fit the surface both ways, a wide but short surface mustn't get a view taller than itself
+void test_surface_res_for_size() {
+    MASSERT_INT_EQ(Surface_ResForSize(320, 168), 1);
+    MASSERT_INT_EQ(Surface_ResForSize(100, 100), 1);
+    MASSERT_INT_EQ(Surface_ResForSize(640, 400), 2);
+    MASSERT_INT_EQ(Surface_ResForSize(1920, 1080), 3);
+    MASSERT_INT_EQ(Surface_ResForSize(2560, 1344), 4);
+    MASSERT_INT_EQ(Surface_ResForSize(2560, 400), 2);
+    MASSERT_INT_EQ(Surface_ResForSize(640, 1344), 2);
+}
+#endif
+
+// Whether the surface holds palette indexes or 12bit colours, every pixel should show the colour it was drawn with
+void test_surface_pixel_colours() {
+    // Model that draws nothing, radius 64
+    u16 model0[] = {
+        0x1e, 0x1e, 0, 0, 0, 0, 0, 64, 0, 0, 0, 0, 0, 0, 0,
+        0x0000,
+    };
+
+    Surface surface = {0};
+    Surface_Init(&surface, 64, 32);
+    RasterContext raster;
+    memset(&raster, 0, sizeof(raster));
+    Raster_Init(&raster);
+    raster.surface = &surface;
+
+    SceneSetup sceneSetup;
+    memset(&sceneSetup, 0, sizeof(sceneSetup));
+    Render_Init(&sceneSetup, &raster);
+    MArrayInit(sceneSetup.assets.models);
+    MArrayAdd(sceneSetup.assets.models, (ModelData*)model0);
+
+    RenderEntity entity;
+    Entity_Init(&entity);
+    entity.modelIndex = 0;
+    Matrix3x3i16Identity(entity.viewMatrix);
+    entity.entityPos[2] = 1000;
+
+    PaletteContext* palette = &raster.paletteContext;
+    Render_RenderAndDrawScene(&sceneSetup, &entity, TRUE);
+    MASSERT_INT_EQ(SurfacePixelColour(palette, surface.pixels[0]), 0x005);
+
+    SurfacePixel red = Palette_GetIndexFor12bitColour(palette, 0xf00);
+    SurfacePixel teal = Palette_GetIndexFor12bitColour(palette, 0x0ab);
+    Palette_CalcDynamicColourUpdates(palette);
+    Surface_DrawRectFill(&surface, 0, 0, 32, 16, Palette_GetDynamicColourIndex(&raster, red));
+    Surface_DrawRectFill(&surface, 32, 0, 64, 16, Palette_GetDynamicColourIndex(&raster, teal));
+    MASSERT_INT_EQ(SurfacePixelColour(palette, surface.pixels[1]), 0xf00);
+    MASSERT_INT_EQ(SurfacePixelColour(palette, surface.pixels[33]), 0x0ab);
+
+    // Images are drawn with the fixed greys, zero is transparent
+    u8 imageData[] = { 0, 15, 7, 0 };
+    Image8Bit image = { 4, 1, imageData };
+    Vec2i16 pos = { 30, 20 };
+    Render_BlitNoClip(&surface, &image, pos);
+    int row = 20 * 64;
+    MASSERT_INT_EQ(SurfacePixelColour(palette, surface.pixels[row + 30]), 0x005);
+    MASSERT_INT_EQ(SurfacePixelColour(palette, surface.pixels[row + 31]), 0xfff);
+    MASSERT_INT_EQ(SurfacePixelColour(palette, surface.pixels[row + 32]), 0x777);
+
+    MArrayFree(sceneSetup.assets.models);
+    Render_Free(&sceneSetup);
+    Raster_Free(&raster);
+    Surface_Free(&surface);
+}
+
+void test_detail_governor() {
+#ifdef FINTRO_DETAIL_GOVERNOR
+    RasterContext raster;
+    memset(&raster, 0, sizeof(raster));
+    SceneSetup sceneSetup;
+    memset(&sceneSetup, 0, sizeof(sceneSetup));
+    sceneSetup.raster = &raster;
+    sceneSetup.governor.level = DETAIL_LEVEL_DEFAULT;
+
+    Render_SetDetailBudget(&sceneSetup, 1000);
+    MASSERT_INT_EQ(sceneSetup.renderDetail, 2);
+    MASSERT_INT_EQ(sceneSetup.planetDetail, 2);
+
+    // Drops a level once over budget for a few frames, then holds while the time settles
+    for (int i = 0; i < DETAIL_GOVERNOR_OVER_FRAMES; i++) {
+        Render_UpdateDetailGovernor(&sceneSetup, 1500, 500);
+    }
+    MASSERT_INT_EQ(sceneSetup.governor.level, DETAIL_LEVEL_DEFAULT - 1);
+    for (int i = 0; i < DETAIL_GOVERNOR_HOLD_FRAMES; i++) {
+        Render_UpdateDetailGovernor(&sceneSetup, 1500, 500);
+    }
+    MASSERT_INT_EQ(sceneSetup.governor.level, DETAIL_LEVEL_DEFAULT - 1);
+
+    // Just under budget isn't enough room to raise the level, restarting the budget keeps the level
+    Render_SetDetailBudget(&sceneSetup, 1000);
+    for (int i = 0; i < 500; i++) {
+        Render_UpdateDetailGovernor(&sceneSetup, 600, 200);
+    }
+    MASSERT_INT_EQ(sceneSetup.governor.level, DETAIL_LEVEL_DEFAULT - 1);
+
+    // Well under budget raises a level at a time up to the top level
+    for (int i = 0; i < 1000; i++) {
+        Render_UpdateDetailGovernor(&sceneSetup, 100, 100);
+    }
+    MASSERT_INT_EQ(sceneSetup.governor.level, DETAIL_LEVELS - 1);
+    MASSERT_INT_EQ(raster.bezierDetail, 1);
+
+    Render_SetDetailBudget(&sceneSetup, 0);
+    MASSERT_INT_EQ(sceneSetup.governor.level, DETAIL_LEVEL_DEFAULT);
+    MASSERT_INT_EQ(sceneSetup.renderDetail, 2);
+    MASSERT_INT_EQ(raster.bezierDetail, 0);
+#endif
+}
+
+int main(int argc, char** argv) {
+    MTEST_FUNC(test_depth_tree_nodes());
+    MTEST_FUNC(test_span_buffer_tree());
+    MTEST_FUNC(test_span_buffer_tree_equal_z());
+    MTEST_FUNC(test_span_buffer_list());
+    MTEST_FUNC(test_span_buffer_list_equal_z());
+    MTEST_FUNC(test_dirty_rects_tree());
+    MTEST_FUNC(test_dirty_rects_list());
+    MTEST_FUNC(test_dirty_rects_span_buffer());
+    MTEST_FUNC(test_dirty_rects_all_moving());
+#ifdef RASTER_THREADS
+    MTEST_FUNC(test_raster_bands());
+    MTEST_FUNC(test_raster_bands_span_buffer());
+#endif
+    MTEST_FUNC(test_span_template_flares());
+    MTEST_FUNC(test_span_fill_kernels());
+    MTEST_FUNC(test_vertex_batch_transform());
+    MTEST_FUNC(test_model_analysis());
+    MTEST_FUNC(test_bezier_detail());
+    MTEST_FUNC(test_render_scene_entities_tree());
+    MTEST_FUNC(test_render_scene_entities_list());
+#ifdef FINTRO_ENTITY_THREADS
+    MTEST_FUNC(test_entity_threads_tree());
+    MTEST_FUNC(test_entity_threads_list());
+#endif
+    MTEST_FUNC(test_palette_nearest_colour());
+    MTEST_FUNC(test_palette_nearest_colour_changes());
+    MTEST_FUNC(test_palette_stats());
+#ifdef FINTRO_DRAW_CAPTURE
+    MTEST_FUNC(test_draw_capture_tree());
+    MTEST_FUNC(test_draw_capture_list());
+    MTEST_FUNC(test_draw_capture_invalid_tree());
+    MTEST_FUNC(test_draw_capture_invalid_list());
+#endif
+#ifdef FINTRO_MODELS_AOT
+    MTEST_FUNC(test_models_aot());
+#endif
+    MTEST_FUNC(test_surface_init_uncleared());
+#ifndef FINTRO_SCREEN_RES_FIXED
+    MTEST_FUNC(test_surface_res_for_size());
+#endif
+    MTEST_FUNC(test_surface_pixel_colours());
+    MTEST_FUNC(test_detail_governor());
+    MTEST_PRINT_RESULTS();
+
+    return 0;
+}
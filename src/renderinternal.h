@@ -140,7 +140,8 @@ typedef enum eDrawFuncEnum {
     DRAW_FUNC_BODY_DRAW_1 = 25,
     DRAW_FUNC_BODY_DRAW_2 = 26,
     DRAW_FUNC_BODY_DRAW_3 = 27,
-    DRAW_FUNC_NOP = 28
+    DRAW_FUNC_NOP = 28,
+    DRAW_FUNC_NEXT_CHUNK = 29
 } DrawFuncEnum;
 
 typedef struct sVertexData {
@@ -163,6 +164,10 @@ typedef struct sDrawParamsLine {
     i16 y2;
 } MSTRUCTPACKED DrawParamsLine;
 
+typedef struct sDrawParamsNextChunk {
+    u32 offset; // draw funcs continue from this depth tree offset
+} MSTRUCTPACKED DrawParamsNextChunk;
+
 typedef struct sDrawParamsPoint {
     i16 x;
     i16 y;
@@ -289,4 +294,101 @@ static inline u32 flipWords(u32 v) {
     return (v >> 16 | v << 16);
 }
 
+// Largest model byte code walked by the model analysis and the C translator
+#define MODEL_CODE_MAX_SIZE 0x8000
+
+static inline u16 ModelCode_Read16(const u8* code, u32 offset) {
+    return *((u16*)(code + offset));
+}
+
+// Number of bytes the renderer usually consumes for the instruction at the given offset, or 0 if
+// this can only be known when running. Only the common path is decoded, handlers can skip more (e.g. off
+// screen sub models), so translated code still checks where each handler left the byte code position.
+static inline u32 ModelCode_InstructionSize(const u8* code, u32 offset) {
+    u16 funcParam = ModelCode_Read16(code, offset);
+    switch (funcParam & 0x1f) {
+        case Render_DONE:
+        case Render_AUDIO_CUE:
+        case Render_DEPTH_TREE_PUSH_POP:
+        case Render_MATRIX_SETUP:
+        case Render_MATRIX_COPY:
+            return 2;
+        case Render_LINE:
+        case Render_IF:
+        case Render_IF_NOT:
+        case Render_CALC_A:
+        case Render_CALC_B:
+        case Render_BITMAP_TEXT:
+        case Render_IF_NOT_VAR:
+        case Render_IF_VAR:
+        case Render_MATRIX_TRANSFORM:
+            return 4;
+        case Render_CIRCLE:
+        case Render_TRI:
+        case Render_MIRRORED_TRI:
+        case Render_TEARDROP:
+        case Render_IF_SCREENSPACE_DIST:
+            return 6;
+        case Render_QUAD:
+        case Render_MIRRORED_QUAD:
+        case Render_VTEXT:
+        case Render_CYLINDER:
+        case Render_LINE_BEZIER:
+            return 8;
+        case Render_CYLINDER_COLOUR_CAP:
+            return 12;
+        case Render_COMPLEX:
+            return 4 + (ModelCode_Read16(code, offset + 2) >> 8);
+        case Render_MODEL:
+            return (ModelCode_Read16(code, offset + 2) & 0x8000) ? 8 : 4;
+        case Render_MODEL_SCALE:
+            return (ModelCode_Read16(code, offset + 2) & 0x8000) ? 10 : 6;
+        case Render_COLOUR:
+            return (ModelCode_Read16(code, offset + 2) >> 8) ? 18 : 4;
+        case Render_PLANET:
+            return 6 + ((funcParam >> 4) & 0xffe);
+        case Render_BATCH: {
+            u16 batchId = funcParam >> 5;
+            if (batchId == 0 || batchId == 0x7ff || batchId == 0x7fe) {
+                return 2;
+            } else if (batchId == 0x7fd) {
+                return 4;
+            }
+            u8 upper = batchId >> 8;
+            if (!(upper & 0x1)) {
+                return 2;
+            } else if ((upper & 0x2) && (upper & 0x4)) {
+                return 4;
+            }
+            u32 size = 2;
+            u16 param;
+            do {
+                param = ModelCode_Read16(code, offset + size);
+                size += 2;
+            } while ((param & 0x8000) && size < MODEL_CODE_MAX_SIZE);
+            return size;
+        }
+        case Render_CICLES:
+        default:
+            return 0;
+    }
+}
+
+// Offset an IF style instruction jumps to when its condition skips code, or 0 if it skips to the end
+static inline u32 ModelCode_BranchTarget(const u8* code, u32 offset, u32 size) {
+    u16 funcParam = ModelCode_Read16(code, offset);
+    switch (funcParam & 0x1f) {
+        case Render_IF:
+        case Render_IF_NOT:
+        case Render_IF_NOT_VAR:
+        case Render_IF_VAR:
+        case Render_IF_SCREENSPACE_DIST: {
+            u16 skipBytes = (funcParam >> 4) & 0xffe;
+            return skipBytes ? offset + size + skipBytes : 0;
+        }
+        default:
+            return 0;
+    }
+}
+
 #endif